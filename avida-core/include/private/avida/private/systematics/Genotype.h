@@ -127,6 +127,7 @@ namespace Avida {
       bool LegacySave(void* df) const;
 
       void RemoveActiveReference() const;
+      void RemovePassiveReference() const;
       
 
       // Genotype Specific Methods
@@ -27,6 +27,7 @@
 #include "avida/core/Properties.h"
 #include "avida/data/Provider.h"
 #include "avida/environment/Types.h"
+#include "avida/output/Types.h"
 #include "avida/systematics/Arbiter.h"
 
 #include "avida/private/systematics/Genotype.h"
@@ -53,11 +54,13 @@ namespace Avida {
       // Config Settings
       int m_threshold;
       bool m_disable_class;
+      bool m_record_pruned;
       
       // Internal Data Structures
       Apto::List<GenotypePtr, Apto::SparseVector> m_active_hash[HASH_SIZE];
       Apto::Array<Apto::List<GenotypePtr, Apto::SparseVector>, Apto::ManagedPointer> m_active_sz;
       Apto::List<GenotypePtr, Apto::SparseVector> m_historic;
+      Apto::Array<GenotypePtr, Apto::Smart> m_prune_queue;  // historic genotypes that have lost their last reference
       GenotypePtr m_coalescent;
       int m_best;
       int m_next_id;
@@ -103,6 +106,20 @@ namespace Avida {
       Apto::Array<PropertyID> m_env_action_average;
       Apto::Array<PropertyID> m_env_action_count;
       
+      // Append-only record of pruned genotypes, parent IDs are stored contiguously in m_pruned_parents
+      struct PrunedGenotype
+      {
+        int id;
+        int parents_begin;
+        int num_parents;
+        int update_born;
+        int update_deactivated;
+        int depth;
+        int total_units;
+      };
+      Apto::Array<PrunedGenotype, Apto::Smart> m_pruned;
+      Apto::Array<int, Apto::Smart> m_pruned_parents;
+      
 
       struct ProvidedData
       {
@@ -118,7 +135,7 @@ namespace Avida {
       
       
     public:
-      GenotypeArbiter(World* world, const RoleID& role, int threshold, bool disable_class = false);
+      GenotypeArbiter(World* world, const RoleID& role, int threshold, bool disable_class = false, bool record_pruned = false);
       ~GenotypeArbiter();
       
       // Arbiter Interface Methods
@@ -134,6 +151,11 @@ namespace Avida {
       IteratorPtr Begin();
       
       
+      // Pruned Phylogeny
+      inline int NumPrunedGenotypes() const { return m_pruned.GetSize(); }
+      void WritePrunedPhylogeny(Output::File& df) const;
+      
+      
       // Data::Provider
       Data::ConstDataSetPtr Provides() const;
       void UpdateProvidedValues(Update current_update);
@@ -145,6 +167,7 @@ namespace Avida {
       // Methods called by Genotype
       GenotypePtr ClassifyNewUnit(UnitPtr bu, ConstGroupMembershipPtr parents, const ClassificationHints* hints = NULL);
       void AdjustGenotype(GenotypePtr genotype, int old_size, int new_size);
+      inline void QueueForPruning(GenotypePtr genotype) { m_prune_queue.Push(genotype); }
       
       inline int NumEnvironmentActionTriggers() const { return m_env_action_count.GetSize(); }
       inline const Apto::Array<PropertyID>& EnvironmentActionTriggerAverageIDs() const { return m_env_action_average; }
@@ -161,6 +184,8 @@ namespace Avida {
       Apto::String nameGenotype(int size);
       
       void removeGenotype(GenotypePtr genotype);
+      void prunePending();
+      void recordPruned(GenotypePtr genotype);
       void updateCoalescent();
       
       inline void resizeActiveList(int size);
@@ -56,7 +56,7 @@ namespace Avida {
     
     LIB_EXPORT inline const PropertyID& ID() const { return m_id; }
     LIB_EXPORT inline const PropertyTypeID& Type() const { return m_type_id; }
-    LIB_EXPORT inline const Apto::String& Description() const { return m_desc.Get(m_id); }
+    LIB_EXPORT inline Apto::String Description() const { return m_desc.GetWithDefault(m_id, ""); } // never inserts
     
     LIB_EXPORT virtual Apto::String StringValue() const = 0;
     LIB_EXPORT virtual int IntValue() const = 0;
@@ -43,6 +43,16 @@ namespace Avida {
       typedef Apto::Set<Apto::String, Apto::DefaultHashBTree, Apto::Multi> ArgMultiSet;
       typedef Apto::SmartPtr<ArgMultiSet> ArgMultiSetPtr;
       
+      // Requested data resolved once, at attach time, to the provider (and parsed argument) that supplies it
+      struct PlanEntry
+      {
+        DataID data_id;
+        ProviderPtr provider;
+        ArgumentedProviderPtr arg_provider;
+        DataID raw_id;
+        Argument argument;
+      };
+      
     private:
       World* m_world;
       
@@ -64,6 +74,14 @@ namespace Avida {
       mutable Apto::Mutex m_current_value_mutex;
       mutable Apto::Map<DataID, PackagePtr> m_current_values;
       
+      // Compiled data plan, guarded by m_current_value_mutex.  Each requested data id gets an integer handle indexing
+      // the plan and a flat value cache; a value is current when its stamp matches m_value_stamp.
+      Apto::Map<DataID, int> m_handles;
+      Apto::Array<PlanEntry, Apto::Smart> m_plan;
+      mutable Apto::Array<PackagePtr, Apto::Smart> m_values;
+      mutable Apto::Array<int, Apto::Smart> m_value_stamps;
+      int m_value_stamp;
+      
       static bool s_registered_with_facet_factory;
       
     public:
@@ -95,6 +113,10 @@ namespace Avida {
       
     public:
       LIB_LOCAL PackagePtr GetCurrentValue(const DataID& data_id) const;
+      
+    private:
+      LIB_LOCAL bool compilePlanEntry(const DataID& data_id, PlanEntry& entry) const;
+      LIB_LOCAL PackagePtr currentValue(int handle) const;
     };
     
   };
@@ -87,6 +87,7 @@ namespace Avida {
       LIB_EXPORT void Write(double x, const char* descr, const char* format = "");
       LIB_EXPORT void Write(int i, const char* descr, const char* format = "");
       LIB_EXPORT void Write(long i, const char* descr, const char* format = "");
+      LIB_EXPORT void Write(long long i, const char* descr, const char* format = "");
       LIB_EXPORT void Write(unsigned int i, const char* descr, const char* format = "");
       LIB_EXPORT void Write(const char* data_str, const char* descr, const char* format = "");
       LIB_EXPORT void Write(Apto::Array<int> list, const char* descr, const char* format);
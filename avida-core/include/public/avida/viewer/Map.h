@@ -87,7 +87,12 @@ namespace Avida {
       virtual bool SetProperty(const Apto::String& property, const Apto::String& value) = 0;
       virtual Apto::String GetProperty(const Apto::String& property) const = 0;
       
-      virtual void Update(cPopulation& pop) = 0;
+      // Refreshes the back buffer from the cells in changed_cells (or every cell, if full is set) and any mode wide
+      // state.  Called without the map lock held, so must not touch the values returned by the accessors above.
+      virtual void Update(cPopulation& pop, const Apto::Array<int, Apto::Smart>& changed_cells, bool full) = 0;
+      
+      // Makes the back buffer current.  Called with the map write lock held.
+      virtual void Publish() = 0;
     };
     
     
@@ -97,6 +102,7 @@ namespace Avida {
     class Map
     {
     protected:
+      cWorld* m_world;
       int m_width;
       int m_height;
       int m_num_viewer_colors;
@@ -106,7 +112,11 @@ namespace Avida {
       int m_symbol_mode;     // Current map symbol mode (index into m_view_modes, -1 = off)
       int m_tag_mode;        // Current map tag mode (index into m_view_modes, -1 = off)
       
-      Apto::RWLock m_rw_lock;
+      Apto::RWLock m_rw_lock;     // Guards the published map state, only held by UpdateMaps while publishing
+      Apto::Mutex m_update_mutex; // Serializes mode updates against property changes
+      
+      Apto::Array<int, Apto::Smart> m_changed_cells;
+      bool m_tracking;
       
       
     public:
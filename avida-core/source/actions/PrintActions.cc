@@ -41,7 +41,9 @@
 #include "cAnalyze.h"
 #include "cAnalyzeGenotype.h"
 #include "cCPUTestInfo.h"
+#include "cDeferredPrintQueue.h"
 #include "cEnvironment.h"
+#include "cGridExporter.h"
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
 #include "cHistogram.h"
@@ -83,6 +85,22 @@ static const cString GetDescription() { return "Arguments: [string fname=\"" #DE
 void Process(cAvidaContext&) { m_world->GetStats().METHOD(m_filename); }            /* 12 */ \
 }                                                                                         /* 13 */ \
 
+// Same as STATS_OUT_FILE, additionally declaring the cStats::ORG_STATS_* groups that METHOD consumes
+#define STATS_OUT_FILE_USING(METHOD, DEFAULT, GROUPS)                                     /*  1 */ \
+class cAction ## METHOD : public cAction {                                                /*  2 */ \
+private:                                                                                  /*  3 */ \
+cString m_filename;                                                                     /*  4 */ \
+public:                                                                                   /*  5 */ \
+cAction ## METHOD(cWorld* world, const cString& args, Feedback&) : cAction(world, args)            /*  6 */ \
+{                                                                                       /*  7 */ \
+cString largs(args);                                                                  /*  8 */ \
+if (largs == "") m_filename = #DEFAULT; else m_filename = largs.PopWord();            /*  9 */ \
+m_world->GetStats().RequireOrgStats(GROUPS);                                          /* 10 */ \
+}                                                                                       /* 11 */ \
+static const cString GetDescription() { return "Arguments: [string fname=\"" #DEFAULT "\"]"; }  /* 12 */ \
+void Process(cAvidaContext&) { m_world->GetStats().METHOD(m_filename); }            /* 13 */ \
+}                                                                                         /* 14 */ \
+
 STATS_OUT_FILE(PrintAverageData,            average.dat         );
 STATS_OUT_FILE(PrintDemeAverageData,        deme_average.dat    );
 STATS_OUT_FILE(PrintErrorData,              error.dat           );
@@ -93,20 +111,21 @@ STATS_OUT_FILE(PrintMessageLog,             message_log.dat     );
 STATS_OUT_FILE(PrintRetMessageLog,          retmessage_log.dat  );
 STATS_OUT_FILE(PrintInterruptData,          interrupt.dat       );
 STATS_OUT_FILE(PrintTotalsData,             totals.dat          );
-STATS_OUT_FILE(PrintTasksData,              tasks.dat           );
+STATS_OUT_FILE_USING(PrintTasksData,              tasks.dat, cStats::ORG_STATS_TASKS);
 STATS_OUT_FILE(PrintThreadsData,            threads.dat         );
-STATS_OUT_FILE(PrintHostTasksData,          host_tasks.dat      );
-STATS_OUT_FILE(PrintParasiteTasksData,      parasite_tasks.dat  );
-STATS_OUT_FILE(PrintTasksExeData,           tasks_exe.dat       );
+STATS_OUT_FILE(PrintTestCPUCacheData,       testcpu_cache.dat   );
+STATS_OUT_FILE_USING(PrintHostTasksData,          host_tasks.dat, cStats::ORG_STATS_PARASITE_TASKS);
+STATS_OUT_FILE_USING(PrintParasiteTasksData,      parasite_tasks.dat, cStats::ORG_STATS_PARASITE_TASKS);
+STATS_OUT_FILE_USING(PrintTasksExeData,           tasks_exe.dat, cStats::ORG_STATS_TASKS);
 STATS_OUT_FILE(PrintNewTasksData,           newtasks.dat	);
 STATS_OUT_FILE(PrintNewReactionData,	    newreactions.dat	);
 STATS_OUT_FILE(PrintNewTasksDataPlus,       newtasksplus.dat	);
-STATS_OUT_FILE(PrintTasksQualData,          tasks_quality.dat   );
-STATS_OUT_FILE(PrintReactionData,           reactions.dat       );
-STATS_OUT_FILE(PrintReactionExeData,        reactions_exe.dat   );
-STATS_OUT_FILE(PrintCurrentReactionData,    cur_reactions.dat   );
-STATS_OUT_FILE(PrintReactionRewardData,     reaction_reward.dat );
-STATS_OUT_FILE(PrintCurrentReactionRewardData,     cur_reaction_reward.dat );
+STATS_OUT_FILE_USING(PrintTasksQualData,          tasks_quality.dat, cStats::ORG_STATS_TASKS);
+STATS_OUT_FILE_USING(PrintReactionData,           reactions.dat, cStats::ORG_STATS_REACTIONS);
+STATS_OUT_FILE_USING(PrintReactionExeData,        reactions_exe.dat, cStats::ORG_STATS_REACTIONS);
+STATS_OUT_FILE_USING(PrintCurrentReactionData,    cur_reactions.dat, cStats::ORG_STATS_REACTIONS);
+STATS_OUT_FILE_USING(PrintReactionRewardData,     reaction_reward.dat, cStats::ORG_STATS_REACTIONS);
+STATS_OUT_FILE_USING(PrintCurrentReactionRewardData,     cur_reaction_reward.dat, cStats::ORG_STATS_REACTIONS);
 STATS_OUT_FILE(PrintTimeData,               time.dat            );
 STATS_OUT_FILE(PrintExtendedTimeData,       xtime.dat           );
 STATS_OUT_FILE(PrintMutationRateData,       mutation_rates.dat  );
@@ -121,10 +140,10 @@ STATS_OUT_FILE(PrintTopPredatorErrorData,      top_pred_error.dat   );
 STATS_OUT_FILE(PrintPreyVarianceData,       prey_variance.dat   );
 STATS_OUT_FILE(PrintPredatorVarianceData,   predator_variance.dat   );
 STATS_OUT_FILE(PrintTopPredatorVarianceData,   top_pred_variance.dat   );
-STATS_OUT_FILE(PrintSenseData,              sense.dat           );
-STATS_OUT_FILE(PrintSenseExeData,           sense_exe.dat       );
-STATS_OUT_FILE(PrintInternalTasksData,      in_tasks.dat        );
-STATS_OUT_FILE(PrintInternalTasksQualData,  in_tasks_quality.dat);
+STATS_OUT_FILE_USING(PrintSenseData,              sense.dat, cStats::ORG_STATS_SENSES);
+STATS_OUT_FILE_USING(PrintSenseExeData,           sense_exe.dat, cStats::ORG_STATS_SENSES);
+STATS_OUT_FILE_USING(PrintInternalTasksData,      in_tasks.dat, cStats::ORG_STATS_INTERNAL_TASKS);
+STATS_OUT_FILE_USING(PrintInternalTasksQualData,  in_tasks_quality.dat, cStats::ORG_STATS_INTERNAL_TASKS);
 STATS_OUT_FILE(PrintSleepData,              sleep.dat           );
 STATS_OUT_FILE(PrintCompetitionData,        competition.dat     );
 STATS_OUT_FILE(PrintDemeReplicationData,    deme_repl.dat       );
@@ -1129,6 +1148,29 @@ class cActionPrintDominantGenotype : public cAction
 private:
   cString m_filename;
   
+  class cPrint : public cDeferredPrint
+  {
+  private:
+    cWorld* m_world;
+    Genome m_genome;
+    cString m_filename;
+    int m_update;
+    cTestCPU* m_testcpu;
+    cCPUTestInfo m_test_info;
+    
+  public:
+    cPrint(cWorld* world, const Genome& genome, const cString& filename, int update)
+      : m_world(world), m_genome(genome), m_filename(filename), m_update(update), m_testcpu(NULL) { ; }
+    ~cPrint() { delete m_testcpu; }
+    
+    void Evaluate(cAvidaContext& ctx)
+    {
+      m_testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+      m_testcpu->TestGenome(ctx, m_test_info, m_genome);
+    }
+    void Write() { m_testcpu->PrintTestedGenome(m_test_info, m_genome, m_filename, m_update); }
+  };
+  
 public:
   cActionPrintDominantGenotype(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
   {
@@ -1137,6 +1179,7 @@ public:
   }
   
   static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  bool IsDeferredPrint() const { return true; }
   
   void Process(cAvidaContext& ctx)
   {
@@ -1146,9 +1189,8 @@ public:
     if (bg) {
       cString filename(m_filename);
       if (filename == "") filename.Set("archive/%s.org", (const char*)bg->Properties().Get("name").StringValue());
-      cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
-      testcpu->PrintGenome(ctx, Genome(bg->Properties().Get("genome")), filename, m_world->GetStats().GetUpdate());
-      delete testcpu;
+      Genome genome(bg->Properties().Get("genome"));
+      m_world->GetDeferredPrints().Submit(ctx, new cPrint(m_world, genome, filename, m_world->GetStats().GetUpdate()));
     }
   }
 };
@@ -2801,6 +2843,57 @@ class cActionTestDominant : public cAction
 private:
   cString m_filename;
   
+  class cPrint : public cDeferredPrint
+  {
+  private:
+    cWorld* m_world;
+    Genome m_genome;
+    cString m_filename;
+    int m_update;
+    double m_merit;
+    int m_gestation_time;
+    double m_fitness;
+    int m_copied_size;
+    int m_executed_size;
+    
+  public:
+    cPrint(cWorld* world, const Genome& genome, const cString& filename, int update)
+      : m_world(world), m_genome(genome), m_filename(filename), m_update(update)
+      , m_merit(0.0), m_gestation_time(0), m_fitness(0.0), m_copied_size(0), m_executed_size(0) { ; }
+    
+    void Evaluate(cAvidaContext& ctx)
+    {
+      cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+      cCPUTestInfo test_info;
+      testcpu->TestGenome(ctx, test_info, m_genome);
+      delete testcpu;
+      
+      cPhenotype& colony_phenotype = test_info.GetColonyOrganism()->GetPhenotype();
+      m_merit = colony_phenotype.GetMerit().GetDouble();
+      m_gestation_time = colony_phenotype.GetGestationTime();
+      m_fitness = colony_phenotype.GetFitness();
+      m_copied_size = colony_phenotype.GetCopiedSize();
+      m_executed_size = colony_phenotype.GetExecutedSize();
+    }
+    
+    void Write()
+    {
+      InstructionSequencePtr seq;
+      seq.DynamicCastFrom(m_genome.Representation());
+      
+      Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)m_filename);
+      df->Write(m_update, "Update");
+      df->Write(m_merit, "Merit");
+      df->Write(m_gestation_time, "Gestation Time");
+      df->Write(m_fitness, "Fitness");
+      df->Write(1.0 / (0.1 + m_gestation_time), "Reproduction Rate");
+      df->Write(seq->GetSize(), "Genome Length");
+      df->Write(m_copied_size, "Copied Size");
+      df->Write(m_executed_size, "Executed Size");
+      df->Endl();
+    }
+  };
+  
 public:
   cActionTestDominant(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("dom-test.dat")
   {
@@ -2808,32 +2901,14 @@ public:
     if (largs.GetSize()) m_filename = largs.PopWord();
   }
   static const cString GetDescription() { return "Arguments: [string fname='dom-test.dat']"; }
+  bool IsDeferredPrint() const { return true; }
   void Process(cAvidaContext& ctx)
   {
     Systematics::ManagerPtr classmgr = Systematics::Manager::Of(m_world->GetNewWorld());
     Systematics::Arbiter::IteratorPtr it = classmgr->ArbiterForRole("genotype")->Begin();
     Systematics::GroupPtr bg = it->Next();
     Genome genome(bg->Properties().Get("genome"));
-    InstructionSequencePtr seq;
-    seq.DynamicCastFrom(genome.Representation());
-    
-    cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
-    cCPUTestInfo test_info;
-    testcpu->TestGenome(ctx, test_info, genome);
-    delete testcpu;
-    
-    cPhenotype& colony_phenotype = test_info.GetColonyOrganism()->GetPhenotype();
-    
-    Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)m_filename);
-    df->Write(m_world->GetStats().GetUpdate(), "Update");
-    df->Write(colony_phenotype.GetMerit().GetDouble(), "Merit");
-    df->Write(colony_phenotype.GetGestationTime(), "Gestation Time");
-    df->Write(colony_phenotype.GetFitness(), "Fitness");
-    df->Write(1.0 / (0.1 + colony_phenotype.GetGestationTime()), "Reproduction Rate");
-    df->Write(seq->GetSize(), "Genome Length");
-    df->Write(colony_phenotype.GetCopiedSize(), "Copied Size");
-    df->Write(colony_phenotype.GetExecutedSize(), "Executed Size");
-    df->Endl();
+    m_world->GetDeferredPrints().Submit(ctx, new cPrint(m_world, genome, m_filename, m_world->GetStats().GetUpdate()));
   }
 };
 
@@ -2843,71 +2918,129 @@ class cActionPrintTaskSnapshot : public cAction
 private:
   cString m_filename;
   
-public:
-  cActionPrintTaskSnapshot(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  struct sOrgSnapshot
   {
-    cString largs(args);
-    if (largs.GetSize()) m_filename = largs.PopWord();
-  }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
-  void Process(cAvidaContext& ctx)
+    int cell_id;
+    Genome* genome;
+    int sum_tasks_rewarded;
+    int sum_tasks_all;
+    int divide_sum_tasks_rewarded;
+    int divide_sum_tasks_all;
+    int parent_sum_tasks_rewarded;
+    int parent_sum_tasks_all;
+    double fitness;
+    int genotype_id;
+  };
+  
+  class cPrint : public cDeferredPrint
   {
-    cString filename(m_filename);
-    if (filename == "") filename.Set("tasks_%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)m_filename);
+  private:
+    cWorld* m_world;
+    cString m_filename;
+    Apto::Array<sOrgSnapshot> m_orgs;
     
-    cPopulation& pop = m_world->GetPopulation();
-    cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  public:
+    cPrint(cWorld* world, const cString& filename) : m_world(world), m_filename(filename) { ; }
+    ~cPrint() { for (int i = 0; i < m_orgs.GetSize(); i++) delete m_orgs[i].genome; }
     
-    for (int i = 0; i < pop.GetSize(); i++) {
-      if (pop.GetCell(i).IsOccupied() == false) continue;
-      cOrganism* organism = pop.GetCell(i).GetOrganism();
+    void AddOrganism(int cell_id, cOrganism* organism)
+    {
+      sOrgSnapshot snap;
+      snap.cell_id = cell_id;
+      snap.genome = new Genome(organism->GetGenome());
+      snap.sum_tasks_rewarded = 0;
+      snap.sum_tasks_all = 0;
+      snap.parent_sum_tasks_rewarded = 0;
+      snap.parent_sum_tasks_all = 0;
+      snap.divide_sum_tasks_rewarded = 0;
+      snap.divide_sum_tasks_all = 0;
+      snap.fitness = 0.0;
+      snap.genotype_id = organism->SystematicsGroup("genotype")->ID();
       
-      // create a test-cpu for the current creature
-      cCPUTestInfo test_info;
-      testcpu->TestGenome(ctx, test_info, organism->GetGenome());
-      cPhenotype& test_phenotype = test_info.GetTestPhenotype();
       cPhenotype& phenotype = organism->GetPhenotype();
-      
-      int num_tasks = m_world->GetEnvironment().GetNumTasks();
-      int sum_tasks_all = 0;
-      int sum_tasks_rewarded = 0;
-      int divide_sum_tasks_all = 0;
-      int divide_sum_tasks_rewarded = 0;
-      int parent_sum_tasks_all = 0;
-      int parent_sum_tasks_rewarded = 0;
-      
+      const int num_tasks = m_world->GetEnvironment().GetNumTasks();
       for (int j = 0; j < num_tasks; j++) {
         // get the number of bonuses for this task
         int bonuses = 1; //phenotype.GetTaskLib().GetTaskNumBonus(j);
         int task_count = ( phenotype.GetCurTaskCount()[j] == 0 ) ? 0 : 1;
-        int divide_tasks_count = (test_phenotype.GetLastTaskCount()[j] == 0)?0:1;
         int parent_task_count = (phenotype.GetLastTaskCount()[j] == 0) ? 0 : 1;
         
         // If only one bonus, this task is not rewarded, as last bonus is + 0.
         if (bonuses > 1) {
-          sum_tasks_rewarded += task_count;
-          divide_sum_tasks_rewarded += divide_tasks_count;
-          parent_sum_tasks_rewarded += parent_task_count;
+          snap.sum_tasks_rewarded += task_count;
+          snap.parent_sum_tasks_rewarded += parent_task_count;
         }
-        sum_tasks_all += task_count;
-        divide_sum_tasks_all += divide_tasks_count;
-        parent_sum_tasks_all += parent_task_count;
+        snap.sum_tasks_all += task_count;
+        snap.parent_sum_tasks_all += parent_task_count;
       }
       
-      df->Write(i, "Cell Number");
-      df->Write(sum_tasks_rewarded, "Number of Tasks Rewarded");
-      df->Write(sum_tasks_all, "Total Number of Tasks Done");
-      df->Write(divide_sum_tasks_rewarded, "Number of Rewarded Tasks on Divide");
-      df->Write(divide_sum_tasks_all, "Number of Total Tasks on Divide");
-      df->Write(parent_sum_tasks_rewarded, "Parent Number of Tasks Rewared");
-      df->Write(parent_sum_tasks_all, "Parent Total Number of Tasks Done");
-      df->Write(test_info.GetColonyFitness(), "Genotype Fitness");
-      df->Write(organism->SystematicsGroup("genotype")->ID(), "Genotype ID");
-      df->Endl();
+      m_orgs.Push(snap);
     }
     
-    delete testcpu;
+    void Evaluate(cAvidaContext& ctx)
+    {
+      cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+      const int num_tasks = m_world->GetEnvironment().GetNumTasks();
+      
+      for (int i = 0; i < m_orgs.GetSize(); i++) {
+        sOrgSnapshot& snap = m_orgs[i];
+        
+        // create a test-cpu for the current creature
+        cCPUTestInfo test_info;
+        testcpu->TestGenome(ctx, test_info, *snap.genome);
+        cPhenotype& test_phenotype = test_info.GetTestPhenotype();
+        
+        for (int j = 0; j < num_tasks; j++) {
+          int bonuses = 1;
+          int divide_tasks_count = (test_phenotype.GetLastTaskCount()[j] == 0)?0:1;
+          if (bonuses > 1) snap.divide_sum_tasks_rewarded += divide_tasks_count;
+          snap.divide_sum_tasks_all += divide_tasks_count;
+        }
+        snap.fitness = test_info.GetColonyFitness();
+      }
+      
+      delete testcpu;
+    }
+    
+    void Write()
+    {
+      Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)m_filename);
+      for (int i = 0; i < m_orgs.GetSize(); i++) {
+        const sOrgSnapshot& snap = m_orgs[i];
+        df->Write(snap.cell_id, "Cell Number");
+        df->Write(snap.sum_tasks_rewarded, "Number of Tasks Rewarded");
+        df->Write(snap.sum_tasks_all, "Total Number of Tasks Done");
+        df->Write(snap.divide_sum_tasks_rewarded, "Number of Rewarded Tasks on Divide");
+        df->Write(snap.divide_sum_tasks_all, "Number of Total Tasks on Divide");
+        df->Write(snap.parent_sum_tasks_rewarded, "Parent Number of Tasks Rewared");
+        df->Write(snap.parent_sum_tasks_all, "Parent Total Number of Tasks Done");
+        df->Write(snap.fitness, "Genotype Fitness");
+        df->Write(snap.genotype_id, "Genotype ID");
+        df->Endl();
+      }
+    }
+  };
+  
+public:
+  cActionPrintTaskSnapshot(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  {
+    cString largs(args);
+    if (largs.GetSize()) m_filename = largs.PopWord();
+  }
+  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  bool IsDeferredPrint() const { return true; }
+  void Process(cAvidaContext& ctx)
+  {
+    cString filename(m_filename);
+    if (filename == "") filename.Set("tasks_%d.dat", m_world->GetStats().GetUpdate());
+    
+    cPopulation& pop = m_world->GetPopulation();
+    cPrint* print = new cPrint(m_world, m_filename);
+    for (int i = 0; i < pop.GetSize(); i++) {
+      if (pop.GetCell(i).IsOccupied() == false) continue;
+      print->AddOrganism(i, pop.GetCell(i).GetOrganism());
+    }
+    m_world->GetDeferredPrints().Submit(ctx, print);
   }
 };
 
@@ -3268,6 +3401,57 @@ private:
 };
 
 
+/*
+ Dumps several grid layers at once, gathered in a single pass over the population.
+ 
+ Parameters:
+ layers (string)
+ Comma separated list of layers, 'all' for every population layer, 'res.NAME' for a resource.
+ format (string)
+ 'binary' writes every layer into one compressed grid file (see cGridSnapshot), 'text' writes each layer into the
+ same file, in the same layout, as its Dump*Grid action.
+ fname (string)
+ Binary file name, defaults to grid_dumps/grids.UPDATE.agrid.
+ */
+class cActionDumpGrids : public cAction
+{
+private:
+  cGridExporter m_exporter;
+  bool m_binary;
+  cString m_filename;
+  
+public:
+  cActionDumpGrids(cWorld* world, const cString& args, Feedback& feedback)
+    : cAction(world, args), m_exporter(world), m_binary(true), m_filename("")
+  {
+    cString largs(args);
+    m_exporter.SelectLayers((largs.GetSize()) ? largs.PopWord() : cString("all"), feedback);
+    if (largs.GetSize()) m_binary = (largs.PopWord() != "text");
+    if (largs.GetSize()) m_filename = largs.PopWord();
+  }
+  static const cString GetDescription()
+  {
+    return cString("Arguments: [string layers='all'] [string format='binary'|'text'] [string fname='']  Layers: ")
+      + cGridExporter::GetLayerNames() + ", res.NAME";
+  }
+  void Process(cAvidaContext& ctx)
+  {
+    cGridSnapshot snapshot;
+    m_exporter.Gather(ctx, snapshot);
+    
+    if (m_binary) {
+      cString filename(m_filename);
+      if (filename == "") filename.Set("grid_dumps/grids.%d.agrid", snapshot.GetUpdate());
+      if (!m_exporter.WriteBinary(snapshot, filename)) {
+        m_world->GetDriver().Feedback().Error("DumpGrids unable to write '%s'", (const char*)filename);
+      }
+    } else {
+      m_exporter.WriteText(snapshot);
+    }
+  }
+};
+
+
 class cActionDumpEnergyGrid : public cAction
 {
 private:
@@ -3783,6 +3967,63 @@ class cActionDumpTaskGrid : public cAction
 private:
   cString m_filename;
   
+  class cPrint : public cDeferredPrint
+  {
+  private:
+    cWorld* m_world;
+    cString m_filename;
+    int m_world_x;
+    int m_world_y;
+    Apto::Array<Genome*> m_genomes;   // column by column, as the grid is written; NULL for empty cells
+    Apto::Array<int> m_task_sums;
+    
+  public:
+    cPrint(cWorld* world, const cString& filename) : m_world(world), m_filename(filename)
+    {
+      cPopulation& pop = m_world->GetPopulation();
+      m_world_x = pop.GetWorldX();
+      m_world_y = pop.GetWorldY();
+      m_genomes.Resize(m_world_x * m_world_y);
+      m_task_sums.Resize(m_world_x * m_world_y);
+      m_task_sums.SetAll(0);
+      for (int i = 0; i < m_world_x; i++) {
+        for (int j = 0; j < m_world_y; j++) {
+          cPopulationCell& cell = pop.GetCell(j * m_world_x + i);
+          m_genomes[i * m_world_y + j] = (cell.IsOccupied()) ? new Genome(cell.GetOrganism()->GetGenome()) : NULL;
+        }
+      }
+    }
+    ~cPrint() { for (int i = 0; i < m_genomes.GetSize(); i++) delete m_genomes[i]; }
+    
+    void Evaluate(cAvidaContext& ctx)
+    {
+      cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+      const int num_tasks = m_world->GetEnvironment().GetNumTasks();
+      
+      for (int i = 0; i < m_genomes.GetSize(); i++) {
+        if (m_genomes[i] == NULL) continue;
+        cCPUTestInfo test_info;
+        testcpu->TestGenome(ctx, test_info, *m_genomes[i]);
+        cPhenotype& test_phenotype = test_info.GetTestPhenotype();
+        for (int k = 0; k < num_tasks; k++) {
+          if (test_phenotype.GetLastTaskCount()[k] > 0) m_task_sums[i] += static_cast<int>(pow(2.0, k));
+        }
+      }
+      
+      delete testcpu;
+    }
+    
+    void Write()
+    {
+      Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)m_filename);
+      ofstream& fp = df->OFStream();
+      for (int i = 0; i < m_world_x; i++) {
+        for (int j = 0; j < m_world_y; j++) fp << m_task_sums[i * m_world_y + j] << " ";
+        fp << endl;
+      }
+    }
+  };
+  
 public:
   cActionDumpTaskGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
   {
@@ -3790,37 +4031,12 @@ public:
     if (largs.GetSize()) m_filename = largs.PopWord();
   }
   static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  bool IsDeferredPrint() const { return true; }
   void Process(cAvidaContext& ctx)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_task.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    cPopulation* pop = &m_world->GetPopulation();
-    cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
-    
-    const int num_tasks = m_world->GetEnvironment().GetNumTasks();
-    
-    for (int i = 0; i < pop->GetWorldX(); i++) {
-      for (int j = 0; j < pop->GetWorldY(); j++) {
-        int task_sum = 0;
-        int cell_num = j * pop->GetWorldX() + i;
-        if (pop->GetCell(cell_num).IsOccupied() == true) {
-          cOrganism* organism = pop->GetCell(cell_num).GetOrganism();
-          cCPUTestInfo test_info;
-          testcpu->TestGenome(ctx, test_info, organism->GetGenome());
-          cPhenotype& test_phenotype = test_info.GetTestPhenotype();
-          for (int k = 0; k < num_tasks; k++) {
-            if (test_phenotype.GetLastTaskCount()[k] > 0) task_sum += static_cast<int>(pow(2.0, k));
-          }
-        }
-        fp << task_sum << " ";
-      }
-      fp << endl;
-    }
-    
-    delete testcpu;
+    m_world->GetDeferredPrints().Submit(ctx, new cPrint(m_world, filename));
   }
 };
 
@@ -5276,6 +5492,7 @@ void RegisterPrintActions(cActionLibrary* action_lib)
   action_lib->Register<cActionPrintInterruptData>("PrintInterruptData");
   action_lib->Register<cActionPrintTotalsData>("PrintTotalsData");
   action_lib->Register<cActionPrintThreadsData>("PrintThreadsData");
+  action_lib->Register<cActionPrintTestCPUCacheData>("PrintTestCPUCacheData");
   action_lib->Register<cActionPrintTasksData>("PrintTasksData");
   action_lib->Register<cActionPrintSoloTaskSnapshot>("PrintSoloTaskSnapshot");
   action_lib->Register<cActionPrintHostTasksData>("PrintHostTasksData");
@@ -5475,6 +5692,7 @@ void RegisterPrintActions(cActionLibrary* action_lib)
   action_lib->Register<cActionPrintGenomicSiteEntropy>("PrintGenomicSiteEntropy");
   
   // Grid Information Dumps
+  action_lib->Register<cActionDumpGrids>("DumpGrids");
   action_lib->Register<cActionDumpClassificationIDGrid>("DumpClassificationIDGrid");
   action_lib->Register<cActionDumpFitnessGrid>("DumpFitnessGrid");
   action_lib->Register<cActionDumpGenotypeColorGrid>("DumpGenotypeColorGrid");
@@ -21,6 +21,11 @@
 
 #include "SaveLoadActions.h"
 
+#include "avida/output/File.h"
+#include "avida/systematics/Manager.h"
+
+#include "avida/private/systematics/GenotypeArbiter.h"
+
 #include "cAction.h"
 #include "cActionLibrary.h"
 #include "cArgContainer.h"
@@ -281,6 +286,55 @@ public:
   }
 };
 
+/*
+ Writes out the genotypes that have been pruned from the historic list, as recorded when RECORD_PRUNED_PHYLOGENY is set.
+ 
+ Parameters:
+   filename (string) default: pruned_phylogeny
+     The name of the file to write, the current update is appended.
+ */
+class cActionSavePrunedPhylogeny : public cAction
+{
+private:
+  cString m_filename;
+  
+public:
+  cActionSavePrunedPhylogeny(cWorld* world, const cString& args, Feedback& feedback)
+  : cAction(world, args), m_filename("pruned_phylogeny")
+  {
+    cArgSchema schema(':','=');
+    
+    // String Entries
+    schema.AddEntry("filename", 0, "pruned_phylogeny");
+    
+    cArgContainer* argc = cArgContainer::Load(args, schema, feedback);
+    
+    if (argc) {
+      m_filename = argc->GetString(0);
+    }
+    
+    delete argc;
+  }
+  
+  static const cString GetDescription() { return "Arguments: [string filename='pruned_phylogeny']"; }
+  
+  void Process(cAvidaContext&)
+  {
+    Avida::Systematics::GenotypeArbiterPtr arb;
+    arb.DynamicCastFrom(Avida::Systematics::Manager::Of(m_world->GetNewWorld())->ArbiterForRole("genotype"));
+    if (!arb) return;
+    
+    cString filename = cStringUtil::Stringf("%s-%d.dat", (const char*)m_filename, m_world->GetStats().GetUpdate());
+    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
+    
+    df->SetFileType("phylogeny");
+    df->WriteComment("Genotypes pruned from the historic list");
+    df->WriteTimeStamp();
+    
+    arb->WritePrunedPhylogeny(*df);
+  }
+};
+
 void RegisterSaveLoadActions(cActionLibrary* action_lib)
 {
   action_lib->Register<cActionLoadParasiteGenotypeList>("LoadParasiteGenotypeList");
@@ -290,4 +344,5 @@ void RegisterSaveLoadActions(cActionLibrary* action_lib)
   action_lib->Register<cActionLoadStructuredSystematicsGroup>("LoadStructuredSystematicsGroup");
   action_lib->Register<cActionSaveStructuredSystematicsGroup>("SaveStructuredSystematicsGroup");
   action_lib->Register<cActionSaveFlameData>("SaveFlameData");
+  action_lib->Register<cActionSavePrunedPhylogeny>("SavePrunedPhylogeny");
 }
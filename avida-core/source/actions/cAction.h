@@ -45,6 +45,10 @@ public:
   const cString& GetArgs() const { return m_args; }
   
   virtual void Process(cAvidaContext& ctx) = 0;
+  
+  // Print actions that only queue their work with cDeferredPrintQueue return true.  Any other action may change what
+  // queued prints read, so the event list flushes the queue before running it.
+  virtual bool IsDeferredPrint() const { return false; }
 };
 
 #endif
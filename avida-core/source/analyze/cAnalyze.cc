@@ -48,6 +48,7 @@
 #include "cAvidaContext.h"
 #include "cCPUTestInfo.h"
 #include "cEnvironment.h"
+#include "cGenotypeFileLoader.h"
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
 #include "cHardwareStatusPrinter.h"
@@ -55,6 +56,7 @@
 #include "cInstSet.h"
 #include "cLandscape.h"
 #include "cModularityAnalysis.h"
+#include "cPerfTimers.h"
 #include "cPhenotype.h"
 #include "cPhenPlastGenotype.h"
 #include "cPlasticPhenotype.h"
@@ -774,6 +776,34 @@ void cAnalyze::LoadFile(cString cur_string)
   
   cout << "Loading: " << filename << endl;
   
+  // Setup the genome...
+  const cInstSet& is = m_world->GetHardwareManager().GetDefaultInstSet();
+  HashPropertyMap props;
+  cHardwareManager::SetupPropertyMap(props, (const char*)is.GetInstSetName());
+  Genome default_genome(is.GetHardwareType(), props, GeneticRepresentationPtr(new InstructionSequence(1)));
+  
+  // Plain genotype files are mapped and parsed in chunks on the analyze job queue.  Files that need cInitFile
+  // preprocessing, or that would produce errors, go through the serial reader below.
+  cGenotypeFileLoader loader(m_world, filename);
+  if (loader.Open() && (loader.GetFiletype() == "population_data" || loader.GetFiletype() == "genotype_data")) {
+    tList< tDataEntryCommand<cAnalyzeGenotype> > column_list;
+    cUserFeedback column_feedback;
+    cAnalyzeGenotype::GetDataCommandManager().LoadCommandList(loader.GetFormat(), column_list, &column_feedback);
+    
+    const bool loaded = (column_feedback.GetNumMessages() == 0 &&
+                         loader.Load(m_jobqueue, column_list, default_genome, batch[cur_batch].List()));
+    while (column_list.GetSize()) delete column_list.Pop();
+    
+    if (loaded) {
+      if (m_world->GetVerbosity() >= VERBOSE_ON) {
+        cout << "Loading file of type: " << loader.GetFiletype() << endl;
+      }
+      batch[cur_batch].SetLineage(false);
+      batch[cur_batch].SetAligned(false);
+      return;
+    }
+  }
+  
   cInitFile input_file(filename, m_world->GetWorkingDir());
   if (!input_file.WasOpened()) {
     const cUserFeedback& feedback = input_file.GetFeedback();
@@ -819,11 +849,6 @@ void cAnalyze::LoadFile(cString cur_string)
   
   bool id_inc = input_file.GetFormat().HasString("id");
   
-  // Setup the genome...
-  const cInstSet& is = m_world->GetHardwareManager().GetDefaultInstSet();
-  HashPropertyMap props;
-  cHardwareManager::SetupPropertyMap(props, (const char*)is.GetInstSetName());
-  Genome default_genome(is.GetHardwareType(), props, GeneticRepresentationPtr(new InstructionSequence(1)));
   int load_count = 0;
   
   for (int line_id = 0; line_id < input_file.GetNumLines(); line_id++) {
@@ -4502,8 +4527,11 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
     if (m_world->GetVerbosity() >= VERBOSE_ON) cout << "  Knockout: " << genotype->GetName() << endl;
     
     // Calculate the stats for the genotype we're working with...
-    genotype->Recalculate(m_ctx);
+    cCPUTestInfo test_info;
+    test_info.TrackSiteCoverage();
+    genotype->Recalculate(m_ctx, &test_info);
     const double base_fitness = genotype->GetFitness();
+    const sCPUSiteCoverage& base_coverage = test_info.GetSiteCoverage();
     
     const int max_line = genotype->GetLength();
     
@@ -4532,10 +4560,15 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
       // Save a copy of the current instruction and replace it with "NULL"
       int cur_inst = base_seq[line_num].GetOp();
       mod_seq[line_num] = null_inst;
-      cAnalyzeGenotype ko_genotype(m_world, mod_genome);
-      ko_genotype.Recalculate(m_ctx);
       
-      double ko_fitness = ko_genotype.GetFitness();
+      // Knockouts of sites the base run never read are known to be neutral without testing them
+      double ko_fitness = base_fitness;
+      if (!base_coverage.IsInert(line_num, base_genome, mod_genome)) {
+        cAnalyzeGenotype ko_genotype(m_world, mod_genome);
+        ko_genotype.Recalculate(m_ctx);
+        ko_fitness = ko_genotype.GetFitness();
+      }
+      
       if (ko_fitness == 0.0) {
         dead_count++;
         ko_effect[line_num] = -2;
@@ -4564,10 +4597,13 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
           int cur_inst2 = base_seq[line2].GetOp();
           mod_seq[line1] = null_inst;
           mod_seq[line2] = null_inst;
-          cAnalyzeGenotype ko_genotype(m_world, mod_genome);
-          ko_genotype.Recalculate(m_ctx);
           
-          double ko_fitness = ko_genotype.GetFitness();
+          double ko_fitness = base_fitness;
+          if (base_coverage.IsRead(line1) || !base_coverage.IsInert(line2, base_genome, mod_genome)) {
+            cAnalyzeGenotype ko_genotype(m_world, mod_genome);
+            ko_genotype.Recalculate(m_ctx);
+            ko_fitness = ko_genotype.GetFitness();
+          }
           
           // If both individual knockouts are both harmful, but in combination
           // they are neutral or even beneficial, they should not count as 
@@ -9631,6 +9667,10 @@ void cAnalyze::ProcessCommands(tList<cAnalyzeCommand>& clist)
     
     cAnalyzeCommandDefBase* command_fun = FindAnalyzeCommandDef(command);
     
+    // Each command gets its own timer, nested commands (FORALL, functions, ...) are counted in their callers as well
+    cPerfTimers* perf = m_ctx.GetPerfTimers();
+    cScopedTimer timer(perf, (perf) ? perf->GetTimerID(cString("analyze:") + command) : 0);
+    
     cUserFeedback feedback;
     if (command_fun != NULL) {
       command_fun->Run(this, args, *cur_command, feedback);
@@ -387,9 +387,12 @@ void cAnalyzeGenotype::CalcKnockouts(bool check_pairs, bool check_chart) const
   // (This may not have been run already, and cost negligiably more time
   // considering the number of knockouts we need to do.
   cAnalyzeGenotype base_genotype(m_world, m_genome);
-  base_genotype.Recalculate(ctx);
+  cCPUTestInfo test_info;
+  test_info.TrackSiteCoverage();
+  base_genotype.Recalculate(ctx, &test_info);
   double base_fitness = base_genotype.GetFitness();
   const Apto::Array<int> base_task_counts( base_genotype.GetTaskCounts() );
+  const sCPUSiteCoverage& base_coverage = test_info.GetSiteCoverage();
   
   // If the base fitness is 0, the organism is dead and has no complexity.
   if (base_fitness == 0.0) {
@@ -421,14 +424,21 @@ void cAnalyzeGenotype::CalcKnockouts(bool check_pairs, bool check_chart) const
     InstructionSequence& mod_seq = *mod_seq_p;
     int cur_inst = mod_seq[line_num].GetOp();
     mod_seq[line_num] = null_inst;
-    cAnalyzeGenotype ko_genotype(m_world, mod_genome);
-    ko_genotype.Recalculate(ctx);
-    if (check_chart == true) {
-      const Apto::Array<int> ko_task_counts( ko_genotype.GetTaskCounts() );
-      knockout_stats->task_counts[line_num] = ko_task_counts;
+    
+    // Knockouts of sites the base run never read behave exactly like the base genotype
+    double ko_fitness = base_fitness;
+    if (base_coverage.IsInert(line_num, m_genome, mod_genome)) {
+      if (check_chart == true) knockout_stats->task_counts[line_num] = base_task_counts;
+    } else {
+      cAnalyzeGenotype ko_genotype(m_world, mod_genome);
+      ko_genotype.Recalculate(ctx);
+      if (check_chart == true) {
+        const Apto::Array<int> ko_task_counts( ko_genotype.GetTaskCounts() );
+        knockout_stats->task_counts[line_num] = ko_task_counts;
+      }
+      ko_fitness = ko_genotype.GetFitness();
     }
     
-    double ko_fitness = ko_genotype.GetFitness();
     if (ko_fitness == 0.0) {
       knockout_stats->dead_count++;
       ko_effect[line_num] = -2;
@@ -485,10 +495,13 @@ void cAnalyzeGenotype::CalcKnockouts(bool check_pairs, bool check_chart) const
       int cur_inst2 = mod_genome_seq[line2].GetOp();
       mod_genome_seq[line1] = null_inst;
       mod_genome_seq[line2] = null_inst;
-      cAnalyzeGenotype ko_genotype(m_world, mod_genome);
-      ko_genotype.Recalculate(ctx);
       
-      double ko_fitness = ko_genotype.GetFitness();
+      double ko_fitness = base_fitness;
+      if (base_coverage.IsRead(line1) || !base_coverage.IsInert(line2, m_genome, mod_genome)) {
+        cAnalyzeGenotype ko_genotype(m_world, mod_genome);
+        ko_genotype.Recalculate(ctx);
+        ko_fitness = ko_genotype.GetFitness();
+      }
       
       // If the individual knockouts are both harmful, but in combination
       // they are neutral or even beneficial, they should not count as 
@@ -859,6 +872,44 @@ void cAnalyzeGenotype::SetSequence(cString _seq)
   *seq = new_seq;
 }
 
+void cAnalyzeGenotype::DecodeSequence(const char* str, int len)
+{
+  // Mirrors the InstructionSequence string constructor: '_' is skipped, '+', '-', '~' and '?' prefix a second symbol,
+  // and symbols that do not decode are dropped
+  InstructionSequencePtr seq;
+  seq.DynamicCastFrom(m_genome.Representation());
+  if (len > 0) seq->Resize(len);
+  
+  int size = 0;
+  for (int i = 0; i < len; i++) {
+    char sym_char = str[i];
+    int operand = 0;
+    switch (sym_char) {
+      case '_': continue;
+      case '+': operand = 62; break;
+      case '-': operand = 124; break;
+      case '~': operand = 186; break;
+      case '?': operand = 248; break;
+    }
+    const bool prefixed = (operand != 0);
+    if (prefixed) {
+      if (i + 1 >= len) continue;
+      sym_char = str[i + 1];
+    }
+    
+    if (sym_char >= 'a' && sym_char <= 'z') operand += sym_char - 'a';
+    else if (sym_char >= 'A' && sym_char <= 'Z') operand += sym_char - 'A' + 26;
+    else if (sym_char >= '0' && sym_char <= '9') operand += sym_char - '0' + 52;
+    else continue;
+    
+    if (prefixed) i++;
+    (*seq)[size++].SetOp(operand);
+  }
+  
+  if (size > 0) seq->Resize(size);
+  else *seq = InstructionSequence();
+}
+
 
 cString cAnalyzeGenotype::GetHTMLSequence() const
 {
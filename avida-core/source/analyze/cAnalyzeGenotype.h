@@ -395,6 +395,7 @@ public:
   cString GetInstSet() const { return cString((const char*)m_genome.Properties().Get("instset").StringValue()); }
   cString GetSequence() const;
   void SetSequence(cString _seq);
+  void DecodeSequence(const char* seq, int len);  // same as SetSequence(), without the intermediate strings
   cString GetHTMLSequence() const;
 
   cString GetMapLink() const {
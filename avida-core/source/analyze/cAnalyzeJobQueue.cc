@@ -40,10 +40,21 @@ using namespace Avida;
 cAnalyzeJobQueue::cAnalyzeJobQueue(cWorld* world)
 : m_world(world), m_last_jobid(0), m_jobs(0), m_pending(0), m_workers(Apto::Platform::AvailableCPUs())
 {
-  const int max_workers = world->GetConfig().MAX_CONCURRENCY.Get();
+  setup(world->GetRandom().GetInt(world->GetRandom().MaxSeed()));
+}
+
+cAnalyzeJobQueue::cAnalyzeJobQueue(cWorld* world, int seed)
+: m_world(world), m_last_jobid(0), m_jobs(0), m_pending(0), m_workers(Apto::Platform::AvailableCPUs())
+{
+  setup(seed);
+}
+
+void cAnalyzeJobQueue::setup(int seed)
+{
+  const int max_workers = m_world->GetConfig().MAX_CONCURRENCY.Get();
   if (max_workers > 0 && max_workers < m_workers.GetSize()) m_workers.Resize(max_workers);
   
-  m_job_seed_rng = new Apto::RNG::AvidaRNG(world->GetRandom().GetInt(world->GetRandom().MaxSeed()));
+  m_job_seed_rng = new Apto::RNG::AvidaRNG(seed);
   
   if (m_workers.GetSize() > 1) {
     for (int i = 0; i < m_workers.GetSize(); i++) {
@@ -83,25 +94,33 @@ cAnalyzeJobQueue::~cAnalyzeJobQueue()
 
 inline void cAnalyzeJobQueue::queueJob(cAnalyzeJob* job)
 {
-  if (m_workers.GetSize()) m_queue.PushRear(job);
-  else singleThreadedJobExecution(job);
+  m_mutex.Lock();
+  job->SetID(m_last_jobid++);
+  m_queue.PushRear(job);
+  m_jobs++;
+  m_mutex.Unlock();
 }
 
 void cAnalyzeJobQueue::AddJob(cAnalyzeJob* job)
 {
-  Apto::MutexAutoLock lock(m_mutex);
-  job->SetID(m_last_jobid++);
+  // Without workers the job runs right away; it is never counted in m_jobs, so Execute has nothing to wait for,
+  // and it runs outside the lock since GetSeedForJob takes it
+  if (!m_workers.GetSize()) {
+    job->SetID(m_last_jobid++);
+    singleThreadedJobExecution(job);
+    return;
+  }
   queueJob(job);
-  m_jobs++;
 }
 
 void cAnalyzeJobQueue::AddJobImmediate(cAnalyzeJob* job)
 {
-  m_mutex.Lock();
-  job->SetID(m_last_jobid++);
-  queueJob(job);
-  m_jobs++;
-  m_mutex.Unlock(); // should unlock prior to signaling condition variable
+  if (!m_workers.GetSize()) {
+    job->SetID(m_last_jobid++);
+    singleThreadedJobExecution(job);
+    return;
+  }
+  queueJob(job); // unlocks prior to signaling condition variable
   m_cond.Signal();
 }
 
@@ -58,6 +58,7 @@ private:
   Apto::Array<cAnalyzeJobWorker*> m_workers;
 
 
+  void setup(int seed);
   void singleThreadedJobExecution(cAnalyzeJob* job);
   inline void queueJob(cAnalyzeJob* job);
 
@@ -69,6 +70,7 @@ private:
 
 public:
   cAnalyzeJobQueue(cWorld* world);
+  cAnalyzeJobQueue(cWorld* world, int seed); // job seeds drawn from seed, leaving the world RNG untouched
   ~cAnalyzeJobQueue();
 
   void AddJob(cAnalyzeJob* job);
@@ -0,0 +1,137 @@
+/*
+ *  cAnalyzeTreeIndex.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cAnalyzeTreeIndex.h"
+
+#include "cAnalyzeGenotype.h"
+
+
+cAnalyzeTreeIndex::cAnalyzeTreeIndex(tList<cAnalyzeGenotype>& genotype_list) : m_missing_parents(0)
+{
+  const int num_nodes = genotype_list.GetSize();
+  m_genotypes.Resize(num_nodes);
+
+  tListIterator<cAnalyzeGenotype> batch_it(genotype_list);
+  cAnalyzeGenotype* genotype = NULL;
+  int pos = 0;
+  while ((genotype = batch_it.Next()) != NULL) {
+    m_genotypes[pos] = genotype;
+    m_id_pos.Set(genotype->GetID(), pos);
+    pos++;
+  }
+
+  // Link parents, counting the children of each node so that the child lists can be laid out contiguously
+  m_parent.Resize(num_nodes);
+  m_child_start.Resize(num_nodes + 1);
+  m_child_start.SetAll(0);
+  for (int i = 0; i < num_nodes; i++) {
+    m_parent[i] = -1;
+    const int parent_id = m_genotypes[i]->GetParentID();
+    if (parent_id == -1) {
+      m_roots.Push(i);
+    } else if (m_id_pos.Get(parent_id, m_parent[i])) {
+      m_child_start[m_parent[i] + 1]++;
+    } else {
+      m_parent[i] = -1;
+      m_roots.Push(i);
+      m_missing_parents++;
+    }
+  }
+  for (int i = 0; i < num_nodes; i++) m_child_start[i + 1] += m_child_start[i];
+
+  m_children.Resize(m_child_start[num_nodes]);
+  Apto::Array<int> fill(num_nodes);
+  for (int i = 0; i < num_nodes; i++) fill[i] = m_child_start[i];
+  for (int i = 0; i < num_nodes; i++) {
+    if (m_parent[i] != -1) m_children[fill[m_parent[i]]++] = i;
+  }
+
+  // Preorder walk from each root, visiting children in batch order
+  m_enter.Resize(num_nodes);
+  m_enter.SetAll(-1);
+  m_exit.Resize(num_nodes);
+  m_exit.SetAll(-1);
+  Apto::Array<int> stack;
+  for (int r = 0; r < m_roots.GetSize(); r++) {
+    stack.Push(m_roots[r]);
+    while (stack.GetSize()) {
+      const int node = stack.Pop();
+      m_enter[node] = m_preorder.GetSize();
+      m_preorder.Push(node);
+      for (int c = m_child_start[node + 1] - 1; c >= m_child_start[node]; c--) stack.Push(m_children[c]);
+    }
+  }
+
+  // Clade ranges, children finish before their parents in reverse preorder
+  for (int rank = m_preorder.GetSize() - 1; rank >= 0; rank--) {
+    const int node = m_preorder[rank];
+    int exit = rank + 1;
+    for (int c = m_child_start[node]; c < m_child_start[node + 1]; c++) {
+      if (m_exit[m_children[c]] > exit) exit = m_exit[m_children[c]];
+    }
+    m_exit[node] = exit;
+  }
+}
+
+
+int cAnalyzeTreeIndex::GetPosition(int id) const
+{
+  int pos = -1;
+  if (!m_id_pos.Get(id, pos)) return -1;
+  return pos;
+}
+
+
+void cAnalyzeTreeIndex::CalcAncestorBranches(Apto::Array<int>& out_dist, Apto::Array<int>& out_branch_pos) const
+{
+  const int num_nodes = m_genotypes.GetSize();
+  out_dist.Resize(num_nodes);
+  out_dist.SetAll(-1);
+  out_branch_pos.Resize(num_nodes);
+  out_branch_pos.SetAll(-1);
+
+  // Parents precede their children in preorder, so each node can build on its parent's values
+  for (int rank = 0; rank < m_preorder.GetSize(); rank++) {
+    const int node = m_preorder[rank];
+    const int parent = m_parent[node];
+    if (parent == -1) {
+      out_dist[node] = 0;
+    } else if (GetNumChildren(parent) > 1) {
+      out_dist[node] = 1;
+      out_branch_pos[node] = parent;
+    } else {
+      out_dist[node] = out_dist[parent] + 1;
+      out_branch_pos[node] = out_branch_pos[parent];
+    }
+  }
+}
+
+
+void cAnalyzeTreeIndex::CalcCladeLeafCounts(Apto::Array<int>& out_leaves) const
+{
+  out_leaves.Resize(m_genotypes.GetSize());
+  out_leaves.SetAll(0);
+
+  for (int rank = m_preorder.GetSize() - 1; rank >= 0; rank--) {
+    const int node = m_preorder[rank];
+    if (GetNumChildren(node) == 0) out_leaves[node] = 1;
+    if (m_parent[node] != -1) out_leaves[m_parent[node]] += out_leaves[node];
+  }
+}
@@ -0,0 +1,87 @@
+/*
+ *  cAnalyzeTreeIndex.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cAnalyzeTreeIndex_h
+#define cAnalyzeTreeIndex_h
+
+#include "avida/core/Types.h"
+#include "tList.h"
+
+class cAnalyzeGenotype;
+
+
+// Parent/child structure of a batch of genotypes, built once so that tree statistics can be computed with linear
+// passes instead of repeated scans of the batch.  Nodes are identified by their position in the batch.  Children are
+// kept in batch order, and the preorder walk (parents before children) assigns each node the range of ranks
+// [GetEnter(), GetExit()) covered by its clade.
+//
+// Genotypes whose parent is not in the batch are counted as missing parents and treated as roots.  Nodes that can
+// not be reached from any root (parent cycles) are left out of the preorder and have an empty range at -1.
+class cAnalyzeTreeIndex
+{
+private:
+  Apto::Array<cAnalyzeGenotype*> m_genotypes;
+  Apto::Map<int, int> m_id_pos;
+  Apto::Array<int> m_parent;        // batch position of each node's parent, -1 for roots
+  Apto::Array<int> m_child_start;   // children of node i are m_children[m_child_start[i] .. m_child_start[i + 1])
+  Apto::Array<int> m_children;
+  Apto::Array<int> m_roots;
+  Apto::Array<int> m_preorder;
+  Apto::Array<int> m_enter;
+  Apto::Array<int> m_exit;
+  int m_missing_parents;
+
+
+  cAnalyzeTreeIndex(); // @not_implemented
+  cAnalyzeTreeIndex(const cAnalyzeTreeIndex&); // @not_implemented
+  cAnalyzeTreeIndex& operator=(const cAnalyzeTreeIndex&); // @not_implemented
+
+public:
+  explicit cAnalyzeTreeIndex(tList<cAnalyzeGenotype>& genotype_list);
+
+  int GetSize() const { return m_genotypes.GetSize(); }
+  cAnalyzeGenotype* GetGenotype(int pos) const { return m_genotypes[pos]; }
+  int GetPosition(int id) const;
+
+  int GetParent(int pos) const { return m_parent[pos]; }
+  int GetNumChildren(int pos) const { return m_child_start[pos + 1] - m_child_start[pos]; }
+  int GetChild(int pos, int idx) const { return m_children[m_child_start[pos] + idx]; }
+  const Apto::Array<int>& GetRoots() const { return m_roots; }
+  int GetNumMissingParents() const { return m_missing_parents; }
+
+  // Preorder walk over the reachable nodes
+  int GetNumReachable() const { return m_preorder.GetSize(); }
+  int GetPreorder(int rank) const { return m_preorder[rank]; }
+  int GetEnter(int pos) const { return m_enter[pos]; }
+  int GetExit(int pos) const { return m_exit[pos]; }
+  int GetCladeSize(int pos) const { return m_exit[pos] - m_enter[pos]; }
+  bool IsInClade(int clade_root, int pos) const
+    { return m_enter[pos] >= m_enter[clade_root] && m_enter[pos] < m_exit[clade_root] && m_enter[pos] >= 0; }
+
+  // Distance from each node back to its closest ancestor with more than one child (the branch point), and the batch
+  // position of that ancestor.  Roots are at distance 0, nodes with no branching ancestor report -1 as their branch
+  // point.  Unreachable nodes are left at -1.
+  void CalcAncestorBranches(Apto::Array<int>& out_dist, Apto::Array<int>& out_branch_pos) const;
+
+  // Number of leaves in each node's clade, counting the node itself if it is a leaf.
+  void CalcCladeLeafCounts(Apto::Array<int>& out_leaves) const;
+};
+
+#endif
@@ -21,6 +21,7 @@
 #include "cAnalyzeTreeStats_CumulativeStemminess.h"
 
 #include "cAnalyzeGenotype.h"
+#include "cAnalyzeTreeIndex.h"
 #include "cWorld.h"
 
 
@@ -75,147 +76,54 @@ void cAnalyzeTreeStats_CumulativeStemminess::PrintAGLData(Apto::Array<cAGLData>
 }
 
 void cAnalyzeTreeStats_CumulativeStemminess::AnalyzeBatchTree(tList<cAnalyzeGenotype> &genotype_list){
-  cAnalyzeGenotype * genotype = NULL;
-  tListIterator<cAnalyzeGenotype> batch_it(genotype_list);
-  const int num_gens = genotype_list.GetSize();
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
-    cout << "Number of genotypes: " << num_gens << endl;
-  }
-
-
-  int array_pos = 0;
-
-  /*
-  Put all of the genotypes in an array for easy reference and collect other
-  information on them as we process them. {{{4
-  */
-  if (m_world->GetVerbosity() >= VERBOSE_ON) {
-    cout << "Scanning genotypes..." << endl;
-  }
-  Apto::Array<cAnalyzeGenotype *> gen_array(num_gens);
-  Apto::Map<int, int> id_hash;  // Store array pos for each id.
-  Apto::Array<int> id_array(num_gens), pid_array(num_gens);
-  Apto::Array<int> depth_array(num_gens), birth_array(num_gens);
-
-  array_pos = 0;
-  batch_it.Reset();
-  while ((genotype = batch_it.Next()) != NULL) {
-    id_hash.Set(genotype->GetID(), array_pos);
-    array_pos++;
-  }
-
-  m_agl.Resize(num_gens);
-  array_pos = 0;
-  batch_it.Reset();
-  while ((genotype = batch_it.Next()) != NULL) {
-    // Put the genotype in an array.
-    m_agl[array_pos].genotype = genotype;
-    m_agl[array_pos].id = genotype->GetID();
-    m_agl[array_pos].pid = genotype->GetParentID();
-    m_agl[array_pos].depth = genotype->GetDepth();
-    m_agl[array_pos].birth = genotype->GetUpdateBorn();
-    array_pos++;
+    cout << "Number of genotypes: " << genotype_list.GetSize() << endl;
+    cout << "Assembling tree..." << endl;
   }
+  cAnalyzeTreeIndex tree(genotype_list);
+  AnalyzeBatchTree(tree);
+}
 
-  //// Now collect information about the offspring of each individual. {{{4
-  Apto::Array<int> ppos_array(num_gens), offspring_count(num_gens);
-  offspring_count.SetAll(0);
-
-  // For each genotype, figure out how far back you need to go to get to a branch point. {{{4
-  Apto::Array<int> anc_branch_dist_array(num_gens);
-  Apto::Array<int> anc_branch_pos_array(num_gens);
-  anc_branch_dist_array.SetAll(-1);
-  anc_branch_pos_array.SetAll(-1);
-  bool found = true;
-  int loop_count = 0;
+void cAnalyzeTreeStats_CumulativeStemminess::AnalyzeBatchTree(const cAnalyzeTreeIndex &tree){
+  const int num_gens = tree.GetSize();
 
-  /*
-  Link each offspring to its parent. {{{4
-  */
-  if (m_world->GetVerbosity() >= VERBOSE_ON) {
-    cout << "Assembling tree..." << endl;
-  }
-  for (int pos = 0; pos < num_gens; pos++) {
-    //cAnalyzeGenotype * genotype = gen_array[pos];
-    cAnalyzeGenotype * genotype = m_agl[pos].genotype;
-    int parent_id = genotype->GetParentID();
-    if (-1 != parent_id){
-      bool found_parent = id_hash.Get(parent_id, m_agl[pos].ppos);
-      if (found_parent){
-        int parent_position = m_agl[pos].ppos;
-        m_agl[parent_position].offspring_positions.Push(pos);
-        ///* XXX I think I'll be able to remove this. */
-        //cAnalyzeGenotype * parent_genotype = m_agl[parent_position].genotype;
-        //genotype->LinkParent(parent_genotype);
-      } else {
-        if (m_world->GetVerbosity() >= VERBOSE_ON) {
-          cerr << "Error: the parent of a non-root tree node is missing - " << endl;
-        }
-        return;
-      }
+  if (tree.GetNumMissingParents() > 0) {
+    if (m_world->GetVerbosity() >= VERBOSE_ON) {
+      cerr << "Error: the parent of a non-root tree node is missing - " << endl;
     }
+    return;
   }
 
   /*
-  Count offspring of each parent. {{{4
+  Put all of the genotypes in an array for easy reference, along with their
+  links into the tree. {{{4
   */
-  if (m_world->GetVerbosity() >= VERBOSE_ON) {
-    cout << "Loading offspring counts..." << endl;
-  }
+  m_agl.Resize(num_gens);
   for (int pos = 0; pos < num_gens; pos++) {
-    m_agl[pos].offspring_count = m_agl[pos].offspring_positions.GetSize();
+    cAnalyzeGenotype * genotype = tree.GetGenotype(pos);
+    m_agl[pos].genotype = genotype;
+    m_agl[pos].id = genotype->GetID();
+    m_agl[pos].pid = genotype->GetParentID();
+    m_agl[pos].depth = genotype->GetDepth();
+    m_agl[pos].birth = genotype->GetUpdateBorn();
+    m_agl[pos].ppos = tree.GetParent(pos);
+    m_agl[pos].offspring_count = tree.GetNumChildren(pos);
+    m_agl[pos].offspring_positions.Resize(m_agl[pos].offspring_count);
+    for (int i = 0; i < m_agl[pos].offspring_count; i++) m_agl[pos].offspring_positions[i] = tree.GetChild(pos, i);
   }
 
-
   /*
   For each genotype, figure out how far back you need to go to get to a branch point. {{{4
   */
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
     cout << "Finding branch points..." << endl;
   }
-  found = true;
-  loop_count = 0;
-  while (found == true) {
-    if (false && m_world->GetVerbosity() >= VERBOSE_ON) {
-      cout << endl << "  wave " << loop_count << "...";
-    }
-    found = false;
-
-    int genotypes_already_set = 0;
-    int genotypes_identified_as_root = 0;
-    int genotypes_with_branching_parent = 0;
-    int genotypes_with_calced_parent = 0;
-    int genotypes_not_ready = 0;
-
-    for (int pos = 0; pos < num_gens; pos++) {
-      if (m_agl[pos].anc_branch_dist > -1){
-        genotypes_already_set++;
-        continue; // continue if its set.
-      }
-      found = true;
-      int parent_pos = m_agl[pos].ppos;
-      if (parent_pos == -1) {
-        genotypes_identified_as_root++;
-        m_agl[pos].anc_branch_dist = 0;  // Org is root.
-      } else if (m_agl[parent_pos].offspring_count > 1) {        // Parent is branch.
-        genotypes_with_branching_parent++;
-        m_agl[pos].anc_branch_dist = 1;
-        m_agl[pos].anc_branch_id = m_agl[parent_pos].id;
-        m_agl[pos].anc_branch_pos = parent_pos;
-      } else if (m_agl[parent_pos].anc_branch_dist > -1) {     // Parent calculated.
-        genotypes_with_calced_parent++;
-        m_agl[pos].anc_branch_dist = m_agl[parent_pos].anc_branch_dist + 1;
-        m_agl[pos].anc_branch_id = m_agl[parent_pos].anc_branch_id;
-        m_agl[pos].anc_branch_pos = m_agl[parent_pos].anc_branch_pos;
-      } else {
-        genotypes_not_ready++;
-        // Otherwise, we are not yet ready to calculate this entry.
-      }
-    }
-    if (false && m_world->GetVerbosity() >= VERBOSE_ON) {
-      cout << " (" << genotypes_already_set << "," << genotypes_identified_as_root << "," << genotypes_with_branching_parent << "," << genotypes_with_calced_parent << "," << genotypes_not_ready << ")" << endl;
-    }
-    loop_count++;
+  Apto::Array<int> anc_branch_dist_array, anc_branch_pos_array;
+  tree.CalcAncestorBranches(anc_branch_dist_array, anc_branch_pos_array);
+  for (int pos = 0; pos < num_gens; pos++) {
+    m_agl[pos].anc_branch_dist = anc_branch_dist_array[pos];
+    m_agl[pos].anc_branch_pos = anc_branch_pos_array[pos];
+    if (anc_branch_pos_array[pos] != -1) m_agl[pos].anc_branch_id = m_agl[anc_branch_pos_array[pos]].id;
   }
 
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
@@ -240,9 +148,10 @@ void cAnalyzeTreeStats_CumulativeStemminess::AnalyzeBatchTree(tList<cAnalyzeGeno
   }
 
   m_agl2.Resize(branch_tree_size);  // Store agl data for each id.
-  Apto::Map<int, int> id_hash_2;
+  Apto::Array<int> branch_pos_2(num_gens);  // Position in m_agl2 of each branching genotype, -1 otherwise
+  branch_pos_2.SetAll(-1);
   int array_pos_2 = 0;
-  if (true) for (int pos = 0; pos < num_gens; pos++) {
+  for (int pos = 0; pos < num_gens; pos++) {
     int offs_count = m_agl[pos].offspring_count;
     //if (offs_count != 1){
     if (offs_count > 1){
@@ -257,19 +166,18 @@ void cAnalyzeTreeStats_CumulativeStemminess::AnalyzeBatchTree(tList<cAnalyzeGeno
       anc_branch_pos, off_branch_dist_acc (to be calculated),
       offspring_positions
       */
-      id_hash_2.Set(m_agl2[array_pos_2].id, array_pos_2);
+      branch_pos_2[pos] = array_pos_2;
       array_pos_2++;
     }
   }
 
   // find branch ancestor positions. {{{4
-  for (int pos = 0; pos < branch_tree_size; pos++){
-    int anc_branch_id = m_agl2[pos].anc_branch_id;
-    id_hash_2.Get(anc_branch_id, m_agl2[pos].anc_branch_pos);
-    int anc_branch_pos = m_agl2[pos].anc_branch_pos;
-    if(0 <= anc_branch_pos){
-      m_agl2[anc_branch_pos].offspring_positions.Push(pos);
-    }
+  for (int pos = 0; pos < num_gens; pos++){
+    int pos_2 = branch_pos_2[pos];
+    if (pos_2 < 0 || m_agl[pos].anc_branch_pos < 0) continue;
+    int anc_branch_pos = branch_pos_2[m_agl[pos].anc_branch_pos];
+    m_agl2[pos_2].anc_branch_pos = anc_branch_pos;
+    m_agl2[anc_branch_pos].offspring_positions.Push(pos_2);
   }
   
   /*
@@ -312,51 +220,40 @@ void cAnalyzeTreeStats_CumulativeStemminess::AnalyzeBatchTree(tList<cAnalyzeGeno
   }
 
   /*
-  DFS of branch tree, to accumulate branch distances. {{{4
+  Accumulate branch distances over the clade of the root. {{{4
+  Branch points below the root are met in reverse preorder, so each one is
+  complete before it is added to its ancestor branch point.
   */
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
     cout << "Accumulating branch distances..." << endl;
   }
-  tList<cAGLData> dfs_stack;
-  if(0 != root){
-    /* DFS. */
-    dfs_stack.Push(root);
-    cAGLData *node = 0;
-    while (0 < dfs_stack.GetSize()){
-      node = dfs_stack.Pop();
-      if (0 != node){
-        if (! node->traversal_visited){
-          dfs_stack.Push(node);
-          node->off_branch_dist_acc = 0;
-          for (int i = 0; i < node->offspring_positions.GetSize(); i++){
-            int pos = node->offspring_positions[i];
-            if (! m_agl2[pos].traversal_visited){
-              dfs_stack.Push(&(m_agl2[pos]));
-            }
-          }
-          node->traversal_visited = true;
-        } else {
-          /*
-          Child nodes, if any, have been visited and have added their
-          off_branch_dist_acc to this node.
-          */
-          if(0 <= node->anc_branch_pos){
-            /*
-            Only accumulate to parent if there is a parent (i.e., this
-            is not the root.)
-            */
-            m_agl2[node->anc_branch_pos].off_branch_dist_acc += node->anc_branch_dist;
-            m_agl2[node->anc_branch_pos].off_branch_dist_acc += node->off_branch_dist_acc;
-          }
-        }
-      }
-    }
-  } else {
+  if (0 == root){
     if (m_world->GetVerbosity() >= VERBOSE_ON) {
       cerr << "Error: couldn't find root of subtree - " << endl;
     }
     return;
   }
+  const int root_pos = tree.GetPosition(root->id);
+  for (int rank = tree.GetEnter(root_pos); rank < tree.GetExit(root_pos); rank++) {
+    const int pos_2 = branch_pos_2[tree.GetPreorder(rank)];
+    if (pos_2 >= 0) {
+      m_agl2[pos_2].off_branch_dist_acc = 0;
+      m_agl2[pos_2].traversal_visited = true;
+    }
+  }
+  for (int rank = tree.GetExit(root_pos) - 1; rank >= tree.GetEnter(root_pos); rank--) {
+    const int pos_2 = branch_pos_2[tree.GetPreorder(rank)];
+    if (pos_2 < 0) continue;
+    cAGLData *node = &(m_agl2[pos_2]);
+    if(0 <= node->anc_branch_pos){
+      /*
+      Only accumulate to parent if there is a parent (i.e., this
+      is not the root.)
+      */
+      m_agl2[node->anc_branch_pos].off_branch_dist_acc += node->anc_branch_dist;
+      m_agl2[node->anc_branch_pos].off_branch_dist_acc += node->off_branch_dist_acc;
+    }
+  }
 
   /*
   Compute cumulative stemminesses. {{{4
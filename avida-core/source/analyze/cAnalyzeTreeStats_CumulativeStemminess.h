@@ -25,6 +25,7 @@
 #include "tList.h"
 
 class cAnalyzeGenotype;
+class cAnalyzeTreeIndex;
 class cWorld;
 
 
@@ -88,6 +89,7 @@ public:
 
   // Commands.
   void AnalyzeBatchTree(tList<cAnalyzeGenotype> &genotype_list);
+  void AnalyzeBatchTree(const cAnalyzeTreeIndex &tree);
 };
 
 #endif
@@ -22,6 +22,7 @@
 
 #include "cAnalyze.h"
 #include "cAnalyzeGenotype.h"
+#include "cAnalyzeTreeIndex.h"
 #include "cWorld.h"
 
 #include <math.h>
@@ -100,53 +101,8 @@ cAnalyzeTreeStats_Gamma::cAnalyzeTreeStats_Gamma(cWorld* world)
 {
 }
 
-void cAnalyzeTreeStats_Gamma::LoadGenotypes(tList<cAnalyzeGenotype> &genotype_list){
-  cAnalyzeGenotype * genotype = NULL;
-  tListIterator<cAnalyzeGenotype> batch_it(genotype_list);
-  
-  m_gen_array.Resize(genotype_list.GetSize());
-  int array_pos = 0;
-  batch_it.Reset();
-  while ((genotype = batch_it.Next()) != NULL) {
-    m_gen_array[array_pos] = genotype;
-    array_pos++;
-  }
-}
-
-void cAnalyzeTreeStats_Gamma::MapIDToGenotypePos(Apto::Array<cAnalyzeGenotype*>& lineage, Apto::Map<int, int>& out_mapping)
-{
-  out_mapping.Clear();
-  for (int i = 0; i < lineage.GetSize(); i++) {
-    out_mapping.Set(lineage[i]->GetID(), i);
-  }
-}
-
-void cAnalyzeTreeStats_Gamma::Unlink(Apto::Array<cAnalyzeGenotype *>& lineage)
-{
-  for(int i = 0; i < lineage.GetSize(); i++){
-    lineage[i]->Unlink();
-  }
-}
-
-void cAnalyzeTreeStats_Gamma::EstablishLinks(Apto::Array<cAnalyzeGenotype*>& lineage, Apto::Map<int, int>& out_mapping)
-{
-  this->Unlink(lineage);
-  this->MapIDToGenotypePos(lineage, out_mapping);
-
-  int parent_id(-1);
-  int parent_index(-1);
-
-  for (int i = 0; i < lineage.GetSize(); i++) {
-    parent_id = lineage[i]->GetParentID();
-    if (parent_id >= 0) {
-      out_mapping.Get(parent_id, parent_index);
-      lineage[parent_index]->LinkChild(*lineage[i]);
-    }
-  }
-}
-
 void cAnalyzeTreeStats_Gamma::FindFurcations(
-  Apto::Array<cAnalyzeGenotype *> &lineage,
+  const cAnalyzeTreeIndex &tree,
   Apto::Array<cAnalyzeLineageFurcation> &out_furcations
 ){
   cAnalyzeGenotype *parent(0);
@@ -154,16 +110,16 @@ void cAnalyzeTreeStats_Gamma::FindFurcations(
   int child_list_size(0);
 
   out_furcations.Resize(0);
-  for(int i = 0; i < lineage.GetSize(); i++){
-    parent = lineage[i];
+  for(int i = 0; i < tree.GetSize(); i++){
+    parent = tree.GetGenotype(i);
 
-    child_list_size = parent->GetChildList().GetSize();
+    child_list_size = tree.GetNumChildren(i);
     if(child_list_size > 1){
       for(int j = 1; j < child_list_size; j++){
         furcation = cAnalyzeLineageFurcation(
           parent,
-          parent->GetChildList().GetPos(j-1),
-          parent->GetChildList().GetPos(j)
+          tree.GetGenotype(tree.GetChild(i, j-1)),
+          tree.GetGenotype(tree.GetChild(i, j))
         );
         out_furcations.Push(furcation);
         if (m_world->GetVerbosity() >= VERBOSE_DETAILS){
@@ -178,7 +134,7 @@ void cAnalyzeTreeStats_Gamma::FindFurcations(
 }
 
 void cAnalyzeTreeStats_Gamma::FindFurcationTimes(
-  Apto::Array<cAnalyzeGenotype *> &lineage,
+  const cAnalyzeTreeIndex &tree,
   int (*furcation_time_policy)(cAnalyzeLineageFurcation &furcation),
   Apto::Array<int> &out_furcation_times
 ){
@@ -188,7 +144,7 @@ void cAnalyzeTreeStats_Gamma::FindFurcationTimes(
     int FurcationTimePolicy_FirstChildBirth(cAnalyzeLineageFurcation &furcation);
     int FurcationTimePolicy_SecondChildBirth(cAnalyzeLineageFurcation &furcation);
   */
-  FindFurcations(lineage, m_furcations);
+  FindFurcations(tree, m_furcations);
 
   int size = m_furcations.GetSize();
   out_furcation_times.Resize(size, 0);
@@ -304,8 +260,12 @@ double cAnalyzeTreeStats_Gamma::Gamma(void){
 // Commands.
 void cAnalyzeTreeStats_Gamma::AnalyzeBatch(tList<cAnalyzeGenotype> &genotype_list, int end_time, int furcation_time_convention)
 {
-  Apto::Map<int, int> mapping;
+  cAnalyzeTreeIndex tree(genotype_list);
+  AnalyzeBatch(tree, end_time, furcation_time_convention);
+}
 
+void cAnalyzeTreeStats_Gamma::AnalyzeBatch(const cAnalyzeTreeIndex &tree, int end_time, int furcation_time_convention)
+{
   int (*furcation_time_policy)(cAnalyzeLineageFurcation &furcation);
   furcation_time_policy = 0;
   if (furcation_time_convention == 1){
@@ -328,9 +288,7 @@ void cAnalyzeTreeStats_Gamma::AnalyzeBatch(tList<cAnalyzeGenotype> &genotype_lis
   }
 
 
-  LoadGenotypes(genotype_list);
-  EstablishLinks(m_gen_array, mapping);
-  FindFurcationTimes(m_gen_array, furcation_time_policy, m_furcation_times);
+  FindFurcationTimes(tree, furcation_time_policy, m_furcation_times);
 
   if (end_time < m_furcation_times[m_furcation_times.GetSize() - 1]){
     /* Bad furcation time convention specified. */
@@ -26,6 +26,7 @@
 #include "tList.h"
 
 class cAnalyzeGenotype;
+class cAnalyzeTreeIndex;
 class cWorld;
 
 // Comparison functions for qsort.
@@ -57,7 +58,6 @@ public:
 class cAnalyzeTreeStats_Gamma {
 public:
   cWorld* m_world;
-  Apto::Array<cAnalyzeGenotype *> m_gen_array;
   Apto::Array<cAnalyzeLineageFurcation> m_furcations;
   Apto::Array<int> m_furcation_times;
   Apto::Array<int> m_internode_distances;
@@ -65,16 +65,12 @@ public:
 public:
   cAnalyzeTreeStats_Gamma(cWorld* world);
   
-  void LoadGenotypes(tList<cAnalyzeGenotype> &genotype_list);
-  void MapIDToGenotypePos(Apto::Array<cAnalyzeGenotype *>&lineage, Apto::Map<int, int>& out_mapping);
-  void Unlink(Apto::Array<cAnalyzeGenotype *>& lineage);
-  void EstablishLinks(Apto::Array<cAnalyzeGenotype *>& lineage, Apto::Map<int, int>& out_mapping);
   void FindFurcations(
-    Apto::Array<cAnalyzeGenotype *> &lineage,
+    const cAnalyzeTreeIndex &tree,
     Apto::Array<cAnalyzeLineageFurcation> &out_furcations
   );
   void FindFurcationTimes(
-    Apto::Array<cAnalyzeGenotype *> &lineage,
+    const cAnalyzeTreeIndex &tree,
     int (*furcation_time_policy)(cAnalyzeLineageFurcation &furcation),
     Apto::Array<int> &out_furcation_times
   );
@@ -96,6 +92,11 @@ public:
     int end_time,
     int furcation_time_convention
   );    
+  void AnalyzeBatch(
+    const cAnalyzeTreeIndex &tree,
+    int end_time,
+    int furcation_time_convention
+  );
 };
   
 int FurcationTimePolicy_ParentBirth(cAnalyzeLineageFurcation &furcation);
@@ -0,0 +1,310 @@
+/*
+ *  cGenotypeFileLoader.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cGenotypeFileLoader.h"
+
+#include "apto/core/FileSystem.h"
+#include "apto/platform.h"
+
+#include "cAnalyzeGenotype.h"
+#include "cAnalyzeJobQueue.h"
+#include "cStringUtil.h"
+#include "cWorld.h"
+#include "tAnalyzeJobBatch.h"
+#include "tDataEntryCommand.h"
+
+#include <cstring>
+#include <fstream>
+
+#if !APTO_PLATFORM(WINDOWS)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+
+static inline bool isWhitespace(char c) { return (c == ' ' || c == '\t' || c == '\r' || c == '\n'); }
+
+// Directives that change how cInitFile assembles lines, files using them are left to the serial reader.  #filetype
+// and #format are only understood in the header, a repeat further down also goes to the serial reader.
+static bool isInitFileDirective(const char* word, int len)
+{
+  return ((len == 8 && strncmp(word, "#include", 8) == 0) || (len == 7 && strncmp(word, "#import", 7) == 0) ||
+          (len == 7 && strncmp(word, "#define", 7) == 0) || (len == 9 && strncmp(word, "#filetype", 9) == 0) ||
+          (len == 7 && strncmp(word, "#format", 7) == 0));
+}
+
+
+// One chunk of data lines, parsed by an analyze job into its own genotype array
+class cGenotypeFileChunk
+{
+private:
+  cWorld* m_world;
+  const char* m_begin;
+  const char* m_end;
+  const Apto::Array<tDataEntryCommand<cAnalyzeGenotype>*>& m_columns;
+  const Apto::Array<bool>& m_sequence_columns;
+  Genome m_default_genome;    // private copy, genomes are not safe to copy from several threads at once
+  bool m_id_names;
+
+  Apto::Array<cAnalyzeGenotype*> m_genotypes;
+  int m_num_genotypes;
+  bool m_needs_init_file;
+
+public:
+  cGenotypeFileChunk(cWorld* world, const char* begin, const char* end,
+                     const Apto::Array<tDataEntryCommand<cAnalyzeGenotype>*>& columns,
+                     const Apto::Array<bool>& sequence_columns, const Genome& default_genome, bool id_names)
+    : m_world(world), m_begin(begin), m_end(end), m_columns(columns), m_sequence_columns(sequence_columns)
+    , m_default_genome(default_genome), m_id_names(id_names), m_num_genotypes(0), m_needs_init_file(false) { ; }
+  ~cGenotypeFileChunk() { for (int i = 0; i < m_num_genotypes; i++) delete m_genotypes[i]; }
+
+  void Parse(cAvidaContext& ctx);
+
+  bool NeedsInitFile() const { return m_needs_init_file; }
+  int GetNumGenotypes() const { return m_num_genotypes; }
+
+  // Hands the genotypes over to the caller, the chunk no longer owns them
+  cAnalyzeGenotype* ReleaseGenotype(int idx)
+  {
+    cAnalyzeGenotype* genotype = m_genotypes[idx];
+    m_genotypes[idx] = NULL;
+    return genotype;
+  }
+};
+
+
+void cGenotypeFileChunk::Parse(cAvidaContext&)
+{
+  // Size the genotype array for the worst case of every line holding a genotype
+  int max_lines = 1;
+  for (const char* p = m_begin; (p = (const char*)memchr(p, '\n', m_end - p)) != NULL; p++) max_lines++;
+  m_genotypes.Resize(max_lines);
+
+  const int num_columns = m_columns.GetSize();
+  Apto::Array<const char*> tokens(num_columns);
+  Apto::Array<int> token_sizes(num_columns);
+
+  const char* line = m_begin;
+  while (line < m_end) {
+    const char* eol = (const char*)memchr(line, '\n', m_end - line);
+    if (eol == NULL) eol = m_end;
+    const char* next_line = eol + 1;
+
+    // Lines are cut at an embedded NUL, as cFile::ReadLine does
+    if (*line == '#') {
+      const char* word_end = line;
+      while (word_end < eol && *word_end != '\0' && !isWhitespace(*word_end)) word_end++;
+      if (isInitFileDirective(line, (int)(word_end - line))) {
+        m_needs_init_file = true;
+        return;
+      }
+      line = next_line;
+      continue;
+    }
+
+    // Split the line into words, stopping at a comment mark
+    int num_tokens = 0;
+    char last_char = '\0';
+    const char* p = line;
+    while (p < eol && *p != '#' && *p != '\0') {
+      if (isWhitespace(*p)) { p++; continue; }
+      const char* word = p;
+      while (p < eol && *p != '#' && *p != '\0' && !isWhitespace(*p)) p++;
+      if (num_tokens < num_columns) {
+        tokens[num_tokens] = word;
+        token_sizes[num_tokens] = (int)(p - word);
+      }
+      num_tokens++;
+      last_char = p[-1];
+    }
+
+    if (num_tokens == 0) {
+      line = next_line;
+      continue;
+    }
+    if (last_char == '\\') {
+      m_needs_init_file = true;
+      return;
+    }
+
+    cAnalyzeGenotype* genotype = new cAnalyzeGenotype(m_world, m_default_genome);
+    for (int i = 0; i < num_columns; i++) {
+      const char* token = (i < num_tokens) ? tokens[i] : "";
+      const int token_size = (i < num_tokens) ? token_sizes[i] : 0;
+      if (m_sequence_columns[i]) genotype->DecodeSequence(token, token_size);
+      else m_columns[i]->SetValue(genotype, cString(token, token_size));
+    }
+    if (m_id_names) genotype->SetName(cStringUtil::Stringf("org-%d", genotype->GetID()));
+
+    m_genotypes[m_num_genotypes++] = genotype;
+    line = next_line;
+  }
+}
+
+
+
+cGenotypeFileLoader::cGenotypeFileLoader(cWorld* world, const cString& filename)
+  : m_world(world)
+  , m_path(Apto::FileSystem::GetAbsolutePath(Apto::String(filename), Apto::String(world->GetWorkingDir())))
+  , m_data(NULL), m_size(0), m_data_start(0), m_mapped(false), m_filetype("unknown")
+{
+}
+
+cGenotypeFileLoader::~cGenotypeFileLoader()
+{
+  close();
+}
+
+
+bool cGenotypeFileLoader::Open()
+{
+  close();
+
+#if APTO_PLATFORM(WINDOWS)
+  std::ifstream fp((const char*)m_path, std::ios::in | std::ios::binary);
+  if (!fp.good()) return false;
+  fp.seekg(0, std::ios::end);
+  m_size = (size_t)fp.tellg();
+  fp.seekg(0, std::ios::beg);
+  if (m_size) {
+    char* buf = new char[m_size];
+    fp.read(buf, m_size);
+    m_data = buf;
+    if ((size_t)fp.gcount() != m_size) { close(); return false; }
+  }
+#else
+  int fd = open(m_path, O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    ::close(fd);
+    return false;
+  }
+  m_size = (size_t)st.st_size;
+  if (m_size) {
+    void* map = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+      ::close(fd);
+      m_size = 0;
+      return false;
+    }
+    madvise(map, m_size, MADV_SEQUENTIAL);
+    m_data = (const char*)map;
+    m_mapped = true;
+  }
+  ::close(fd);
+#endif
+
+  // Read the directives heading the file, the data starts at the first line that is not one
+  size_t pos = 0;
+  while (pos < m_size && m_data[pos] == '#') {
+    const char* eol = (const char*)memchr(m_data + pos, '\n', m_size - pos);
+    const size_t line_end = eol ? (size_t)(eol - m_data) : m_size;
+    const char* nul = (const char*)memchr(m_data + pos, '\0', line_end - pos);
+    cString cmdstr(m_data + pos, (int)((nul ? (size_t)(nul - m_data) : line_end) - pos));
+    cString cmd = cmdstr.PopWord();
+
+    if (cmd == "#include" || cmd == "#import" || cmd == "#define") return false;
+    if (cmd == "#filetype") {
+      cString ft = cmdstr.PopWord();
+      if (m_filetype != "unknown" && m_filetype != ft) return false;
+      m_filetype = ft;
+    } else if (cmd == "#format") {
+      if (m_format.GetSize() != 0) return false;
+      m_format.Load(cmdstr);
+    }
+
+    pos = line_end + 1;
+  }
+  m_data_start = (pos < m_size) ? pos : m_size;
+
+  return true;
+}
+
+
+bool cGenotypeFileLoader::Load(cAnalyzeJobQueue& queue, tList<tDataEntryCommand<cAnalyzeGenotype> >& columns,
+                               const Genome& default_genome, tList<cAnalyzeGenotype>& batch_list, size_t chunk_size)
+{
+  Apto::Array<tDataEntryCommand<cAnalyzeGenotype>*> column_array(columns.GetSize());
+  Apto::Array<bool> sequence_columns(columns.GetSize());
+  tListIterator<tDataEntryCommand<cAnalyzeGenotype> > column_it(columns);
+  for (int i = 0; column_it.Next() != NULL; i++) {
+    column_array[i] = column_it.Get();
+    sequence_columns[i] = (column_it.Get()->GetName() == "sequence");
+  }
+  const bool id_names = m_format.HasString("id");
+
+  // Split the data at line boundaries
+  tList<cGenotypeFileChunk> chunks;
+  tAnalyzeJobBatch<cGenotypeFileChunk> jobbatch(queue);
+  size_t pos = m_data_start;
+  while (pos < m_size) {
+    size_t chunk_end = pos + chunk_size;
+    if (chunk_end >= m_size) chunk_end = m_size;
+    else {
+      const char* eol = (const char*)memchr(m_data + chunk_end, '\n', m_size - chunk_end);
+      chunk_end = eol ? (size_t)(eol - m_data) + 1 : m_size;
+    }
+
+    cGenotypeFileChunk* chunk = new cGenotypeFileChunk(m_world, m_data + pos, m_data + chunk_end, column_array,
+                                                       sequence_columns, default_genome, id_names);
+    chunks.PushRear(chunk);
+    jobbatch.AddJob(chunk, &cGenotypeFileChunk::Parse);
+    pos = chunk_end;
+  }
+  jobbatch.RunBatch();
+
+  bool loaded = true;
+  tListIterator<cGenotypeFileChunk> chunk_it(chunks);
+  while (chunk_it.Next() != NULL) if (chunk_it.Get()->NeedsInitFile()) loaded = false;
+
+  // Append in file order, naming by position when the file carries no ids
+  int load_count = 0;
+  cGenotypeFileChunk* chunk = NULL;
+  while ((chunk = chunks.Pop()) != NULL) {
+    if (loaded) {
+      for (int i = 0; i < chunk->GetNumGenotypes(); i++) {
+        cAnalyzeGenotype* genotype = chunk->ReleaseGenotype(i);
+        if (!id_names) genotype->SetName(cStringUtil::Stringf("org-%d", load_count++));
+        batch_list.PushRear(genotype);
+      }
+    }
+    delete chunk;
+  }
+
+  return loaded;
+}
+
+
+void cGenotypeFileLoader::close()
+{
+  if (m_data) {
+#if APTO_PLATFORM(WINDOWS)
+    delete [] m_data;
+#else
+    if (m_mapped) munmap((void*)m_data, m_size);
+#endif
+  }
+  m_data = NULL;
+  m_size = 0;
+  m_mapped = false;
+}
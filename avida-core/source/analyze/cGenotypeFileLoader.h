@@ -0,0 +1,85 @@
+/*
+ *  cGenotypeFileLoader.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cGenotypeFileLoader_h
+#define cGenotypeFileLoader_h
+
+#include "avida/core/Genome.h"
+
+#include "cString.h"
+#include "cStringList.h"
+#include "tList.h"
+
+class cAnalyzeGenotype;
+class cAnalyzeJobQueue;
+class cWorld;
+template <class T> class tDataEntryCommand;
+
+using namespace Avida;
+
+
+// Bulk loader for genotype_data (detail, spop) files used by the analyze LOAD command.  The file is memory mapped,
+// the header directives are read up front, and the data lines are split into chunks at line boundaries that are
+// parsed as analyze jobs.  Each chunk fills its own pre-sized genotype array; the chunks are then appended to the
+// batch in file order, so the batch is identical to what cInitFile based loading produces.
+//
+// Only plain files are handled here.  Load() declines (returns false, leaving the batch untouched) for anything
+// that relies on cInitFile preprocessing, such as #include, #import, #define or '\' continued lines, and the caller
+// falls back to the serial reader.
+class cGenotypeFileLoader
+{
+public:
+  // Target size of the data chunks handed to the analyze job queue, chunks always end at a line boundary
+  static const size_t DEFAULT_CHUNK_SIZE = 4 * 1024 * 1024;
+
+private:
+  cWorld* m_world;
+  cString m_path;
+  const char* m_data;
+  size_t m_size;
+  size_t m_data_start;      // offset of the first line following the header directives
+  bool m_mapped;            // m_data is a file mapping rather than a heap buffer
+  cString m_filetype;
+  cStringList m_format;
+
+
+  cGenotypeFileLoader(); // @not_implemented
+  cGenotypeFileLoader(const cGenotypeFileLoader&); // @not_implemented
+  cGenotypeFileLoader& operator=(const cGenotypeFileLoader&); // @not_implemented
+
+public:
+  cGenotypeFileLoader(cWorld* world, const cString& filename);
+  ~cGenotypeFileLoader();
+
+  // Maps the file and reads its header, returns false if the file cannot be opened or needs the serial reader
+  bool Open();
+
+  const cString& GetFiletype() const { return m_filetype; }
+  const cStringList& GetFormat() const { return m_format; }
+
+  // Parses all data lines with the given column commands, appending the genotypes to batch_list
+  bool Load(cAnalyzeJobQueue& queue, tList<tDataEntryCommand<cAnalyzeGenotype> >& columns, const Genome& default_genome,
+            tList<cAnalyzeGenotype>& batch_list, size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+private:
+  void close();
+};
+
+#endif
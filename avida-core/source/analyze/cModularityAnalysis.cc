@@ -24,6 +24,7 @@
 #include "cAnalyzeGenotype.h"
 #include "cOrganism.h"
 #include "cPhenotype.h"
+#include "cTestCPUCache.h"
 #include "tDataCommandManager.h"
 #include "tDataEntry.h"
 
@@ -62,7 +63,10 @@ void cModularityAnalysis::CalcFunctionalModularity(cAvidaContext& ctx)
   const InstructionSequence& base_seq = *base_seq_p;
 
   // Calculate the stats for the genotype we're working with...
+  test_info.TrackSiteCoverage();
   testcpu->TestGenome(ctx, test_info, base_genome);  
+  test_info.TrackSiteCoverage(false);
+  const sCPUSiteCoverage base_coverage = test_info.GetSiteCoverage();
   double base_fitness = test_info.GetColonyFitness();
     
   // Check if the organism does any tasks
@@ -105,11 +109,18 @@ void cModularityAnalysis::CalcFunctionalModularity(cAvidaContext& ctx)
       
       mod_seq[line_num] = null_inst;
       
+      // Knockouts of sites the base run never read leave every task in place
+      if (base_coverage.IsInert(line_num, base_genome, mod_genome)) {
+        mod_seq[line_num].SetOp(cur_inst);
+        continue;
+      }
+      
       // Run the modified genome through the Test CPU
-      testcpu->TestGenome(ctx, test_info, mod_genome);
+      sCPUTestSummary summary;
+      testcpu->TestGenome(ctx, test_info, mod_genome, summary);
       
-      if (test_info.GetColonyFitness() > 0.0) {
-        const Apto::Array<int>& test_tasks = test_info.GetColonyOrganism()->GetPhenotype().GetLastTaskCount();
+      if (summary.colony_fitness > 0.0) {
+        const Apto::Array<int>& test_tasks = summary.colony_task_counts;
         
         for (int cur_task = 0; cur_task < num_tasks; cur_task++) {
           // This is done so that under 'binary' option it marks
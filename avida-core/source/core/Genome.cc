@@ -36,7 +36,7 @@
 #include "cStringUtil.h"
 
 static Apto::BasicString<Apto::ThreadSafe> s_prop_id_instset("instset");
-static PropertyDescriptionMap s_prop_desc_map;
+static PropertyDescriptionMap s_prop_desc_map;  // set in cHardwareManager::Initialize(), read-only thereafter
 
 void cHardwareManager::Initialize()
 {
@@ -25,8 +25,10 @@
 using namespace std;
 using namespace Avida;
 
-cCPUMemory::cCPUMemory(const cCPUMemory& in_memory) : InstructionSequence(in_memory), m_flag_array(in_memory.GetSize())
+cCPUMemory::cCPUMemory(const cCPUMemory& in_memory)
+  : InstructionSequence(in_memory), m_flag_array(in_memory.GetSize()), m_site_read(NULL)
 {
+  in_memory.MarkAllRead();
   for (int i = 0; i < m_flag_array.GetSize(); i++) m_flag_array[i] = in_memory.m_flag_array[i];
 }
 
@@ -47,6 +49,7 @@ void cCPUMemory::prepareInsert(int pos, int num_sites)
   const int old_size = m_active_size;
   const int new_size = m_active_size + num_sites;
   adjustCapacity(new_size);
+  if (pos < old_size) MarkAllRead();
   
   // Shift any sites needed...
   for (int i = old_size - 1; i >= pos; i--) m_seq[i + num_sites] = m_seq[i];
@@ -60,6 +63,7 @@ void cCPUMemory::Reset(int new_size)
 
   adjustCapacity(new_size);
   Clear();
+  MarkAllRead();
 }
 
 
@@ -95,6 +99,7 @@ void cCPUMemory::Copy(int to, int from)
   assert(from >= 0);
   assert(from < m_seq.GetSize());
   
+  markRead(from);
   m_seq[to] = m_seq[from];
   m_flag_array[to] = m_flag_array[from];
 }
@@ -129,6 +134,7 @@ void cCPUMemory::Remove(int pos, int num_sites)
   assert(pos + num_sites <= m_active_size); // Cannot extend past end of genome.
 
   const int new_size = m_active_size - num_sites;
+  if (pos < new_size) MarkAllRead();
   for (int i = pos; i < new_size; i++) {
     m_seq[i] = m_seq[i + num_sites];
     m_flag_array[i] = m_flag_array[i + num_sites];
@@ -156,9 +162,17 @@ void cCPUMemory::Replace(int pos, int num_sites, const InstructionSequence& geno
 }
 
 
+InstructionSequence cCPUMemory::Crop(int start, int end) const
+{
+  if (m_site_read) for (int i = start; i < end; i++) markRead(i);
+  return InstructionSequence::Crop(start, end);
+}
+
+
 void cCPUMemory::operator=(const cCPUMemory& other_memory)
 {
   adjustCapacity(other_memory.m_active_size);
+  MarkAllRead();
   
   // Fill in the new information...
   for (int i = 0; i < m_active_size; i++) {
@@ -171,6 +185,7 @@ void cCPUMemory::operator=(const cCPUMemory& other_memory)
 void cCPUMemory::operator=(const InstructionSequence& other_genome)
 {
   adjustCapacity(other_genome.GetSize());
+  MarkAllRead();
   
   // Fill in the new information...
   for (int i = 0; i < m_active_size; i++) {
@@ -39,17 +39,49 @@ private:
 	static const unsigned char MASK_UNUSED2  = 0x80; // unused bit
   
   Apto::Array<unsigned char> m_flag_array;
+  Apto::Array<bool>* m_site_read;
 
   void adjustCapacity(int new_size);
   void prepareInsert(int pos, int num_sites);
 
+  inline void markRead(int pos) const
+    { if (m_site_read && pos >= 0 && pos < m_site_read->GetSize()) (*m_site_read)[pos] = true; }
+
 public:
   cCPUMemory(const cCPUMemory& in_memory);
-  cCPUMemory(const InstructionSequence& in_genome) : InstructionSequence(in_genome), m_flag_array(in_genome.GetSize()) { ; }
-  explicit cCPUMemory(int size = 1)  : InstructionSequence(size), m_flag_array(size) { ClearFlags(); }
-  cCPUMemory(const Apto::String& in_string) : InstructionSequence(in_string), m_flag_array(in_string.GetSize()) { ; }
+  cCPUMemory(const InstructionSequence& in_genome)
+    : InstructionSequence(in_genome), m_flag_array(in_genome.GetSize()), m_site_read(NULL) { ; }
+  explicit cCPUMemory(int size = 1)  : InstructionSequence(size), m_flag_array(size), m_site_read(NULL) { ClearFlags(); }
+  cCPUMemory(const Apto::String& in_string)
+    : InstructionSequence(in_string), m_flag_array(in_string.GetSize()), m_site_read(NULL) { ; }
   ~cCPUMemory() { ; }
 
+  // Read tracking, used by the test CPU to find the sites a run actually depended on.  While attached, every read of
+  // a site through this class marks its entry in site_read.  Edits that shift sites around mark every entry, since
+  // positions no longer line up with the original sites.  Whole sequence readers mark every entry as well; the virtual
+  // ones do so even when called through an InstructionSequence reference.  Site reads through such a reference
+  // bypass operator[] below, so code handing this memory to InstructionSequence functions must call MarkAllRead().
+  void TrackReads(Apto::Array<bool>* site_read) { m_site_read = site_read; }
+  inline void MarkAllRead() const { if (m_site_read) m_site_read->SetAll(true); }
+
+  inline Avida::Instruction& operator[](int idx) { markRead(idx); return InstructionSequence::operator[](idx); }
+  inline const Avida::Instruction& operator[](int idx) const { markRead(idx); return InstructionSequence::operator[](idx); }
+  InstructionSequence Crop(int start, int end) const;
+  InstructionSequence Cut(int start, int end) const { MarkAllRead(); return InstructionSequence::Cut(start, end); }
+  
+  int FindInst(const Avida::Instruction& inst, int start_index = 0) const
+    { MarkAllRead(); return InstructionSequence::FindInst(inst, start_index); }
+  int CountInst(const Avida::Instruction& inst) const { MarkAllRead(); return InstructionSequence::CountInst(inst); }
+  int MinDistBetween(const Avida::Instruction& inst) const
+    { MarkAllRead(); return InstructionSequence::MinDistBetween(inst); }
+  inline bool HasInst(const Avida::Instruction& inst) const { return (FindInst(inst) >= 0); }
+  
+  Apto::String AsString() const { MarkAllRead(); return InstructionSequence::AsString(); }
+  Avida::GeneticRepresentationPtr Clone() const { MarkAllRead(); return InstructionSequence::Clone(); }
+  bool Serialize(Avida::ArchivePtr ar) const { MarkAllRead(); return InstructionSequence::Serialize(ar); }
+  bool operator==(const Avida::GeneticRepresentation& other_seq) const
+    { MarkAllRead(); return InstructionSequence::operator==(other_seq); }
+
   inline bool FlagCopied(int pos) const     { return (MASK_COPIED   & m_flag_array[pos]) != 0; }
   inline bool FlagMutated(int pos) const    { return (MASK_MUTATED  & m_flag_array[pos]) != 0; }
   inline bool FlagExecuted(int pos) const   { return (MASK_EXECUTED & m_flag_array[pos]) != 0; }
@@ -90,6 +122,7 @@ public:
   void Insert(int pos, const InstructionSequence& genome);
   void Remove(int pos, int num_sites = 1);
   void Replace(int pos, int num_sites, const InstructionSequence& genome);
+  void Rotate(int n) { MarkAllRead(); InstructionSequence::Rotate(n); }
 
   void operator=(const cCPUMemory& other_memory);
   void operator=(const InstructionSequence& other_genome);
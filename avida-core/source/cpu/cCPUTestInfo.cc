@@ -38,6 +38,7 @@ cCPUTestInfo::cCPUTestInfo(int max_tests)
   , use_random_inputs(false)
   , use_manual_inputs(false)
   , m_tracer(NULL)
+  , m_track_coverage(false)
   , m_cur_sg(0)
   , org_array(max_tests)
   , m_res_method(RES_INITIAL)
@@ -64,6 +65,7 @@ cCPUTestInfo& cCPUTestInfo::operator=(const cCPUTestInfo& test_info)
   manual_inputs = test_info.manual_inputs; 
   if (test_info.m_tracer) { m_tracer = test_info.m_tracer; }
   m_mut_rates = test_info.m_mut_rates;
+  m_track_coverage = test_info.m_track_coverage;
   m_cur_sg = test_info.m_cur_sg;
   is_viable = test_info.is_viable;
   max_depth = test_info.max_depth;
@@ -71,7 +73,11 @@ cCPUTestInfo& cCPUTestInfo::operator=(const cCPUTestInfo& test_info)
   max_cycle = test_info.max_cycle;
   cycle_to = test_info.cycle_to;
   used_inputs = test_info.used_inputs; 
+  m_coverage = test_info.m_coverage;
   org_array = test_info.org_array;
+  m_from_cache = test_info.m_from_cache;
+  m_cached_fitness = test_info.m_cached_fitness;
+  m_cached_colony_fitness = test_info.m_cached_colony_fitness;
   m_res_method = test_info.m_res_method;
   m_res = NULL;  //Beware -- Resource history is NOT COPIED.
   m_res_update = test_info.m_res_update;
@@ -95,6 +101,10 @@ void cCPUTestInfo::Clear()
   depth_found = -1;
   max_cycle = 0;
   cycle_to = -1;
+  m_coverage.Clear();
+  m_from_cache = false;
+  m_cached_fitness = 0.0;
+  m_cached_colony_fitness = 0.0;
 
   for (int i = 0; i < generation_tests; i++) {
     if (org_array[i] == NULL) break;
@@ -106,6 +116,7 @@ void cCPUTestInfo::Clear()
 
 double cCPUTestInfo::GetGenotypeFitness()
 {
+  if (m_from_cache) return m_cached_fitness;
   if (org_array[0] != NULL) return org_array[0]->GetPhenotype().GetFitness();
   return 0.0;
 }
@@ -113,6 +124,7 @@ double cCPUTestInfo::GetGenotypeFitness()
 
 double cCPUTestInfo::GetColonyFitness()
 {
+  if (m_from_cache) return m_cached_colony_fitness;
   if (IsViable()) return GetColonyOrganism()->GetPhenotype().GetFitness();
   return 0.0;
 }
@@ -122,3 +134,14 @@ cPhenotype& cCPUTestInfo::GetTestPhenotype(int level)
   assert(org_array[level] != NULL);
   return org_array[level]->GetPhenotype();
 }
+
+
+bool sCPUSiteCoverage::SameOffspringMatches(const Avida::Genome& base_genome, const Avida::Genome& mod_genome) const
+{
+  // Copy true and ancestor checks compare each offspring against the depth 0 genome, the one place its contents are
+  // consulted outside of the CPU memory
+  for (int i = 0; i < offspring.GetSize(); i++) {
+    if ((offspring[i] == base_genome) != (offspring[i] == mod_genome)) return false;
+  }
+  return true;
+}
@@ -25,6 +25,8 @@
 #ifndef cCPUTestInfo_h
 #define cCPUTestInfo_h
 
+#include "avida/core/Genome.h"
+
 #include "nHardware.h"
 #include "cHardwareTracer.h"
 #include "cMutationRates.h"
@@ -43,6 +45,26 @@ enum eTestCPUResourceMethod { RES_INITIAL = 0, RES_CONSTANT, RES_UPDATED_DEPLETA
 // DYNAMIC - UPDATED_DEPLETABLE + resources inflow/outflow (NOT IMPLEMENTED YET!)
 
 
+// Sites of the depth 0 genome that a test run read, see cCPUTestInfo::TrackSiteCoverage().  Substituting a site the
+// run never read cannot change the run, so the test result for the substituted genome is known without running it, as
+// long as the offspring genome comparisons (copy true, ancestor cycles) come out the same for both genomes.
+struct sCPUSiteCoverage
+{
+  bool valid;                       // false if the run could not be tracked, every site then counts as read
+  Apto::Array<bool> site_read;
+  Apto::Array<Avida::Genome> offspring;  // offspring produced at each depth
+
+  sCPUSiteCoverage() : valid(false) { ; }
+
+  void Clear() { valid = false; site_read.Resize(0); offspring.Resize(0); }
+
+  bool IsRead(int site) const { return !valid || site >= site_read.GetSize() || site_read[site]; }
+  bool SameOffspringMatches(const Avida::Genome& base_genome, const Avida::Genome& mod_genome) const;
+  bool IsInert(int site, const Avida::Genome& base_genome, const Avida::Genome& mod_genome) const
+    { return !IsRead(site) && SameOffspringMatches(base_genome, mod_genome); }
+};
+
+
 class cCPUTestInfo
 {
   friend class cTestCPU;
@@ -55,6 +77,7 @@ private:
   Apto::Array<int> manual_inputs;  //   if so, use these.
   HardwareTracerPtr m_tracer;
   cMutationRates m_mut_rates;
+  bool m_track_coverage;      // Should we record which sites of the genome are read?
   
   int m_cur_sg;
 
@@ -65,9 +88,15 @@ private:
   int max_cycle;          // Longest cycle found.
   int cycle_to;           // Cycle path of the last genotype.
 	Apto::Array<int> used_inputs; //Depth 0 inputs
+  sCPUSiteCoverage m_coverage;
 
   Apto::Array<cOrganism*> org_array;
   
+  // Set when the outputs were served from the test CPU cache, org_array is then empty
+  bool m_from_cache;
+  double m_cached_fitness;
+  double m_cached_colony_fitness;
+  
   // Information about how to handle resources
   eTestCPUResourceMethod m_res_method;
   cResourceHistory* m_res;
@@ -89,6 +118,7 @@ public:
   void UseManualInputs(Apto::Array<int> inputs) {use_manual_inputs = true; use_random_inputs = false; manual_inputs = inputs;}
   void ResetInputMode() {use_manual_inputs = false; use_random_inputs = false;}
   void SetTraceExecution(HardwareTracerPtr tracer) { m_tracer = tracer; }
+  void TrackSiteCoverage(bool track = true) { m_track_coverage = track; }
   void SetResourceOptions(int res_method = RES_INITIAL, cResourceHistory* res = NULL, int update = 0, int cpu_cycle_offset = 0)
     { m_res_method = (eTestCPUResourceMethod)res_method; m_res = res; m_res_update = update; m_res_cpu_cycle_offset = cpu_cycle_offset; }
   
@@ -110,6 +140,8 @@ public:
   int GetDepthFound() const { return depth_found; }
   int GetMaxCycle() const { return max_cycle; }
   int GetCycleTo() const { return cycle_to; }
+  bool IsFromCache() const { return m_from_cache; }
+  const sCPUSiteCoverage& GetSiteCoverage() const { return m_coverage; }
 
   // Genotype Stats...
   inline cOrganism* GetTestOrganism(int level = 0);
@@ -1208,7 +1208,7 @@ cHeadCPU cHardwareCPU::FindLabel(int direction)
 // to find search label's match inside another label.
 
 int cHardwareCPU::FindLabel_Forward(const cCodeLabel & search_label,
-                                    const InstructionSequence & search_genome, int pos)
+                                    const cCPUMemory & search_genome, int pos)
 {
   assert (pos < search_genome.GetSize() && pos >= 0);
   
@@ -1290,7 +1290,7 @@ int cHardwareCPU::FindLabel_Forward(const cCodeLabel & search_label,
 // to find search label's match inside another label.
 
 int cHardwareCPU::FindLabel_Backward(const cCodeLabel & search_label,
-                                     const InstructionSequence & search_genome, int pos)
+                                     const cCPUMemory & search_genome, int pos)
 {
   assert (pos < search_genome.GetSize());
   
@@ -3362,7 +3362,8 @@ bool cHardwareCPU::Inst_Repro(cAvidaContext& ctx)
     return false;
   }
   
-  // Setup child
+  // Setup child, the whole genome is passed on regardless of what was read from memory
+  m_memory.MarkAllRead();
   m_organism->OffspringGenome() = m_organism->GetGenome();
   InstructionSequencePtr offspring_seq;
   offspring_seq.DynamicCastFrom(m_organism->OffspringGenome().Representation());
@@ -3482,6 +3483,7 @@ bool cHardwareCPU::Inst_SpawnDeme(cAvidaContext& ctx)
 
 bool cHardwareCPU::Inst_SenseQuorum(cAvidaContext& ctx) {
   int cellID = m_organism->GetCellID();
+  m_memory.MarkAllRead();  // Kin are judged on the whole genome
   Apto::String ref_genome = m_organism->GetGenome().Representation()->AsString();
   int radius = m_world->GetConfig().KABOOM_RADIUS.Get();
   int distance = m_world->GetConfig().KABOOM_HAMMING.Get();
@@ -3554,6 +3556,7 @@ bool cHardwareCPU::Inst_SenseQuorum(cAvidaContext& ctx) {
 
 bool cHardwareCPU::Inst_NoisyQuorum(cAvidaContext& ctx) {
   int cellID = m_organism->GetCellID();
+  m_memory.MarkAllRead();  // Kin are judged on the whole genome
   Apto::String ref_genome = m_organism->GetGenome().Representation()->AsString();
   int radius = m_world->GetConfig().KABOOM_RADIUS.Get();
   int distance = m_world->GetConfig().KABOOM_HAMMING.Get();
@@ -4117,16 +4120,9 @@ bool cHardwareCPU::DoSense(cAvidaContext& ctx, int conversion_method, double bas
   // There are no resources, return
   if (res_count.GetSize() == 0) return false;
   
-  // Only recalculate logs if these values have changed
-  static int last_num_resources = 0;
-  static int max_label_length = 0;
+  // Label length needed to address every resource, recomputed each call rather than cached in a static shared by all worlds
   int num_nops = GetInstSet().GetNumNops();
-  
-  if ((last_num_resources != res_count.GetSize()))
-  {
-    max_label_length = (int) ceil(log((double)res_count.GetSize())/log((double)num_nops));
-    last_num_resources = res_count.GetSize();
-  }
+  const int max_label_length = (int) ceil(log((double)res_count.GetSize())/log((double)num_nops));
   
   // Convert modifying NOPs to the index of the resource.
   // If there are fewer than the number of NOPs required
@@ -4916,6 +4912,7 @@ bool cHardwareCPU::Inst_DonateEditDist(cAvidaContext& ctx)
       neighbor = m_organism->GetNeighbor();
       int edit_dist = max_dist + 1;
       if (neighbor != NULL) {
+        m_memory.MarkAllRead();  // The distance is taken over the whole genome
         const Genome& org_genome = m_organism->GetGenome();
         ConstInstructionSequencePtr org_seq_p;
         org_seq_p.DynamicCastFrom(org_genome.Representation());
@@ -4931,40 +4928,6 @@ bool cHardwareCPU::Inst_DonateEditDist(cAvidaContext& ctx)
       if (edit_dist <= max_dist) {
         found = true;
 				
-        // Code to track the edit distance between edt donors and recipients
-        const Genome& org_genome = m_organism->GetGenome();
-        ConstInstructionSequencePtr org_seq_p;
-        org_seq_p.DynamicCastFrom(org_genome.Representation());
-        const InstructionSequence& org_seq = *org_seq_p;
-        
-        const Genome& neighbor_genome = neighbor->GetGenome();
-        ConstInstructionSequencePtr neighbor_seq_p;
-        neighbor_seq_p.DynamicCastFrom(neighbor_genome.Representation());
-        const InstructionSequence& neighbor_seq = *neighbor_seq_p;
-        
-        const int edit_dist = InstructionSequence::FindEditDistance(org_seq, neighbor_seq);
-				
-        /*static ofstream edit_file("edit_dists.dat");*/
-        static int num_edit_donates = 0;
-        static int num_edit_donates_15_dist = 0;
-        static int tot_dist_edit_donate = 0;
-				
-        num_edit_donates++;
-        if (edit_dist > 15) num_edit_donates_15_dist++;
-        tot_dist_edit_donate += edit_dist;
-        
-        if (num_edit_donates == 1000) {
-          /*
-           edit_file << num_edit_donates << " "
-           << (double) num_edit_donates_15_dist / (double) num_edit_donates << " "
-           << (double) tot_dist_edit_donate / (double) num_edit_donates << endl;
-           */
-					
-          num_edit_donates = 0;
-          num_edit_donates_15_dist = 0;
-          tot_dist_edit_donate = 0;
-        }
-        
         break;
       }
       m_organism->Rotate(ctx, 1);
@@ -4992,6 +4955,7 @@ bool cHardwareCPU::Inst_GetFacedEditDistance(cAvidaContext& ctx)
   cOrganism* target = NULL;
   target = m_organism->GetOrgInterface().GetNeighbor();
 
+  m_memory.MarkAllRead();  // The distance is taken over the whole genome
   const Genome& org_genome = m_organism->GetGenome();
   ConstInstructionSequencePtr org_seq_p;
   org_seq_p.DynamicCastFrom(org_genome.Representation());
@@ -5150,40 +5114,6 @@ bool cHardwareCPU::Inst_DonateShadedGreenBeard(cAvidaContext& ctx)
       // shade (color/number of donations)
       //			if (neighbor_shade_of_gb >=  shade_of_gb) {
       if (neighbor_shade_of_gb ==  shade_of_gb) {	
-        // Code to track the edit distance between shaded donors and recipients
-        const Genome& org_genome = m_organism->GetGenome();
-        ConstInstructionSequencePtr org_seq_p;
-        org_seq_p.DynamicCastFrom(org_genome.Representation());
-        const InstructionSequence& org_seq = *org_seq_p;
-        
-        const Genome& neighbor_genome = neighbor->GetGenome();
-        ConstInstructionSequencePtr neighbor_seq_p;
-        neighbor_seq_p.DynamicCastFrom(neighbor_genome.Representation());
-        const InstructionSequence& neighbor_seq = *neighbor_seq_p;
-        
-        const int edit_dist = InstructionSequence::FindEditDistance(org_seq, neighbor_seq);
-				
-        /*static ofstream gb_file("shaded_gb_dists.dat");*/
-        static int num_gb_donates = 0;
-        static int num_gb_donates_15_dist = 0;
-        static int tot_dist_gb_donate = 0;
-				
-        num_gb_donates++;
-        if (edit_dist > 15) num_gb_donates_15_dist++;
-        tot_dist_gb_donate += edit_dist;
-				
-        if (num_gb_donates == 1000) {
-          /*
-           gb_file << num_gb_donates << " "
-           << (double) num_gb_donates_15_dist / (double) num_gb_donates << " "
-           << (double) tot_dist_gb_donate / (double) num_gb_donates << endl;
-           */
-					
-          num_gb_donates = 0;
-          num_gb_donates_15_dist = 0;
-          tot_dist_gb_donate = 0;
-        }
-				
         found = true;
       }
     }
@@ -5345,40 +5275,11 @@ bool cHardwareCPU::Inst_DonateThreshGreenBeard(cAvidaContext& ctx)
       }
 			
       if (neighbor_thresh_of_gb >= m_world->GetConfig().MIN_GB_DONATE_THRESHOLD.Get() ) {
-        const Genome& org_gen = m_organism->GetGenome();
-        ConstInstructionSequencePtr org_seq_p;
-        org_seq_p.DynamicCastFrom(org_gen.Representation());
-        const InstructionSequence& org_seq = *org_seq_p;
-
         const Genome& neighbor_gen = neighbor->GetGenome();
         ConstInstructionSequencePtr neighbor_seq_p;
         neighbor_seq_p.DynamicCastFrom(neighbor_gen.Representation());
         const InstructionSequence& neighbor_seq = *neighbor_seq_p;
         
-        // Code to track the edit distance between tgb donors and recipients
-        const int edit_dist = InstructionSequence::FindEditDistance(org_seq, neighbor_seq);
-				
-        /*static ofstream tgb_file("thresh_gb_dists.dat");*/
-        static int num_tgb_donates = 0;
-        static int num_tgb_donates_15_dist = 0;
-        static int tot_dist_tgb_donate = 0;
-        
-        num_tgb_donates++;
-        if (edit_dist > 15) num_tgb_donates_15_dist++;
-        tot_dist_tgb_donate += edit_dist;
-				
-        if (num_tgb_donates == 1000) {
-          /*
-           tgb_file << num_tgb_donates << " "
-           << (double) num_tgb_donates_15_dist / (double) num_tgb_donates << " "
-           << (double) tot_dist_tgb_donate / (double) num_tgb_donates << endl;
-           */
-          
-          num_tgb_donates = 0;
-          num_tgb_donates_15_dist = 0;
-          tot_dist_tgb_donate = 0;
-        }
-        
         // for each instruction in the genome...
         for (int i=0;i<neighbor_seq.GetSize();i++){
 					
@@ -6084,6 +5985,7 @@ bool cHardwareCPU::Inst_DonateSpecific(cAvidaContext& ctx)
       m_organism->GetPhenotype().SetIsDonorEdit();
       target->GetPhenotype().SetIsReceiverEdit();
       
+      m_memory.MarkAllRead();  // The distance is taken over the whole genome
       const Genome& org_genome = m_organism->GetGenome();
       ConstInstructionSequencePtr org_seq_p;
       org_seq_p.DynamicCastFrom(org_genome.Representation());
@@ -6925,6 +6827,7 @@ bool cHardwareCPU::Inst_HeadWrite(cAvidaContext& ctx)
   if (m_organism->TestCopyDel(ctx)) active_head.RemoveInst();
   if (m_organism->TestCopyUniform(ctx)) doUniformCopyMutation(ctx, active_head);
   if (!m_slip_read_head && m_organism->TestCopySlip(ctx)) {
+    m_memory.MarkAllRead();  // Slips shift the memory through an InstructionSequence reference
     doSlipMutation(ctx, m_memory, active_head.GetPosition());
   }
   
@@ -6964,6 +6867,7 @@ bool cHardwareCPU::Inst_HeadCopy(cAvidaContext& ctx)
     if (m_slip_read_head) {
       read_head.Set(ctx.GetRandom().GetInt(m_memory.GetSize()));
     } else {
+      m_memory.MarkAllRead();  // Slips shift the memory through an InstructionSequence reference
       doSlipMutation(ctx, m_memory, write_head.GetPosition());
     }
   }
@@ -7030,6 +6934,7 @@ bool cHardwareCPU::HeadCopy_ErrorCorrect(cAvidaContext& ctx, double reduction)
     if (m_slip_read_head) {
       read_head.Set(ctx.GetRandom().GetInt(m_memory.GetSize()));
     } else {
+      m_memory.MarkAllRead();  // Slips shift the memory through an InstructionSequence reference
       doSlipMutation(ctx, m_memory, write_head.GetPosition());
     }
   }
@@ -8218,15 +8123,9 @@ bool cHardwareCPU::DoSenseFacing(cAvidaContext& ctx, int conversion_method, doub
   // There are no resources, return
   if (res_count.GetSize() == 0) return false;
   
-  // Only recalculate logs if these values have changed
-  static int last_num_resources = 0;
-  static int max_label_length = 0;
+  // Label length needed to address every resource
   int num_nops = GetInstSet().GetNumNops();
-  
-  if ((last_num_resources != res_count.GetSize())) {
-    max_label_length = (int) ceil(log((double)res_count.GetSize())/log((double)num_nops));
-    last_num_resources = res_count.GetSize();
-  }
+  const int max_label_length = (int) ceil(log((double)res_count.GetSize())/log((double)num_nops));
   
   // Convert modifying NOPs to the index of the resource.
   // If there are fewer than the number of NOPs required
@@ -173,8 +173,8 @@ protected:
   cCodeLabel& GetLabel() { return m_threads[m_cur_thread].next_label; }
   void ReadLabel(int max_size=cCodeLabel::MAX_LENGTH);
   cHeadCPU FindLabel(int direction);
-  int FindLabel_Forward(const cCodeLabel & search_label, const InstructionSequence& search_genome, int pos);
-  int FindLabel_Backward(const cCodeLabel & search_label, const InstructionSequence& search_genome, int pos);
+  int FindLabel_Forward(const cCodeLabel & search_label, const cCPUMemory& search_genome, int pos);
+  int FindLabel_Backward(const cCodeLabel & search_label, const cCPUMemory& search_genome, int pos);
   cHeadCPU FindLabel(const cCodeLabel & in_label, int direction);
   void FindLabelInMemory(const cCodeLabel& label, cHeadCPU& search_head);
 
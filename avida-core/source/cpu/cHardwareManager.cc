@@ -43,7 +43,7 @@ using namespace Avida;
 static const Apto::BasicString<Apto::ThreadSafe> s_prop_id_instset("instset");
 
 cHardwareManager::cHardwareManager(cWorld* world)
-: m_world(world)
+: m_world(world), m_test_cpu_cache(world->GetConfig().TEST_CPU_CACHE_SIZE.Get())
 {
   cString filename = world->GetConfig().INST_SET.Get();
   m_is_name_map.Set("(default)", 0);
@@ -25,6 +25,7 @@
 #include "avida/output/File.h"
 
 #include "cAvidaContext.h"
+#include "cCPUMemory.h"
 #include "cCPUTestInfo.h"
 #include "cEnvironment.h"
 #include "cHardwareBase.h"
@@ -38,6 +39,7 @@
 #include "cResourceHistory.h"
 #include "cResourceLib.h"
 #include "cStringUtil.h"
+#include "cTestCPUCache.h"
 #include "cTestCPUInterface.h"
 #include "cWorld.h"
 #include "tMatrix.h"
@@ -184,7 +186,9 @@ bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Gen
 {
   ctx.SetTestMode();
   test_info.Clear();
+  const unsigned int rng_uses = ctx.GetRandomUses();
   TestGenome_Body(ctx, test_info, genome, 0);
+  if (test_info.m_track_coverage) FinishCoverage(ctx, test_info, rng_uses);
   ctx.ClearTestMode();
   
   return test_info.is_viable;
@@ -223,6 +227,78 @@ bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Gen
   return test_info.is_viable;
 }
 
+bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, sCPUTestSummary& summary)
+{
+  cTestCPUCache& cache = m_world->GetHardwareManager().GetTestCPUCache();
+  const bool use_cache = cache.IsEnabled() && IsCacheable(test_info);
+  
+  Apto::String key;
+  if (use_cache) {
+    key = GetCacheKey(test_info, genome);
+    if (cache.Lookup(key, summary)) {
+      test_info.Clear();
+      test_info.is_viable = summary.is_viable;
+      test_info.max_depth = summary.max_depth;
+      test_info.depth_found = summary.depth_found;
+      test_info.max_cycle = summary.max_cycle;
+      test_info.cycle_to = summary.cycle_to;
+      test_info.m_from_cache = true;
+      test_info.m_cached_fitness = summary.fitness;
+      test_info.m_cached_colony_fitness = summary.colony_fitness;
+      return summary.is_viable;
+    }
+  }
+  
+  TestGenome(ctx, test_info, genome);
+  summary.Set(test_info);
+  if (use_cache) cache.Store(key, summary);
+  
+  return summary.is_viable;
+}
+
+void cTestCPU::FinishCoverage(cAvidaContext& ctx, cCPUTestInfo& test_info, unsigned int rng_uses)
+{
+  sCPUSiteCoverage& coverage = test_info.m_coverage;
+  if (coverage.site_read.GetSize() == 0) return;  // Hardware does not support read tracking
+  
+  // Runs that consumed random numbers can not be reproduced by reasoning about the sites they read, and traced runs
+  // are expected to produce their trace output
+  if (ctx.GetRandomUses() != rng_uses || test_info.m_tracer) return;
+  
+  // Promoter scans and exact copy checks consult the genome outside of the tracked reads
+  if (m_world->GetConfig().PROMOTERS_ENABLED.Get() || m_world->GetConfig().REQUIRE_EXACT_COPY.Get()) return;
+  
+  for (int i = 0; i <= test_info.max_depth; i++) {
+    cOrganism* org = test_info.org_array[i];
+    if (org != NULL && org->GetPhenotype().GetNumDivides() > 0) coverage.offspring.Push(org->OffspringGenome());
+  }
+  coverage.valid = true;
+}
+
+bool cTestCPU::IsCacheable(const cCPUTestInfo& test_info) const
+{
+  // Only tests that are a pure function of the genome, environment and test options can be reused
+  if (test_info.use_random_inputs || test_info.m_tracer) return false;
+  if (test_info.m_res_method != RES_INITIAL || test_info.m_res_update != 0 || test_info.m_res_cpu_cycle_offset != 0) return false;
+  if (!test_info.m_mut_rates.IsClear()) return false;
+  
+  return true;
+}
+
+Apto::String cTestCPU::GetCacheKey(const cCPUTestInfo& test_info, const Genome& genome) const
+{
+  Apto::String key(genome.AsString());
+  key += Apto::FormatStr("|%d|%d|%d|%d|%d|%.17g", m_world->GetEnvironment().GetSignature(),
+                         m_world->GetConfig().TEST_CPU_TIME_MOD.Get(), test_info.generation_tests, test_info.m_cur_sg,
+                         m_test_solo_res, m_test_solo_res_lev);
+  if (test_info.use_manual_inputs) {
+    key += "|";
+    for (int i = 0; i < test_info.manual_inputs.GetSize(); i++) key += Apto::FormatStr("%d,", test_info.manual_inputs[i]);
+  }
+  
+  return key;
+}
+
 bool cTestCPU::TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth)
 {
   assert(cur_depth < test_info.generation_tests);
@@ -264,8 +340,18 @@ bool cTestCPU::TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, cons
   seq.DynamicCastFrom(genome.Representation());
   organism->GetPhenotype().SetupInject(*seq);
 
+  // Record the sites of the genome read while running the depth 0 organism, see sCPUSiteCoverage
+  cCPUMemory* tracked_memory = NULL;
+  if (cur_depth == 0 && test_info.m_track_coverage && organism->GetHardware().GetType() == HARDWARE_TYPE_CPU_ORIGINAL) {
+    test_info.m_coverage.site_read.Resize(seq->GetSize());
+    test_info.m_coverage.site_read.SetAll(false);
+    tracked_memory = &organism->GetHardware().GetMemory();
+    tracked_memory->TrackReads(&test_info.m_coverage.site_read);
+  }
+
   // Run the current organism.
   ProcessGestation(ctx, test_info, cur_depth);
+  if (tracked_memory) tracked_memory->TrackReads(NULL);
 
   
   // Notify the organism that it has died to allow for various cleanup methods to run
@@ -320,13 +406,17 @@ bool cTestCPU::TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, cons
 
 
 void cTestCPU::PrintGenome(cAvidaContext& ctx, const Genome& genome, cString filename, int update, bool for_groups, int last_birth_cell, int last_group_id, int last_forager_type)
+{
+  cCPUTestInfo test_info;
+  TestGenome(ctx, test_info, genome);
+  PrintTestedGenome(test_info, genome, filename, update, for_groups, last_birth_cell, last_group_id, last_forager_type);
+}
+
+void cTestCPU::PrintTestedGenome(cCPUTestInfo& test_info, const Genome& genome, cString filename, int update, bool for_groups, int last_birth_cell, int last_group_id, int last_forager_type)
 {
   ConstInstructionSequencePtr seq;
   seq.DynamicCastFrom(genome.Representation());
   if (filename == "") filename.Set("archive/%03d-unnamed.org", seq->GetSize());
-    
-  cCPUTestInfo test_info;
-  TestGenome(ctx, test_info, genome);
   
   // Open the file...
   Apto::String file_path((const char*)filename);
@@ -36,6 +36,7 @@ class cBioGroup;
 class cInstSet;
 class cResourceCount;
 class cResourceHistory;
+struct sCPUTestSummary;
 
 using namespace Avida;
 
@@ -70,6 +71,9 @@ private:
 
   bool ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int cur_depth);
   bool TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth);
+  void FinishCoverage(cAvidaContext& ctx, cCPUTestInfo& test_info, unsigned int rng_uses);
+  bool IsCacheable(const cCPUTestInfo& test_info) const;
+  Apto::String GetCacheKey(const cCPUTestInfo& test_info, const Genome& genome) const;
 
   
   cTestCPU(); // @not_implemented
@@ -86,10 +90,19 @@ public:
   cTestCPU(cAvidaContext& ctx, cWorld* world);
   ~cTestCPU() { }
   
+  // When test_info.TrackSiteCoverage() is set, the sites of the genome the run read are reported through
+  // test_info.GetSiteCoverage().
   bool TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome);
   bool TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, std::ofstream& out_fp);
   
+  // Consults the world's test CPU cache before running the genome.  On a cache hit the test organisms in test_info
+  // are not available (see cCPUTestInfo::IsFromCache()), only the viability, depth, cycle and fitness outputs of
+  // test_info can be read; everything else must come from summary.
+  bool TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, sCPUTestSummary& summary);
+  
   void PrintGenome(cAvidaContext& ctx, const Genome& genome, cString filename = "", int update = -1, bool for_groups = false, int last_birth_cell = 0, int last_group_id = -1, int last_forager_type = -1);
+  // Writes the PrintGenome report for a genome that has already been run through TestGenome with test_info.
+  void PrintTestedGenome(cCPUTestInfo& test_info, const Genome& genome, cString filename = "", int update = -1, bool for_groups = false, int last_birth_cell = 0, int last_group_id = -1, int last_forager_type = -1);
 
   inline int GetInput();
   inline int GetInputAt(int & input_pointer);
@@ -0,0 +1,110 @@
+/*
+ *  cTestCPUCache.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cTestCPUCache.h"
+
+#include "cCPUTestInfo.h"
+#include "cOrganism.h"
+#include "cPhenotype.h"
+
+
+void sCPUTestSummary::Set(cCPUTestInfo& test_info)
+{
+  is_viable = test_info.IsViable();
+  max_depth = test_info.GetMaxDepth();
+  depth_found = test_info.GetDepthFound();
+  max_cycle = test_info.GetMaxCycle();
+  cycle_to = test_info.GetCycleTo();
+
+  fitness = test_info.GetGenotypeFitness();
+  colony_fitness = test_info.GetColonyFitness();
+
+  cPhenotype& phenotype = test_info.GetTestPhenotype();
+  merit = phenotype.GetMerit().GetDouble();
+  gestation_time = phenotype.GetGestationTime();
+  executed_size = phenotype.GetExecutedSize();
+  copied_size = phenotype.GetCopiedSize();
+  task_counts = phenotype.GetLastTaskCount();
+  colony_task_counts = test_info.GetColonyOrganism()->GetPhenotype().GetLastTaskCount();
+}
+
+
+cTestCPUCache::cTestCPUCache(int capacity)
+  : m_capacity((capacity > 0) ? capacity : 0), m_order(m_capacity), m_next(0), m_hits(0), m_misses(0)
+{
+}
+
+
+bool cTestCPUCache::Lookup(const Apto::String& key, sCPUTestSummary& summary)
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  if (m_entries.Get(key, summary)) {
+    m_hits++;
+    return true;
+  }
+  m_misses++;
+  return false;
+}
+
+
+void cTestCPUCache::Store(const Apto::String& key, const sCPUTestSummary& summary)
+{
+  if (m_capacity == 0) return;
+
+  Apto::MutexAutoLock lock(m_mutex);
+
+  // Another thread may have stored the same genome while this one was testing it
+  if (m_entries.Has(key)) return;
+
+  // Evict the oldest entry, if the ring has wrapped around
+  if (m_order[m_next].GetSize()) m_entries.Remove(m_order[m_next]);
+
+  m_entries.Set(key, summary);
+  m_order[m_next] = key;
+  m_next = (m_next + 1) % m_capacity;
+}
+
+
+void cTestCPUCache::Clear()
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  m_entries.Clear();
+  for (int i = 0; i < m_order.GetSize(); i++) m_order[i] = "";
+  m_next = 0;
+}
+
+
+long long cTestCPUCache::GetHits() const
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  return m_hits;
+}
+
+long long cTestCPUCache::GetMisses() const
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  return m_misses;
+}
+
+int cTestCPUCache::GetSize() const
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  return m_entries.GetSize();
+}
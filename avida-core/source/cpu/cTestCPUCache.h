@@ -0,0 +1,95 @@
+/*
+ *  cTestCPUCache.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cTestCPUCache_h
+#define cTestCPUCache_h
+
+#include "avida/core/Types.h"
+
+#include "apto/core/Mutex.h"
+
+class cCPUTestInfo;
+
+
+// Condensed results of a single cTestCPU::TestGenome() run.  Only the values commonly consumed by genotype metrics,
+// landscaping and knockout style analyses are retained; the test organisms themselves are not.
+struct sCPUTestSummary
+{
+  bool is_viable;
+  int max_depth;
+  int depth_found;
+  int max_cycle;
+  int cycle_to;
+
+  double fitness;         // Fitness of the organism at depth 0
+  double colony_fitness;  // Fitness of the colony forming organism (0.0 if not viable)
+  double merit;
+  int gestation_time;
+  int executed_size;
+  int copied_size;
+
+  Apto::Array<int> task_counts;         // Last task counts of the organism at depth 0
+  Apto::Array<int> colony_task_counts;  // Last task counts of the colony forming organism
+
+  sCPUTestSummary() : is_viable(false), max_depth(-1), depth_found(-1), max_cycle(0), cycle_to(-1), fitness(0.0)
+    , colony_fitness(0.0), merit(0.0), gestation_time(0), executed_size(0), copied_size(0) { ; }
+
+  void Set(cCPUTestInfo& test_info);
+};
+
+
+// Bounded, thread-safe memo table of test CPU results, keyed by the genome string along with the environment
+// signature and the test options that can influence the outcome.  Entries are evicted in insertion order once
+// the configured capacity has been reached.
+class cTestCPUCache
+{
+private:
+  mutable Apto::Mutex m_mutex;
+
+  int m_capacity;
+  Apto::Map<Apto::String, sCPUTestSummary> m_entries;
+  Apto::Array<Apto::String> m_order;  // Ring buffer of keys in insertion order
+  int m_next;
+
+  long long m_hits;
+  long long m_misses;
+
+
+  cTestCPUCache(); // @not_implemented
+  cTestCPUCache(const cTestCPUCache&); // @not_implemented
+  cTestCPUCache& operator=(const cTestCPUCache&); // @not_implemented
+
+public:
+  cTestCPUCache(int capacity);
+  ~cTestCPUCache() { ; }
+
+  inline bool IsEnabled() const { return (m_capacity > 0); }
+
+  bool Lookup(const Apto::String& key, sCPUTestSummary& summary);
+  void Store(const Apto::String& key, const sCPUTestSummary& summary);
+  void Clear();
+
+  long long GetHits() const;
+  long long GetMisses() const;
+  int GetSize() const;
+  int GetCapacity() const { return m_capacity; }
+};
+
+#endif
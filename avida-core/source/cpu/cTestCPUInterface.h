@@ -118,6 +118,7 @@ public:
   int GetFrozenPeakY(cAvidaContext& ctx, int res_id) { return 0; } 
 
   cResourceCount* GetResourceCount() { return NULL; }
+  cSensingIndex* GetSensingIndex() { return NULL; }
   void TriggerDoUpdates(cAvidaContext&) { }
   void UpdateResources(cAvidaContext& ctx, const Apto::Array<double>& res_change);
   void UpdateAVResources(cAvidaContext& ctx, const Apto::Array<double>& res_change);
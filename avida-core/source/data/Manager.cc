@@ -42,7 +42,7 @@ bool Avida::Data::Manager::s_registered_with_facet_factory =
   Avida::WorldFacet::RegisterFacetType(Avida::Reserved::DataManagerFacetID, DeserializeDataManager);
 
 
-Avida::Data::Manager::Manager() : m_world(NULL), m_available(new DataSet)
+Avida::Data::Manager::Manager() : m_world(NULL), m_available(new DataSet), m_value_stamp(0)
 {
   
 }
@@ -295,8 +295,26 @@ bool Avida::Data::Manager::AttachRecorder(RecorderPtr recorder, bool concurrent_
     }
   }
   
+  // Resolve the providers of all requested values now, so that retrieval during updates needs no parsing or map walks
+  Apto::Array<PlanEntry, Apto::Smart> plan_entries;
+  for (ConstDataSetIterator it = requested->Begin(); it.Next();) {
+    PlanEntry entry;
+    if (compilePlanEntry(*it.Get(), entry)) plan_entries.Push(entry);
+  }
+  
   m_rwlock.WriteUnlock();
   
+  // Extend the data plan, handing out integer handles to any newly requested values
+  m_current_value_mutex.Lock();
+  for (int i = 0; i < plan_entries.GetSize(); i++) {
+    if (m_handles.Has(plan_entries[i].data_id)) continue;
+    m_handles[plan_entries[i].data_id] = m_plan.GetSize();
+    m_plan.Push(plan_entries[i]);
+    m_values.Push(PackagePtr());
+    m_value_stamps.Push(-1);
+  }
+  m_current_value_mutex.Unlock();
+  
   
   if (concurrent_update) {
     for (Apto::Set<ProviderPtr>::Iterator it = provider_set.Begin(); it.Next();) {
@@ -308,6 +326,7 @@ bool Avida::Data::Manager::AttachRecorder(RecorderPtr recorder, bool concurrent_
         ConstDataSetPtr provided = provider->Provides();
         m_current_value_mutex.Lock();
         for (ConstDataSetIterator pit = provided->Begin(); pit.Next();) m_current_values.Remove(*pit.Get());
+        m_value_stamp++;
         m_current_value_mutex.Unlock();
       }
     }
@@ -422,6 +441,7 @@ void Avida::Data::Manager::PerformUpdate(Context&, Update current_update)
 {
   m_current_value_mutex.Lock();
   m_current_values.Clear();
+  m_value_stamp++;  // invalidates every cached plan value at once
   m_current_value_mutex.Unlock();
   
   m_rwlock.ReadLock();
@@ -449,6 +469,10 @@ Avida::Data::PackagePtr Avida::Data::Manager::GetCurrentValue(const DataID& data
   PackagePtr rtn;
   Apto::MutexAutoLock cvmutexlock(m_current_value_mutex);
   
+  // Values requested by attached recorders go through the compiled plan
+  int handle = -1;
+  if (m_handles.Get(data_id, handle)) return currentValue(handle);
+  
   if (m_current_values.Get(data_id, rtn)) return rtn;
   
   if (data_id[data_id.GetSize() - 1] == ']') {
@@ -486,3 +510,47 @@ Avida::Data::PackagePtr Avida::Data::Manager::GetCurrentValue(const DataID& data
   return rtn;
 }
 
+
+bool Avida::Data::Manager::compilePlanEntry(const DataID& data_id, PlanEntry& entry) const
+{
+  // Called with m_rwlock held
+  entry.data_id = data_id;
+  if (!data_id.GetSize()) return false;
+  
+  if (data_id[data_id.GetSize() - 1] == ']') {
+    // Find start of argument
+    int start_idx = -1;
+    for (int i = 0; i < data_id.GetSize(); i++) {
+      if (data_id[i] == '[') {
+        start_idx = i + 1;
+        break;
+      }
+    }
+    if (start_idx == -1) return false;  // argument start not found
+    
+    // Separate argument from incoming requested data id
+    entry.argument = data_id.Substring(start_idx, data_id.GetSize() - start_idx - 1);
+    entry.raw_id = data_id.Substring(0, start_idx) + "]";
+    return m_active_arg_provider_map.Get(entry.raw_id, entry.arg_provider);
+  }
+  
+  return m_active_provider_map.Get(data_id, entry.provider);
+}
+
+Avida::Data::PackagePtr Avida::Data::Manager::currentValue(int handle) const
+{
+  // Called with m_current_value_mutex held
+  if (m_value_stamps[handle] == m_value_stamp) return m_values[handle];
+  
+  const PlanEntry& entry = m_plan[handle];
+  PackagePtr rtn;
+  if (entry.arg_provider) rtn = entry.arg_provider->GetProvidedValueForArgument(entry.raw_id, entry.argument);
+  else rtn = entry.provider->GetProvidedValue(entry.data_id);
+  
+  // Like the string keyed cache, only successful lookups are retained
+  if (rtn) {
+    m_values[handle] = rtn;
+    m_value_stamps[handle] = m_value_stamp;
+  }
+  return rtn;
+}
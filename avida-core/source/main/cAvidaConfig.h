@@ -284,6 +284,7 @@ public:
   CONFIG_ADD_VAR(SPECULATIVE, bool, 1, "Enable speculative execution\n(pre-execute instructions that don't affect other organisms)");
   CONFIG_ADD_VAR(POPULATION_CAP, int, 0, "Carrying capacity in number of organisms (use 0 for no cap)");
   CONFIG_ADD_VAR(POP_CAP_ELDEST, int, 0, "Carrying capacity in number of organisms (use 0 for no cap). Will kill oldest organism in population, but still use birth method to place new offspring."); 
+  CONFIG_ADD_VAR(ORG_STATS_ON_DEMAND, bool, 1, "Only gather per-organism task, reaction and sense statistics that an\nactive output consumes (0 = always gather everything)");
   
   
   // -------- Topology config options --------
@@ -431,6 +432,7 @@ public:
   CONFIG_ADD_VAR(LEKKING, bool, 0, "Offspring from males go directly into birth chamber to await female choice (off by default)");
   CONFIG_ADD_VAR(MAX_GLOBAL_BIRTH_CHAMBER_SIZE, int, 3600, "Maximum number of waiting that can be stored in the birth chamber in a well-mixed population (3600 by default)");
   CONFIG_ADD_VAR(DISABLE_GENOTYPE_CLASSIFICATION, bool, 0, "Disable tracking of historical genotypes to conserve memory (off by default)");
+  CONFIG_ADD_VAR(RECORD_PRUNED_PHYLOGENY, bool, 0, "Keep a compact record of genotypes pruned from the historic list, for SavePrunedPhylogeny (off by default)");
   CONFIG_ADD_VAR(NOISY_MATE_ASSESSMENT, bool, 0, "Is mate assessment perfect (0) or noisy (1) (0 by default)");
   CONFIG_ADD_VAR(MATE_ASSESSMENT_CV, double, 0.1, "Coefficient of variation for how noisy mate assessment is (0.1 by default)");
   CONFIG_ADD_VAR(FORCED_MATE_PREFERENCE, int, -1, "Force all females to use a specific mate preference; -1 = off (mate preferences can evolve); 0 = all females mate randomly; 1 = all prefer highest display A; 2 = highest display B; 3 = highest merit");
@@ -470,6 +472,11 @@ public:
   CONFIG_ADD_GROUP(MP_GROUP, "Config options for multiple, distributed populations");
   CONFIG_ADD_VAR(ENABLE_MP, int, 0, "Enable multi-process Avida; 0=disabled (default),\n1=enabled.");
   CONFIG_ADD_VAR(MP_SCHEDULING_STYLE, int, 0, "Style of scheduling:\n0=non-MP aware (default)\n1=MP aware, integrated across worlds.");
+  CONFIG_ADD_VAR(MP_MIGRATION_LAG, int, 1, "Number of updates migrants spend in transit between worlds; worlds may run\nthis many updates ahead of each other (0 = arrive at the end of the update they were sent)");
+  CONFIG_ADD_VAR(MP_LOOPBACK, int, 0, "Send all migrants back into this world through the batched migration path,\nwithout any MPI communication (for testing); 0=disabled (default), 1=enabled.");
+  CONFIG_ADD_VAR(MP_ISLAND_COUNT, int, 1, "Number of island populations run concurrently by avida-islands, one thread each");
+  CONFIG_ADD_VAR(MP_ISLAND_MIGRATION_RATE, double, 0.0, "Probability that an offspring migrates to another island");
+  CONFIG_ADD_VAR(MP_ISLAND_MIGRATION_FILE, cString, "-", "NxN file of connectivity weights between islands\n(- = migrants go to any other island with equal probability)");
 	
   
   // -------- Deme config options --------
@@ -539,6 +546,7 @@ public:
   CONFIG_ADD_GROUP(TIME_GROUP, "Time Slicing");
   CONFIG_ADD_VAR(AVE_TIME_SLICE, int, 30, "Average number of CPU-cycles per org per update");
   CONFIG_ADD_VAR(SLICING_METHOD, int, 1, "0 = CONSTANT: all organisms receive equal number of CPU cycles\n1 = PROBABILISTIC: CPU cycles distributed randomly, proportional to merit.\n2 = INTEGRATED: CPU cycles given out deterministicly, proportional to merit\n3 = DEME_PROBABALISTIC: Demes receive fixed number of CPU cycles, awarded probabalistically to members\n4 = CROSS_DEME_PROBABALISTIC: Demes receive CPU cycles proportional to living population size, awarded probabalistically to members");
+  CONFIG_ADD_VAR(SLICING_BURST_SIZE, int, 1, "Number of consecutive CPU cycles an organism receives each time it is scheduled.\nCPU shares are unchanged; larger bursts reduce scheduling overhead (1 = no bursts)");
   CONFIG_ADD_VAR(BASE_MERIT_METHOD, int, 4, "How should merit be initialized?\n0 = Constant (merit independent of size)\n1 = Merit proportional to copied size\n2 = Merit prop. to executed size\n3 = Merit prop. to full size\n4 = Merit prop. to min of executed or copied size\n5 = Merit prop. to sqrt of the minimum size\n6 = Merit prop. to num times MERIT_BONUS_INST is in genome.");
   CONFIG_ADD_VAR(BASE_CONST_MERIT, int, 100, "Base merit valse for BASE_MERIT_METHOD 0");
   CONFIG_ADD_VAR(MERIT_BONUS_INST, int, 0, "Instruction ID to count for BASE_MERIT_METHOD 6"); 
@@ -588,6 +596,7 @@ public:
   CONFIG_ADD_GROUP(GENEOLOGY_GROUP, "Geneology");
   CONFIG_ADD_VAR(THRESHOLD, int, 3, "Number of organisms in a genotype needed for it\n  to be considered viable.");
   CONFIG_ADD_VAR(TEST_CPU_TIME_MOD, int, 20, "Time allocated in test CPUs (multiple of length)");
+  CONFIG_ADD_VAR(TEST_CPU_CACHE_SIZE, int, 0, "Number of test CPU results to remember for reuse by genotype\n  metrics, landscaping and knockout analyses (0 = disabled).\n  Cached genomes are not re-run, and so consume no random numbers.");
   
 
   // -------- Organism Network config options --------
@@ -633,6 +642,7 @@ public:
   // -------- Analyze config options --------
   CONFIG_ADD_GROUP(ANALYZE_GROUP, "Analysis Settings");
   CONFIG_ADD_VAR(MAX_CONCURRENCY, int, -1, "Maximum number of analyze threads, -1 == use all available.");
+  CONFIG_ADD_VAR(DEFER_TEST_PRINTS, bool, 0, "Run the test CPU work of print actions (PrintDominantGenotype, TestDominant,\nPrintTaskSnapshot, DumpTaskGrid) on the analyze threads, side by side with the\nother prints of the same update. Deferred prints use random number seeds of their own.");
   CONFIG_ADD_VAR(INJECT_RESETS_TASKS, int, 0, "Executing INJECT (semi-succesfully) will trigger last_task_count to be writen from current_task_count");
   CONFIG_ADD_VAR(ANALYZE_OPTION_1, cString, "", "String variable accessible from analysis scripts");
   CONFIG_ADD_VAR(ANALYZE_OPTION_2, cString, "", "String variable accessible from analysis scripts");
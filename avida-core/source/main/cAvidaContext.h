@@ -28,6 +28,7 @@
 
 #include "avida/core/Types.h"
 
+class cPerfTimers;
 class cWorld;
 
 
@@ -36,14 +37,16 @@ class cAvidaContext
 private:
   Avida::WorldDriver* m_driver;
   Apto::Random* m_rng;
+  unsigned int m_rng_uses;
+  cPerfTimers* m_perf;
 
   bool m_analyze;
   bool m_testing;
   bool m_org_faults;
   
 public:
-  cAvidaContext(Avida::WorldDriver* driver, Apto::Random& rng) : m_driver(driver), m_rng(&rng), m_analyze(false), m_testing(false), m_org_faults(false) { ; }
-  cAvidaContext(Avida::WorldDriver* driver, Apto::Random* rng) : m_driver(driver), m_rng(rng), m_analyze(false), m_testing(false), m_org_faults(false) { ; }
+  cAvidaContext(Avida::WorldDriver* driver, Apto::Random& rng) : m_driver(driver), m_rng(&rng), m_rng_uses(0), m_perf(NULL), m_analyze(false), m_testing(false), m_org_faults(false) { ; }
+  cAvidaContext(Avida::WorldDriver* driver, Apto::Random* rng) : m_driver(driver), m_rng(rng), m_rng_uses(0), m_perf(NULL), m_analyze(false), m_testing(false), m_org_faults(false) { ; }
   ~cAvidaContext() { ; }
   
   Avida::WorldDriver& Driver() { return *m_driver; }
@@ -51,7 +54,12 @@ public:
   
   void SetRandom(Apto::Random& rng) { m_rng = &rng; }
   void SetRandom(Apto::Random* rng) { m_rng = rng; }
-  Apto::Random& GetRandom() { return *m_rng; }
+  Apto::Random& GetRandom() { m_rng_uses++; return *m_rng; }
+  unsigned int GetRandomUses() const { return m_rng_uses; } // Number of GetRandom() calls, lets callers detect RNG dependence
+  Apto::Random& GetRandomUncounted() { return *m_rng; } // Only for draws whose outcome is fixed, see cMutationRates
+  
+  void SetPerfTimers(cPerfTimers* timers) { m_perf = timers; }
+  cPerfTimers* GetPerfTimers() const { return m_perf; } // NULL unless timing was requested, see cScopedTimer
   
   void SetAnalyzeMode() { m_analyze = true; }
   void ClearAnalyzeMode() { m_analyze = false; }
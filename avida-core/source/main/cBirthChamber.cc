@@ -31,6 +31,7 @@
 #include "cBirthNeighborhoodHandler.h"
 #include "cBirthMatingTypeGlobalHandler.h"
 #include "cOrganism.h"
+#include "cPerfTimers.h"
 #include "cWorld.h"
 #include "cStats.h"
 #include "AvidaTools.h"
@@ -134,7 +135,7 @@ bool cBirthChamber::ValidateBirthEntry(cBirthEntry& entry)
 
 void cBirthChamber::StoreAsEntry(const Genome& offspring, cOrganism* parent, cBirthEntry& entry) const
 {
-  entry.genome = offspring;
+  assignGenome(entry.genome, offspring);
   if (m_world->GetConfig().ENERGY_ENABLED.Get() == 1) {
     entry.energy4Offspring = parent->GetPhenotype().ExtractParentEnergy();
     entry.merit = parent->GetPhenotype().ConvertEnergyToMerit(entry.energy4Offspring);
@@ -142,7 +143,7 @@ void cBirthChamber::StoreAsEntry(const Genome& offspring, cOrganism* parent, cBi
     entry.merit = parent->GetPhenotype().GetMerit();
   }
   entry.timestamp = m_world->GetStats().GetUpdate();
-  entry.groups = Systematics::GroupMembershipPtr(new Systematics::GroupMembership);
+  entry.groups = entry.GroupStorage();
   *entry.groups = *parent->SystematicsGroupMembership();
   
   //@CHC: Set all the mating type properties
@@ -195,27 +196,33 @@ bool cBirthChamber::RegionSwap(InstructionSequence& genome0, InstructionSequence
      return false;
    } 
 
-   if (size0 > 0 && size1 > 0) {
-     InstructionSequence cross0 = genome0.Crop(start0, end0);
-     InstructionSequence cross1 = genome1.Crop(start1, end1);
-     genome0.Replace(start0, size0, cross1);
-     genome1.Replace(start1, size1, cross0);
-   } else if (size0 > 0) {
-     InstructionSequence cross0 = genome0.Crop(start0, end0);
-     genome1.Replace(start1, size1, cross0);
-   } else if (size1 > 0) {
-     InstructionSequence cross1 = genome1.Crop(start1, end1);
-     genome0.Replace(start0, size0, cross1);
-   }
+   if (size0 <= 0 && size1 <= 0) return true;
+
+   // Stage both crossing sections in the scratch buffer, then splice each into the other genome
+   if (m_swap_buf.GetSize() < size0 + size1) m_swap_buf.Resize(size0 + size1);
+   for (int i = 0; i < size0; i++) m_swap_buf[i] = genome0[start0 + i];
+   for (int i = 0; i < size1; i++) m_swap_buf[size0 + i] = genome1[start1 + i];
+
+   spliceRegion(genome0, start0, size0, (size1 > 0) ? &m_swap_buf[size0] : NULL, size1);
+   spliceRegion(genome1, start1, size1, (size0 > 0) ? &m_swap_buf[0] : NULL, size0);
 
    return true;
 }
 
 void cBirthChamber::GenomeSwap(InstructionSequence& genome0, InstructionSequence& genome1, double& merit0, double& merit1)
 {
-  InstructionSequence genome0_tmp = genome0;
-  genome0 = genome1;
-  genome1 = genome0_tmp;
+  // Swap site by site over the longer of the two, then trim each to the other's old length
+  const int size0 = genome0.GetSize();
+  const int size1 = genome1.GetSize();
+  if (size0 < size1) genome0.Resize(size1);
+  else if (size1 < size0) genome1.Resize(size0);
+  for (int i = 0; i < genome0.GetSize(); i++) {
+    Instruction inst = genome0[i];
+    genome0[i] = genome1[i];
+    genome1[i] = inst;
+  }
+  genome0.Resize(size1);
+  genome1.Resize(size0);
 
   double merit0_tmp = merit0;
   merit0 = merit1;
@@ -254,6 +261,7 @@ bool cBirthChamber::DoAsexBirth(cAvidaContext& ctx, const Genome& offspring, cOr
     }
   }
   
+  cScopedTimer timer(ctx.GetPerfTimers(), cPerfTimers::PERF_SYSTEMATICS);
   Systematics::ConstParentGroupsPtr pgrps(new Systematics::ConstParentGroups(1));
   (*pgrps)[0] = parent.SystematicsGroupMembership();
   child_array[0]->SelfClassify(pgrps);
@@ -275,8 +283,8 @@ bool cBirthChamber::DoPairAsexBirth(cAvidaContext& ctx, const cBirthEntry& old_e
   merit_array[1] = parent.GetPhenotype().GetMerit();
 
   // Setup the genotypes for both children...
-  SetupGenotypeInfo(child_array[0], old_entry.groups);
-  SetupGenotypeInfo(child_array[1], parent.SystematicsGroupMembership());
+  SetupGenotypeInfo(ctx, child_array[0], old_entry.groups);
+  SetupGenotypeInfo(ctx, child_array[1], parent.SystematicsGroupMembership());
 
   return true;
 }
@@ -385,7 +393,8 @@ void cBirthChamber::DoModularShuffleRecombination(cAvidaContext& ctx, Instructio
                                                    double& merit0, double& merit1)
 {
   const int num_modules = m_world->GetConfig().MODULE_NUM.Get();
-  Apto::Array<bool> swapped_region(num_modules);
+  Apto::Array<bool>& swapped_region = m_swapped_region;
+  if (swapped_region.GetSize() != num_modules) swapped_region.Resize(num_modules);
   swapped_region.SetAll(false);
 
   int swap_count = 0;
@@ -432,8 +441,47 @@ void cBirthChamber::DoModularShuffleRecombination(cAvidaContext& ctx, Instructio
 }
 
 
-void cBirthChamber::SetupGenotypeInfo(cOrganism* organism, Systematics::ConstGroupMembershipPtr p0grps, Systematics::ConstGroupMembershipPtr p1grps)
+// Copies src into dest, reusing dest's instruction storage whenever both are plain instruction sequences of the same
+// hardware and instruction set (Genome::operator= always clones a new representation)
+void cBirthChamber::assignGenome(Genome& dest, const Genome& src)
+{
+  InstructionSequencePtr dest_seq;
+  dest_seq.DynamicCastFrom(dest.Representation());
+  ConstInstructionSequencePtr src_seq;
+  src_seq.DynamicCastFrom(src.Representation());
+  
+  if (!dest_seq || !src_seq || dest.HardwareType() != src.HardwareType() ||
+      dest.Properties().Get("instset").StringValue() != src.Properties().Get("instset").StringValue()) {
+    dest = src;
+    return;
+  }
+  
+  dest_seq->Resize(src_seq->GetSize());
+  for (int i = 0; i < src_seq->GetSize(); i++) (*dest_seq)[i] = (*src_seq)[i];
+}
+
+// Replaces old_size sites of genome at start with new_size sites from src, shifting the tail in place
+void cBirthChamber::spliceRegion(InstructionSequence& genome, int start, int old_size, const Instruction* src, int new_size)
+{
+  const int old_total = genome.GetSize();
+  const int tail_start = start + old_size;
+  const int shift = new_size - old_size;
+  
+  if (shift > 0) {
+    genome.Resize(old_total + shift);
+    for (int i = old_total - 1; i >= tail_start; i--) genome[i + shift] = genome[i];
+  } else if (shift < 0) {
+    for (int i = tail_start; i < old_total; i++) genome[i + shift] = genome[i];
+    genome.Resize(old_total + shift);
+  }
+  
+  for (int i = 0; i < new_size; i++) genome[start + i] = src[i];
+}
+
+
+void cBirthChamber::SetupGenotypeInfo(cAvidaContext& ctx, cOrganism* organism, Systematics::ConstGroupMembershipPtr p0grps, Systematics::ConstGroupMembershipPtr p1grps)
 {
+  cScopedTimer timer(ctx.GetPerfTimers(), cPerfTimers::PERF_SYSTEMATICS);
   Systematics::ConstParentGroupsPtr pgrps(new Systematics::ConstParentGroups);
   if (p0grps) pgrps->Push(p0grps);
   if (p1grps) pgrps->Push(p1grps);
@@ -473,9 +521,11 @@ bool cBirthChamber::SubmitOffspring(cAvidaContext& ctx, const Genome& offspring,
     ClearEntry(*old_entry);
     return ret;
   }
-  // If we made it this far, RECOMBINATION will happen!
-  Genome genome0(old_entry->genome);
-  Genome genome1(offspring);
+  // If we made it this far, RECOMBINATION will happen!  The waiting genome is recombined in place (the entry is cleared
+  // below) and the new offspring goes through the reusable scratch genome, so neither needs a fresh copy.
+  Genome& genome0 = old_entry->genome;
+  Genome& genome1 = m_recomb_genome;
+  assignGenome(genome1, offspring);
   double meritOrEnergy0;
   double meritOrEnergy1;
 
@@ -550,8 +600,8 @@ bool cBirthChamber::SubmitOffspring(cAvidaContext& ctx, const Genome& offspring,
     merit_array[1] = meritOrEnergy1;
     
     // Setup the genotypes for both children...
-    SetupGenotypeInfo(child_array[0], parent0_groups, parent1_groups);
-    SetupGenotypeInfo(child_array[1], parent1_groups, parent0_groups);
+    SetupGenotypeInfo(ctx, child_array[0], parent0_groups, parent1_groups);
+    SetupGenotypeInfo(ctx, child_array[1], parent1_groups, parent0_groups);
 
   }
   else { 			// Build only one organism	
@@ -567,7 +617,7 @@ bool cBirthChamber::SubmitOffspring(cAvidaContext& ctx, const Genome& offspring,
       merit_array[0] = meritOrEnergy0;
 
       // Setup the genotype for the child...
-      SetupGenotypeInfo(child_array[0], parent0_groups, parent1_groups);
+      SetupGenotypeInfo(ctx, child_array[0], parent0_groups, parent1_groups);
     } 
     else {
       child_array[0] = new cOrganism(m_world, ctx, genome1, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
@@ -578,7 +628,7 @@ bool cBirthChamber::SubmitOffspring(cAvidaContext& ctx, const Genome& offspring,
       merit_array[0] = meritOrEnergy1;
 
       // Setup the genotype for the child...
-      SetupGenotypeInfo(child_array[0], parent1_groups, parent0_groups);
+      SetupGenotypeInfo(ctx, child_array[0], parent1_groups, parent0_groups);
     }
   } 
 
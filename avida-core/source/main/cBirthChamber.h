@@ -23,6 +23,7 @@
 #ifndef cBirthChamber_h
 #define cBirthChamber_h
 
+#include "avida/core/InstructionSequence.h"
 #include "avida/systematics/Group.h"
 
 #include "cBirthEntry.h"
@@ -48,6 +49,11 @@ class cBirthChamber
 private:
   cWorld* m_world;
   Apto::Map<int, cBirthSelectionHandler*> m_handler_map;
+  
+  // Recombination scratch space, grown as needed and reused so that steady state crossover does not allocate
+  Genome m_recomb_genome;
+  Apto::Array<Instruction> m_swap_buf;
+  Apto::Array<bool> m_swapped_region;
 
 
   cBirthChamber(); // @not_implemented
@@ -75,6 +81,9 @@ public:
 private:
   cBirthSelectionHandler* getSelectionHandler(int hw_type);
   
+  static void assignGenome(Genome& dest, const Genome& src);
+  static void spliceRegion(InstructionSequence& genome, int start, int old_size, const Instruction* src, int new_size);
+  
   bool RegionSwap(InstructionSequence& genome0, InstructionSequence& genome1, int start0, int end0, int start1, int end1);
   void GenomeSwap(InstructionSequence& genome0, InstructionSequence& genome1, double& merit0, double& merit1);
   
@@ -92,7 +101,7 @@ private:
   void DoModularShuffleRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1,
                                      double& merit0, double& merit1);
   
-  void SetupGenotypeInfo(cOrganism* organism, Systematics::ConstGroupMembershipPtr p0grps, Systematics::ConstGroupMembershipPtr p1grps = Systematics::ConstGroupMembershipPtr(NULL));
+  void SetupGenotypeInfo(cAvidaContext& ctx, cOrganism* organism, Systematics::ConstGroupMembershipPtr p0grps, Systematics::ConstGroupMembershipPtr p1grps = Systematics::ConstGroupMembershipPtr(NULL));
 };
 
 
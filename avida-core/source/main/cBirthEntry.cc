@@ -60,6 +60,18 @@ cBirthEntry::cBirthEntry(const Genome& _offspring, cOrganism* _parent, int _time
 }
 
 
+cBirthEntry::cBirthEntry(const cBirthEntry& _birth_entry)
+: m_mating_type(MATING_TYPE_JUVENILE)
+, m_mating_display_a(0)
+, m_mating_display_b(0)
+, m_mate_preference(MATE_PREFERENCE_RANDOM)
+, m_group_id(-1)
+, timestamp(-1)
+{
+  *this = _birth_entry;
+}
+
+
 cBirthEntry::~cBirthEntry()
 {
   if (groups) {
@@ -101,8 +113,23 @@ cString cBirthEntry::GetPhenotypeStringFormat()
   return "genome timestamp merit mating_type mate_preference mating_display_a mating_display_b group";
 }
 
+Systematics::GroupMembershipPtr cBirthEntry::GroupStorage()
+{
+  if (!m_group_storage) m_group_storage = Systematics::GroupMembershipPtr(new Systematics::GroupMembership);
+  return m_group_storage;
+}
+
 cBirthEntry& cBirthEntry::operator=(const cBirthEntry& _birth_entry)
 {
+  if (this == &_birth_entry) return *this;
+  
+  // Release the references held by whatever this entry stored before
+  if (groups) {
+    for (int i = 0; i < groups->GetSize(); i++) {
+      (*groups)[i]->RemoveActiveReference();
+    }
+  }
+  
   m_mating_type = _birth_entry.m_mating_type;
   m_mating_display_a = _birth_entry.m_mating_display_a;
   m_mating_display_b = _birth_entry.m_mating_display_b;
@@ -114,7 +141,13 @@ cBirthEntry& cBirthEntry::operator=(const cBirthEntry& _birth_entry)
   energy4Offspring = _birth_entry.energy4Offspring;
   merit = _birth_entry.merit;
   timestamp = _birth_entry.timestamp;
-  groups = _birth_entry.groups;
+  
+  // Copy the membership into this entry's own storage, so that entries never share (and later overwrite) storage
+  groups = Systematics::GroupMembershipPtr(NULL);
+  if (_birth_entry.groups) {
+    groups = GroupStorage();
+    *groups = *_birth_entry.groups;
+  }
   
   // Creating a copy of this birth entry, make sure to add active references to group membership
   if (groups) {
@@ -42,6 +42,7 @@ private:
   int m_mate_preference;
   int m_group_id;
   Apto::Array<int> m_parent_task_count;
+  Systematics::GroupMembershipPtr m_group_storage; // owned by this entry alone, reused each time it is filled
 public:
   Genome genome;
   double energy4Offspring;
@@ -51,6 +52,7 @@ public:
   
   cBirthEntry();
   cBirthEntry(const Genome& _offspring, cOrganism* _parent, int _timestamp);
+  cBirthEntry(const cBirthEntry& _birth_entry);
   ~cBirthEntry();
   
   //Accessor functions
@@ -69,6 +71,9 @@ public:
   void SetMatePreference(int _mate_preference) { m_mate_preference = _mate_preference; }
   void SetGroupID(int _group_id) { m_group_id = _group_id; }
   
+  // Group membership storage for this entry, allocated once and kept across ClearEntry
+  Systematics::GroupMembershipPtr GroupStorage();
+  
   //Other functions
   cString GetPhenotypeString();
   static cString GetPhenotypeStringFormat();
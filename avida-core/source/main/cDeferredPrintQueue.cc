@@ -0,0 +1,102 @@
+/*
+ *  cDeferredPrintQueue.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cDeferredPrintQueue.h"
+
+#include "cAnalyzeJob.h"
+#include "cAnalyzeJobQueue.h"
+#include "cAvidaContext.h"
+#include "cWorld.h"
+
+
+// Deferred prints are evaluated with an RNG of their own, seeded when they are submitted
+static void evaluateSeeded(cWorld* world, cDeferredPrint* print, int seed)
+{
+  Apto::RNG::AvidaRNG rng(seed);
+  cAvidaContext ctx(&world->GetDriver(), rng);
+  print->Evaluate(ctx);
+}
+
+
+class cDeferredPrintJob : public cAnalyzeJob
+{
+private:
+  cWorld* m_world;
+  cDeferredPrint* m_print;
+  int m_seed;
+
+public:
+  cDeferredPrintJob(cWorld* world, cDeferredPrint* print, int seed) : m_world(world), m_print(print), m_seed(seed) { ; }
+
+  void Run(cAvidaContext&)
+  {
+    // The worker's own RNG is seeded in pickup order, use the seed assigned when the print was added instead
+    evaluateSeeded(m_world, m_print, m_seed);
+  }
+};
+
+
+cDeferredPrintQueue::cDeferredPrintQueue(cWorld* world)
+  : m_world(world)
+  , m_enabled(world->GetConfig().DEFER_TEST_PRINTS.Get())
+  , m_seed_rng(world->GetConfig().RANDOM_SEED.Get())
+  , m_jobs(NULL)
+{
+}
+
+cDeferredPrintQueue::~cDeferredPrintQueue()
+{
+  Flush();
+  delete m_jobs;
+}
+
+
+void cDeferredPrintQueue::Submit(cAvidaContext& ctx, cDeferredPrint* print)
+{
+  if (!m_enabled || ctx.GetAnalyzeMode()) {
+    print->Evaluate(ctx);
+    print->Write();
+    delete print;
+    return;
+  }
+
+  const int seed = m_seed_rng.GetInt(m_seed_rng.MaxSeed());
+
+  // The job queue's own seed only feeds the worker contexts, which the print jobs do not use
+  if (m_jobs == NULL) m_jobs = new cAnalyzeJobQueue(m_world, m_world->GetConfig().RANDOM_SEED.Get());
+
+  m_prints.Push(print);
+
+  // Without worker threads the job queue runs the job right here
+  m_jobs->AddJobImmediate(new cDeferredPrintJob(m_world, print, seed));
+}
+
+void cDeferredPrintQueue::Flush()
+{
+  if (m_prints.GetSize() == 0) return;
+
+  m_jobs->Execute();
+
+  for (int i = 0; i < m_prints.GetSize(); i++) {
+    m_prints[i]->Write();
+    delete m_prints[i];
+  }
+  m_prints.Resize(0);
+}
@@ -0,0 +1,80 @@
+/*
+ *  cDeferredPrintQueue.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cDeferredPrintQueue_h
+#define cDeferredPrintQueue_h
+
+#include "apto/rng.h"
+
+#include "avida/core/Types.h"
+
+class cAnalyzeJobQueue;
+class cAvidaContext;
+class cWorld;
+
+
+// A print action whose test CPU work has been split off from the state it reads.  The action snapshots what it needs
+// from the population when it is processed; Evaluate then runs on an analyze worker thread and must only touch that
+// snapshot plus world state that is fixed during a run (configuration, environment, instruction sets).  Write is
+// called back on the main thread, after every queued evaluation has finished.
+class cDeferredPrint
+{
+public:
+  cDeferredPrint() { ; }
+  virtual ~cDeferredPrint() { ; }
+
+  virtual void Evaluate(cAvidaContext& ctx) = 0;
+  virtual void Write() = 0;
+};
+
+
+// Queue of deferred prints.  Each deferred print is evaluated with its own RNG, seeded from a stream that starts at
+// RANDOM_SEED when it is submitted, so neither the number of worker threads nor their scheduling can change its output,
+// and the world RNG is never drawn from.  Prints that are not deferred draw from the caller's context, as they always
+// have, so a test CPU run that uses random numbers may come out differently in the two modes.  Flush writes the prints
+// in the order they were queued; the event list calls it before any event that is not a deferred print, and cWorld
+// after the events of each update, so the prints never overlap with changes to the world.
+class cDeferredPrintQueue
+{
+private:
+  cWorld* m_world;
+  bool m_enabled;
+  Apto::RNG::AvidaRNG m_seed_rng;
+  cAnalyzeJobQueue* m_jobs;               // created with the first print, so idle runs start no threads
+  Apto::Array<cDeferredPrint*> m_prints;  // awaiting Write, in the order they were added
+
+
+  cDeferredPrintQueue(); // @not_implemented
+  cDeferredPrintQueue(const cDeferredPrintQueue&); // @not_implemented
+  cDeferredPrintQueue& operator=(const cDeferredPrintQueue&); // @not_implemented
+
+public:
+  cDeferredPrintQueue(cWorld* world);
+  ~cDeferredPrintQueue();
+
+  // Takes ownership of print.  With DEFER_TEST_PRINTS set the print is queued for the worker threads, otherwise it is
+  // evaluated and written immediately with ctx, as is every print in analyze mode.
+  void Submit(cAvidaContext& ctx, cDeferredPrint* print);
+
+  // Waits for outstanding evaluations, then writes and releases every print
+  void Flush();
+};
+
+#endif
@@ -37,6 +37,7 @@
 #include "cReactionResult.h" //@JJB**
 #include "cTaskState.h" //@JJB**
 
+#include <algorithm>
 #include <cmath>
 
 
@@ -153,12 +154,15 @@ cDeme& cDeme::operator=(const cDeme& in_deme)
   _germline                           = in_deme._germline;
   cell_events                         = in_deme.cell_events;
   event_slot_end_points               = in_deme.event_slot_end_points;
+  m_event_schedule                    = in_deme.m_event_schedule;
+  m_active_events                     = in_deme.m_active_events;
   m_germline_genotype_id              = in_deme.m_germline_genotype_id;
   m_founder_genotype_ids              = in_deme.m_founder_genotype_ids;
   m_founder_phenotypes                = in_deme.m_founder_phenotypes;
   _current_merit                      = in_deme._current_merit;
   _next_merit                         = in_deme._next_merit;
   deme_pred_list                      = in_deme.deme_pred_list;
+  res_threshold_pred_list             = in_deme.res_threshold_pred_list;
   message_pred_list                   = in_deme.message_pred_list;
   movement_pred_list                  = in_deme.movement_pred_list;
   points                              = in_deme.points;
@@ -340,10 +344,8 @@ void cDeme::ProcessPreUpdate()
 void cDeme::ProcessUpdate(cAvidaContext& ctx)
 {
   // test deme predicate
-  for (int i = 0; i < deme_pred_list.GetSize(); i++) {
-    if (deme_pred_list[i]->GetName() == "cDemeResourceThreshold") {
-      (*deme_pred_list[i])(ctx, &deme_resource_count);
-    }
+  for (int i = 0; i < res_threshold_pred_list.GetSize(); i++) {
+    (*res_threshold_pred_list[i])(ctx, &deme_resource_count);
   }
 
   energyUsage.Clear();
@@ -353,7 +355,11 @@ void cDeme::ProcessUpdate(cAvidaContext& ctx)
     return;
   }
   
-  if (m_world->GetConfig().ENERGY_ENABLED.Get()) {
+  // energy usage is only reported at the end of an event time slot
+  vector<pair<int, int> >::iterator slot_end = event_slot_end_points.begin();
+  while (slot_end != event_slot_end_points.end() && (*slot_end).first != _age) slot_end++;
+  
+  if (slot_end != event_slot_end_points.end() && m_world->GetConfig().ENERGY_ENABLED.Get()) {
     for(int i = 0; i < GetSize(); i++) {
       cPopulationCell& cell = GetCell(i);
       if(cell.IsOccupied()) {
@@ -362,97 +368,50 @@ void cDeme::ProcessUpdate(cAvidaContext& ctx)
     }
   }
   
-  for(int i = 0; i < cell_events.GetSize(); i++) {
-    cDemeCellEvent& event = cell_events[i];
+  // Only events that are already active or that start at this age can change, visit them in index order
+  vector<pair<int, int> >::iterator starting = std::lower_bound(m_event_schedule.begin(), m_event_schedule.end(),
+                                                                 std::make_pair(_age, -1));
+  Apto::Array<int> still_active;
+  int next_active = 0;
+  while (true) {
+    const bool have_active = (next_active < m_active_events.GetSize());
+    const bool have_starting = (starting != m_event_schedule.end() && (*starting).first == _age);
+    if (!have_active && !have_starting) break;
     
-    if(event.IsActive() && event.GetDelay() < _age && _age <= event.GetDelay()+event.GetDuration()) {
-      //remove energy from cells  (should be done with outflow, but this will work for now)
-      int eventCell = event.GetNextEventCellID();
-      cResource* res = m_world->GetEnvironment().GetResourceLib().GetResource("CELL_ENERGY");
-      
-      while(eventCell != -1) {
-        cPopulationCell& cell = m_world->GetPopulation().GetCell(GetCellID(eventCell));
-        if(event.GetEventID() == cell.GetCellData()){
-          if(cell.IsOccupied()) {
-            // remove energy from organism
-            cPhenotype& orgPhenotype = cell.GetOrganism()->GetPhenotype();
-            orgPhenotype.ReduceEnergy(orgPhenotype.GetStoredEnergy()*m_world->GetConfig().ATTACK_DECAY_RATE.Get());
-          }
-          //remove energy from cell... organism might not takeup all of a cell's energy
-          Apto::Array<double> cell_resources = deme_resource_count.GetCellResources(eventCell, ctx);  // uses global cell_id; is this a problem
-          cell_resources[res->GetID()] *= m_world->GetConfig().ATTACK_DECAY_RATE.Get();
-          deme_resource_count.ModifyCell(ctx, cell_resources, eventCell);
-        }
-        eventCell = event.GetNextEventCellID();
-      }
+    int event_idx;
+    if (have_active && (!have_starting || m_active_events[next_active] <= (*starting).second)) {
+      event_idx = m_active_events[next_active++];
+      if (have_starting && (*starting).second == event_idx) starting++;
+    } else {
+      event_idx = (*starting++).second;
     }
     
-    
-    
-    if(!event.IsActive() && event.GetDelay() == _age) {
-      eventsTotal++;
-      event.ActivateEvent(); //start event
-      int eventCell = event.GetNextEventCellID();
-      while(eventCell != -1) {
-        // place event ID in cells' data
-        if(event.IsDecayed()) {
-          m_world->GetPopulation().GetCell(GetCellID(eventCell)).SetCellData(event.GetEventIDDecay(GetCellPosition(eventCell)));
-        } else {
-          m_world->GetPopulation().GetCell(GetCellID(eventCell)).SetCellData(event.GetEventID());
-        }
-        
-        // record activation of each cell in stats
-//        std::pair<int, int> pos = GetCellPosition(eventCell);
-//        m_world->GetStats().IncEventCount(pos.first, pos.second);
-        
-        
-        //TODO // increase outflow of energy from these cells if not event currently present
-        
-        
-        eventCell = event.GetNextEventCellID();
-      }
-    } else if (event.IsActive() && event.GetDelay()+event.GetDuration() == _age) {
-      int eventCell = event.GetNextEventCellID();
-      while (eventCell != -1) {
-        if (event.GetEventID() == m_world->GetPopulation().GetCell(GetCellID(eventCell)).GetCellData()) { // eventID == CellData
-          //set cell data to 0
-          m_world->GetPopulation().GetCell(GetCellID(eventCell)).SetCellData(0);
-          
-          //  TODO // remove energy outflow from these cells
-          
-        }
-        eventCell = event.GetNextEventCellID();
-      }
-      event.DeactivateEvent();  //event over
-    }
+    processCellEvent(ctx, cell_events[event_idx]);
+    if (cell_events[event_idx].IsActive()) still_active.Push(event_idx);
   }
+  m_active_events = still_active;
   
-  for (vector<pair<int, int> >::iterator iter = event_slot_end_points.begin();
-       iter < event_slot_end_points.end();
-       iter++) {
-    if (_age == (*iter).first) {
-      // at end point              
-      if (GetEventsKilledThisSlot() >=
-	 m_world->GetConfig().DEMES_MIM_EVENTS_KILLED_RATIO.Get() * (*iter).second) {
-        consecutiveSuccessfulEventPeriods++;
-      } else {
-        consecutiveSuccessfulEventPeriods = 0;
-      }
-      
-      // update stats.flow_rate_tuples
-      std::map<int, flow_rate_tuple>& flowRateTuples = m_world->GetStats().FlowRateTuples();
-      
-      flowRateTuples[(*iter).second].orgCount.Add(GetOrgCount());
-      flowRateTuples[(*iter).second].eventsKilled.Add(GetEventsKilledThisSlot());
-      flowRateTuples[(*iter).second].attemptsToKillEvents.Add(GetEventKillAttemptsThisSlot());
-      flowRateTuples[(*iter).second].AvgEnergyUsageRatio.Add(energyUsage.Average());
-      flowRateTuples[(*iter).second].totalBirths.Add(birth_count_perslot);
-      flowRateTuples[(*iter).second].currentSleeping.Add(sleeping_count);
-      birth_count_perslot = 0;
-      eventsKilledThisSlot = 0;
-      eventKillAttemptsThisSlot = 0;
-      break;
+  if (slot_end != event_slot_end_points.end()) {
+    // at end point              
+    if (GetEventsKilledThisSlot() >=
+       m_world->GetConfig().DEMES_MIM_EVENTS_KILLED_RATIO.Get() * (*slot_end).second) {
+      consecutiveSuccessfulEventPeriods++;
+    } else {
+      consecutiveSuccessfulEventPeriods = 0;
     }
+    
+    // update stats.flow_rate_tuples
+    std::map<int, flow_rate_tuple>& flowRateTuples = m_world->GetStats().FlowRateTuples();
+    
+    flowRateTuples[(*slot_end).second].orgCount.Add(GetOrgCount());
+    flowRateTuples[(*slot_end).second].eventsKilled.Add(GetEventsKilledThisSlot());
+    flowRateTuples[(*slot_end).second].attemptsToKillEvents.Add(GetEventKillAttemptsThisSlot());
+    flowRateTuples[(*slot_end).second].AvgEnergyUsageRatio.Add(energyUsage.Average());
+    flowRateTuples[(*slot_end).second].totalBirths.Add(birth_count_perslot);
+    flowRateTuples[(*slot_end).second].currentSleeping.Add(sleeping_count);
+    birth_count_perslot = 0;
+    eventsKilledThisSlot = 0;
+    eventKillAttemptsThisSlot = 0;
   }
   ++_age;
 	
@@ -754,14 +713,11 @@ double cDeme::GetCellEnergy(int absolute_cell_id, cAvidaContext& ctx) const
 
   double total_energy = 0.0;
   int relative_cell_id = GetRelativeCellID(absolute_cell_id);
-  Apto::Array<double> cell_resources = deme_resource_count.GetCellResources(relative_cell_id, ctx);
   
   // sum all energy resources
   for (int i = 0; i < energy_res_ids.GetSize(); i++) {
-    if (cell_resources[energy_res_ids[i]] > 0.0) {
-      total_energy += cell_resources[energy_res_ids[i]];
-      cell_resources[energy_res_ids[i]] *= -1.0;
-    }
+    const double energy = deme_resource_count.GetCellResVal(ctx, relative_cell_id, energy_res_ids[i]);
+    if (energy > 0.0) total_energy += energy;
   }
 
   return total_energy;
@@ -774,19 +730,16 @@ double cDeme::GetAndClearCellEnergy(int absolute_cell_id, cAvidaContext& ctx)
   
   double total_energy = 0.0;
   int relative_cell_id = GetRelativeCellID(absolute_cell_id);
-  Apto::Array<double> cell_resources = deme_resource_count.GetCellResources(relative_cell_id, ctx);
   
-  // sum all energy resources
+  // sum all energy resources and set them to zero
   for (int i = 0; i < energy_res_ids.GetSize(); i++) {
-    if (cell_resources[energy_res_ids[i]] > 0.0) {
-      total_energy += cell_resources[energy_res_ids[i]];
-      cell_resources[energy_res_ids[i]] *= -1.0;
+    const double energy = deme_resource_count.GetCellResVal(ctx, relative_cell_id, energy_res_ids[i]);
+    if (energy > 0.0) {
+      total_energy += energy;
+      deme_resource_count.ModifyCell(ctx, energy_res_ids[i], -energy, relative_cell_id);
     }
   }
 
-  // set energy resources to zero
-  deme_resource_count.ModifyCell(ctx, cell_resources, relative_cell_id);
-
   return total_energy;
 }
 
@@ -796,15 +749,13 @@ void cDeme::GiveBackCellEnergy(int absolute_cell_id, double value, cAvidaContext
   assert(absolute_cell_id <= cell_ids[cell_ids.GetSize()-1]);
   
   int relative_cell_id = GetRelativeCellID(absolute_cell_id);
-  Apto::Array<double> cell_resources = deme_resource_count.GetCellResources(relative_cell_id, ctx);
   
   double amount_per_resource = value / energy_res_ids.GetSize();
   
   // put back energy resources evenly
   for(int i = 0; i < energy_res_ids.GetSize(); i++) {
-    cell_resources[energy_res_ids[i]] += amount_per_resource;
+    deme_resource_count.ModifyCell(ctx, energy_res_ids[i], amount_per_resource, relative_cell_id);
   }
-  deme_resource_count.ModifyCell(ctx, cell_resources, relative_cell_id);
 }
 
 void cDeme::SetCellEvent(int x1, int y1, int x2, int y2,
@@ -814,6 +765,7 @@ void cDeme::SetCellEvent(int x1, int y1, int x2, int y2,
     cDemeCellEvent demeEvent = cDemeCellEvent(x1, y1, x2, y2, delay, duration, width, GetHeight(), static_position, this, m_world);
     cell_events.Push(demeEvent);
   }
+  scheduleCellEvents();
 }
 
 /*void cDeme::SetCellEventGradient(int x1, int y1, int x2, int y2, int delay, int duration, bool static_pos, int time_to_live) {
@@ -849,6 +801,7 @@ void cDeme::SetCellEventSlots(int x1, int y1, int x2, int y2, int delay, int dur
       cell_events.Push(demeEvent);
     }
   }
+  scheduleCellEvents();
   
   // setup stats.flow_rate_tuples
   std::map<int, flow_rate_tuple>& flowRateTuples = m_world->GetStats().FlowRateTuples();
@@ -863,13 +816,85 @@ void cDeme::SetCellEventSlots(int x1, int y1, int x2, int y2, int delay, int dur
   }
 }
 
+void cDeme::processCellEvent(cAvidaContext& ctx, cDemeCellEvent& event)
+{
+  if(event.IsActive() && event.GetDelay() < _age && _age <= event.GetDelay()+event.GetDuration()) {
+    //remove energy from cells  (should be done with outflow, but this will work for now)
+    int eventCell = event.GetNextEventCellID();
+    cResource* res = m_world->GetEnvironment().GetResourceLib().GetResource("CELL_ENERGY");
+    
+    while(eventCell != -1) {
+      cPopulationCell& cell = m_world->GetPopulation().GetCell(GetCellID(eventCell));
+      if(event.GetEventID() == cell.GetCellData()){
+        if(cell.IsOccupied()) {
+          // remove energy from organism
+          cPhenotype& orgPhenotype = cell.GetOrganism()->GetPhenotype();
+          orgPhenotype.ReduceEnergy(orgPhenotype.GetStoredEnergy()*m_world->GetConfig().ATTACK_DECAY_RATE.Get());
+        }
+        //remove energy from cell... organism might not takeup all of a cell's energy
+        const double energy = deme_resource_count.GetCellResVal(ctx, eventCell, res->GetID());  // uses global cell_id; is this a problem
+        deme_resource_count.ModifyCell(ctx, res->GetID(), energy * (m_world->GetConfig().ATTACK_DECAY_RATE.Get() - 1.0), eventCell);
+      }
+      eventCell = event.GetNextEventCellID();
+    }
+  }
+  
+  
+  
+  if(!event.IsActive() && event.GetDelay() == _age) {
+    eventsTotal++;
+    event.ActivateEvent(); //start event
+    int eventCell = event.GetNextEventCellID();
+    while(eventCell != -1) {
+      // place event ID in cells' data
+      if(event.IsDecayed()) {
+        m_world->GetPopulation().GetCell(GetCellID(eventCell)).SetCellData(event.GetEventIDDecay(GetCellPosition(eventCell)));
+      } else {
+        m_world->GetPopulation().GetCell(GetCellID(eventCell)).SetCellData(event.GetEventID());
+      }
+      
+      // record activation of each cell in stats
+//        std::pair<int, int> pos = GetCellPosition(eventCell);
+//        m_world->GetStats().IncEventCount(pos.first, pos.second);
+      
+      
+      //TODO // increase outflow of energy from these cells if not event currently present
+      
+      
+      eventCell = event.GetNextEventCellID();
+    }
+  } else if (event.IsActive() && event.GetDelay()+event.GetDuration() == _age) {
+    int eventCell = event.GetNextEventCellID();
+    while (eventCell != -1) {
+      if (event.GetEventID() == m_world->GetPopulation().GetCell(GetCellID(eventCell)).GetCellData()) { // eventID == CellData
+        //set cell data to 0
+        m_world->GetPopulation().GetCell(GetCellID(eventCell)).SetCellData(0);
+        
+        //  TODO // remove energy outflow from these cells
+        
+      }
+      eventCell = event.GetNextEventCellID();
+    }
+    event.DeactivateEvent();  //event over
+  }
+}
+
+void cDeme::scheduleCellEvents()
+{
+  // Event delays are fixed once the events are set up, so they can be ordered once and looked up by age
+  m_event_schedule.clear();
+  for (int i = 0; i < cell_events.GetSize(); i++) m_event_schedule.push_back(std::make_pair(cell_events[i].GetDelay(), i));
+  std::sort(m_event_schedule.begin(), m_event_schedule.end());
+}
+
 bool cDeme::KillCellEvent(const int eventID)
 {
   eventKillAttemptsThisSlot++;
   
   if (eventID <= 0) return false;
-  for( int i = 0; i < cell_events.GetSize(); i++) {
-    cDemeCellEvent& event = cell_events[i];
+  // only events activated by ProcessUpdate can be killed, and those are all in the active list
+  for (int i = 0; i < m_active_events.GetSize(); i++) {
+    cDemeCellEvent& event = cell_events[m_active_events[i]];
     if(event.IsActive() && event.GetEventID() == eventID) {
       // remove event ID from all cells
       int eventCell = event.GetNextEventCellID();
@@ -1043,6 +1068,7 @@ void cDeme::AddDemeResourceThresholdPredicate(cString resourceName, cString comp
   cDemeResourceThresholdPredicate* pred =
     new cDemeResourceThresholdPredicate(resourceName, comparisonOperator, threasholdValue);
   deme_pred_list.Push(pred);
+  res_threshold_pred_list.Push(pred);
 }
 
 void cDeme::AddEventReceivedCenterPred(int times)
@@ -1141,24 +1167,15 @@ void cDeme::AddPheromone(int absolute_cell_id, double value, cAvidaContext& ctx)
   //  cPopulation& pop = m_world->GetPopulation();
   
   int relative_cell_id = GetRelativeCellID(absolute_cell_id);
-  Apto::Array<double> cell_resources = deme_resource_count.GetCellResources(relative_cell_id, ctx);
   
+  // ModifyCell adds the given amount to the cell
   for (int i = 0; i < deme_resource_count.GetSize(); i++) {
     if (strcmp(deme_resource_count.GetResName(i), "pheromone") == 0) {
       // There should only be one "pheromone" resource, so no need to divvy value up
-      cell_resources[i] = value;
-    }
-    else {
-      cell_resources[i] = 0;
+      deme_resource_count.ModifyCell(ctx, i, value, relative_cell_id);
     }
   }
   
-  //It appears that ModifyCell adds the amount of resources specified in the cell_resources array, so I'm just
-  //settign the element to the value I want to add instead of setting the element to the current value plus the amount to add
-  // Ask Ben why he does it differently in GiveBackCellEnergy()
-  
-  deme_resource_count.ModifyCell(ctx, cell_resources, relative_cell_id);
-  
   // CellData-based version
   //const int newval = pop.GetCell(absolute_cell_id).GetCellData() + (int) round(value);
   //pop.GetCell(absolute_cell_id).SetCellData(newval);
@@ -1172,8 +1189,7 @@ double cDeme::GetSpatialResource(int rel_cellid, int resource_id, cAvidaContext&
   assert(resource_id >= 0);
   assert(resource_id < deme_resource_count.GetSize());
   
-  Apto::Array<double> cell_resources = deme_resource_count.GetCellResources(rel_cellid, ctx);
-  return cell_resources[resource_id];
+  return deme_resource_count.GetCellResVal(ctx, rel_cellid, resource_id);
 }
 
 void cDeme::AdjustSpatialResource(cAvidaContext& ctx, int rel_cellid, int resource_id, double amount)
@@ -1183,11 +1199,7 @@ void cDeme::AdjustSpatialResource(cAvidaContext& ctx, int rel_cellid, int resour
   assert(resource_id >= 0);
   assert(resource_id < deme_resource_count.GetSize());
   
-  Apto::Array<double> res_change;
-  res_change.Resize(deme_resource_count.GetSize(), 0);
-  res_change[resource_id] = amount;
-  
-  deme_resource_count.ModifyCell(ctx, res_change, rel_cellid);  
+  deme_resource_count.ModifyCell(ctx, resource_id, amount, rel_cellid);
 }
 
 void cDeme::AdjustResource(cAvidaContext& ctx, int resource_id, double amount)
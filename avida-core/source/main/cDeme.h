@@ -42,6 +42,7 @@ class cOrganism;
 class cOrgMovementPredicate;
 class cOrgMessagePredicate;
 class cDemePredicate;
+class cDemeResourceThresholdPredicate;
 class cReactionResult; //@JJB**
 class cTaskState; //@JJB**
 
@@ -120,6 +121,8 @@ private:
   
   Apto::Array<cDemeCellEvent, Apto::Smart> cell_events;
   std::vector<std::pair<int, int> > event_slot_end_points; // (slot end point, slot flow rate)
+  std::vector<std::pair<int, int> > m_event_schedule; // (activation age, cell event index), sorted
+  Apto::Array<int> m_active_events; // Indices of the cell events left active by the last update, ascending
   
   int         m_germline_genotype_id; // Genotype id of germline (if in use)
   Apto::Array<int> m_founder_genotype_ids; // List of genotype ids used to found deme.
@@ -130,6 +133,7 @@ private:
   cMerit _next_merit; //!< Deme merit that will be inherited upon deme replication.
 
   Apto::Array<cDemePredicate*, Apto::Smart> deme_pred_list; // Deme Predicates
+  Apto::Array<cDemeResourceThresholdPredicate*, Apto::Smart> res_threshold_pred_list; // Subset of deme_pred_list tested each update
   Apto::Array<cOrgMessagePredicate*, Apto::Smart> message_pred_list; // Message Predicates
   Apto::Array<cOrgMovementPredicate*, Apto::Smart> movement_pred_list;  // Movement Predicates
 	
@@ -287,6 +291,10 @@ public:
 
   bool KillCellEvent(const int eventID);
   cDemeCellEvent* GetCellEvent(const int i) { return &cell_events[i]; };
+private:
+  void scheduleCellEvents();
+  void processCellEvent(cAvidaContext& ctx, cDemeCellEvent& event);
+public:
   
   double CalculateTotalEnergy(cAvidaContext& ctx) const; 
   double CalculateTotalInitialEnergyResources() const;
@@ -30,6 +30,7 @@ cDemeCellEvent::cDemeCellEvent(int x1, int y1, int x2, int y2, int delay, int du
   , m_deme_height(deme_height)
   , m_event_width(x2-x1)
   , m_event_height(y2-y1)
+  , m_use_gradient(false)
   , m_active(false)
   , m_static_pos(static_pos)
   , m_dead(false)
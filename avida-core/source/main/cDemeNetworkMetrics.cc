@@ -0,0 +1,216 @@
+/*
+ *  cDemeNetworkMetrics.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cDemeNetworkMetrics.h"
+
+#include <cassert>
+
+
+int cDemeNetworkMetrics::AddVertex()
+{
+  const int u = m_adj.GetSize();
+  m_adj.Resize(u + 1);
+  m_triangles.Push(0);
+  m_component.Push(u);
+  m_num_components++;
+  changeDegree(u, 0);
+  return u;
+}
+
+
+bool cDemeNetworkMetrics::AddEdge(int u, int v)
+{
+  assert(u != v);
+  if (findNeighbor(u, v) >= 0) return false;
+  
+  // Every common neighbor w closes a triangle u-v-w: the new edge lies in w's neighborhood, and w-v (resp. w-u) is
+  // a new edge in u's (resp. v's) neighborhood
+  const int common = countCommonNeighbors(u, v, 1);
+  m_triangles[u] += common;
+  m_triangles[v] += common;
+  
+  changeDegree(u, 1);
+  changeDegree(v, 1);
+  insertNeighbor(u, v);
+  insertNeighbor(v, u);
+  m_num_edges++;
+  
+  if (m_components_valid && joinComponents(u, v)) m_num_components--;
+  return true;
+}
+
+
+bool cDemeNetworkMetrics::RemoveEdge(int u, int v)
+{
+  if (findNeighbor(u, v) < 0) return false;
+  
+  changeDegree(u, -1);
+  changeDegree(v, -1);
+  removeNeighbor(u, v);
+  removeNeighbor(v, u);
+  m_num_edges--;
+  
+  const int common = countCommonNeighbors(u, v, -1);
+  m_triangles[u] -= common;
+  m_triangles[v] -= common;
+  
+  m_components_valid = false;
+  return true;
+}
+
+
+void cDemeNetworkMetrics::ClearVertex(int u)
+{
+  while (m_adj[u].GetSize()) RemoveEdge(u, m_adj[u][m_adj[u].GetSize() - 1]);
+}
+
+
+int cDemeNetworkMetrics::GetNumComponents() const
+{
+  if (!m_components_valid) rebuildComponents();
+  return m_num_components;
+}
+
+
+/*! Same computation, in the same order, as clustering_coefficient() in cDemeNetworkUtils.h, so the results are
+ identical down to the last bit.
+ */
+double cDemeNetworkMetrics::ClusteringCoefficient() const
+{
+  double sum = 0.0;
+  for (int u = 0; u < m_adj.GetSize(); u++) {
+    const int degree = m_adj[u].GetSize();
+    if (degree > 1) sum += (double)m_triangles[u] / (double)(degree * (degree - 1) / 2);
+  }
+  return sum / m_adj.GetSize();
+}
+
+
+int cDemeNetworkMetrics::findNeighbor(int u, int v) const
+{
+  const Apto::Array<int>& adj = m_adj[u];
+  int lo = 0;
+  int hi = adj.GetSize() - 1;
+  while (lo <= hi) {
+    const int mid = (lo + hi) / 2;
+    if (adj[mid] == v) return mid;
+    if (adj[mid] < v) lo = mid + 1;
+    else hi = mid - 1;
+  }
+  return -1;
+}
+
+void cDemeNetworkMetrics::insertNeighbor(int u, int v)
+{
+  Apto::Array<int>& adj = m_adj[u];
+  int pos = adj.GetSize();
+  adj.Push(v);
+  while (pos > 0 && adj[pos - 1] > v) {
+    adj[pos] = adj[pos - 1];
+    pos--;
+  }
+  adj[pos] = v;
+}
+
+void cDemeNetworkMetrics::removeNeighbor(int u, int v)
+{
+  Apto::Array<int>& adj = m_adj[u];
+  const int pos = findNeighbor(u, v);
+  assert(pos >= 0);
+  for (int i = pos + 1; i < adj.GetSize(); i++) adj[i - 1] = adj[i];
+  adj.Pop();
+}
+
+// Walks the common neighbors of u and v, adjusting each one's triangle count by delta, and returns how many there are
+int cDemeNetworkMetrics::countCommonNeighbors(int u, int v, int delta)
+{
+  const Apto::Array<int>& adj_u = m_adj[u];
+  const Apto::Array<int>& adj_v = m_adj[v];
+  int common = 0;
+  int i = 0;
+  int j = 0;
+  while (i < adj_u.GetSize() && j < adj_v.GetSize()) {
+    if (adj_u[i] < adj_v[j]) i++;
+    else if (adj_v[j] < adj_u[i]) j++;
+    else {
+      m_triangles[adj_u[i]] += delta;
+      common++;
+      i++;
+      j++;
+    }
+  }
+  return common;
+}
+
+// Moves u between degree histogram buckets, must be called before its neighbor list changes
+void cDemeNetworkMetrics::changeDegree(int u, int delta)
+{
+  const int old_degree = m_adj[u].GetSize();
+  const int new_degree = old_degree + delta;
+  if (new_degree >= m_degree_count.GetSize()) {
+    const int old_size = m_degree_count.GetSize();
+    m_degree_count.Resize(new_degree + 1);
+    for (int d = old_size; d <= new_degree; d++) m_degree_count[d] = 0;
+  }
+  
+  if (delta == 0) {
+    m_degree_count[new_degree]++;
+    return;
+  }
+  m_degree_count[old_degree]--;
+  m_degree_count[new_degree]++;
+  
+  // Keep the histogram trimmed to the current maximum degree
+  int size = m_degree_count.GetSize();
+  while (size > 1 && m_degree_count[size - 1] == 0) size--;
+  if (size != m_degree_count.GetSize()) m_degree_count.Resize(size);
+}
+
+
+int cDemeNetworkMetrics::findComponent(int u) const
+{
+  while (m_component[u] != u) {
+    m_component[u] = m_component[m_component[u]];
+    u = m_component[u];
+  }
+  return u;
+}
+
+bool cDemeNetworkMetrics::joinComponents(int u, int v) const
+{
+  const int ru = findComponent(u);
+  const int rv = findComponent(v);
+  if (ru == rv) return false;
+  m_component[ru] = rv;
+  return true;
+}
+
+void cDemeNetworkMetrics::rebuildComponents() const
+{
+  m_num_components = m_adj.GetSize();
+  for (int u = 0; u < m_adj.GetSize(); u++) m_component[u] = u;
+  for (int u = 0; u < m_adj.GetSize(); u++) {
+    for (int i = 0; i < m_adj[u].GetSize(); i++) {
+      const int v = m_adj[u][i];
+      if (u < v && joinComponents(u, v)) m_num_components--;
+    }
+  }
+  m_components_valid = true;
+}
@@ -0,0 +1,96 @@
+/*
+ *  cDemeNetworkMetrics.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cDemeNetworkMetrics_h
+#define cDemeNetworkMetrics_h
+
+#include "avida/core/Types.h"
+
+
+/*! Incrementally maintained statistics of an undirected, simple network.
+ 
+ Mirrors the vertices and edges of a cDemeTopologyNetwork in a compact sorted adjacency store and keeps, per vertex,
+ the number of edges among its neighbors (i.e., the triangles it belongs to), along with the degree distribution and
+ the connected components.  Adding or removing an edge (u,v) costs O(d(u) + d(v)); the clustering coefficient is then
+ an O(V) pass instead of the O(V d^2) recount done by clustering_coefficient() in cDemeNetworkUtils.h, and gives
+ exactly the same value.
+ 
+ Components are tracked with a union-find under edge additions; removals mark them stale, and they are rebuilt from
+ the adjacency store the next time they are queried.
+ */
+class cDemeNetworkMetrics
+{
+private:
+  Apto::Array<Apto::Array<int> > m_adj;   //!< Sorted neighbor list of each vertex.
+  Apto::Array<int> m_triangles;           //!< Number of edges among the neighbors of each vertex.
+  Apto::Array<int> m_degree_count;        //!< Number of vertices of each degree.
+  int m_num_edges;
+  
+  mutable Apto::Array<int> m_component;   //!< Union-find parent of each vertex.
+  mutable int m_num_components;
+  mutable bool m_components_valid;
+  
+  
+  cDemeNetworkMetrics(const cDemeNetworkMetrics&); // @not_implemented
+  cDemeNetworkMetrics& operator=(const cDemeNetworkMetrics&); // @not_implemented
+  
+public:
+  cDemeNetworkMetrics() : m_num_edges(0), m_num_components(0), m_components_valid(true) { ; }
+  
+  //! Adds a new, unconnected vertex; vertices are numbered consecutively from 0, like a boost vecS vertex list.
+  int AddVertex();
+  
+  //! Adds the edge u-v; returns false if it already exists.
+  bool AddEdge(int u, int v);
+  
+  //! Removes the edge u-v; returns false if it does not exist.
+  bool RemoveEdge(int u, int v);
+  
+  //! Removes every edge incident to u (the vertex itself remains).
+  void ClearVertex(int u);
+  
+  inline int GetNumVertices() const { return m_adj.GetSize(); }
+  inline int GetNumEdges() const { return m_num_edges; }
+  inline int GetDegree(int u) const { return m_adj[u].GetSize(); }
+  inline int GetTriangles(int u) const { return m_triangles[u]; }
+  inline bool HasEdge(int u, int v) const { return findNeighbor(u, v) >= 0; }
+  
+  //! Number of vertices with degree d.
+  inline int GetDegreeCount(int d) const { return (d < m_degree_count.GetSize()) ? m_degree_count[d] : 0; }
+  inline int GetMaxDegree() const { return m_degree_count.GetSize() - 1; }
+  
+  int GetNumComponents() const;
+  inline bool IsConnected() const { return GetNumComponents() == 1; }
+  
+  double ClusteringCoefficient() const;
+  
+private:
+  int findNeighbor(int u, int v) const;
+  void insertNeighbor(int u, int v);
+  void removeNeighbor(int u, int v);
+  int countCommonNeighbors(int u, int v, int delta);
+  void changeDegree(int u, int delta);
+  
+  int findComponent(int u) const;
+  bool joinComponents(int u, int v) const;
+  void rebuildComponents() const;
+};
+
+#endif
@@ -0,0 +1,161 @@
+/*
+ *  cDemeResourceArena.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cDemeResourceArena.h"
+
+#include "AvidaTools.h"
+#include "cDeme.h"
+#include "cEnvironment.h"
+#include "cResource.h"
+#include "cResourceCount.h"
+#include "cResourceLib.h"
+#include "cSpatialResCount.h"
+#include "cWorld.h"
+
+using namespace AvidaTools;
+
+
+void cDemeResourceArena::Build(cWorld* world, Apto::Array<cDeme>& demes)
+{
+  // Give any grids still attached their own storage back before the block is reallocated
+  for (int d = 0; d < demes.GetSize(); d++) {
+    cResourceCount& res_count = demes[d].GetDemeResources();
+    for (int i = 0; i < res_count.GetSize(); i++) res_count.GetSpatialGrid(i).DetachStorage();
+  }
+
+  m_blocks.Resize(0);
+  m_num_demes = demes.GetSize();
+  m_last_updated = 0;
+  m_steps.Resize(0);
+  if (m_num_demes == 0) return;
+
+  const cResourceLib& resource_lib = world->GetEnvironment().GetResourceLib();
+  int deme_res_index = -1;
+  int total_cells = 0;
+  for (int i = 0; i < resource_lib.GetSize(); i++) {
+    cResource* res = resource_lib.GetResource(i);
+    if (!res->GetDemeResource()) continue;
+    deme_res_index++;
+
+    // Gradient resources move and change shape on their own, they stay with their deme
+    if (res->GetGradient() || !demes[0].GetDemeResourceCount().IsSpatial(deme_res_index)) continue;
+
+    // Every deme must have the same grid for the block to be stepped with one set of flow links
+    const cSpatialResCount& grid = demes[0].GetDemeResources().GetSpatialGrid(deme_res_index);
+    bool same_size = (grid.GetSize() > 0);
+    for (int d = 1; same_size && d < m_num_demes; d++) {
+      same_size = (demes[d].GetDemeResources().GetSpatialGrid(deme_res_index).GetSize() == grid.GetSize());
+    }
+    if (!same_size) continue;
+
+    sBlock block;
+    block.res_id = deme_res_index;
+    block.offset = total_cells;
+    block.num_cells = grid.GetSize();
+
+    block.num_inflow_cells = (grid.inflowY2 - grid.inflowY1 + 1) * (grid.inflowX2 - grid.inflowX1 + 1) * 1.0;
+    for (int y = grid.inflowY1; y <= grid.inflowY2; y++) {
+      for (int x = grid.inflowX1; x <= grid.inflowX2; x++) {
+        block.inflow_cells.Push((Mod(y, grid.world_y) * grid.world_x) + Mod(x, grid.world_x));
+      }
+    }
+    if (grid.outflowX1 != -99 && grid.outflowY1 != -99 && grid.outflowX2 != -99 && grid.outflowY2 != -99) {
+      for (int y = grid.outflowY1; y <= grid.outflowY2; y++) {
+        for (int x = grid.outflowX1; x <= grid.outflowX2; x++) {
+          block.outflow_cells.Push((Mod(y, grid.world_y) * grid.world_x) + Mod(x, grid.world_x));
+        }
+      }
+    }
+    block.has_cell_list = (grid.GetCellListSize() > 0);
+
+    m_blocks.Push(block);
+    total_cells += m_num_demes * block.num_cells;
+  }
+
+  m_amount.ResizeClear(total_cells);
+  m_delta.ResizeClear(total_cells);
+  for (int b = 0; b < m_blocks.GetSize(); b++) {
+    const sBlock& block = m_blocks[b];
+    for (int d = 0; d < m_num_demes; d++) {
+      const int offset = block.offset + d * block.num_cells;
+      demes[d].GetDemeResources().GetSpatialGrid(block.res_id).AttachStorage(&m_amount[offset], &m_delta[offset]);
+    }
+  }
+
+  for (int d = 0; d < m_num_demes; d++) demes[d].GetDemeResources().ShareClock(&m_steps);
+}
+
+
+void cDemeResourceArena::ProcessUpdate(Apto::Array<cDeme>& demes, int update)
+{
+  assert(demes.GetSize() == m_num_demes);
+
+  // Fold the logged steps into each count once per update, so that the log stays one update long
+  for (int d = 0; d < m_num_demes; d++) demes[d].GetDemeResources().RebaseClock();
+  m_steps.Resize(0);
+
+  // Same schedule as the lazy spatial updates in cResourceCount::DoUpdates, but for all demes at once
+  while (update > m_last_updated) {
+    m_last_updated++;
+    for (int b = 0; b < m_blocks.GetSize(); b++) stepBlock(demes, m_blocks[b]);
+  }
+}
+
+
+void cDemeResourceArena::stepBlock(Apto::Array<cDeme>& demes, const sBlock& block)
+{
+  if (block.num_cells == 0) return;
+
+  double* amount = &m_amount[block.offset];
+  double* delta = &m_delta[block.offset];
+  const int num_cells = block.num_cells;
+
+  // Inflow and outflow rates may be changed for a single deme, so they are read from each deme's count
+  for (int d = 0; d < m_num_demes; d++) {
+    const cResourceCount& res_count = demes[d].GetDemeResourceCount();
+    const double* deme_amount = amount + d * num_cells;
+    double* deme_delta = delta + d * num_cells;
+
+    const double inflow = res_count.GetInflowRate(block.res_id) / block.num_inflow_cells;
+    for (int i = 0; i < block.inflow_cells.GetSize(); i++) deme_delta[block.inflow_cells[i]] += inflow;
+
+    const double decay = res_count.GetDecayRate(block.res_id);
+    for (int i = 0; i < block.outflow_cells.GetSize(); i++) {
+      const int cell = block.outflow_cells[i];
+      deme_delta[cell] -= Apto::Max((deme_amount[cell] * (1.0 - decay)), 0.0);
+    }
+
+    if (block.has_cell_list) {
+      cSpatialResCount& grid = demes[d].GetDemeResources().GetSpatialGrid(block.res_id);
+      grid.CellInflow();
+      grid.CellOutflow();
+    }
+  }
+
+  // Diffusion and gravity settings come from the resource definition, so one grid's links serve every deme
+  const cSpatialResCount& grid = demes[0].GetDemeResources().GetSpatialGrid(block.res_id);
+  for (int d = 0; d < m_num_demes; d++) grid.flowCells(amount + d * num_cells, delta + d * num_cells);
+
+  const int block_size = m_num_demes * num_cells;
+  for (int i = 0; i < block_size; i++) {
+    amount[i] += delta[i];
+    delta[i] = 0.0;
+  }
+}
@@ -0,0 +1,75 @@
+/*
+ *  cDemeResourceArena.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cDemeResourceArena_h
+#define cDemeResourceArena_h
+
+#include "avida/core/Types.h"
+
+class cDeme;
+class cWorld;
+
+
+// Shared storage and stepping for the resources of every deme.  The cell grids of the plain spatial deme resources
+// (not gradients) are attached to one contiguous block, laid out resource by resource and deme by deme, and are
+// stepped once per update by a single pass over the block instead of lazily by each deme's cResourceCount.  The
+// arena also keeps one log of the update time steps for all deme resource counts, so that a CPU cycle advances every
+// deme at once.  Each count replays the log lazily, adding the steps one by one just as cResourceCount::Update does.
+class cDemeResourceArena
+{
+private:
+  struct sBlock
+  {
+    int res_id;                         // deme resource id
+    int offset;                         // first cell of the block in m_amount/m_delta
+    int num_cells;                      // cells per deme
+    Apto::Array<int> inflow_cells;      // cells of the inflow rectangle, in cSpatialResCount::Source order
+    double num_inflow_cells;            // size of the inflow rectangle as used by Source
+    Apto::Array<int> outflow_cells;     // cells of the outflow rectangle, empty if there is no outflow
+    bool has_cell_list;
+  };
+
+  Apto::Array<sBlock> m_blocks;
+  Apto::Array<double> m_amount;
+  Apto::Array<double> m_delta;
+  int m_num_demes;
+  int m_last_updated;
+  Apto::Array<double, Apto::Smart> m_steps;
+
+
+  cDemeResourceArena(const cDemeResourceArena&); // @not_implemented
+  cDemeResourceArena& operator=(const cDemeResourceArena&); // @not_implemented
+
+public:
+  cDemeResourceArena() : m_num_demes(0), m_last_updated(0) { ; }
+
+  // (Re)attaches the deme resource counts, must be called whenever they are set up again
+  void Build(cWorld* world, Apto::Array<cDeme>& demes);
+
+  void Update(double step_size) { m_steps.Push(step_size); }
+  void ProcessUpdate(Apto::Array<cDeme>& demes, int update);
+
+  int GetNumAttached() const { return m_blocks.GetSize(); }
+
+private:
+  void stepBlock(Apto::Array<cDeme>& demes, const sBlock& block);
+};
+
+#endif
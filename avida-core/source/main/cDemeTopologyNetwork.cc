@@ -76,10 +76,21 @@ bool cDemeTopologyNetwork::edge_decayed::operator()(Network::edge_descriptor e)
  */
 void cDemeTopologyNetwork::ProcessUpdate() {
 	if((m_world->GetConfig().DEME_NETWORK_LINK_DECAY.Get() != 0) && (boost::num_edges(m_network)>0)) {
-		boost::remove_edge_if(edge_decayed(m_world->GetStats().GetUpdate(),
-																			 m_world->GetConfig().DEME_NETWORK_LINK_DECAY.Get(),
-																			 m_network),
-													m_network);
+		edge_decayed decayed(m_world->GetStats().GetUpdate(), m_world->GetConfig().DEME_NETWORK_LINK_DECAY.Get(), m_network);
+		
+		// collect the decayed edges first, so that they can be removed from both the network and the metrics:
+		std::vector<std::pair<Network::vertex_descriptor,Network::vertex_descriptor> > removed;
+		Network::edge_iterator ei,ei_end;
+		for(boost::tie(ei,ei_end)=boost::edges(m_network); ei!=ei_end; ++ei) {
+			if(decayed(*ei)) {
+				removed.push_back(std::make_pair(boost::source(*ei, m_network), boost::target(*ei, m_network)));
+			}
+		}
+		
+		for(std::size_t i=0; i<removed.size(); ++i) {
+			boost::remove_edge(removed[i].first, removed[i].second, m_network);
+			m_metrics.RemoveEdge(removed[i].first, removed[i].second);
+		}
 	}
 }
 
@@ -92,6 +103,7 @@ void cDemeTopologyNetwork::OrganismDeath(cPopulationCell& u) {
 		if(ui!=m_cv.end()) {
 			// it would be nice if this worked generally:
 			boost::clear_vertex(ui->second, m_network);
+			m_metrics.ClearVertex(ui->second);
 			// but, warning: this can trigger a double-delete bug if there are self-loops.
 			
 			// it would also be nice to do this:
@@ -114,17 +126,9 @@ void cDemeTopologyNetwork::Connect(cPopulationCell& u, cPopulationCell& v, doubl
 		return;
 	}
 	
-	// find or create the vertex for u
-	CellVertexMap::iterator ui=m_cv.find(u.GetID());
-	if(ui==m_cv.end()) {
-		ui = m_cv.insert(std::make_pair(u.GetID(), boost::add_vertex(vertex_properties(u.GetPosition(), u.GetID()), m_network))).first;
-	}
-	
-	// find or create the vertex for v
-	CellVertexMap::iterator vi=m_cv.find(v.GetID());
-	if(vi==m_cv.end()) {
-		vi = m_cv.insert(std::make_pair(v.GetID(), boost::add_vertex(vertex_properties(v.GetPosition(), v.GetID()), m_network))).first;
-	}
+	// find or create the vertices for u and v
+	CellVertexMap::iterator ui=FindOrAddVertex(u);
+	CellVertexMap::iterator vi=FindOrAddVertex(v);
 	
 	// sanity
 	assert(ui->second != vi->second);
@@ -134,6 +138,7 @@ void cDemeTopologyNetwork::Connect(cPopulationCell& u, cPopulationCell& v, doubl
 	if(!e.second) {
 		// create the edge
 		boost::add_edge(ui->second, vi->second, edge_properties(m_world->GetStats().GetUpdate()), m_network);
+		m_metrics.AddEdge(ui->second, vi->second);
 		// we have to track link lengths here in order to bypass a bug that's triggered when
 		// links decay.  if links decay, the network could actually have dissipated by the time
 		// we get around to calculating fitness.
@@ -145,6 +150,21 @@ void cDemeTopologyNetwork::Connect(cPopulationCell& u, cPopulationCell& v, doubl
 }
 
 
+/*! Find or create the vertex for the given cell.
+ */
+cDemeTopologyNetwork::CellVertexMap::iterator cDemeTopologyNetwork::FindOrAddVertex(cPopulationCell& u) {
+	CellVertexMap::iterator ui=m_cv.find(u.GetID());
+	if(ui==m_cv.end()) {
+		ui = m_cv.insert(std::make_pair(u.GetID(), boost::add_vertex(vertex_properties(u.GetPosition(), u.GetID()), m_network))).first;
+		// vecS vertex descriptors are consecutive indices, as are the metrics' vertices:
+		int mv = m_metrics.AddVertex();
+		assert(static_cast<std::size_t>(mv) == ui->second);
+		(void)mv;
+	}
+	return ui;
+}
+
+
 /*! Broadcast a message to connected cells.
  */
 void cDemeTopologyNetwork::BroadcastToNeighbors(cPopulationCell& s, cOrgMessage& msg, cPopulationInterface* pop_interface) {
@@ -236,8 +256,8 @@ double cDemeTopologyNetwork::Fitness(bool record_stats) const {
 	bool calc_fitness=true; // are we going to calculate fitness or not?
 	cStats::network_stats_t stats; // stats that we'll use for fitness
 	
-	stats[E] = boost::num_edges(m_network);
-	stats[V] = boost::num_vertices(m_network);
+	stats[E] = m_metrics.GetNumEdges();
+	stats[V] = m_metrics.GetNumVertices();
 	
 	// Are we requiring connectedness before fitness is calculated?
 	if(m_world->GetConfig().DEME_NETWORK_REQUIRES_CONNECTEDNESS.Get()) {
@@ -251,7 +271,7 @@ double cDemeTopologyNetwork::Fitness(bool record_stats) const {
 		
 		// short-circuit if we're not connected:
 		if(stats[COMPLETE] == 1.0) {
-			stats[CONNECTED] = network_is_connected(m_network) ? 1.0 : 0.0;
+			stats[CONNECTED] = m_metrics.IsConnected() ? 1.0 : 0.0;
 		} else {
 			stats[CONNECTED] = 0.0;
 			calc_fitness = false;
@@ -262,7 +282,7 @@ double cDemeTopologyNetwork::Fitness(bool record_stats) const {
 		case MIN_CPL: { stats[CPL] = calc_fitness ? characteristic_path_length(m_network) : 0.0; break; }
 		case MAX_CC: 
 		case MIN_CC:
-		case TGT_CC: { stats[CC] = calc_fitness ? clustering_coefficient(m_network) : 0.0; break; }
+		case TGT_CC: { stats[CC] = calc_fitness ? m_metrics.ClusteringCoefficient() : 0.0; break; }
 		case LENGTH_SUM: { stats[LINK_LENGTH_SUM] = calc_fitness ? m_link_length_sum : 0.0; break; }
 		default: {
 			m_world->GetDriver().RaiseFatalException(-1, "Unrecognized network fitness type in cDemeTopologyNetwork::Fitness().");
@@ -311,8 +331,8 @@ double cDemeTopologyNetwork::Fitness(bool record_stats) const {
 cStats::network_stats_t cDemeTopologyNetwork::Measure() const {
 	cStats::network_stats_t stats;
 	
-	stats[E] = boost::num_edges(m_network);
-	stats[V] = boost::num_vertices(m_network);
+	stats[E] = m_metrics.GetNumEdges();
+	stats[V] = m_metrics.GetNumVertices();
 	
 	if(stats[V] >= (std::size_t)m_deme.GetSize()) {
 		stats[COMPLETE] = 1.0;
@@ -321,14 +341,14 @@ cStats::network_stats_t cDemeTopologyNetwork::Measure() const {
 	}
 	
 	if(stats[COMPLETE] == 1.0) {
-		stats[CONNECTED] = network_is_connected(m_network) ? 1.0 : 0.0;
+		stats[CONNECTED] = m_metrics.IsConnected() ? 1.0 : 0.0;
 	} else {
 		stats[CONNECTED] = 0.0;
 	}
 	
 	if(stats[CONNECTED] == 1.0) {
 		stats[CPL] = characteristic_path_length(m_network);
-		stats[CC] = clustering_coefficient(m_network);
+		stats[CC] = m_metrics.ClusteringCoefficient();
 		stats[LINK_LENGTH_SUM] = m_link_length_sum;
 	} else {
 		stats[CPL] = 0.0;
@@ -31,6 +31,7 @@
 #include <vector>
 
 #include "cDemeNetwork.h"
+#include "cDemeNetworkMetrics.h"
 
 class cDeme;
 class cWorld;
@@ -121,7 +122,11 @@ protected:
 	//! Ensure that the active edge of the given vertex is valid.
 	bool ActivateEdge(Network::vertex_descriptor u);
 	
+	//! Find or create the vertex for the given cell.
+	CellVertexMap::iterator FindOrAddVertex(cPopulationCell& u);
+	
 	Network m_network; //!< Underlying network model.
+	cDemeNetworkMetrics m_metrics; //!< Incrementally maintained statistics of m_network; must see every edge change.
 	CellVertexMap m_cv; //!< Map of cell ids to vertex descriptors.
 	double m_link_length_sum; //!< Sum of all link lengths, at connection.
 	
@@ -53,7 +53,7 @@ using namespace Avida;
 
 cEnvironment::cEnvironment(cWorld* world) : m_world(world) , m_tasklib(world),
 m_input_size(INPUT_SIZE_DEFAULT), m_output_size(OUTPUT_SIZE_DEFAULT), m_true_rand(false),
-m_use_specific_inputs(false), m_specific_inputs(), m_mask(0), m_hammers(false), m_paths(false)
+m_use_specific_inputs(false), m_specific_inputs(), m_mask(0), m_hammers(false), m_paths(false), m_signature(0)
 {
   mut_rates.Setup(world);
   if (m_world->GetConfig().DEFAULT_GROUP.Get() != -1) possible_group_ids.insert(m_world->GetConfig().DEFAULT_GROUP.Get());
@@ -1136,6 +1136,7 @@ bool cEnvironment::LoadLine(cString line, Feedback& feedback)
 /* Routine to read in a line from the enviroment file and hand that line
  line to the approprate routine to process it.                         */
 {
+  m_signature++;
   cString type = line.PopWord();      // Determine type of this entry.
   type.ToUpper();                     // Make type case insensitive.
 
@@ -1811,6 +1812,7 @@ double cEnvironment::GetReactionValue(int reaction_id)
 
 bool cEnvironment::SetReactionValue(cAvidaContext& ctx, const cString& name, double value)
 {
+  m_signature++;
   const int num_reactions = reaction_lib.GetSize();
 
   // See if this should be applied to all reactions.
@@ -1852,6 +1854,7 @@ bool cEnvironment::SetReactionValue(cAvidaContext& ctx, const cString& name, dou
 
 bool cEnvironment::SetReactionValueMult(const cString& name, double value_mult)
 {
+  m_signature++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   found_reaction->MultiplyValue(value_mult);
@@ -1860,6 +1863,7 @@ bool cEnvironment::SetReactionValueMult(const cString& name, double value_mult)
 
 bool cEnvironment::SetReactionInst(const cString& name, cString inst_name)
 {
+  m_signature++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   found_reaction->ModifyInst(inst_name);
@@ -1868,6 +1872,7 @@ bool cEnvironment::SetReactionInst(const cString& name, cString inst_name)
 
 bool cEnvironment::SetReactionMinTaskCount(const cString& name, int min_count)
 {
+  m_signature++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   return found_reaction->SetMinTaskCount( min_count );
@@ -1875,6 +1880,7 @@ bool cEnvironment::SetReactionMinTaskCount(const cString& name, int min_count)
 
 bool cEnvironment::SetReactionMaxTaskCount(const cString& name, int max_count)
 {
+  m_signature++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   return found_reaction->SetMaxTaskCount( max_count );
@@ -1882,6 +1888,7 @@ bool cEnvironment::SetReactionMaxTaskCount(const cString& name, int max_count)
 
 bool cEnvironment::SetReactionMinCount(const cString& name, int reaction_min_count)
 {
+  m_signature++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   return found_reaction->SetMinReactionCount( reaction_min_count );
@@ -1889,6 +1896,7 @@ bool cEnvironment::SetReactionMinCount(const cString& name, int reaction_min_cou
 
 bool cEnvironment::SetReactionMaxCount(const cString& name, int reaction_max_count)
 {
+  m_signature++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   return found_reaction->SetMaxReactionCount( reaction_max_count );
@@ -1896,6 +1904,7 @@ bool cEnvironment::SetReactionMaxCount(const cString& name, int reaction_max_cou
 
 bool cEnvironment::SetReactionTask(const cString& name, const cString& task)
 {
+  m_signature++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
 
@@ -1913,6 +1922,7 @@ bool cEnvironment::SetReactionTask(const cString& name, const cString& task)
 
 bool cEnvironment::SetResourceInflow(const cString& name, double _inflow )
 {
+  m_signature++;
   cResource* found_resource = resource_lib.GetResource(name);
   if (found_resource == NULL) return false;
   found_resource->SetInflow( _inflow );
@@ -1921,6 +1931,7 @@ bool cEnvironment::SetResourceInflow(const cString& name, double _inflow )
 
 bool cEnvironment::SetResourceOutflow(const cString& name, double _outflow )
 {
+  m_signature++;
   cResource* found_resource = resource_lib.GetResource(name);
   if (found_resource == NULL) return false;
   found_resource->SetOutflow( _outflow );
@@ -1929,6 +1940,7 @@ bool cEnvironment::SetResourceOutflow(const cString& name, double _outflow )
 
 bool cEnvironment::ChangeResource(cReaction* reaction, const cString& res, int process_num)
 {
+  m_signature++;
   cReactionProcess* process = reaction->GetProcess(process_num);
   process->SetResource(m_world->GetEnvironment().GetResourceLib().GetResource(res));
   return true;
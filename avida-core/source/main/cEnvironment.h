@@ -83,6 +83,8 @@ private:
   bool m_hammers;
   bool m_paths;
   
+  int m_signature;  // Incremented whenever the environment definition changes
+  
   cEnvironment(); // @not_implemented
   cEnvironment(const cEnvironment&); // @not_implemented
   cEnvironment& operator=(const cEnvironment&); // @not_implemented
@@ -96,8 +98,8 @@ public:
 
   // Interaction with the organisms
   void SetupInputs(cAvidaContext& ctx, Apto::Array<int>& input_array, bool random = true) const;
-  void SetSpecificInputs(const Apto::Array<int> in_input_array) { m_use_specific_inputs = true; m_specific_inputs = in_input_array; }
-  void SetSpecificRandomMask(unsigned int mask) { m_mask = mask; }
+  void SetSpecificInputs(const Apto::Array<int> in_input_array) { m_use_specific_inputs = true; m_specific_inputs = in_input_array; m_signature++; }
+  void SetSpecificRandomMask(unsigned int mask) { m_mask = mask; m_signature++; }
   void SwapInputs(cAvidaContext& ctx, Apto::Array<int>& src_input_array, Apto::Array<int>& dest_input_array) const;
 
 
@@ -133,6 +135,9 @@ public:
 
   int GetInputSize()  const { return m_input_size; };
   int GetOutputSize() const { return m_output_size; };
+  
+  // Changes whenever reactions, resources or inputs are redefined; used to key cached test CPU results
+  int GetSignature() const { return m_signature; }
 
   const cString& GetReactionName(int reaction_id) const;
   double GetReactionValue(const cString& name);
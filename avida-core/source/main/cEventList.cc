@@ -25,6 +25,7 @@
 #include "avida/Avida.h"
 
 #include "cActionLibrary.h"
+#include "cDeferredPrintQueue.h"
 #include "cInitFile.h"
 #include "cStats.h"
 #include "cString.h"
@@ -42,6 +43,12 @@ const double cEventList::TRIGGER_ALL = 0.0;
 const double cEventList::TRIGGER_ONCE = DBL_MAX;
 
 
+cEventList::cEventList(cWorld* world)
+  : m_world(world), m_head(NULL), m_tail(NULL), m_num_events(0), m_next_seq(0)
+{
+  for (int i = 0; i < NUM_QUEUES; i++) m_last_trigger[i] = -DBL_MAX;
+}
+
 cEventList::~cEventList()
 {
   cEventListEntry* current = NULL;
@@ -60,6 +67,7 @@ bool cEventList::AddEvent(eTriggerType trigger, double start, double interval,
   
   if (action != NULL) {
     cEventListEntry* entry = new cEventListEntry(action, name, trigger, start, interval, stop);
+    entry->SetSeq(m_next_seq++);
     
     // If there are no events in the list yet.
     if (m_tail == NULL) {
@@ -73,7 +81,7 @@ bool cEventList::AddEvent(eTriggerType trigger, double start, double interval,
       m_tail = entry;
     }
     
-    SyncEvent(entry);
+    if (SyncEvent(entry)) enqueue(entry);
 		
 		if (trigger == BIRTHS_INTERRUPT)  //Operates outside of usual event processing
 			QueueBirthInterruptEvent(start);
@@ -107,6 +115,8 @@ void cEventList::Delete(cEventListEntry* entry)
 {
   assert(entry != NULL);
   
+  unqueue(entry);
+  
   if (entry->GetPrev() != NULL) {
     entry->GetPrev()->SetNext(entry->GetNext());
   } else {
@@ -149,34 +159,48 @@ double cEventList::GetTriggerValue(eTriggerType trigger) const
 }
 
 
+void cEventList::processAction(cAvidaContext& ctx, cAction* action)
+{
+  // Deferred prints may only overlap with other prints, anything else could change the world they are reading
+  if (!action->IsDeferredPrint()) m_world->GetDeferredPrints().Flush();
+  action->Process(ctx);
+}
+
+
 void cEventList::Process(cAvidaContext& ctx)
 {
-  double t_val = 0; // trigger value
+  // A trigger value that has fallen since the last update may bring parked entries back into range
+  for (int q = QUEUE_UPDATE; q < NUM_QUEUES; q++) {
+    if (m_queue[q].GetSize() == 0 && m_parked[q].GetSize() == 0) continue;
+    const double t_val = GetTriggerValue((q == QUEUE_UPDATE) ? UPDATE : (q == QUEUE_GENERATION) ? GENERATION : BIRTHS);
+    if (t_val < m_last_trigger[q]) unpark(q);
+    m_last_trigger[q] = t_val;
+  }
   
-  // Iterate through all entrys in event list
-  cEventListEntry* entry = m_head;
-  while (entry != NULL) {
-    cEventListEntry* next_entry = entry->GetNext();
-    
-    // Check trigger condition
+  // Pull every entry that is due, then process them in list order, just as a walk of the whole list would
+  Apto::Array<cEventListEntry*, Apto::Smart> due;
+  Apto::Array<cEventListEntry*, Apto::Smart> deferred;
+  Apto::Array<cEventListEntry*, Apto::Smart> requeue;
+  for (int q = 0; q < NUM_QUEUES; q++) collectDue(q, -1, due, 0, deferred);
+  
+  for (int i = 0; i < due.GetSize(); i++) {
+    cEventListEntry* entry = due[i];
+    const int seq = entry->GetSeq();
     
     // IMMEDIATE Events always happen and are always deleted
     if (entry->GetTrigger() == IMMEDIATE) {
-      entry->GetAction()->Process(ctx);
+      processAction(ctx, entry->GetAction());
       Delete(entry);
-    } else if (entry->GetTrigger() != BIRTHS_INTERRUPT) {
-      //BIRTHS_INTERRUPT occur outside of update boundaries
-	  //and should not alter the behavior of other events.
-	  
-	  // Get the value of the appropriate trigger varile
-      t_val = GetTriggerValue(entry->GetTrigger());
+    } else {
+      // Get the value of the appropriate trigger varile
+      double t_val = GetTriggerValue(entry->GetTrigger());
       
       if (t_val != DBL_MAX &&
           (t_val >= entry->GetStart() || entry->GetStart() == TRIGGER_BEGIN) &&
           (t_val <= entry->GetStop() || entry->GetStop() == TRIGGER_END)) {
 
         // Process the Action
-        entry->GetAction()->Process(ctx);
+        processAction(ctx, entry->GetAction());
         
         // Handle Interval Adjustment
         if (entry->GetInterval() == TRIGGER_ALL) {
@@ -193,12 +217,25 @@ void cEventList::Process(cAvidaContext& ctx)
         // If the event can never happen now... excize it
         if (entry != NULL && entry->GetStop() != TRIGGER_END &&
             ((entry->GetStart() > entry->GetStop() && entry->GetInterval() > 0) ||
-             (entry->GetStart() < entry->GetStop() && entry->GetInterval() < 0)))
-            Delete(entry);
+             (entry->GetStart() < entry->GetStop() && entry->GetInterval() < 0))) {
+          Delete(entry);
+          entry = NULL;
+        }
+        
+        if (entry != NULL) requeue.Push(entry);
+      } else if (t_val != DBL_MAX && entry->GetStop() != TRIGGER_END && t_val > entry->GetStop()) {
+        park(entry);
+      } else {
+        requeue.Push(entry);
       }
-    } 
-    entry = next_entry;
+    }
+    
+    // The action may have moved trigger values or added events, pick up anything later in the list that is now due
+    for (int q = 0; q < NUM_QUEUES; q++) collectDue(q, seq, due, i + 1, deferred);
   }
+  
+  for (int i = 0; i < requeue.GetSize(); i++) enqueue(requeue[i]);
+  for (int i = 0; i < deferred.GetSize(); i++) enqueue(deferred[i]);
 }
 
 
@@ -232,7 +269,7 @@ void cEventList::ProcessInterrupt(cAvidaContext& ctx)
 			if (t_val == entry->GetStart() ) {  //This event *must* happen at this value
 				
 				// Process the Action
-				entry->GetAction()->Process(ctx);
+				processAction(ctx, entry->GetAction());
 				
 				// Handle Interval Adjustment
 				if (entry->GetInterval() == TRIGGER_ALL) {
@@ -259,6 +296,9 @@ void cEventList::ProcessInterrupt(cAvidaContext& ctx)
 		} 
 		entry = next_entry;
 	}
+	
+	// The update resumes after the interrupt, so any prints it queued have to be finished here
+	m_world->GetDeferredPrints().Flush();
 }
 
 
@@ -268,29 +308,32 @@ void cEventList::Sync()
   cEventListEntry* next_entry;
   while (entry != NULL) {
     next_entry = entry->GetNext();
-    SyncEvent(entry);
+    unqueue(entry);
+    if (SyncEvent(entry)) enqueue(entry);
     entry = next_entry;
   }
+  for (int i = 0; i < NUM_QUEUES; i++) m_last_trigger[i] = -DBL_MAX;
 }
 
 
-void cEventList::SyncEvent(cEventListEntry* entry)
+// Returns false if the entry was removed
+bool cEventList::SyncEvent(cEventListEntry* entry)
 {
   // Ignore events that are immdeiate
-  if (entry->GetTrigger() == IMMEDIATE) return;
+  if (entry->GetTrigger() == IMMEDIATE) return true;
   
   double t_val = GetTriggerValue(entry->GetTrigger());
   
   // If t_val has past the end, remove (even if it is TRIGGER_ALL)
   if (t_val > entry->GetStop()) {
     Delete(entry);
-    return;
+    return false;
   }
   
   // If it is a trigger once and has passed, remove
   if (t_val > entry->GetStart() && entry->GetInterval() == TRIGGER_ONCE) {
     Delete(entry);
-    return;
+    return false;
   }
   
   // If for some reason t_val has been reset or soemthing, rewind
@@ -299,10 +342,153 @@ void cEventList::SyncEvent(cEventListEntry* entry)
   }
   
   // Can't fast forward events that are Triger All
-  if (entry->GetInterval() == TRIGGER_ALL) return;
+  if (entry->GetInterval() == TRIGGER_ALL) return true;
   
   // Keep adding interval to start until we are caught up
   while (t_val > entry->GetStart()) entry->NextInterval();
+  return true;
+}
+
+
+int cEventList::queueFor(eTriggerType trigger)
+{
+  switch (trigger) {
+    case IMMEDIATE:   return QUEUE_IMMEDIATE;
+    case UPDATE:      return QUEUE_UPDATE;
+    case GENERATION:  return QUEUE_GENERATION;
+    case BIRTHS:      return QUEUE_BIRTHS;
+    default:          return -1;  // BIRTHS_INTERRUPT is handled by ProcessInterrupt, UNDEFINED never fires
+  }
+}
+
+double cEventList::queueKey(const cEventListEntry* entry)
+{
+  if (entry->GetTrigger() == IMMEDIATE || entry->GetStart() == TRIGGER_BEGIN) return -DBL_MAX;
+  return entry->GetStart();
+}
+
+bool cEventList::queueBefore(const cEventListEntry* a, const cEventListEntry* b)
+{
+  const double a_key = queueKey(a);
+  const double b_key = queueKey(b);
+  return (a_key < b_key || (a_key == b_key && a->GetSeq() < b->GetSeq()));
+}
+
+void cEventList::enqueue(cEventListEntry* entry)
+{
+  const int q = queueFor(entry->GetTrigger());
+  if (q < 0) return;
+  
+  Apto::Array<cEventListEntry*, Apto::Smart>& heap = m_queue[q];
+  heap.Push(entry);
+  entry->SetQueuePos(heap.GetSize() - 1);
+  siftUp(heap, heap.GetSize() - 1);
+}
+
+void cEventList::unqueue(cEventListEntry* entry)
+{
+  const int pos = entry->GetQueuePos();
+  if (pos < 0) return;
+  
+  const int q = queueFor(entry->GetTrigger());
+  Apto::Array<cEventListEntry*, Apto::Smart>& entries = (entry->IsParked()) ? m_parked[q] : m_queue[q];
+  assert(entries[pos] == entry);
+  
+  const int last = entries.GetSize() - 1;
+  if (pos != last) {
+    entries[pos] = entries[last];
+    entries[pos]->SetQueuePos(pos, entry->IsParked());
+  }
+  entries.Pop();
+  if (!entry->IsParked() && pos != last) {
+    if (pos > 0 && queueBefore(entries[pos], entries[(pos - 1) / 2])) siftUp(entries, pos);
+    else siftDown(entries, pos);
+  }
+  entry->SetQueuePos(-1);
+}
+
+void cEventList::park(cEventListEntry* entry)
+{
+  const int q = queueFor(entry->GetTrigger());
+  assert(q >= 0 && entry->GetQueuePos() < 0);
+  m_parked[q].Push(entry);
+  entry->SetQueuePos(m_parked[q].GetSize() - 1, true);
+}
+
+void cEventList::unpark(int queue)
+{
+  Apto::Array<cEventListEntry*, Apto::Smart> parked = m_parked[queue];
+  m_parked[queue].Resize(0);
+  for (int i = 0; i < parked.GetSize(); i++) {
+    parked[i]->SetQueuePos(-1);
+    enqueue(parked[i]);
+  }
+}
+
+void cEventList::siftUp(Apto::Array<cEventListEntry*, Apto::Smart>& heap, int pos)
+{
+  cEventListEntry* entry = heap[pos];
+  while (pos > 0) {
+    const int parent = (pos - 1) / 2;
+    if (!queueBefore(entry, heap[parent])) break;
+    heap[pos] = heap[parent];
+    heap[pos]->SetQueuePos(pos);
+    pos = parent;
+  }
+  heap[pos] = entry;
+  entry->SetQueuePos(pos);
+}
+
+void cEventList::siftDown(Apto::Array<cEventListEntry*, Apto::Smart>& heap, int pos)
+{
+  const int size = heap.GetSize();
+  if (pos >= size) return;
+  
+  cEventListEntry* entry = heap[pos];
+  while (true) {
+    int child = pos * 2 + 1;
+    if (child >= size) break;
+    if (child + 1 < size && queueBefore(heap[child + 1], heap[child])) child++;
+    if (!queueBefore(heap[child], entry)) break;
+    heap[pos] = heap[child];
+    heap[pos]->SetQueuePos(pos);
+    pos = child;
+  }
+  heap[pos] = entry;
+  entry->SetQueuePos(pos);
+}
+
+// Moves every entry of the queue whose key has been reached into due (kept sorted by list order from index first on)
+// if it lies after after_seq in the list, or into deferred otherwise
+void cEventList::collectDue(int queue, int after_seq, Apto::Array<cEventListEntry*, Apto::Smart>& due, int first,
+                            Apto::Array<cEventListEntry*, Apto::Smart>& deferred)
+{
+  Apto::Array<cEventListEntry*, Apto::Smart>& heap = m_queue[queue];
+  if (heap.GetSize() == 0) return;
+  
+  double t_val = TRIGGER_BEGIN;
+  if (queue == QUEUE_UPDATE) t_val = GetTriggerValue(UPDATE);
+  else if (queue == QUEUE_GENERATION) t_val = GetTriggerValue(GENERATION);
+  else if (queue == QUEUE_BIRTHS) t_val = GetTriggerValue(BIRTHS);
+  if (t_val == DBL_MAX) return;
+  
+  while (heap.GetSize() && queueKey(heap[0]) <= t_val) {
+    cEventListEntry* entry = heap[0];
+    unqueue(entry);
+    
+    if (entry->GetSeq() <= after_seq) {
+      deferred.Push(entry);
+      continue;
+    }
+    
+    int pos = due.GetSize();
+    due.Push(entry);
+    while (pos > first && due[pos - 1]->GetSeq() > entry->GetSeq()) {
+      due[pos] = due[pos - 1];
+      pos--;
+    }
+    due[pos] = entry;
+  }
 }
 
 
@@ -70,20 +70,43 @@ public:
 private:
   class cEventListEntry;  
   
+  // Besides the list (which keeps file order), scheduled entries sit in a min-heap per trigger keyed by the next trigger
+  // value at which they can fire, so that Process only visits the entries that are due.  Entries whose trigger value
+  // has run past their stop are parked, and only re-queued should that trigger value ever fall again.
+  enum { QUEUE_IMMEDIATE = 0, QUEUE_UPDATE, QUEUE_GENERATION, QUEUE_BIRTHS, NUM_QUEUES };
+  
 private:
   cWorld* m_world;
   cEventListEntry* m_head;
   cEventListEntry* m_tail;
   int m_num_events;
+  int m_next_seq;
+  
+  Apto::Array<cEventListEntry*, Apto::Smart> m_queue[NUM_QUEUES];
+  Apto::Array<cEventListEntry*, Apto::Smart> m_parked[NUM_QUEUES];
+  double m_last_trigger[NUM_QUEUES];
   
   tList<double> m_birth_interrupt_queue;
   
   void QueueBirthInterruptEvent(double t_val);
   void DequeueBirthInterruptEvent(double t_val);
   
-  void SyncEvent(cEventListEntry* event);
+  bool SyncEvent(cEventListEntry* event);
   double GetTriggerValue(eTriggerType trigger) const;
   void Delete(cEventListEntry* entry);
+  void processAction(cAvidaContext& ctx, cAction* action);
+  
+  static int queueFor(eTriggerType trigger);
+  static double queueKey(const cEventListEntry* entry);
+  static bool queueBefore(const cEventListEntry* a, const cEventListEntry* b);
+  void enqueue(cEventListEntry* entry);
+  void unqueue(cEventListEntry* entry);
+  void park(cEventListEntry* entry);
+  void unpark(int queue);
+  void siftUp(Apto::Array<cEventListEntry*, Apto::Smart>& heap, int pos);
+  void siftDown(Apto::Array<cEventListEntry*, Apto::Smart>& heap, int pos);
+  void collectDue(int queue, int after_seq, Apto::Array<cEventListEntry*, Apto::Smart>& due, int first,
+                  Apto::Array<cEventListEntry*, Apto::Smart>& deferred);
   
   cEventList(); // @not_implemented
   cEventList(const cEventList&); // @not_implemented
@@ -91,7 +114,7 @@ private:
   
   
 public:
-  cEventList(cWorld* world) : m_world(world), m_head(NULL), m_tail(NULL), m_num_events(0) { ; }
+  cEventList(cWorld* world);
   ~cEventList();
   
   
@@ -149,12 +172,16 @@ private:
     cEventListEntry* m_prev;
     cEventListEntry* m_next;
     
+    int m_seq;          // position in list order
+    int m_queue_pos;    // slot in its trigger queue (or parked array), -1 if in neither
+    bool m_parked;
+    
   public:
     cEventListEntry(cAction* action, const cString& name, eTriggerType trigger = UPDATE, double start = TRIGGER_BEGIN,
                     double interval = TRIGGER_ONCE, double stop = TRIGGER_END, cEventListEntry* prev = NULL,
                     cEventListEntry* next = NULL)
     : m_action(action), m_name(name), m_trigger(trigger), m_start(start), m_interval(interval), m_stop(stop)
-    , m_original_start(start), m_prev(prev), m_next(next)
+    , m_original_start(start), m_prev(prev), m_next(next), m_seq(0), m_queue_pos(-1), m_parked(false)
     {
     }
     
@@ -163,6 +190,9 @@ private:
     void SetPrev(cEventListEntry* prev) { m_prev = prev; }
     void SetNext(cEventListEntry* next) { m_next = next; }
     
+    void SetSeq(int seq) { m_seq = seq; }
+    void SetQueuePos(int pos, bool parked = false) { m_queue_pos = pos; m_parked = parked; }
+    
     void NextInterval(){ m_start += m_interval; }
     void Reset() { m_start = m_original_start; }
     
@@ -179,6 +209,10 @@ private:
     
     cEventListEntry* GetPrev() const { return m_prev; }
     cEventListEntry* GetNext() const { return m_next; }
+    
+    int GetSeq() const { return m_seq; }
+    int GetQueuePos() const { return m_queue_pos; }
+    bool IsParked() const { return m_parked; }
   };
   
 };
@@ -27,6 +27,7 @@
 #include "avida/core/WorldDriver.h"
 
 #include "cAvidaContext.h"
+#include "cGradientStencil.h"
 #include "cPopulation.h"
 #include "cStats.h"
 #include "cWorld.h"
@@ -67,7 +68,7 @@ from -1 to 1, without first changing to 0
   Finally, we only toy with movement direction when # updates since last change = updatestep.
  */
 
-cGradientCount::cGradientCount(cWorld* world, int peakx, int peaky, int height, int spread, double plateau, int decay, 
+cGradientCount::cGradientCount(cWorld* world, cGradientStencilCache* stencils, int peakx, int peaky, int height, int spread, double plateau, int decay, 
                                int max_x, int max_y, int min_x, int min_y, double move_a_scaler, int updatestep,  
                                int worldx, int worldy, int geometry, int halo, int halo_inner_radius, int halo_width,
                                int halo_anchor_x, int halo_anchor_y, int move_speed, int move_resistance,
@@ -76,6 +77,8 @@ cGradientCount::cGradientCount(cWorld* world, int peakx, int peaky, int height,
                                int max_size, int config, int count, double init_plat, double threshold,
                                double damage, double death_odds, int is_path, int is_hammer)
   : m_world(world)
+  , m_stencils(stencils)
+  , m_stencil(NULL)
   , m_peakx(peakx), m_peaky(peaky)
   , m_height(height), m_spread(spread), m_plateau(plateau), m_decay(decay)
   , m_max_x(max_x), m_max_y(max_y), m_min_x(min_x), m_min_y(min_y)
@@ -155,7 +158,7 @@ void cGradientCount::updatePeakRes(cAvidaContext& ctx)
     int min_pos_y = max(m_peaky - m_spread - 1, 0);
     for (int ii = min_pos_x; ii < max_pos_x + 1; ii++) {
       for (int jj = min_pos_y; jj < max_pos_y + 1; jj++) {
-        if (Element(jj * GetX() + ii).GetAmount() >= 1) {
+        if (GetAmount(jj * GetX() + ii) >= 1) {
           has_edible = true;
           break;
         }
@@ -311,17 +314,25 @@ void cGradientCount::fillinResourceValues()
     m_current_height = m_height;
   }
 
+  // distances and cone heights come from the shared stencil for this spread and height, cells outside of it are
+  // beyond the spread
+  const cGradientStencil& stencil = currentStencil();
+  const bool full_height = (m_current_height == m_height);
+  
   int plateau_cell = 0;
   for (int ii = min_pos_x; ii < max_pos_x + 1; ii++) {
+    const int dx = m_peakx - ii;
     for (int jj = min_pos_y; jj < max_pos_y + 1; jj++) {
+      const int dy = m_peaky - jj;
       double thisheight = 0.0;
-      double thisdist = sqrt((double) (m_peakx - ii) * (m_peakx - ii) + (m_peaky - jj) * (m_peaky - jj));
-      if (m_spread >= thisdist) {
+      const int stencil_idx = stencil.Covers(dx, dy) ? stencil.Index(dx, dy) : -1;
+      if (stencil_idx >= 0 && stencil.InSpread(stencil_idx)) {
+        const double thisdist = stencil.GetDist(stencil_idx);
         // determine theoretical individual cells values and add one to distance from center 
         // (so that center point = radius 1, not 0)
         // also used to distinguish plateau cells
         
-        thisheight = m_current_height / (thisdist + 1);
+        thisheight = full_height ? stencil.GetSlope(stencil_idx) : m_current_height / (thisdist + 1);
         
         // set the floor values
         // plateaus will override this so that plateaus can hit 0 when being eaten
@@ -330,7 +341,7 @@ void cGradientCount::fillinResourceValues()
         // create cylindrical profiles of resources whereever thisheight would be >1 (area where thisdist + 1 <= m_height)
         // and slopes outside of that range
         // plateau = -1 turns off this option; if activated, causes 'peaks' to be flat plateaus = plateau value 
-        bool is_plat_cell = ((m_height / (thisdist + 1)) >= 1);
+        bool is_plat_cell = stencil.IsPlateau(stencil_idx);
         // apply plateau inflow(s) and outflow 
         if ((is_plat_cell && m_plateau >= 0) || (m_plateau < 0 && thisdist == 0 && m_plateau_array.GetSize())) { 
           if (m_just_reset || m_world->GetStats().GetUpdate() <= 0) {
@@ -378,7 +389,7 @@ void cGradientCount::fillinResourceValues()
               thisheight = 0;
             }
             else {
-              double past_height = Element(old_cell_y * GetX() + old_cell_x).GetAmount(); 
+              double past_height = GetAmount(old_cell_y * GetX() + old_cell_x); 
               double newheight = past_height; 
               if (m_cone_inflow > 0 || m_cone_outflow > 0) newheight += m_cone_inflow - (past_height * m_cone_outflow);
               if (m_gradient_inflow > 0) newheight += m_gradient_inflow / (thisdist + 1); 
@@ -389,7 +400,7 @@ void cGradientCount::fillinResourceValues()
           }
         }
       }
-      Element(jj * GetX() + ii).SetAmount(thisheight);
+      SetCellAmount(jj * GetX() + ii, thisheight);
       if (thisheight > 0) updateBounds(ii, jj);
     }
   }         
@@ -398,11 +409,22 @@ void cGradientCount::fillinResourceValues()
   m_just_reset = false;
 }
 
+const cGradientStencil& cGradientCount::currentStencil()
+{
+  if (!m_stencil || m_stencil->GetSpread() != m_spread || m_stencil->GetHeight() != m_height) {
+    m_stencil = m_stencils->Get(m_spread, m_height);
+  }
+  return *m_stencil;
+}
+
 void cGradientCount::getCurrentPlatValues()
 { 
+  // without plateaus only the peak cell is tracked, otherwise the plateau cells come from a stencil spanning the
+  // whole box around the peak, walked in the same order fillinResourceValues() recorded them
   int temp_height = 0;
   if (m_plateau < 0) temp_height = 1;
   else temp_height = m_height;
+  const cGradientStencil* stencil = (m_plateau >= 0) ? m_stencils->Get(temp_height + 1, m_height) : NULL;
   int plateau_box_min_x = m_peakx - temp_height - 1;
   int plateau_box_max_x = m_peakx + temp_height + 1;
   int plateau_box_min_y = m_peaky - temp_height - 1;
@@ -410,12 +432,15 @@ void cGradientCount::getCurrentPlatValues()
   int plateau_cell = 0;
   double amount_devoured = 0.0;
   for (int ii = plateau_box_min_x; ii < plateau_box_max_x + 1; ii++) {
+    const int dx = m_peakx - ii;
     for (int jj = plateau_box_min_y; jj < plateau_box_max_y + 1; jj++) { 
-      double thisdist = sqrt((double) (m_peakx - ii) * (double) (m_peakx - ii) + (double) (m_peaky - jj) * (double) (m_peaky - jj));
-      double find_plat_dist = temp_height / (thisdist + 1);
-      if ((find_plat_dist >= 1 && m_plateau >= 0) || (m_plateau < 0 && thisdist == 0 && m_plateau_array.GetSize() > 0)) {
+      const int dy = m_peaky - jj;
+      bool is_plat_cell = false;
+      if (stencil) is_plat_cell = stencil->IsPlateau(stencil->Index(dx, dy));
+      else is_plat_cell = (dx == 0 && dy == 0 && m_plateau_array.GetSize() > 0);
+      if (is_plat_cell) {
         double past_cell_height = m_plateau_array[plateau_cell];
-        double pre_move_height = Element(m_plateau_cell_IDs[plateau_cell]).GetAmount();  
+        double pre_move_height = GetAmount(m_plateau_cell_IDs[plateau_cell]);  
         if (pre_move_height < past_cell_height) {
           m_plateau_array[plateau_cell] = pre_move_height; 
           amount_devoured = amount_devoured + past_cell_height - pre_move_height;
@@ -661,13 +686,13 @@ void cGradientCount::generateBarrier(cAvidaContext& ctx)
     // clear any old resource
     if (m_wall_cells.GetSize()) {
       for (int i = 0; i < m_wall_cells.GetSize(); i++) {
-        Element(m_wall_cells[i]).SetAmount(0);
+        SetCellAmount(m_wall_cells[i], 0);
       }
     }
     else {
       for (int ii = 0; ii < GetX(); ii++) {
         for (int jj = 0; jj < GetY(); jj++) {
-          Element(jj * GetX() + ii).SetAmount(0);
+          SetCellAmount(jj * GetX() + ii, 0);
         }
       }
     }
@@ -685,7 +710,7 @@ void cGradientCount::generateBarrier(cAvidaContext& ctx)
         start_randx = ctx.GetRandom().GetUInt(0, GetX());
         start_randy = ctx.GetRandom().GetUInt(0, GetY());  
       }
-      Element(start_randy * GetX() + start_randx).SetAmount(m_plateau);
+      SetCellAmount(start_randy * GetX() + start_randx, m_plateau);
       // if (m_plateau > 0) updateBounds(start_randx, start_randy);
       updateBounds(start_randx, start_randy);
       m_wall_cells.Push(start_randy * GetX() + start_randx);
@@ -779,12 +804,12 @@ void cGradientCount::generateBarrier(cAvidaContext& ctx)
                randy < (m_halo_anchor_y + m_halo_inner_radius) && 
                randx > (m_halo_anchor_x - m_halo_inner_radius) && 
                randy > (m_halo_anchor_y - m_halo_inner_radius)) || 
-              (m_config == 0 && Element(randy * GetX() + randx).GetAmount())) {
+              (m_config == 0 && GetAmount(randy * GetX() + randx))) {
             num_blocks --;
             count_block = false;
           }
           if (count_block) {
-            Element(randy * GetX() + randx).SetAmount(m_plateau);
+            SetCellAmount(randy * GetX() + randx, m_plateau);
             if (m_plateau > 0) updateBounds(randx, randy);
             m_wall_cells.Push(randy * GetX() + randx);
             if (place_corner) {
@@ -793,7 +818,7 @@ void cGradientCount::generateBarrier(cAvidaContext& ctx)
                      cornery < (m_halo_anchor_y + m_halo_inner_radius) && 
                      cornerx > (m_halo_anchor_x - m_halo_inner_radius) && 
                      cornery > (m_halo_anchor_y - m_halo_inner_radius))) ){
-                  Element(cornery * GetX() + cornerx).SetAmount(m_plateau);
+                  SetCellAmount(cornery * GetX() + cornerx, m_plateau);
                   if (m_plateau > 0) updateBounds(cornerx, cornery);
                   m_wall_cells.Push(randy * GetX() + randx);
                 }
@@ -832,14 +857,14 @@ void cGradientCount::generateHills(cAvidaContext& ctx)
     if (m_min_usedx == -1 || m_min_usedy == -1 || m_max_usedx == -1 || m_max_usedy == -1) {
       for (int ii = 0; ii < GetX(); ii++) {
         for (int jj = 0; jj < GetY(); jj++) {
-          Element(jj * GetX() + ii).SetAmount(0);
+          SetCellAmount(jj * GetX() + ii, 0);
         }
       }
     }
     else {
       for (int ii = m_min_usedx; ii < m_max_usedx + 1; ii++) {
         for (int jj = m_min_usedy; jj < m_max_usedy + 1; jj++) {
-          Element(jj * GetX() + ii).SetAmount(0);
+          SetCellAmount(jj * GetX() + ii, 0);
         }
       }
     }
@@ -873,15 +898,21 @@ void cGradientCount::generateHills(cAvidaContext& ctx)
       int max_pos_y = min(m_peaky + rand_hill_radius + 1, GetY() - 1);
       int min_pos_y = max(m_peaky - rand_hill_radius - 1, 0);
 
+      // distances come from the shared stencil with the hill radius as its spread, the box edge lies beyond it
+      const cGradientStencil& stencil = *m_stencils->Get(rand_hill_radius, m_height);
+
       // look to place new cell values within a box around the hill center
       for (int ii = min_pos_x; ii < max_pos_x + 1; ii++) {
+        const int dx = m_peakx - ii;
         for (int jj = min_pos_y; jj < max_pos_y + 1; jj++) {
+          const int dy = m_peaky - jj;
+          if (!stencil.Covers(dx, dy) || !stencil.InSpread(stencil.Index(dx, dy))) continue;
           double thisheight = 0.0;
-          double thisdist = sqrt((double) (m_peakx - ii) * (m_peakx - ii) + (m_peaky - jj) * (m_peaky - jj));
+          double thisdist = stencil.GetDist(stencil.Index(dx, dy));
           // only plot values when within set config radius & if no larger amount has already been plotted for another overlapping hill
-          if ((thisdist <= rand_hill_radius) && (Element(jj * GetX() + ii).GetAmount() <  m_plateau / (thisdist + 1))) {
+          if (GetAmount(jj * GetX() + ii) <  m_plateau / (thisdist + 1)) {
           thisheight = m_plateau / (thisdist + 1);
-          Element(jj * GetX() + ii).SetAmount(thisheight);
+          SetCellAmount(jj * GetX() + ii, thisheight);
           if (thisheight > 0) updateBounds(ii, jj);
           }
         }
@@ -970,7 +1001,7 @@ void cGradientCount::UpdatePredatoryRes(cAvidaContext& ctx)
   // kill off up to 1 org per update within the predator radius (plateau area), with prob of death for selected prey = m_pred_odds
   if (m_predator) {
     for (int i = 0; i < m_plateau_cell_IDs.GetSize(); i ++) {
-      if (Element(m_plateau_cell_IDs[i]).GetAmount() >= 1) {
+      if (GetAmount(m_plateau_cell_IDs[i]) >= 1) {
         m_world->GetPopulation().ExecutePredatoryResource(ctx, m_plateau_cell_IDs[i], m_pred_odds, m_guarded_juvs_per_adult, m_hammer);
       }
     }
@@ -989,7 +1020,7 @@ void cGradientCount::UpdateDamagingRes(cAvidaContext& ctx)
   // we don't call this for walls and hills because they never move
   if (m_damage) {
     for (int i = 0; i < m_plateau_cell_IDs.GetSize(); i ++) {
-      if (Element(m_plateau_cell_IDs[i]).GetAmount() >= m_threshold) {
+      if (GetAmount(m_plateau_cell_IDs[i]) >= m_threshold) {
         // skip if initiating world and resources (cells don't exist yet)
         if (ctx.HasDriver()) m_world->GetPopulation().ExecuteDamagingResource(ctx, m_plateau_cell_IDs[i], m_damage, m_hammer);
       }
@@ -1002,7 +1033,7 @@ void cGradientCount::UpdateDeadlyRes(cAvidaContext& ctx)
   // we don't call this for walls and hills because they never move
   if (m_deadly) {
     for (int i = 0; i < m_plateau_cell_IDs.GetSize(); i ++) {
-      if (Element(m_plateau_cell_IDs[i]).GetAmount() >= m_threshold) {
+      if (GetAmount(m_plateau_cell_IDs[i]) >= m_threshold) {
         // skip if initiating world and resources (cells don't exist yet)
         if (ctx.HasDriver()) m_world->GetPopulation().ExecuteDeadlyResource(ctx, m_plateau_cell_IDs[i], m_death_odds, m_hammer);
       }
@@ -1044,7 +1075,7 @@ void cGradientCount::BuildProbabilisticRes(cAvidaContext& ctx, double lambda, do
 
   // only if theta == 1 do want want a 'hill' with resource for certain in the center
   if (theta == 0) {
-    Element(m_peaky * worldx + m_peakx).SetAmount(m_initial_plat);
+    SetCellAmount(m_peaky * worldx + m_peakx, m_initial_plat);
     if (m_initial_plat > 0) updateBounds(m_peakx, m_peaky);
     if (m_plateau_outflow > 0 || m_plateau_inflow > 0) { 
       if (num_cells == -1) m_prob_res_cells.Push(m_peaky * worldx + m_peakx);
@@ -1079,7 +1110,7 @@ void cGradientCount::BuildProbabilisticRes(cAvidaContext& ctx, double lambda, do
     double this_prob = (1/lambda) * (sqrt(2 / 3.14159)) * exp(-0.5 * pow(((cell_dist - theta) / lambda), 2));
     
     if (ctx.GetRandom().P(this_prob)) {
-      Element(cell_id).SetAmount(m_initial_plat);
+      SetCellAmount(cell_id, m_initial_plat);
       if (m_initial_plat > 0) updateBounds(this_x, this_y);
       if (m_plateau_outflow > 0 || m_plateau_inflow > 0) {
         if (loop_once) m_prob_res_cells.Push(cell_id);
@@ -1090,7 +1121,7 @@ void cGradientCount::BuildProbabilisticRes(cAvidaContext& ctx, double lambda, do
     }
     // just push this cell out of the way for this loop, but keep it around for next time
     else { 
-      Element(cell_id).SetAmount(0); 
+      SetCellAmount(cell_id, 0); 
       cell_id_array.Swap(cell_idx, max_unused_idx--);
     }
 
@@ -1106,9 +1137,9 @@ void cGradientCount::UpdateProbabilisticRes()
 {
   if (m_plateau_outflow > 0 || m_plateau_inflow > 0) {
     for (int i = 0; i < m_prob_res_cells.GetSize(); i++) {
-      double curr_val = Element(m_prob_res_cells[i]).GetAmount();
+      double curr_val = GetAmount(m_prob_res_cells[i]);
       double amount = curr_val + m_plateau_inflow - (curr_val * m_plateau_outflow);
-      Element(m_prob_res_cells[i]).SetAmount(amount); 
+      SetCellAmount(m_prob_res_cells[i], amount); 
       if (amount > 0) updateBounds(m_prob_res_cells[i] % GetX(), m_prob_res_cells[i] / GetX());
     }
   }
@@ -1118,7 +1149,7 @@ void cGradientCount::clearExistingProbRes()
 {
   for (int x = m_min_usedx; x < m_max_usedx + 1; x ++) {
     for (int y = m_min_usedy; y < m_max_usedy + 1; y ++) {
-      Element(y * GetX() + x).SetAmount(0);
+      SetCellAmount(y * GetX() + x, 0);
     }
   }
 }
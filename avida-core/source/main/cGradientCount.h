@@ -26,12 +26,16 @@
 
 #include "cSpatialResCount.h"
 
+class cGradientStencil;
+class cGradientStencilCache;
 class cWorld;
 
 class cGradientCount : public cSpatialResCount
 {
 private:
   cWorld* m_world;
+  cGradientStencilCache* m_stencils;
+  const cGradientStencil* m_stencil;    // profile for the current spread and height, see currentStencil()
   
   // Configuration Arguments
   int m_peakx;
@@ -118,7 +122,7 @@ private:
   int m_max_usedy;
     
 public:
-  cGradientCount(cWorld* world, int peakx, int peaky, int height, int spread, double plateau, int decay,              
+  cGradientCount(cWorld* world, cGradientStencilCache* stencils, int peakx, int peaky, int height, int spread, double plateau, int decay,              
                  int max_x, int max_y, int min_x, int min_y, double move_a_scaler, int updatestep, 
                  int worldx, int worldy, int geometry,int halo, int halo_inner_radius, int halo_width,
                  int halo_anchor_x, int halo_anchor_y, int move_speed, int move_resistance, double plateau_inflow, double plateau_outflow,
@@ -187,6 +191,7 @@ public:
   
 private:
   void fillinResourceValues();
+  const cGradientStencil& currentStencil();
   void updatePeakRes(cAvidaContext& ctx);
   void moveRes(cAvidaContext& ctx);
   int setHaloOrbit(cAvidaContext& ctx, int current_orbit);
@@ -0,0 +1,61 @@
+/*
+ *  cGradientStencil.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cGradientStencil.h"
+
+#include <cmath>
+
+
+cGradientStencil::cGradientStencil(int spread, int height)
+  : m_spread(spread), m_height(height), m_width((spread >= 0) ? 2 * spread + 1 : 0)
+{
+  m_dist.Resize(m_width * m_width);
+  m_slope.Resize(m_width * m_width);
+  m_flags.Resize(m_width * m_width);
+
+  // Same arithmetic as the per cell profile computation this replaces, so the values match bit for bit
+  for (int dy = -m_spread; dy <= m_spread; dy++) {
+    for (int dx = -m_spread; dx <= m_spread; dx++) {
+      const int idx = Index(dx, dy);
+      const double dist = sqrt((double) dx * dx + dy * dy);
+      m_dist[idx] = dist;
+      m_slope[idx] = m_height / (dist + 1);
+      m_flags[idx] = 0;
+      if (m_spread >= dist) m_flags[idx] |= IN_SPREAD;
+      if ((m_height / (dist + 1)) >= 1) m_flags[idx] |= PLATEAU;
+    }
+  }
+}
+
+
+cGradientStencilCache::~cGradientStencilCache()
+{
+  for (int i = 0; i < m_stencils.GetSize(); i++) delete m_stencils[i];
+}
+
+const cGradientStencil* cGradientStencilCache::Get(int spread, int height)
+{
+  for (int i = 0; i < m_stencils.GetSize(); i++) {
+    if (m_stencils[i]->GetSpread() == spread && m_stencils[i]->GetHeight() == height) return m_stencils[i];
+  }
+  cGradientStencil* stencil = new cGradientStencil(spread, height);
+  m_stencils.Push(stencil);
+  return stencil;
+}
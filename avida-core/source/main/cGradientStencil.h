@@ -0,0 +1,85 @@
+/*
+ *  cGradientStencil.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cGradientStencil_h
+#define cGradientStencil_h
+
+#include "avida/core/Types.h"
+
+
+// Precomputed radial profile of a gradient resource cone.  The stencil covers the square of cells within spread of
+// the peak, indexed by the offset from the peak, and holds for each cell its distance from the peak, the cone height
+// (height / (distance + 1)) and whether it lies within the spread and on the plateau.  cGradientCount blits it
+// around the current peak instead of recomputing the profile cell by cell each time the peak moves, and reads the
+// plateau cells and hill distances from it as well.
+class cGradientStencil
+{
+public:
+  enum { IN_SPREAD = 0x1, PLATEAU = 0x2 };
+
+private:
+  int m_spread;
+  int m_height;
+  int m_width;
+  Apto::Array<double> m_dist;
+  Apto::Array<double> m_slope;
+  Apto::Array<unsigned char> m_flags;
+
+
+  cGradientStencil(); // @not_implemented
+  cGradientStencil(const cGradientStencil&); // @not_implemented
+  cGradientStencil& operator=(const cGradientStencil&); // @not_implemented
+
+public:
+  cGradientStencil(int spread, int height);
+
+  int GetSpread() const { return m_spread; }
+  int GetHeight() const { return m_height; }
+
+  // Offsets are peak - cell, as used by cGradientCount
+  bool Covers(int dx, int dy) const { return (dx >= -m_spread && dx <= m_spread && dy >= -m_spread && dy <= m_spread); }
+  int Index(int dx, int dy) const { return (dy + m_spread) * m_width + (dx + m_spread); }
+
+  double GetDist(int idx) const { return m_dist[idx]; }
+  double GetSlope(int idx) const { return m_slope[idx]; }
+  bool InSpread(int idx) const { return (m_flags[idx] & IN_SPREAD); }
+  bool IsPlateau(int idx) const { return (m_flags[idx] & PLATEAU); }
+};
+
+
+// Stencils shared by all of the gradient resources of a cResourceCount, built on first use for each spread and
+// height and kept until the count is destroyed
+class cGradientStencilCache
+{
+private:
+  Apto::Array<cGradientStencil*> m_stencils;
+
+
+  cGradientStencilCache(const cGradientStencilCache&); // @not_implemented
+  cGradientStencilCache& operator=(const cGradientStencilCache&); // @not_implemented
+
+public:
+  cGradientStencilCache() { ; }
+  ~cGradientStencilCache();
+
+  const cGradientStencil* Get(int spread, int height);
+};
+
+#endif
@@ -0,0 +1,294 @@
+/*
+ *  cGridExporter.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cGridExporter.h"
+
+#include "avida/core/Feedback.h"
+#include "avida/core/InstructionSequence.h"
+#include "avida/output/File.h"
+#include "avida/output/Manager.h"
+#include "avida/systematics/Group.h"
+
+#include "cEnvironment.h"
+#include "cOrganism.h"
+#include "cPhenotype.h"
+#include "cPopulation.h"
+#include "cPopulationCell.h"
+#include "cResource.h"
+#include "cResourceLib.h"
+#include "cStats.h"
+#include "cWorld.h"
+
+#include <cmath>
+#include <fstream>
+
+using namespace Avida;
+using namespace std;
+
+
+// Per-cell values, matching what the corresponding Dump*Grid action writes for the cell
+
+static double layerEnergy(cWorld*, cPopulationCell& cell, const Apto::Array<double>&)
+{
+  return (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().GetStoredEnergy() : 0.0;
+}
+
+static double layerExecutionRatio(cWorld*, cPopulationCell& cell, const Apto::Array<double>&)
+{
+  return (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().GetEnergyUsageRatio() : 1.0;
+}
+
+static double layerCellData(cWorld*, cPopulationCell& cell, const Apto::Array<double>&)
+{
+  return cell.GetCellData();
+}
+
+static double layerFitness(cWorld*, cPopulationCell& cell, const Apto::Array<double>&)
+{
+  return (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().GetFitness() : 0.0;
+}
+
+static double layerGenotypeID(cWorld*, cPopulationCell& cell, const Apto::Array<double>&)
+{
+  if (!cell.IsOccupied()) return -1;
+  Systematics::GroupPtr genotype = cell.GetOrganism()->SystematicsGroup("genotype");
+  return (genotype) ? genotype->ID() : -1;
+}
+
+static double layerPhenotypeID(cWorld*, cPopulationCell& cell, const Apto::Array<double>&)
+{
+  return (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().CalcID() : -1;
+}
+
+static double layerOrganismID(cWorld*, cPopulationCell& cell, const Apto::Array<double>&)
+{
+  return (cell.IsOccupied()) ? cell.GetOrganism()->GetID() : -1;
+}
+
+static double layerVitality(cWorld*, cPopulationCell& cell, const Apto::Array<double>&)
+{
+  return (cell.IsOccupied()) ? cell.GetOrganism()->GetVitality() : -1;
+}
+
+static double layerTarget(cWorld* world, cPopulationCell& cell, const Apto::Array<double>&)
+{
+  // With avatars, DumpTargetGrid reports the avatar in the cell, predators first
+  if (world->GetConfig().USE_AVATARS.Get()) {
+    if (!cell.HasAV()) return -99;
+    return (cell.HasPredAV()) ? cell.GetRandPredAV()->GetForageTarget() : cell.GetRandPreyAV()->GetForageTarget();
+  }
+  return (cell.IsOccupied()) ? cell.GetOrganism()->GetForageTarget() : -99;
+}
+
+static double layerMaxResource(cWorld* world, cPopulationCell&, const Apto::Array<double>& res_count)
+{
+  // Same rules as DumpMaxResGrid: hills raise the floor, walls trump everything else
+  const cResourceLib& resource_lib = world->GetEnvironment().GetResourceLib();
+  double max_resource = 0.0;
+  double topo_height = 0.0;
+  for (int h = 0; h < res_count.GetSize(); h++) {
+    int hab_type = resource_lib.GetResource(h)->GetHabitat();
+    if ((res_count[h] > max_resource) && (hab_type != 1) && (hab_type !=2)) max_resource = res_count[h];
+    else if ((hab_type == 1 || hab_type == 4 || hab_type == 5) && res_count[h] > 0) topo_height = resource_lib.GetResource(h)->GetPlateau();
+    else if (hab_type == 2 && res_count[h] > 0) {
+      topo_height = resource_lib.GetResource(h)->GetPlateau();
+      max_resource = 0.0;
+      break;
+    }
+  }
+  return max_resource + topo_height;
+}
+
+static double layerSleep(cWorld*, cPopulationCell& cell, const Apto::Array<double>&)
+{
+  return (cell.IsOccupied()) ? cell.GetOrganism()->IsSleeping() : 0.0;
+}
+
+static double layerGenomeLength(cWorld*, cPopulationCell& cell, const Apto::Array<double>&)
+{
+  if (!cell.IsOccupied()) return -1;
+  ConstInstructionSequencePtr seq;
+  seq.DynamicCastFrom(cell.GetOrganism()->GetGenome().Representation());
+  return seq->GetSize();
+}
+
+static double layerReactions(cWorld* world, cPopulationCell& cell, const Apto::Array<double>&)
+{
+  if (!cell.IsOccupied()) return -1;
+  const int num_tasks = world->GetEnvironment().GetNumTasks();
+  const cPhenotype& phenotype = cell.GetOrganism()->GetPhenotype();
+  int task_sum = 0;
+  for (int k = 0; k < num_tasks; k++) {
+    if (phenotype.GetLastReactionCount()[k] > 0) task_sum += static_cast<int>(pow(2.0, k));
+  }
+  return task_sum;
+}
+
+static double layerDonor(cWorld*, cPopulationCell& cell, const Apto::Array<double>&)
+{
+  return (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().IsDonorLast() : -1;
+}
+
+static double layerReceiver(cWorld*, cPopulationCell& cell, const Apto::Array<double>&)
+{
+  return (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().IsReceiver() : -1;
+}
+
+
+const cGridExporter::sLayerDef cGridExporter::s_layer_defs[] = {
+  { "energy",        cGridSnapshot::LAYER_DOUBLE, false, false, "grid_energy.%d.dat",              layerEnergy },
+  { "exe_ratio",     cGridSnapshot::LAYER_DOUBLE, false, false, "grid_exe_ratio.%d.dat",           layerExecutionRatio },
+  { "cell_data",     cGridSnapshot::LAYER_DOUBLE, false, false, "grid_cell_data.%d.dat",           layerCellData },
+  { "fitness",       cGridSnapshot::LAYER_DOUBLE, true,  false, "grid_fitness-%d.dat",             layerFitness },
+  { "genotype_id",   cGridSnapshot::LAYER_INT,    false, false, "grid_class_id-%d.dat",            layerGenotypeID },
+  { "phenotype_id",  cGridSnapshot::LAYER_INT,    false, false, "grid_phenotype_id.%d.dat",        layerPhenotypeID },
+  { "org_id",        cGridSnapshot::LAYER_INT,    false, false, "id_grid.%d.dat",                  layerOrganismID },
+  { "vitality",      cGridSnapshot::LAYER_DOUBLE, false, false, "grid_dumps/vitality_grid.%d.dat", layerVitality },
+  { "target",        cGridSnapshot::LAYER_INT,    false, false, "grid_dumps/target_grid.%d.dat",   layerTarget,
+    "grid_dumps/avatar_grid.%d.dat" },
+  { "max_res",       cGridSnapshot::LAYER_DOUBLE, false, true,  "grid_dumps/max_res_grid.%d.dat",  layerMaxResource },
+  { "sleep",         cGridSnapshot::LAYER_DOUBLE, false, false, "grid_sleep.%d.dat",               layerSleep },
+  { "genome_length", cGridSnapshot::LAYER_INT,    true,  false, "grid_genome_length.%d.dat",       layerGenomeLength },
+  { "reactions",     cGridSnapshot::LAYER_INT,    true,  false, "grid_reactions.%d.dat",           layerReactions },
+  { "donor",         cGridSnapshot::LAYER_INT,    true,  false, "grid_donor.%d.dat",               layerDonor },
+  { "receiver",      cGridSnapshot::LAYER_INT,    true,  false, "grid_receiver.%d.dat",            layerReceiver },
+  { NULL,            cGridSnapshot::LAYER_INT,    false, false, NULL,                              NULL }
+};
+
+
+bool cGridExporter::SelectLayers(const cString& layers, Feedback& feedback)
+{
+  const cResourceLib& resource_lib = m_world->GetEnvironment().GetResourceLib();
+  bool success = true;
+
+  cString names(layers);
+  while (names.GetSize()) {
+    cString name = names.Pop(',');
+    name.Trim();
+    if (name == "") continue;
+
+    if (name == "all") {
+      for (int i = 0; s_layer_defs[i].name != NULL; i++) selectLayer(i, -1, s_layer_defs[i].name);
+      continue;
+    }
+
+    if (name.GetSize() > 4 && name.Substring(0, 4) == "res.") {
+      cResource* res = resource_lib.GetResource(name.Substring(4, name.GetSize() - 4));
+      if (res) {
+        selectLayer(-1, res->GetID(), (const char*)name);
+        continue;
+      }
+    } else {
+      int def = 0;
+      while (s_layer_defs[def].name != NULL && name != s_layer_defs[def].name) def++;
+      if (s_layer_defs[def].name != NULL) {
+        selectLayer(def, -1, s_layer_defs[def].name);
+        continue;
+      }
+    }
+
+    feedback.Error("unknown grid layer '%s'", (const char*)name);
+    success = false;
+  }
+
+  return success;
+}
+
+void cGridExporter::selectLayer(int def, int res_id, const Apto::String& name)
+{
+  for (int i = 0; i < m_selected.GetSize(); i++) if (m_selected[i].name == name) return;
+
+  sSelection sel;
+  sel.def = def;
+  sel.res_id = res_id;
+  sel.name = name;
+  m_selected.Push(sel);
+  if (def < 0 || s_layer_defs[def].uses_resources) m_uses_resources = true;
+}
+
+
+void cGridExporter::Gather(cAvidaContext& ctx, cGridSnapshot& snapshot) const
+{
+  cPopulation& pop = m_world->GetPopulation();
+  const int num_cells = pop.GetWorldX() * pop.GetWorldY();
+
+  snapshot.Reset(pop.GetWorldX(), pop.GetWorldY(), m_world->GetStats().GetUpdate());
+  for (int l = 0; l < m_selected.GetSize(); l++) {
+    const sSelection& sel = m_selected[l];
+    snapshot.AddLayer(sel.name, (sel.def < 0) ? cGridSnapshot::LAYER_DOUBLE : s_layer_defs[sel.def].type);
+  }
+
+  const Apto::Array<double> no_resources;
+  for (int cell_id = 0; cell_id < num_cells; cell_id++) {
+    cPopulationCell& cell = pop.GetCell(cell_id);
+    const Apto::Array<double>& cell_res = (m_uses_resources) ? pop.GetCellResources(cell_id, ctx) : no_resources;
+
+    for (int l = 0; l < m_selected.GetSize(); l++) {
+      const sSelection& sel = m_selected[l];
+      if (sel.def < 0) {
+        snapshot.SetDouble(l, cell_id, cell_res[sel.res_id]);
+      } else if (s_layer_defs[sel.def].type == cGridSnapshot::LAYER_INT) {
+        snapshot.SetInt(l, cell_id, static_cast<int>(s_layer_defs[sel.def].value(m_world, cell, cell_res)));
+      } else {
+        snapshot.SetDouble(l, cell_id, s_layer_defs[sel.def].value(m_world, cell, cell_res));
+      }
+    }
+  }
+}
+
+
+bool cGridExporter::WriteBinary(const cGridSnapshot& snapshot, const cString& filename) const
+{
+  // Opened directly rather than through Output::File, which writes in text mode
+  Output::ManagerPtr omgr = Output::Manager::Of(m_world->GetNewWorld());
+  Output::OutputID oid = omgr->OutputIDFromPath((const char*)filename);
+  ofstream fp((const char*)oid, ios::out | ios::binary);
+  return fp.good() && snapshot.Save(fp);
+}
+
+void cGridExporter::WriteText(const cGridSnapshot& snapshot) const
+{
+  for (int l = 0; l < m_selected.GetSize(); l++) {
+    const sSelection& sel = m_selected[l];
+    cString filename;
+    if (sel.def < 0) {
+      const cString res_name = m_world->GetEnvironment().GetResourceLib().GetResource(sel.res_id)->GetName();
+      filename.Set("grid_res_%s.%d.dat", (const char*)res_name, snapshot.GetUpdate());
+    } else {
+      const sLayerDef& def = s_layer_defs[sel.def];
+      const bool avatars = (def.avatar_text_file != NULL && m_world->GetConfig().USE_AVATARS.Get());
+      filename.Set((avatars) ? def.avatar_text_file : def.text_file, snapshot.GetUpdate());
+    }
+
+    Output::FilePtr df = Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
+    snapshot.WriteText(l, df->OFStream(), (sel.def >= 0 && s_layer_defs[sel.def].transposed));
+  }
+}
+
+
+cString cGridExporter::GetLayerNames()
+{
+  cString names;
+  for (int i = 0; s_layer_defs[i].name != NULL; i++) {
+    if (i) names += ", ";
+    names += s_layer_defs[i].name;
+  }
+  return names;
+}
@@ -0,0 +1,91 @@
+/*
+ *  cGridExporter.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cGridExporter_h
+#define cGridExporter_h
+
+#include "avida/core/Types.h"
+
+#include "cGridSnapshot.h"
+
+class cAvidaContext;
+class cPopulationCell;
+class cString;
+class cWorld;
+
+
+// Gathers a chosen set of per-cell layers (fitness, genotype id, reactions, resources, ...) into a cGridSnapshot in a
+// single row-major pass over the population, so that dumping several layers visits each cell once.  The snapshot can
+// be written as one binary grid file (see cGridSnapshot), or as one text file per layer, laid out and named exactly as
+// the corresponding Dump*Grid action would.
+class cGridExporter
+{
+private:
+  typedef double (*LayerFunction)(cWorld* world, cPopulationCell& cell, const Apto::Array<double>& cell_res);
+
+  struct sLayerDef
+  {
+    const char* name;
+    cGridSnapshot::eLayerType type;
+    bool transposed;        // text dump is written column by column
+    bool uses_resources;
+    const char* text_file;  // printf format, given the update
+    LayerFunction value;
+    const char* avatar_text_file;  // text_file used instead when USE_AVATARS is set, if the layer has one
+  };
+
+  struct sSelection
+  {
+    int def;                // index into s_layer_defs, -1 for a resource layer
+    int res_id;
+    Apto::String name;
+  };
+
+  static const sLayerDef s_layer_defs[];
+
+  cWorld* m_world;
+  Apto::Array<sSelection> m_selected;
+  bool m_uses_resources;
+
+
+  cGridExporter(); // @not_implemented
+  cGridExporter(const cGridExporter&); // @not_implemented
+  cGridExporter& operator=(const cGridExporter&); // @not_implemented
+
+public:
+  cGridExporter(cWorld* world) : m_world(world), m_uses_resources(false) { ; }
+
+  // Comma separated layer names; "all" selects every population layer and "res.NAME" the named resource.  Unknown
+  // names are reported and skipped.
+  bool SelectLayers(const cString& layers, Avida::Feedback& feedback);
+  int GetNumLayers() const { return m_selected.GetSize(); }
+
+  void Gather(cAvidaContext& ctx, cGridSnapshot& snapshot) const;
+
+  bool WriteBinary(const cGridSnapshot& snapshot, const cString& filename) const;
+  void WriteText(const cGridSnapshot& snapshot) const;
+
+  static cString GetLayerNames();
+
+private:
+  void selectLayer(int def, int res_id, const Apto::String& name);
+};
+
+#endif
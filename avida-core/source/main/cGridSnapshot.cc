@@ -0,0 +1,210 @@
+/*
+ *  cGridSnapshot.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cGridSnapshot.h"
+
+#include <climits>
+#include <cstring>
+
+using namespace std;
+
+
+static const char GRID_FILE_MAGIC[4] = { 'A', 'G', 'R', 'D' };
+static const int GRID_FILE_VERSION = 1;
+
+
+void cGridSnapshot::Reset(int world_x, int world_y, int update)
+{
+  m_world_x = world_x;
+  m_world_y = world_y;
+  m_update = update;
+  m_layers.Resize(0);
+}
+
+int cGridSnapshot::AddLayer(const Apto::String& name, eLayerType type)
+{
+  const int num_cells = m_world_x * m_world_y;
+  const int layer = m_layers.GetSize();
+  m_layers.Resize(layer + 1);
+  sLayer& new_layer = m_layers[layer];
+  new_layer.name = name;
+  new_layer.type = type;
+  new_layer.ints.Resize((type == LAYER_INT) ? num_cells : 0);
+  new_layer.ints.SetAll(0);
+  new_layer.doubles.Resize((type == LAYER_DOUBLE) ? num_cells : 0);
+  new_layer.doubles.SetAll(0.0);
+  return layer;
+}
+
+int cGridSnapshot::FindLayer(const Apto::String& name) const
+{
+  for (int i = 0; i < m_layers.GetSize(); i++) if (m_layers[i].name == name) return i;
+  return -1;
+}
+
+
+bool cGridSnapshot::Save(ostream& out) const
+{
+  const int num_cells = m_world_x * m_world_y;
+
+  out.write(GRID_FILE_MAGIC, sizeof(GRID_FILE_MAGIC));
+  writeVarint(out, GRID_FILE_VERSION);
+  writeVarint(out, m_world_x);
+  writeVarint(out, m_world_y);
+  writeVarint(out, (m_update < 0) ? 0 : m_update + 1);
+  writeVarint(out, m_layers.GetSize());
+
+  for (int l = 0; l < m_layers.GetSize(); l++) {
+    const sLayer& layer = m_layers[l];
+    writeVarint(out, layer.name.GetSize());
+    out.write((const char*)layer.name, layer.name.GetSize());
+    writeVarint(out, layer.type);
+
+    // Runs of equal values, as (run length, value) pairs; doubles compare by bits so -0.0 and NaNs survive
+    int cell = 0;
+    while (cell < num_cells) {
+      int run = 1;
+      if (layer.type == LAYER_INT) {
+        const int value = layer.ints[cell];
+        while (cell + run < num_cells && layer.ints[cell + run] == value) run++;
+        writeVarint(out, run);
+        // zigzag, so small negative markers (-1 for empty cells) stay one byte
+        writeVarint(out, (value < 0) ? ((static_cast<unsigned long long>(-(value + 1)) << 1) | 1) : (static_cast<unsigned long long>(value) << 1));
+      } else {
+        const unsigned long long bits = doubleBits(layer.doubles[cell]);
+        while (cell + run < num_cells && doubleBits(layer.doubles[cell + run]) == bits) run++;
+        writeVarint(out, run);
+        for (int b = 0; b < 8; b++) out.put(static_cast<char>((bits >> (8 * b)) & 0xFF));
+      }
+      cell += run;
+    }
+  }
+
+  return out.good();
+}
+
+bool cGridSnapshot::Load(istream& in, int world_x_req, int world_y_req)
+{
+  char magic[sizeof(GRID_FILE_MAGIC)];
+  if (!in.read(magic, sizeof(magic)) || memcmp(magic, GRID_FILE_MAGIC, sizeof(magic)) != 0) return false;
+
+  unsigned long long version, world_x, world_y, update, num_layers;
+  if (!readVarint(in, version) || version != GRID_FILE_VERSION) return false;
+  if (!readVarint(in, world_x) || !readVarint(in, world_y) || !readVarint(in, update) || !readVarint(in, num_layers)) {
+    return false;
+  }
+
+  // Check the header before anything is sized from it: the cell count must fit an int, and match the world if given
+  const unsigned long long max_int = INT_MAX;
+  if (world_x > max_int || world_y > max_int || update > max_int) return false;
+  if (world_y != 0 && world_x > max_int / world_y) return false;
+  if (world_x_req >= 0 && (world_x != static_cast<unsigned long long>(world_x_req) ||
+                           world_y != static_cast<unsigned long long>(world_y_req))) {
+    return false;
+  }
+  Reset(static_cast<int>(world_x), static_cast<int>(world_y), static_cast<int>(update) - 1);
+  const int num_cells = m_world_x * m_world_y;
+
+  for (unsigned long long l = 0; l < num_layers; l++) {
+    unsigned long long name_len, type;
+    if (!readVarint(in, name_len) || name_len >= max_int) return false;
+    Apto::Array<char> name_buf(static_cast<int>(name_len) + 1);
+    if (name_len && !in.read(&name_buf[0], name_len)) return false;
+    name_buf[static_cast<int>(name_len)] = '\0';
+    if (!readVarint(in, type) || (type != LAYER_INT && type != LAYER_DOUBLE)) return false;
+
+    const int layer = AddLayer(Apto::String(&name_buf[0]), static_cast<eLayerType>(type));
+    sLayer& cur = m_layers[layer];
+
+    int cell = 0;
+    while (cell < num_cells) {
+      unsigned long long run;
+      if (!readVarint(in, run) || run == 0 || run > static_cast<unsigned long long>(num_cells - cell)) return false;
+      if (cur.type == LAYER_INT) {
+        unsigned long long zz;
+        if (!readVarint(in, zz)) return false;
+        const int value = (zz & 1) ? -static_cast<int>(zz >> 1) - 1 : static_cast<int>(zz >> 1);
+        for (unsigned long long i = 0; i < run; i++) cur.ints[cell++] = value;
+      } else {
+        unsigned char bytes[8];
+        if (!in.read(reinterpret_cast<char*>(bytes), 8)) return false;
+        unsigned long long bits = 0;
+        for (int b = 7; b >= 0; b--) bits = (bits << 8) | bytes[b];
+        const double value = bitsDouble(bits);
+        for (unsigned long long i = 0; i < run; i++) cur.doubles[cell++] = value;
+      }
+    }
+  }
+
+  return true;
+}
+
+
+void cGridSnapshot::WriteText(int layer, ostream& out, bool transposed) const
+{
+  const sLayer& cur = m_layers[layer];
+  const int rows = (transposed) ? m_world_x : m_world_y;
+  const int cols = (transposed) ? m_world_y : m_world_x;
+
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c < cols; c++) {
+      const int cell_id = (transposed) ? (c * m_world_x + r) : (r * m_world_x + c);
+      if (cur.type == LAYER_INT) out << cur.ints[cell_id] << " ";
+      else out << cur.doubles[cell_id] << " ";
+    }
+    out << endl;
+  }
+}
+
+
+void cGridSnapshot::writeVarint(ostream& out, unsigned long long value)
+{
+  while (value >= 0x80) {
+    out.put(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out.put(static_cast<char>(value));
+}
+
+bool cGridSnapshot::readVarint(istream& in, unsigned long long& value)
+{
+  value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    const int byte = in.get();
+    if (byte == istream::traits_type::eof()) return false;
+    value |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) return true;
+  }
+  return false;
+}
+
+unsigned long long cGridSnapshot::doubleBits(double value)
+{
+  unsigned long long bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+double cGridSnapshot::bitsDouble(unsigned long long bits)
+{
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
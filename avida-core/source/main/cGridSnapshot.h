@@ -0,0 +1,88 @@
+/*
+ *  cGridSnapshot.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cGridSnapshot_h
+#define cGridSnapshot_h
+
+#include "apto/core.h"
+
+#include <iostream>
+
+
+// A set of per-cell values (layers) captured over the world grid at one update.  Cells are stored row-major, the
+// same order as population cell ids.
+//
+// Save writes a compact binary grid file: each layer is run-length encoded, with integer values as zigzag varints and
+// floating point values as their raw IEEE bits, so empty or uniform regions of the grid cost a few bytes and values
+// read back bit-exact.  Load reads such a file back.  WriteText writes a layer in the whitespace separated format of
+// the Dump*Grid actions.
+class cGridSnapshot
+{
+public:
+  enum eLayerType { LAYER_INT = 0, LAYER_DOUBLE = 1 };
+
+private:
+  struct sLayer
+  {
+    Apto::String name;
+    eLayerType type;
+    Apto::Array<int> ints;
+    Apto::Array<double> doubles;
+  };
+
+  int m_world_x;
+  int m_world_y;
+  int m_update;
+  Apto::Array<sLayer> m_layers;
+
+public:
+  cGridSnapshot(int world_x = 0, int world_y = 0, int update = -1) { Reset(world_x, world_y, update); }
+
+  void Reset(int world_x, int world_y, int update);
+  int AddLayer(const Apto::String& name, eLayerType type);
+
+  int GetWorldX() const { return m_world_x; }
+  int GetWorldY() const { return m_world_y; }
+  int GetUpdate() const { return m_update; }
+  int GetNumLayers() const { return m_layers.GetSize(); }
+  const Apto::String& GetLayerName(int layer) const { return m_layers[layer].name; }
+  eLayerType GetLayerType(int layer) const { return m_layers[layer].type; }
+  int FindLayer(const Apto::String& name) const;
+
+  int GetInt(int layer, int cell_id) const { return m_layers[layer].ints[cell_id]; }
+  double GetDouble(int layer, int cell_id) const { return m_layers[layer].doubles[cell_id]; }
+  void SetInt(int layer, int cell_id, int value) { m_layers[layer].ints[cell_id] = value; }
+  void SetDouble(int layer, int cell_id, double value) { m_layers[layer].doubles[cell_id] = value; }
+
+  bool Save(std::ostream& out) const;
+  // Rejects malformed files, and, when world_x and world_y are given, grids of any other size
+  bool Load(std::istream& in, int world_x = -1, int world_y = -1);
+
+  // Rows are grid rows, or grid columns when transposed (as several of the text dumps are written)
+  void WriteText(int layer, std::ostream& out, bool transposed = false) const;
+
+private:
+  static void writeVarint(std::ostream& out, unsigned long long value);
+  static bool readVarint(std::istream& in, unsigned long long& value);
+  static unsigned long long doubleBits(double value);
+  static double bitsDouble(unsigned long long bits);
+};
+
+#endif
@@ -0,0 +1,99 @@
+/*
+ *  cIslandUniverse.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cIslandUniverse.h"
+
+#include <cassert>
+
+
+cIslandUniverse::cIslandUniverse(int num_islands)
+  : m_num_islands(num_islands), m_parity(num_islands), m_waiting(0), m_barrier_generation(0)
+{
+  assert(num_islands > 0);
+  for (int p = 0; p < 2; p++) {
+    m_transit[p].Resize(num_islands * num_islands);
+    m_census[p].Resize(num_islands);
+    m_census[p].SetAll(0);
+    m_finished[p] = false;
+  }
+  m_parity.SetAll(0);
+}
+
+
+void cIslandUniverse::SendMigrant(int source, int destination, const sMigrant& migrant)
+{
+  assert(source >= 0 && source < m_num_islands);
+  assert(destination >= 0 && destination < m_num_islands);
+  m_transit[m_parity[source]][source * m_num_islands + destination].Push(migrant);
+}
+
+
+int cIslandUniverse::Exchange(int island, int num_organisms, Apto::Array<sMigrant, Apto::Smart>& arrivals, bool& finished)
+{
+  const int parity = m_parity[island];
+  Apto::Array<Apto::Array<sMigrant, Apto::Smart> >& transit = m_transit[parity];
+  
+  // Publish the census for this update, counting departing migrants so extinction is not declared while some are in transit
+  int census = num_organisms;
+  for (int dst = 0; dst < m_num_islands; dst++) census += transit[island * m_num_islands + dst].GetSize();
+  m_census[parity][island] = census;
+  
+  // Like the census, the flag is only read for this update once every island has passed the barrier.  It is never
+  // cleared, since no island starts another update after it has been set.
+  if (finished) {
+    m_mutex.Lock();
+    m_finished[parity] = true;
+    m_mutex.Unlock();
+  }
+  
+  barrier();
+  
+  // Every island has finished sending for this update; collect our arrivals in source order.  None of these buffers
+  // will be written again until all islands have passed the next barrier, by which time we have cleared them.
+  for (int src = 0; src < m_num_islands; src++) {
+    Apto::Array<sMigrant, Apto::Smart>& inbox = transit[src * m_num_islands + island];
+    for (int i = 0; i < inbox.GetSize(); i++) arrivals.Push(inbox[i]);
+    inbox.ResizeClear(0);
+  }
+  
+  int universe_pop = 0;
+  for (int i = 0; i < m_num_islands; i++) universe_pop += m_census[parity][i];
+  finished = m_finished[parity];
+  
+  m_parity[island] = !parity;
+  
+  return universe_pop;
+}
+
+
+void cIslandUniverse::barrier()
+{
+  m_mutex.Lock();
+  const int generation = m_barrier_generation;
+  if (++m_waiting == m_num_islands) {
+    m_waiting = 0;
+    m_barrier_generation++;
+    m_mutex.Unlock();
+    m_cond.Broadcast();
+  } else {
+    while (generation == m_barrier_generation) m_cond.Wait(m_mutex);
+    m_mutex.Unlock();
+  }
+}
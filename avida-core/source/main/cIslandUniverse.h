@@ -0,0 +1,90 @@
+/*
+ *  cIslandUniverse.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cIslandUniverse_h
+#define cIslandUniverse_h
+
+#include "apto/core.h"
+#include "apto/core/ConditionVariable.h"
+#include "apto/core/Mutex.h"
+
+
+// Shared state for a set of island populations run concurrently within a single process, one thread per island.
+//
+// Islands advance in lock step, exchanging migrants at update boundaries.  Migrants in transit are buffered per
+// (source, destination) pair and double buffered by update parity, so that every buffer has exactly one writer (its
+// source island, during the update) and one reader (its destination, after the update barrier).  Sending a migrant is
+// thus a plain append with no locking; the update barrier is the only synchronization point.  Arrivals are always
+// delivered in source island order, then send order, so results do not depend on thread timing.
+class cIslandUniverse
+{
+public:
+  struct sMigrant
+  {
+    Apto::String genome;
+    double merit;
+    int lineage;
+    int generation;
+    
+    sMigrant() : merit(0.0), lineage(0), generation(0) { ; }
+  };
+  
+private:
+  int m_num_islands;
+  
+  Apto::Array<Apto::Array<sMigrant, Apto::Smart> > m_transit[2];  // [parity][source * num_islands + destination]
+  Apto::Array<int> m_census[2];                                   // [parity][island], organisms + migrants sent
+  bool m_finished[2];                                             // [parity], some island has stopped
+  Apto::Array<int> m_parity;                                      // current update parity of each island
+  
+  Apto::Mutex m_mutex;
+  Apto::ConditionVariable m_cond;
+  int m_waiting;
+  int m_barrier_generation;
+  
+  
+  cIslandUniverse(); // @not_implemented
+  cIslandUniverse(const cIslandUniverse&); // @not_implemented
+  cIslandUniverse& operator=(const cIslandUniverse&); // @not_implemented
+  
+public:
+  cIslandUniverse(int num_islands);
+  ~cIslandUniverse() { ; }
+  
+  int GetNumIslands() const { return m_num_islands; }
+  
+  // Queue a migrant for delivery at the end of the source island's current update.  Only the source island's own
+  // thread may call this.
+  void SendMigrant(int source, int destination, const sMigrant& migrant);
+  
+  // Complete the calling island's update: publishes its census, waits for all other islands to reach the same point,
+  // and appends migrants addressed to this island to arrivals.  Returns the universe population (including migrants
+  // in transit) at the end of the update, which is identical for every island.
+  //
+  // An island whose run has finished (e.g. through an Exit event) makes one last exchange with finished set, so that
+  // the others are not left waiting.  On return, finished is set for every island if any island has finished, in
+  // which case they all stop at this update boundary.
+  int Exchange(int island, int num_organisms, Apto::Array<sMigrant, Apto::Smart>& arrivals, bool& finished);
+  
+private:
+  void barrier();
+};
+
+#endif
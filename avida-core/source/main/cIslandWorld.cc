@@ -0,0 +1,120 @@
+/*
+ *  cIslandWorld.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cIslandWorld.h"
+
+#include "avida/core/Genome.h"
+
+#include "cIslandUniverse.h"
+#include "cMerit.h"
+#include "cMigrationMatrix.h"
+#include "cOrganism.h"
+#include "cPhenotype.h"
+#include "cPopulation.h"
+#include "cPopulationCell.h"
+#include "cStats.h"
+
+
+cIslandWorld* cIslandWorld::Initialize(cAvidaConfig* cfg, const cString& working_dir, World* new_world,
+                                       cIslandUniverse* universe, cMigrationMatrix* topology, int island_id,
+                                       cUserFeedback* feedback, const Apto::Map<Apto::String, Apto::String>* mappings)
+{
+  cIslandWorld* world = new cIslandWorld(cfg, working_dir, universe, topology, island_id);
+  if (!world->setup(new_world, feedback, mappings)) {
+    delete world;
+    world = NULL;
+  }
+  return world;
+}
+
+
+void cIslandWorld::MigrateOrganism(cOrganism* org, const cPopulationCell& cell, const cMerit& merit, int lineage)
+{
+  (void)cell;
+  assert(org);
+  
+  // Each row of the topology is only ever sampled by its own island, so the migration counts need no locking
+  const int num_islands = m_universe->GetNumIslands();
+  int dst_island = m_island_id;
+  if (m_topology) {
+    dst_island = m_topology->GetProbabilisticDemeID(m_island_id, GetRandom(), false);
+  } else if (num_islands > 1) {
+    dst_island = GetRandom().GetInt(num_islands - 1);
+    if (dst_island >= m_island_id) dst_island++;
+  }
+  
+  // Migrants are flattened to their string form, so that no reference counted state is shared across threads
+  cIslandUniverse::sMigrant migrant;
+  migrant.genome = org->GetGenome().AsString();
+  migrant.merit = merit.GetDouble();
+  migrant.lineage = lineage;
+  migrant.generation = org->GetPhenotype().GetGeneration();
+  m_universe->SendMigrant(m_island_id, dst_island, migrant);
+  
+  GetStats().OutgoingMigrant(org);
+}
+
+
+bool cIslandWorld::TestForMigration()
+{
+  return GetRandom().P(m_conf->MP_ISLAND_MIGRATION_RATE.Get());
+}
+
+
+void cIslandWorld::ProcessPostUpdate(cAvidaContext& ctx)
+{
+  Apto::Array<cIslandUniverse::sMigrant, Apto::Smart> arrivals;
+  bool finished = false;
+  m_universe_popsize = m_universe->Exchange(m_island_id, GetPopulation().GetNumOrganisms(), arrivals, finished);
+  
+  // Another island has stopped, so every island stops at this update boundary
+  if (finished) {
+    m_universe_finished = true;
+    GetDriver().Finish();
+    return;
+  }
+  if (m_universe_popsize == 0) m_universe_finished = true;
+  
+  // Arrivals are injected at random locations (mass action), as with cMultiProcessWorld
+  cPopulation& pop = GetPopulation();
+  for (int i = 0; i < arrivals.GetSize(); i++) {
+    const int target_cell = ctx.GetRandom().GetInt(pop.GetSize());
+    pop.InjectGenome(target_cell, Systematics::Source(Systematics::DUPLICATION, "migrant"), Genome(arrivals[i].genome), ctx,
+                     arrivals[i].lineage);
+    
+    cOrganism* org = pop.GetCell(target_cell).GetOrganism();
+    if (!org) continue;
+    org->UpdateMerit(ctx, arrivals[i].merit);
+    org->GetPhenotype().SetGeneration(arrivals[i].generation);
+    GetStats().IncomingMigrant(org);
+  }
+}
+
+
+void cIslandWorld::ProcessFinish(cAvidaContext&)
+{
+  // Islands that stopped together at the last boundary are done, otherwise release the others from the next one
+  if (m_universe_finished) return;
+  
+  Apto::Array<cIslandUniverse::sMigrant, Apto::Smart> arrivals;
+  bool finished = true;
+  m_universe->Exchange(m_island_id, GetPopulation().GetNumOrganisms(), arrivals, finished);
+  m_universe_finished = true;
+}
@@ -0,0 +1,80 @@
+/*
+ *  cIslandWorld.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cIslandWorld_h
+#define cIslandWorld_h
+
+#include "cWorld.h"
+
+class cIslandUniverse;
+
+
+/*! Island world, one of several populations run concurrently in a single process.
+
+ This is the shared memory counterpart of cMultiProcessWorld.  Each island is stepped by its own thread and offspring
+ migrate between islands through a cIslandUniverse, which synchronizes all islands at update boundaries.  Destination
+ islands are drawn from the cMigrationMatrix topology when one is supplied, otherwise uniformly from the other islands.
+ Since every island has its own random number generator and migrants are delivered in a fixed order, runs are
+ reproducible for a given seed and island count.
+ */
+class cIslandWorld : public cWorld
+{
+private:
+  cIslandUniverse* m_universe;
+  cMigrationMatrix* m_topology;
+  int m_island_id;
+  int m_universe_popsize; //!< Total size of the universe, as of the last update boundary.
+  bool m_universe_finished; //!< True once all islands are stopping at the last update boundary.
+  
+  
+  cIslandWorld(); // @not_implemented
+  cIslandWorld(const cIslandWorld&); // @not_implemented
+  cIslandWorld& operator=(const cIslandWorld&); // @not_implemented
+  
+  cIslandWorld(cAvidaConfig* cfg, const cString& wd, cIslandUniverse* universe, cMigrationMatrix* topology, int island_id)
+    : cWorld(cfg, wd), m_universe(universe), m_topology(topology), m_island_id(island_id), m_universe_popsize(-1)
+    , m_universe_finished(false) { ; }
+  
+public:
+  //! Create and initialize an island.  The universe and topology (which may be NULL) are shared and not owned.
+  static cIslandWorld* Initialize(cAvidaConfig* cfg, const cString& working_dir, World* new_world, cIslandUniverse* universe,
+                                  cMigrationMatrix* topology, int island_id, cUserFeedback* feedback = NULL,
+                                  const Apto::Map<Apto::String, Apto::String>* mappings = NULL);
+  ~cIslandWorld() { ; }
+  
+  int GetIslandID() const { return m_island_id; }
+  
+  //! Migrate this organism to a different island, arriving at the end of the current update.
+  void MigrateOrganism(cOrganism* org, const cPopulationCell& cell, const cMerit& merit, int lineage);
+  
+  //! Returns true if an offspring should be migrated to a different island.
+  bool TestForMigration();
+  
+  //! Synchronize with the other islands and inject any migrants that have arrived.
+  void ProcessPostUpdate(cAvidaContext& ctx);
+  
+  //! Tell the other islands that this one has stopped (e.g. through an Exit event), so that they stop as well.
+  void ProcessFinish(cAvidaContext& ctx);
+  
+  //! Early exit is only allowed once every island is empty, so that all islands stop on the same update.
+  bool AllowsEarlyExit() const { return m_universe_popsize == 0; }
+};
+
+#endif
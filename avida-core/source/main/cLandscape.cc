@@ -32,6 +32,7 @@
 #include "cPhenotype.h"
 #include "cStats.h"             // For GetUpdate in outputs...
 #include "cTestCPU.h"
+#include "cTestCPUCache.h"
 #include "cWorld.h"
 
 
@@ -96,9 +97,10 @@ void cLandscape::Reset(const Genome& in_genome)
 
 double cLandscape::ProcessGenome(cAvidaContext& ctx, cTestCPU* testcpu, Genome& in_genome)
 {
-  testcpu->TestGenome(ctx, m_cpu_test_info, in_genome);
+  sCPUTestSummary summary;
+  testcpu->TestGenome(ctx, m_cpu_test_info, in_genome, summary);
   
-  double test_fitness = m_cpu_test_info.GetColonyFitness();
+  double test_fitness = summary.colony_fitness;
   
   total_fitness += test_fitness;
   total_sqr_fitness += test_fitness * test_fitness;
@@ -921,8 +923,9 @@ double cLandscape::TestMutPair(cAvidaContext& ctx, cTestCPU* testcpu, Genome& mo
 
   mod_seq[line1] = mut1;
   mod_seq[line2] = mut2;
-  testcpu->TestGenome(ctx, m_cpu_test_info, mod_genome);
-  double combo_fitness = m_cpu_test_info.GetColonyFitness() / base_fitness;
+  sCPUTestSummary summary;
+  testcpu->TestGenome(ctx, m_cpu_test_info, mod_genome, summary);
+  double combo_fitness = summary.colony_fitness / base_fitness;
   
   mod_seq[line1] = base_seq[line1];
   mod_seq[line2] = base_seq[line2];
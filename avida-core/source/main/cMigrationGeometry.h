@@ -0,0 +1,56 @@
+/*
+ *  cMigrationGeometry.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cMigrationGeometry_h
+#define cMigrationGeometry_h
+
+
+// Routing of spatial migrants between the worlds of an Avida-MP universe, a square grid of universe_dim x universe_dim
+// worlds that wraps around its edges.  Kept free of MPI, so that cMultiProcessWorld (which needs Boost) and the unit
+// tests share it.  A loopback universe (MP_LOOPBACK) is a single world whose neighbors are all itself.
+class cMigrationGeometry
+{
+public:
+  // Rank of the world a migrant leaving boundary cell (x, y) of the world at (universe_x, universe_y) moves to
+  static int DestinationWorld(int x, int y, int world_x, int world_y, int universe_x, int universe_y, int universe_dim)
+  {
+    int dst_x = universe_x;
+    int dst_y = universe_y;
+    if (x == 0) --dst_x;                      // migrate left
+    else if (x == world_x - 1) ++dst_x;       // migrate right
+    else if (y == 0) --dst_y;                 // migrate down
+    else if (y == world_y - 1) ++dst_y;       // migrate up
+    dst_x = (dst_x + universe_dim) % universe_dim;
+    dst_y = (dst_y + universe_dim) % universe_dim;
+    return dst_y * universe_dim + dst_x;
+  }
+
+  // Cell a spatial migrant from cell (x, y) arrives in, the originating cell inverted through the world's center
+  static int ArrivalCell(int x, int y, int world_x, int world_y)
+  {
+    return world_x * (world_y - y - 1) + (world_x - x - 1);
+  }
+
+  // Message tag of the batches shipped for the num_shipped-th update.  At most lag + 1 updates are in flight, and each
+  // of them must use a tag of its own (see cMultiProcessWorld::ProcessPostUpdate()).
+  static int BatchTag(int first_tag, int num_shipped, int lag) { return first_tag + (num_shipped % (lag + 1)); }
+};
+
+#endif
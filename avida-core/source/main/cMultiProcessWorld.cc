@@ -28,22 +28,24 @@
 #endif
 
 #if BOOST_IS_AVAILABLE
+#include "avida/core/Genome.h"
 #include "avida/core/Sequence.h"
 
 #include "cOrganism.h"
 #include "cPhenotype.h"
 #include "cMerit.h"
+#include "cMigrationGeometry.h"
 #include "cWorld.h"
 #include "cPopulation.h"
 #include "cPopulationCell.h"
 #include "cMultiProcessWorld.h"
 #include "nGeometry.h"
 #include <map>
+#include <algorithm>
 #include <functional>
 #include <iostream>
 #include <sstream>
 #include <cmath>
-#include <boost/optional.hpp>
 
 using namespace Avida;
 
@@ -53,40 +55,26 @@ static const char* UPDATE="mean update time [ut]";
 static const char* POSTUPDATE="mean post-update time [post]";
 static const char* CALCUPDATE="mean calc-update time [calc]";
 
-/*! Message that is sent from one cMultiProcessWorld to another during organism
- migration.
+//! First tag used for migration batches; each update in flight gets its own, see ProcessPostUpdate().
+static const int MIGRATION_TAG=0;
+
+
+/*! Pack an organism into a migration message.
  */
-struct migration_message {
-	//! Default constructor.
-	migration_message() { }
-	
-	//! Initializing constructor.
-	migration_message(cOrganism* org, const cPopulationCell& cell, double merit, int lineage)
-	: _merit(merit), _lineage(lineage) {
-		_genome = org->GetGenome().AsString();
-		cell.GetPosition(_x, _y);
-		_generation = org->GetPhenotype().GetGeneration();
-	}
+cMultiProcessWorld::migration_message::migration_message(cOrganism* org, const cPopulationCell& cell, double merit, int lineage)
+: _merit(merit), _lineage(lineage) {
+	_genome = (const char*)org->GetGenome().AsString();
+	cell.GetPosition(_x, _y);
+	_generation = org->GetPhenotype().GetGeneration();
+}
 
-	//! Finish unpacking an organism from this message.
-	void unpack(cOrganism* org) {
-		org->UpdateMerit(cAvidaContext& ctx, _merit);
-		org->GetPhenotype().SetGeneration(_generation);
-	}	
-	
-	//! Serializer, used to (de)marshal organisms for migration.
-	template<class Archive>
-	void serialize(Archive & ar, const unsigned int version) {
-		ar & _genome & _merit & _lineage & _x & _y & _generation;
-	}
-	
-	std::string _genome; //!< Genome of the migrating organism.
-	double _merit; //!< Merit of this organism in its originating population.
-	int _lineage; //!< Lineage label of this organism in its orginating population.
-	int _x; //!< X-coordinate of the cell from which this migrant originated.
-	int _y; //!< Y-coordinate of the cell from which this migrant originated.
-	int _generation; //!< Generation of this organism.
-};
+
+/*! Finish unpacking an organism from this message.
+ */
+void cMultiProcessWorld::migration_message::unpack(cAvidaContext& ctx, cOrganism* org) {
+	org->UpdateMerit(ctx, _merit);
+	org->GetPhenotype().SetGeneration(_generation);
+}
 
 
 /*! Create and initialize a cMultiProcessWorld.
@@ -114,24 +102,57 @@ cMultiProcessWorld::cMultiProcessWorld(cAvidaConfig* cfg, const cString& cwd, bo
 , m_universe_dim(0)
 , m_universe_x(0)
 , m_universe_y(0)
-, m_universe_popsize(-1) {
+, m_universe_popsize(-1)
+, m_num_shipped(0) {
+	m_outbox.resize(GetNumWorlds());
+	
 	if(GetConfig().BIRTH_METHOD.Get() == POSITION_OFFSPRING_RANDOM) {
-		// there are a couple bugs in spatial that still need to be worked out:
-		// specifically, what to do about size(1) universes?
-		GetDriver().RaiseFatalException(-1, "Spatial Avida-MP worlds are not currently supported.");
-
-		m_universe_dim = sqrt(m_mpi_world.size());
-		if((m_universe_dim*m_universe_dim) != m_mpi_world.size()) {
+		// the universe is a square grid of worlds; in loopback mode it is a single world,
+		// whose neighbors on a torus are all itself.
+		m_universe_dim = sqrt(GetNumWorlds());
+		if((m_universe_dim*m_universe_dim) != GetNumWorlds()) {
 			GetDriver().RaiseFatalException(-1, "Spatial Avida-MP worlds must be square.");
 		}
 		
 		// where is *this* world in the universe?
-		m_universe_x = m_mpi_world.rank() % m_universe_dim;
-		m_universe_y = m_mpi_world.rank() / m_universe_dim;
+		m_universe_x = GetWorldRank() % m_universe_dim;
+		m_universe_y = GetWorldRank() / m_universe_dim;
 	}
 }
 
 
+/*! Destructor.
+ 
+ Completes any migration traffic still in flight, so that no buffer is released while
+ MPI may still be using it.  Migrants that have not reached their lag are discarded.
+ */
+cMultiProcessWorld::~cMultiProcessWorld() {
+	while(!m_pending.empty()) {
+		boost::mpi::wait_all(m_pending.front()->reqs.begin(), m_pending.front()->reqs.end());
+		delete m_pending.front();
+		m_pending.pop_front();
+	}
+}
+
+
+/*! Number of worlds participating in migration.
+ 
+ In loopback mode (MP_LOOPBACK) this world behaves as a universe of one, and every
+ migrant travels through the batching and lag machinery back into this population
+ without any MPI communication.
+ */
+int cMultiProcessWorld::GetNumWorlds() const {
+	return m_conf->MP_LOOPBACK.Get() ? 1 : m_mpi_world.size();
+}
+
+
+/*! Rank of this world among those participating in migration.
+ */
+int cMultiProcessWorld::GetWorldRank() const {
+	return m_conf->MP_LOOPBACK.Get() ? 0 : m_mpi_world.rank();
+}
+
+
 /*! Migrate this organism to a different world.
  
  If this method is called, it means that this organism is to be migrated to a
@@ -148,29 +169,20 @@ void cMultiProcessWorld::MigrateOrganism(cOrganism* org, const cPopulationCell&
 		case POSITION_OFFSPRING_RANDOM: { // spatial, random in neighborhood
 			int x, y;
 			cell.GetPosition(x,y);
-			if(x == 0) {
-				// migrate left
-				dst_world = m_mpi_world.rank() - 1;
-			} else if(x == (GetConfig().WORLD_X.Get()-1)) {
-				// migrate right
-				dst_world = m_mpi_world.rank() + 1;
-			} else if(y == 0) {
-				// migrate down
-				dst_world = m_mpi_world.rank() - m_universe_dim;
-			} else if(y == (GetConfig().WORLD_Y.Get()-1)) {
-				// migrate up
-				dst_world = m_mpi_world.rank() + m_universe_dim;
-			}
+			// neighbors wrap around the edges of the universe (on a bounded grid, IsWorldBoundary
+			// never lets the universe's own edge cells get here).
+			dst_world = cMigrationGeometry::DestinationWorld(x, y, GetConfig().WORLD_X.Get(), GetConfig().WORLD_Y.Get(),
+			                                                 m_universe_x, m_universe_y, m_universe_dim);
 			break;
 		}
 		case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action
 			// prevent a migration back to this same world, unless this is the only world
 			// we have:
-			if(m_mpi_world.size() == 1) {
+			if(GetNumWorlds() == 1) {
 				dst_world = 0;
 			} else {
-				dst_world = GetRandom().GetInt(m_mpi_world.size()-1);
-				if (dst_world >= m_mpi_world.rank()) {
+				dst_world = GetRandom().GetInt(GetNumWorlds()-1);
+				if (dst_world >= GetWorldRank()) {
 					++dst_world;
 				}
 			}
@@ -181,12 +193,11 @@ void cMultiProcessWorld::MigrateOrganism(cOrganism* org, const cPopulationCell&
 		}
 	}
 
-	assert(dst_world < m_mpi_world.size());
+	assert(dst_world < GetNumWorlds());
 	assert(dst_world >= 0);
 
-	// the tag is set to the number of messages previously sent; this is to allow
-	// the receiver to sort messages for consistency.
-	m_reqs.push_back(m_mpi_world.isend(dst_world, m_reqs.size(), migration_message(org, cell, merit.GetDouble(), lineage)));
+	// migrants are batched per destination, and shipped together at the end of the update:
+	m_outbox[dst_world].push_back(migration_message(org, cell, merit.GetDouble(), lineage));
 	
 	// stats tracking:
 	GetStats().OutgoingMigrant(org);
@@ -210,10 +221,10 @@ void cMultiProcessWorld::MigrateOrganism(cOrganism* org, const cPopulationCell&
 bool cMultiProcessWorld::TestForMigration() {
 	switch(GetConfig().BIRTH_METHOD.Get()) {
 		case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action
-			if(m_mpi_world.size() == 1) {
+			if(GetNumWorlds() == 1) {
 				return true; // 1 world == always migrate
 			}
-			return GetRandom().P((m_mpi_world.size() - 1) / m_mpi_world.size());
+			return GetRandom().P(static_cast<double>(GetNumWorlds() - 1) / GetNumWorlds());
 		}
 		default: {
 			// default is to not migrate!
@@ -258,65 +269,87 @@ bool cMultiProcessWorld::IsWorldBoundary(const cPopulationCell& cell) {
 
 /*! Process post-update events.
  
- This method is called after each update of the local population completes.  Here
- we check to see if this world has received any migrants from other worlds, and if
- so, we inject them into the local population.  Note that this is an unconditional
- injection -- that is, migrants are "pushed" to this world.
+ This method is called after each update of the local population completes.  Migrants
+ sent during this update are shipped as one packed batch per destination world, and a
+ matching non-blocking receive is posted for the batch each other world sends us.  Every
+ world sends exactly one batch (possibly empty) to every other world per update, so the
+ n-th batch received from a world is always its n-th update.
  
- Migrants are injected according to BIRTH_METHOD.
+ Migrants then spend MP_MIGRATION_LAG updates in transit: the batches sent during update
+ u are injected at the end of update u + MP_MIGRATION_LAG.  We only wait on the batches
+ that are due, so a world may run up to the lag ahead of its slowest peer, and there is
+ no world-wide barrier.  Because batches are applied in order of source rank, and then
+ send order, results do not depend on message timing.
  
  \todo What to do about cross-world lineage labels?
- 
- \todo At the moment, this method forces synchronization on update boundaries across
- *all* worlds.  This could slow things down quite a bit, so we may need to consider a
- second mode that relaxes consistency in favor of speed.
  */
 void cMultiProcessWorld::ProcessPostUpdate(cAvidaContext& ctx) {
 	namespace mpi = boost::mpi;
-	using namespace boost;
 	
 	// restart the timer for this method, and get the elapsed time for the past update:
 	m_pf[UPDATE] = m_update_timer.elapsed();
 	m_post_update_timer.restart();
 	
-	// wait until we're sure that this process has sent all its messages:
-	mpi::wait_all(m_reqs.begin(), m_reqs.end());
-	m_reqs.clear();
+	const int num_worlds = GetNumWorlds();
+	const int rank = GetWorldRank();
+	const int lag = std::max(0, GetConfig().MP_MIGRATION_LAG.Get());
+	
+	// a serialized irecv is two receives on its tag (size, then payload), so two batches from the same world must
+	// never be awaited on the same tag.  At most lag+1 updates are in flight, so cycling through lag+1 tags keeps them
+	// apart, and a tag is only reused once the receive that last used it has completed.
+	const int tag = cMigrationGeometry::BatchTag(MIGRATION_TAG, m_num_shipped++, lag);
 	
-	// at this point, we know that *this* process has sent everything.  but, we don't
-	// know if it's *received* everything.  so, we're going to put in a synchronization
-	// barrier, which means that every process must reach the barrier before any are allowed
-	// to proceed.  since we just finished waiting for all communication to complete,
-	// this means that all messages must have been received, too.
-	m_mpi_world.barrier();	
+	// ship this update's migrants; the batch addressed to ourselves never leaves the process:
+	pending_update* update = new pending_update;
+	update->outgoing.swap(m_outbox);
+	update->incoming.resize(num_worlds);
+	m_outbox.resize(num_worlds);
+	for(int w=0; w<num_worlds; ++w) {
+		if(w == rank) {
+			update->incoming[w].swap(update->outgoing[w]);
+		} else {
+			update->reqs.push_back(m_mpi_world.isend(w, tag, update->outgoing[w]));
+			update->reqs.push_back(m_mpi_world.irecv(w, tag, update->incoming[w]));
+		}
+	}
+	m_pending.push_back(update);
 	
-	// now, receive all the messages, but store them in order by source and tag:
-	typedef std::map<int,migration_message> rx_tag_t;
-	typedef std::map<int,rx_tag_t> rx_src_t;
-	rx_src_t recvd;
-	optional<mpi::status> s = m_mpi_world.iprobe(mpi::any_source,mpi::any_tag);
-	while(s.is_initialized()) {
-		migration_message msg;
-		m_mpi_world.recv(s->source(), s->tag(), msg);
-		recvd[s->source()][s->tag()] = msg;		
-		// any others?
-		s = m_mpi_world.iprobe(mpi::any_source,mpi::any_tag);		
+	// apply the update whose migrants have now been in transit for the configured lag:
+	while(static_cast<int>(m_pending.size()) > lag) {
+		pending_update* due = m_pending.front();
+		m_pending.pop_front();
+		mpi::wait_all(due->reqs.begin(), due->reqs.end());
+		ApplyMigrants(ctx, *due);
+		delete due;
 	}
 	
-	// iterate over received messages in-order, injecting genomes into our population:
-	for(rx_src_t::iterator i=recvd.begin(); i!=recvd.end(); ++i) {
-		for(rx_tag_t::iterator j=i->second.begin(); j!=i->second.end(); ++j) {
-			//std::cerr << "**********  INJECTING *********** " << i->first << " " << j->first << std::endl;
+	// record profiling stats:
+	m_pf[POSTUPDATE] = m_post_update_timer.elapsed();
+	GetStats().ProfilingData(m_pf);
+	m_pf.clear();
+	
+	// restart the update timer!
+	m_update_timer.restart();
+}
+
+
+/*! Inject all migrants from a completed update into the local population.
+ 
+ Migrants are injected according to BIRTH_METHOD.  Note that this is an unconditional
+ injection -- that is, migrants are "pushed" to this world.
+ */
+void cMultiProcessWorld::ApplyMigrants(cAvidaContext& ctx, pending_update& update) {
+	for(int src=0; src<static_cast<int>(update.incoming.size()); ++src) {
+		migration_batch& batch = update.incoming[src];
+		for(migration_batch::iterator i=batch.begin(); i!=batch.end(); ++i) {
 			// ok, add this migrant to the current population
-			migration_message& migrant = j->second;
+			migration_message& migrant = *i;
 			int target_cell=-1;
 			
 			switch(GetConfig().BIRTH_METHOD.Get()) {
 				case POSITION_OFFSPRING_RANDOM: { // spatial
 					// invert the orginating cell
-					migrant._x = GetConfig().WORLD_X.Get() - migrant._x - 1;
-					migrant._y = GetConfig().WORLD_Y.Get() - migrant._y - 1;
-					target_cell = GetConfig().WORLD_Y.Get() * migrant._y + migrant._x;
+					target_cell = cMigrationGeometry::ArrivalCell(migrant._x, migrant._y, GetConfig().WORLD_X.Get(), GetConfig().WORLD_Y.Get());
 					break;
 				}
 				case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action
@@ -329,30 +362,16 @@ void cMultiProcessWorld::ProcessPostUpdate(cAvidaContext& ctx) {
 			}
 			
 			GetPopulation().InjectGenome(target_cell,
-																	 SRC_ORGANISM_RANDOM, // for right now, we'll treat this as a random organism injection
-																	 Genome(cString(migrant._genome.c_str())), // genome unpacked from message
+																	 Systematics::Source(Systematics::DUPLICATION, "migrant"),
+																	 Genome(Apto::String(migrant._genome.c_str())), // genome unpacked from message
 																	 ctx, migrant._lineage); // lineage label
 			// unpack the rest from the message:
-			migrant.unpack(GetPopulation().GetCell(target_cell).GetOrganism());
-			GetStats().IncomingMigrant(GetPopulation().GetCell(target_cell).GetOrganism());
+			cOrganism* org = GetPopulation().GetCell(target_cell).GetOrganism();
+			if(org == 0) continue;
+			migrant.unpack(ctx, org);
+			GetStats().IncomingMigrant(org);
 		}
 	}
-	
-	// oh, sweet sanity; make sure that we actually processed all messages.
-	assert(!m_mpi_world.iprobe(mpi::any_source,mpi::any_tag).is_initialized());
-	
-	// finally, we need another barrier down here, in the off chance that one of the
-	// processes is really speedy and manages to migrate another org to this world
-	// before we finished the probe-loop.
-	m_mpi_world.barrier();
-
-	// record profiling stats:
-	m_pf[POSTUPDATE] = m_post_update_timer.elapsed();
-	GetStats().ProfilingData(m_pf);
-	m_pf.clear();
-	
-	// restart the update timer!
-	m_update_timer.restart();
 }
 
 
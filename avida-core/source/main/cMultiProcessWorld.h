@@ -25,7 +25,11 @@
 #include <boost/mpi.hpp>
 #include <boost/mpi/environment.hpp>
 #include <boost/mpi/communicator.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
 #include <boost/timer.hpp>
+#include <deque>
+#include <string>
 #include <vector>
 
 #include "cWorld.h"
@@ -42,6 +46,45 @@
  */
 class cMultiProcessWorld : public cWorld
 	{
+	public:
+		/*! Message that is sent from one cMultiProcessWorld to another during organism
+		 migration.
+		 */
+		struct migration_message {
+			//! Default constructor.
+			migration_message() { }
+			
+			//! Initializing constructor.
+			migration_message(cOrganism* org, const cPopulationCell& cell, double merit, int lineage);
+			
+			//! Finish unpacking an organism from this message.
+			void unpack(cAvidaContext& ctx, cOrganism* org);
+			
+			//! Serializer, used to (de)marshal organisms for migration.
+			template<class Archive>
+			void serialize(Archive & ar, const unsigned int version) {
+				ar & _genome & _merit & _lineage & _x & _y & _generation;
+			}
+			
+			std::string _genome; //!< Genome of the migrating organism.
+			double _merit; //!< Merit of this organism in its originating population.
+			int _lineage; //!< Lineage label of this organism in its orginating population.
+			int _x; //!< X-coordinate of the cell from which this migrant originated.
+			int _y; //!< Y-coordinate of the cell from which this migrant originated.
+			int _generation; //!< Generation of this organism.
+		};
+		
+		//! All migrants sent from one world to another during a single update, shipped as one message.
+		typedef std::vector<migration_message> migration_batch;
+		
+	private:
+		//! Migration traffic for a single update, held until it has been sent, received and applied.
+		struct pending_update {
+			std::vector<migration_batch> outgoing; //!< Batches sent to each world (indexed by rank).
+			std::vector<migration_batch> incoming; //!< Batches received from each world (indexed by rank).
+			std::vector<boost::mpi::request> reqs; //!< Outstanding sends and receives for this update.
+		};
+		
 	private:
 		cMultiProcessWorld(); // @not_implemented
 		cMultiProcessWorld(const cMultiProcessWorld&); // @not_implemented
@@ -50,11 +93,13 @@ class cMultiProcessWorld : public cWorld
 	protected:
 		boost::mpi::environment& m_mpi_env; //!< MPI environment.
 		boost::mpi::communicator& m_mpi_world; //!< World-wide MPI communicator.
-		std::vector<boost::mpi::request> m_reqs; //!< Requests outstanding since the last ProcessPostUpdate.
+		std::vector<migration_batch> m_outbox; //!< Migrants sent during the current update, by destination rank.
+		std::deque<pending_update*> m_pending; //!< Updates whose migrants have not yet been applied, oldest first.
 		int m_universe_dim; //!< Dimension (x & y) of the universe (number of worlds along the side of a grid of worlds).
 		int m_universe_x; //!< X coordinate of this world.
 		int m_universe_y; //!< Y coordinate of this world.
 		int m_universe_popsize; //!< Total size of the universe, delayed one update.
+		int m_num_shipped; //!< Number of updates whose migrants have been shipped, selects each batch's tag.
 		
 		boost::timer m_update_timer; //!< Tracks the clock-time of updates.
 		boost::timer m_post_update_timer; //!< Tracks the clock-time of post-update processing.
@@ -69,7 +114,7 @@ class cMultiProcessWorld : public cWorld
 		static cMultiProcessWorld* Initialize(cAvidaConfig* cfg, const cString& cwd, boost::mpi::environment& env, boost::mpi::communicator& worldcomm);
 		
 		//! Destructor.
-		virtual ~cMultiProcessWorld() { }
+		virtual ~cMultiProcessWorld();
 		
 		//! Migrate this organism to a different world.
 		virtual void MigrateOrganism(cOrganism* org, const cPopulationCell& cell,
@@ -89,6 +134,16 @@ class cMultiProcessWorld : public cWorld
 		
 		//! Calculate the size (in virtual CPU cycles) of the current update.
 		virtual int CalculateUpdateSize();
+		
+	protected:
+		//! Number of worlds participating in migration (1 in loopback mode).
+		int GetNumWorlds() const;
+		
+		//! Rank of this world among those participating in migration (0 in loopback mode).
+		int GetWorldRank() const;
+		
+		//! Inject all migrants from a completed update into the local population.
+		void ApplyMigrants(cAvidaContext& ctx, pending_update& update);
 	};
 
 #endif
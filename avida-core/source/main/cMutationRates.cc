@@ -25,6 +25,8 @@
 #include "cWorld.h"
 #include "cAvidaConfig.h"
 
+#include <cstring>
+
 
 void cMutationRates::Setup(cWorld* world)
 {
@@ -133,3 +135,11 @@ void cMutationRates::Copy(const cMutationRates& in_muts)
   meta = in_muts.meta;
   update = in_muts.update;
 }
+
+bool cMutationRates::IsClear() const
+{
+  const cMutationRates clear;
+  return (memcmp(&copy, &clear.copy, sizeof(copy)) == 0 && memcmp(&divide, &clear.divide, sizeof(divide)) == 0 &&
+          memcmp(&point, &clear.point, sizeof(point)) == 0 && memcmp(&inject, &clear.inject, sizeof(inject)) == 0 &&
+          memcmp(&meta, &clear.meta, sizeof(meta)) == 0 && memcmp(&update, &clear.update, sizeof(update)) == 0);
+}
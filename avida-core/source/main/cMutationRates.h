@@ -97,6 +97,11 @@ private:
     double death_prob;    
   };
   sUpdateMuts update;
+  
+  static bool testDivide(cAvidaContext& ctx, double prob)
+  {
+    return (prob == 0.0) ? ctx.GetRandomUncounted().P(prob) : ctx.GetRandom().P(prob);
+  }
 
 public:
   cMutationRates() { Clear(); }
@@ -107,6 +112,7 @@ public:
   void Setup(cWorld* world);
   void Clear();
   void Copy(const cMutationRates& in_muts);
+  bool IsClear() const;
 
   // Copy muts should always check if they are 0.0 before consulting the random number generator for performance
   bool TestCopyMut(cAvidaContext& ctx) const { return (copy.mut_prob == 0.0) ? false : ctx.GetRandom().P(copy.mut_prob); }
@@ -118,14 +124,16 @@ public:
     return (copy.uniform_prob == 0.0) ? false : ctx.GetRandom().P(copy.uniform_prob);
   }
   
-  bool TestDivideMut(cAvidaContext& ctx) const { return ctx.GetRandom().P(divide.divide_mut_prob); }
-  bool TestDivideIns(cAvidaContext& ctx) const { return ctx.GetRandom().P(divide.divide_ins_prob); }
-  bool TestDivideDel(cAvidaContext& ctx) const { return ctx.GetRandom().P(divide.divide_del_prob); }
+  // These divide muts draw even at 0.0, keeping the random stream of existing runs.  A draw at 0.0 cannot come out
+  // true, so it is not counted as a use of the random number generator (see cAvidaContext::GetRandomUses()).
+  bool TestDivideMut(cAvidaContext& ctx) const { return testDivide(ctx, divide.divide_mut_prob); }
+  bool TestDivideIns(cAvidaContext& ctx) const { return testDivide(ctx, divide.divide_ins_prob); }
+  bool TestDivideDel(cAvidaContext& ctx) const { return testDivide(ctx, divide.divide_del_prob); }
   bool TestDivideUniform(cAvidaContext& ctx) const
   {
     return (divide.divide_uniform_prob == 0.0) ? false : ctx.GetRandom().P(divide.divide_uniform_prob);
   }
-  bool TestDivideSlip(cAvidaContext& ctx) const { return ctx.GetRandom().P(divide.divide_slip_prob); }
+  bool TestDivideSlip(cAvidaContext& ctx) const { return testDivide(ctx, divide.divide_slip_prob); }
   bool TestDivideTrans(cAvidaContext& ctx) const
   {
     return (divide.divide_trans_prob == 0.0) ? false : ctx.GetRandom().P(divide.divide_trans_prob);
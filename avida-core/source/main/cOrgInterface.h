@@ -45,6 +45,7 @@ class cOrgMessage;
 class cOrgSinkMessage;
 class cPopulationCell;
 class cResourceCount;
+class cSensingIndex;
 class cString;
 
 using namespace Avida;
@@ -124,6 +125,7 @@ public:
   virtual int GetFrozenPeakX(cAvidaContext& ctx, int res_id) = 0; 
   virtual int GetFrozenPeakY(cAvidaContext& ctx, int res_id) = 0;
   virtual cResourceCount* GetResourceCount() = 0;
+  virtual cSensingIndex* GetSensingIndex() = 0;
   virtual void TriggerDoUpdates(cAvidaContext& ctx) = 0;
   virtual void UpdateResources(cAvidaContext& ctx, const Apto::Array<double>& res_change) = 0;
   virtual void UpdateDemeResources(cAvidaContext& ctx, const Apto::Array<double>& res_change) = 0;
@@ -0,0 +1,86 @@
+/*
+ *  cOrgMessagePool.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cOrgMessagePool_h
+#define cOrgMessagePool_h
+
+#include "apto/core.h"
+
+#include "cOrgMessage.h"
+#include "tRingQueue.h"
+
+
+/*! Population wide free list of organism mailboxes.  An organism takes a mailbox the first time it messages and hands
+it back when it dies, so the queue storage is reused by later generations instead of being reallocated for every
+organism.  Test CPU organisms message too, so the pool is locked. */
+class cOrgMessagePool
+{
+public:
+  struct sMailbox
+  {
+    cOrgMessagePool* pool;             //!< Pool this mailbox returns to.
+    tRingQueue<cOrgMessage> sent;      //!< Most recently sent messages, retained for stats (MESSAGE_SEND_BUFFER_SIZE).
+    tRingQueue<cOrgMessage> received;  //!< Messages waiting to be retrieved (MESSAGE_RECV_BUFFER_SIZE).
+    
+    sMailbox(cOrgMessagePool* in_pool) : pool(in_pool) { ; }
+  };
+  
+private:
+  Apto::Mutex m_mutex;
+  Apto::Array<sMailbox*, Apto::Smart> m_free;
+  
+  
+  cOrgMessagePool(const cOrgMessagePool&); // @not_implemented
+  cOrgMessagePool& operator=(const cOrgMessagePool&); // @not_implemented
+  
+public:
+  cOrgMessagePool() { ; }
+  ~cOrgMessagePool() { for (int i = 0; i < m_free.GetSize(); i++) delete m_free[i]; }
+  
+  //! Returns an empty mailbox able to hold at least the given number of sent and received messages.
+  sMailbox* Acquire(int sent_capacity, int received_capacity)
+  {
+    sMailbox* mailbox = NULL;
+    {
+      Apto::MutexAutoLock lock(m_mutex);
+      if (m_free.GetSize()) mailbox = m_free.Pop();
+    }
+    if (!mailbox) mailbox = new sMailbox(this);
+    
+    mailbox->sent.Reserve(sent_capacity);
+    mailbox->received.Reserve(received_capacity);
+    return mailbox;
+  }
+  
+  //! Returns a mailbox to the pool it was acquired from.
+  static void Release(sMailbox* mailbox) { mailbox->pool->release(mailbox); }
+  
+private:
+  void release(sMailbox* mailbox)
+  {
+    mailbox->sent.Clear();
+    mailbox->received.Clear();
+    
+    Apto::MutexAutoLock lock(m_mutex);
+    m_free.Push(mailbox);
+  }
+};
+
+#endif
@@ -27,9 +27,10 @@
 #include "cPopulationCell.h"
 #include "cResource.h"
 #include "cResourceCount.h"
+#include "cSensingIndex.h"
 
 cOrgSensor::cOrgSensor(cWorld* world, cOrganism* in_organism)
-: m_world(world), m_organism(in_organism), m_res_lib(world->GetEnvironment().GetResourceLib())
+: m_world(world), m_organism(in_organism), m_res_lib(world->GetEnvironment().GetResourceLib()), m_walk_index(NULL)
 {
   ResetOrgSensor();
 }
@@ -426,8 +427,10 @@ cOrgSensor::sLookOut cOrgSensor::PreWalk(cAvidaContext& ctx, sLookInit& in_defs,
   if (!limits.visible) {     // nothing in range
     stuff_seen.report_type = 0;
   } else {
+    m_walk_index = GetWalkIndex(in_defs, val_res);
     if (m_world->GetConfig().WORLD_GEOMETRY.Get() == 2) WalkTorus(ctx, in_defs, facing, cell_id, limits, stuff_seen, center_cell, tot_bounds, worldBounds, val_res, this_cell, ahead_dir, worldx);
     else WalkCells(ctx, in_defs, facing, cell_id, limits, stuff_seen, center_cell, tot_bounds, worldBounds, val_res, this_cell, ahead_dir, worldx);
+    m_walk_index = NULL;
   }
   return stuff_seen;
 }
@@ -485,6 +488,9 @@ void cOrgSensor::WalkCells(cAvidaContext& ctx, sLookInit& in_defs, const int fac
       if (!do_left && direction == left) continue;
       if (!do_right && direction == right) break;
       
+      // cells on this side only need testing if the skip tables show something along it
+      const bool arm_may_hold = ArmMayHold(in_defs, val_res, center_cell, direction, num_cells_either_side);
+      
       // walk in from the farthest cell on side towards the center
       for (int j = num_cells_either_side; j > 0; j--) {
         bool valid_cell = true;
@@ -517,7 +523,7 @@ void cOrgSensor::WalkCells(cAvidaContext& ctx, sLookInit& in_defs, const int fac
         else any_valid_side_cells = true;
         
         // Now we can look at the current side cell because we know it's in the world.
-        if (valid_cell) {
+        if (valid_cell && arm_may_hold && CellMayHold(in_defs, val_res, this_cell, worldx)) {
           cellResultInfo = TestCell(ctx, in_defs, this_cell, val_res, first_step, stop_at_first_found);
           first_step = false;
           
@@ -548,7 +554,7 @@ void cOrgSensor::WalkCells(cAvidaContext& ctx, sLookInit& in_defs, const int fac
     if (stop_at_first_found && found_edible) break;                             // end side and center searches (found on side)
     
     // work on CENTER cell for this dist
-    if (count_center) {
+    if (count_center && CellMayHold(in_defs, val_res, center_cell, worldx)) {
       cellResultInfo = TestCell(ctx, in_defs, center_cell, val_res, first_step, stop_at_first_found);
       
       if (!foundFirstVisible && cellResultInfo.has_some) {
@@ -691,6 +697,9 @@ void cOrgSensor::WalkTorus(cAvidaContext& ctx, sLookInit& in_defs, const int fac
     for (int do_lr = 0; do_lr <= 1; do_lr++) {
       if (do_lr == 1) direction = right;
       
+      // cells on this side only need testing if the skip tables show something along it
+      const bool arm_may_hold = ArmMayHold(in_defs, val_res, center_cell, direction, num_cells_either_side);
+      
       // walk in from the farthest cell on side towards the center
       for (int j = num_cells_either_side; j > 0; j--) {
         bool valid_cell = true;
@@ -708,7 +717,7 @@ void cOrgSensor::WalkTorus(cAvidaContext& ctx, sLookInit& in_defs, const int fac
         else any_valid_side_cells = true;
         
         // Now we can look at the current side cell because we know it's in bounds.
-        if (valid_cell) {
+        if (valid_cell && arm_may_hold && CellMayHold(in_defs, val_res, this_cell, worldx)) {
           cellResultInfo = TestCell(ctx, in_defs, this_cell, val_res, first_step, stop_at_first_found);
           first_step = false;
           
@@ -739,7 +748,7 @@ void cOrgSensor::WalkTorus(cAvidaContext& ctx, sLookInit& in_defs, const int fac
     if (stop_at_first_found && found_edible) break;                             // end side and center searches (found on side)
     
     // work on CENTER cell for this dist
-    if (count_center) {
+    if (count_center && CellMayHold(in_defs, val_res, center_cell, worldx)) {
       cellResultInfo = TestCell(ctx, in_defs, center_cell, val_res, first_step, stop_at_first_found);
       
       if (!foundFirstVisible && cellResultInfo.has_some) {
@@ -1198,6 +1207,60 @@ cOrgSensor::sBounds cOrgSensor::GetBounds(cAvidaContext& ctx, const int res_id)
   return res_bounds;
 }
 
+/* Skip tables are only used when skipping a cell can not change the outcome of the walk: every resource sought must be
+ * spatial (global resources are counted on the first step only), and must only register in a cell with a positive amount.
+ */
+cSensingIndex* cOrgSensor::GetWalkIndex(const sLookInit& in_defs, const Apto::Array<int, Apto::Smart>& val_res)
+{
+  cSensingIndex* index = m_organism->GetOrgInterface().GetSensingIndex();
+  if (index == NULL || in_defs.habitat == -2) return index;
+  
+  const bool positive_only = (in_defs.habitat == 1 || in_defs.habitat == 2 || in_defs.habitat == 5);
+  for (int k = 0; k < val_res.GetSize(); k++) {
+    const cResource* res = m_res_lib.GetResource(val_res[k]);
+    if (res->GetGeometry() == nGeometry::GLOBAL || res->GetGeometry() == nGeometry::PARTIAL) return NULL;
+    if (!positive_only && res->GetThreshold() <= 0) return NULL;
+  }
+  for (int k = 0; k < val_res.GetSize(); k++) index->SyncResource(val_res[k]);
+  return index;
+}
+
+bool cOrgSensor::ArmMayHold(const sLookInit& in_defs, const Apto::Array<int, Apto::Smart>& val_res, const Apto::Coord<int>& center_cell, const Apto::Coord<int>& direction, int len)
+{
+  if (m_walk_index == NULL) return true;
+  
+  const int x = center_cell.X();
+  const int y = center_cell.Y();
+  const int dx = direction.X();
+  const int dy = direction.Y();
+  if (in_defs.habitat == -2) {
+    if (!m_use_avatar) return m_walk_index->AnyOccupiedInArm(cSensingIndex::OCC_ORGANISM, x, y, dx, dy, len);
+    if (in_defs.search_type >= 0 && m_walk_index->AnyOccupiedInArm(cSensingIndex::OCC_PRED_AV, x, y, dx, dy, len)) return true;
+    if (in_defs.search_type <= 0 && m_walk_index->AnyOccupiedInArm(cSensingIndex::OCC_PREY_AV, x, y, dx, dy, len)) return true;
+    return false;
+  }
+  for (int k = 0; k < val_res.GetSize(); k++) {
+    if (m_walk_index->AnyResourceInArm(val_res[k], x, y, dx, dy, len)) return true;
+  }
+  return false;
+}
+
+bool cOrgSensor::CellMayHold(const sLookInit& in_defs, const Apto::Array<int, Apto::Smart>& val_res, const Apto::Coord<int>& cell, int worldx)
+{
+  if (m_walk_index == NULL) return true;
+  
+  const int cell_id = cell.X() + (cell.Y() * worldx);
+  if (in_defs.habitat == -2) {
+    if (!m_use_avatar) return m_walk_index->IsOccupied(cSensingIndex::OCC_ORGANISM, cell_id);
+    return (in_defs.search_type >= 0 && m_walk_index->IsOccupied(cSensingIndex::OCC_PRED_AV, cell_id)) ||
+           (in_defs.search_type <= 0 && m_walk_index->IsOccupied(cSensingIndex::OCC_PREY_AV, cell_id));
+  }
+  for (int k = 0; k < val_res.GetSize(); k++) {
+    if (m_walk_index->HasResource(val_res[k], cell_id)) return true;
+  }
+  return false;
+}
+
 Apto::Array<int, Apto::Smart> cOrgSensor::BuildResArray(sLookInit& in_defs, bool single_bound)
 {
   // for hills and walls, we treat them all as generic and don't allow orgs to select individuals instances of that sort of resource
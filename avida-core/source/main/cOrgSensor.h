@@ -28,6 +28,8 @@
 #include "cResourceLib.h"
 #include "cWorld.h"
 
+class cSensingIndex;
+
 struct sOrgDisplay 
 {
   int distance;
@@ -51,6 +53,8 @@ class cOrgSensor
 
   const cResourceLib& m_res_lib;
   
+  cSensingIndex* m_walk_index;   // skip tables for the current walk, NULL when every cell must be tested
+  
   void ResetOrgSensor();
   
   public:
@@ -146,6 +150,10 @@ class cOrgSensor
   inline bool TestBounds(const Apto::Coord<int>& cell_id, sBounds& bounds_set);
   Apto::Array<int, Apto::Smart> BuildResArray(sLookInit& in_defs, bool single_bound);
   
+  cSensingIndex* GetWalkIndex(const sLookInit& in_defs, const Apto::Array<int, Apto::Smart>& val_res);
+  bool ArmMayHold(const sLookInit& in_defs, const Apto::Array<int, Apto::Smart>& val_res, const Apto::Coord<int>& center_cell, const Apto::Coord<int>& direction, int len);
+  bool CellMayHold(const sLookInit& in_defs, const Apto::Array<int, Apto::Smart>& val_res, const Apto::Coord<int>& cell, int worldx);
+  
   void SetReturnRelativeFacing(bool do_set) { m_return_rel_facing = do_set; }
   int ReturnRelativeFacing(cOrganism* sighted_org);
   
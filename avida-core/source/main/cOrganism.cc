@@ -33,6 +33,7 @@
 #include "cHardwareManager.h"
 #include "cInstSet.h"
 #include "cOrgSensor.h"
+#include "cPopulation.h"
 #include "cPopulationCell.h"
 #include "cStateGrid.h"
 #include "cStringUtil.h"
@@ -57,6 +58,7 @@ static const Apto::BasicString<Apto::ThreadSafe> s_ext_prop_name_instset("instse
 // Internal cOrganism Properties
 // --------------------------------------------------------------------------------------------------------------
 
+// Filled by cOrganism::Initialize() before any world exists, and only read afterwards (worlds may run concurrently)
 static PropertyDescriptionMap s_prop_desc_map;
 
 static const Apto::BasicString<Apto::ThreadSafe> s_prop_name_genome("genome");
@@ -249,7 +251,7 @@ cOrganism::~cOrganism()
   delete m_hardware;
   delete m_interface;
   
-  if(m_msg) delete m_msg;
+  if(m_msg) cOrgMessagePool::Release(m_msg);
   if(m_opinion) delete m_opinion;  
   if (m_neighborhood) delete m_neighborhood;
   delete m_org_display;
@@ -939,6 +941,17 @@ void cOrganism::NewTrial()
 }
 
 
+/*! Takes a mailbox from the population's pool, sized for the configured send
+ and receive buffers.  Unbounded (-1) buffers start small and grow as needed.
+ */
+void cOrganism::AcquireMailbox()
+{
+  const int send_size = m_world->GetConfig().MESSAGE_SEND_BUFFER_SIZE.Get();
+  const int recv_size = m_world->GetConfig().MESSAGE_RECV_BUFFER_SIZE.Get();
+  m_msg = m_world->GetPopulation().GetMessagePool().Acquire((send_size == -1) ? 1 : send_size, (recv_size == -1) ? 8 : recv_size);
+}
+
+
 /*! Called as the bottom-half of a successfully sent message.
  */
 void cOrganism::MessageSent(cAvidaContext&, cOrgMessage& msg) {
@@ -946,15 +959,13 @@ void cOrganism::MessageSent(cAvidaContext&, cOrgMessage& msg) {
 	const int bsize = m_world->GetConfig().MESSAGE_SEND_BUFFER_SIZE.Get();
   
 	if((bsize > 0) || (bsize == -1)) {
-		// yep; store it:
-		m_msg->sent.push_back(msg);
+		// yep; store it, chopping off the oldest message if our buffer is full:
+		if((bsize != -1) && (m_msg->sent.GetSize() >= bsize)) m_msg->sent.PopFront();
+		if(m_msg->sent.IsFull()) m_msg->sent.Reserve(m_msg->sent.GetCapacity() * 2 + 1);
+		m_msg->sent.PushRear(msg);
 		// and set the receiver-pointer of this message to NULL.  We don't want to
 		// walk this list later thinking that the receivers are still around.
-		m_msg->sent.back().SetReceiver(0);
-		// if our buffer is too large, chop off old messages:
-		while((bsize != -1) && (static_cast<int>(m_msg->sent.size()) > bsize)) {
-			m_msg->sent.pop_front();
-		}
+		m_msg->sent.Back().SetReceiver(0);
 	}	
 }
 
@@ -1007,10 +1018,10 @@ void cOrganism::ReceiveMessage(cOrgMessage& msg)
   InitMessaging();
 	// don't store more messages than we're configured to.
 	const int bsize = m_world->GetConfig().MESSAGE_RECV_BUFFER_SIZE.Get();
-	if((bsize != -1) && (bsize <= static_cast<int>(m_msg->received.size()))) {
+	if((bsize != -1) && (bsize <= m_msg->received.GetSize())) {
 		switch (m_world->GetConfig().MESSAGE_RECV_BUFFER_BEHAVIOR.Get()) {
 			case 0: // drop oldest message
-				m_msg->received.pop_front();
+				if(!m_msg->received.IsEmpty()) m_msg->received.PopFront();
 				break;
 			case 1: // drop this message
 				return;
@@ -1022,7 +1033,8 @@ void cOrganism::ReceiveMessage(cOrgMessage& msg)
 	}
   
 	msg.SetReceiver(this);
-	m_msg->received.push_back(msg);
+	if(m_msg->received.IsFull()) m_msg->received.Reserve(m_msg->received.GetCapacity() * 2 + 1);
+	m_msg->received.PushRear(msg);
   
   if (m_world->GetConfig().ACTIVE_MESSAGES_ENABLED.Get() > 0) {
     // then create new thread and load its registers
@@ -1041,10 +1053,10 @@ std::pair<bool, cOrgMessage> cOrganism::RetrieveMessage() {
   InitMessaging();
 	std::pair<bool, cOrgMessage> ret = std::make_pair(false, cOrgMessage());	
 	
-	if(m_msg->received.size() > 0) {
-		ret.second = m_msg->received.front();
+	if(!m_msg->received.IsEmpty()) {
+		ret.second = m_msg->received.Front();
 		ret.first = true;
-		m_msg->received.pop_front();
+		m_msg->received.PopFront();
 	}
 	
 	return ret;
@@ -33,6 +33,7 @@
 #include "cPhenotype.h"
 #include "cOrgInterface.h"
 #include "cOrgMessage.h"
+#include "cOrgMessagePool.h"
 #include "tBuffer.h"
 #include "tList.h"
 
@@ -378,7 +379,7 @@ public:
 
   // -------- Messaging support --------
 public:
-  typedef std::deque<cOrgMessage> message_list_type; //!< Container-type for cOrgMessages.
+  typedef tRingQueue<cOrgMessage> message_list_type; //!< Container-type for cOrgMessages.
 
   //! Called when this organism attempts to send a message.
   bool SendMessage(cAvidaContext& ctx, cOrgMessage& msg);
@@ -393,28 +394,18 @@ public:
   //! Returns the list of all messages sent by this organism.
   const message_list_type& GetSentMessages() { InitMessaging(); return m_msg->sent; }
   //! Use at your own rish; clear all the message buffers.
-  void FlushMessageBuffers() { InitMessaging(); m_msg->sent.clear(); m_msg->received.clear(); }
-  int PeekAtNextMessageType() { InitMessaging(); return m_msg->received.front().GetMessageType(); }
+  void FlushMessageBuffers() { InitMessaging(); m_msg->sent.Clear(); m_msg->received.Clear(); }
+  int PeekAtNextMessageType() { InitMessaging(); return m_msg->received.Front().GetMessageType(); }
 
 private:
-  /*! Contains all the different data structures needed to support messaging within
-  cOrganism.  Inspired by cNetSupport (above), the idea is to minimize impact on
-  organisms that DON'T use messaging. */
-  struct cMessagingSupport
-  {
-    cMessagingSupport() : retrieve_index(0) { }
-
-    message_list_type sent; //!< List of all messages sent by this organism.
-    message_list_type received; //!< List of all messages received by this organism.
-    message_list_type::size_type retrieve_index; //!< Index of next message that can be retrieved.
-  };
-
-  /*! This member variable is lazily initialized whenever any of the messaging
-  methods are used.  (My kingdom for boost::shared_ptr.) */
-  cMessagingSupport* m_msg;
+  /*! Sent and received message queues, taken from the population's message pool
+  the first time any of the messaging methods are used, so that organisms that
+  DON'T use messaging pay nothing. */
+  cOrgMessagePool::sMailbox* m_msg;
 
   //! Called to check for (and initialize) messaging support within this organism.
-  inline void InitMessaging() { if(!m_msg) m_msg = new cMessagingSupport(); }	
+  inline void InitMessaging() { if(!m_msg) AcquireMailbox(); }
+  void AcquireMailbox();
   //! Called as the bottom-half of a successfully sent message.
   void MessageSent(cAvidaContext& ctx, cOrgMessage& msg);
   // -------- End of messaging support --------
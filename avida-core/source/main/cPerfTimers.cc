@@ -0,0 +1,86 @@
+/*
+ *  cPerfTimers.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cPerfTimers.h"
+
+#include "apto/platform.h"
+
+#if APTO_PLATFORM(WINDOWS)
+# include <windows.h>
+#else
+# include <sys/time.h>
+# include <time.h>
+#endif
+
+
+cPerfTimers::cPerfTimers() : m_timers(NUM_PERF_TIMERS)
+{
+  m_timers[PERF_EVENTS].name = "events";
+  m_timers[PERF_STATS].name = "stats";
+  m_timers[PERF_EXECUTE].name = "execute";
+  m_timers[PERF_POST_UPDATE].name = "post_update";
+  m_timers[PERF_WORLD_FACETS].name = "world_facets";
+  m_timers[PERF_RESOURCES].name = "resources";
+  m_timers[PERF_BIRTHS].name = "births";
+  m_timers[PERF_SYSTEMATICS].name = "systematics";
+  Reset();
+}
+
+
+int cPerfTimers::GetTimerID(const cString& name)
+{
+  for (int i = 0; i < m_timers.GetSize(); i++) if (m_timers[i].name == name) return i;
+
+  const int timer_id = m_timers.GetSize();
+  m_timers.Resize(timer_id + 1);
+  m_timers[timer_id].name = name;
+  m_timers[timer_id].nsec = 0;
+  m_timers[timer_id].calls = 0;
+  return timer_id;
+}
+
+
+void cPerfTimers::Reset()
+{
+  for (int i = 0; i < m_timers.GetSize(); i++) {
+    m_timers[i].nsec = 0;
+    m_timers[i].calls = 0;
+  }
+}
+
+
+long long cPerfTimers::Now()
+{
+#if APTO_PLATFORM(WINDOWS)
+  static LARGE_INTEGER freq;
+  if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+  LARGE_INTEGER count;
+  QueryPerformanceCounter(&count);
+  return (long long)((double)count.QuadPart * 1.0e9 / (double)freq.QuadPart);
+#elif defined(CLOCK_MONOTONIC)
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#else
+  timeval tv;
+  gettimeofday(&tv, NULL);
+  return (long long)tv.tv_sec * 1000000000LL + (long long)tv.tv_usec * 1000LL;
+#endif
+}
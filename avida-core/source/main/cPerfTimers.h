@@ -0,0 +1,100 @@
+/*
+ *  cPerfTimers.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cPerfTimers_h
+#define cPerfTimers_h
+
+#include "avida/core/Types.h"
+
+#include "cString.h"
+
+
+// Wall time counters for the main subsystems, filled in by cScopedTimer.  A set of timers is attached to a context
+// (cAvidaContext::SetPerfTimers); code holding a context without timers, which is every context unless the
+// avida-bench target installs them, pays only a null test per timed scope.  Timers are inclusive and may nest, births
+// are timed within execute for example, so they do not sum to the total run time.
+//
+// The counters are not synchronized.  Only attach them to a context that is used from a single thread.
+class cPerfTimers
+{
+public:
+  enum eTimer {
+    PERF_EVENTS = 0,    // scheduled events and actions, including the output they write
+    PERF_STATS,         // end of update statistics (cStats::ProcessUpdate)
+    PERF_EXECUTE,       // the time slice, every organism step of an update
+    PERF_POST_UPDATE,   // population and world post update processing
+    PERF_WORLD_FACETS,  // per update work of the world facets, systematics bookkeeping and data recorders
+    PERF_RESOURCES,     // spatial resource steps, for the population and for demes
+    PERF_BIRTHS,        // offspring activation, from the birth chamber through placement
+    PERF_SYSTEMATICS,   // classification of new offspring
+    NUM_PERF_TIMERS
+  };
+
+private:
+  struct sTimer
+  {
+    cString name;
+    long long nsec;
+    long long calls;
+  };
+
+  Apto::Array<sTimer> m_timers;
+
+
+  cPerfTimers(const cPerfTimers&); // @not_implemented
+  cPerfTimers& operator=(const cPerfTimers&); // @not_implemented
+
+public:
+  cPerfTimers();
+
+  // Returns the id of the named timer, adding it if need be.  Ids of the built in timers are their eTimer values.
+  int GetTimerID(const cString& name);
+
+  int GetNumTimers() const { return m_timers.GetSize(); }
+  const cString& GetName(int timer_id) const { return m_timers[timer_id].name; }
+  long long GetNanoseconds(int timer_id) const { return m_timers[timer_id].nsec; }
+  long long GetCalls(int timer_id) const { return m_timers[timer_id].calls; }
+
+  void Add(int timer_id, long long nsec) { m_timers[timer_id].nsec += nsec; m_timers[timer_id].calls++; }
+  void Reset();
+
+  // Monotonic clock reading in nanoseconds, from an arbitrary origin
+  static long long Now();
+};
+
+
+class cScopedTimer
+{
+private:
+  cPerfTimers* m_timers;
+  int m_timer_id;
+  long long m_start;
+
+  cScopedTimer(); // @not_implemented
+  cScopedTimer(const cScopedTimer&); // @not_implemented
+  cScopedTimer& operator=(const cScopedTimer&); // @not_implemented
+
+public:
+  cScopedTimer(cPerfTimers* timers, int timer_id)
+    : m_timers(timers), m_timer_id(timer_id), m_start(timers ? cPerfTimers::Now() : 0) { ; }
+  ~cScopedTimer() { if (m_timers) m_timers->Add(m_timer_id, cPerfTimers::Now() - m_start); }
+};
+
+#endif
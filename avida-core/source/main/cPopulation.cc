@@ -43,9 +43,11 @@
 #include "AvidaTools.h"
 
 #include "cAvidaContext.h"
+#include "cBurstSchedule.h"
 #include "cCPUTestInfo.h"
 #include "cCodeLabel.h"
 #include "cDemePlaceholderUnit.h"
+#include "cDemeProbSchedule.h"
 #include "cEnvironment.h"
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
@@ -54,8 +56,10 @@
 #include "cMigrationMatrix.h"   
 #include "cOrganism.h"
 #include "cParasite.h"
+#include "cPerfTimers.h"
 #include "cPhenotype.h"
 #include "cPopulationCell.h"
+#include "cProbDemeProbSchedule.h"
 #include "cResource.h"
 #include "cResourceCount.h"
 #include "cStats.h"
@@ -266,6 +270,7 @@ cPopulation::cPopulation(cWorld* world)
 : m_world(world)
 , m_scheduler(NULL)
 , birth_chamber(world)
+, m_sensing_index(world, resource_count)
 , print_mini_trace_genomes(false)
 , use_micro_traces(false)
 , m_next_prey_q(0)
@@ -277,6 +282,7 @@ cPopulation::cPopulation(cWorld* world)
 , num_top_pred_organisms(0)
 , sync_events(false)
 , m_hgt_resid(-1)
+, m_track_cell_changes(false)
 {
   world_x = world->GetConfig().WORLD_X.Get();
   world_y = world->GetConfig().WORLD_Y.Get();
@@ -479,6 +485,8 @@ void cPopulation::SetupCellGrid()
     }
   }
   
+  m_deme_res_arena.Build(m_world, deme_array);
+  
   // if HGT is on, make sure there's a resource for it:
   if (m_world->GetConfig().ENABLE_HGT.Get() && (m_hgt_resid == -1)) {
     m_world->GetDriver().Feedback().Warning("HGT is enabled, but no HGT resource is defined; add hgt=1 to a single resource in the environment file.");
@@ -612,6 +620,12 @@ inline void cPopulation::AdjustSchedule(const cPopulationCell& cell, const cMeri
   const int deme_id = cell.GetDemeID();
   const cDeme& deme = deme_array[deme_id];
   m_scheduler->AdjustPriority(cell.GetID(), deme.HasDemeMerit() ? (merit.GetDouble() * deme.GetDemeMerit().GetDouble()) : merit.GetDouble());
+  
+  // Every birth, death, move and merit change passes through here
+  if (m_track_cell_changes && !m_cell_changed[cell.GetID()]) {
+    m_cell_changed[cell.GetID()] = true;
+    m_changed_cells.Push(cell.GetID());
+  }
 }
 
 
@@ -621,6 +635,7 @@ inline void cPopulation::AdjustSchedule(const cPopulationCell& cell, const cMeri
 bool cPopulation::ActivateOffspring(cAvidaContext& ctx, const Genome& offspring_genome, cOrganism* parent_organism)
 {
   assert(parent_organism != NULL);
+  cScopedTimer timer(ctx.GetPerfTimers(), cPerfTimers::PERF_BIRTHS);
   bool is_doomed = false;
   int doomed_cell = (world_x * world_y) - 1; //Also at the end of cPopulation::ActivateOrganism
   Apto::Array<cOrganism*> offspring_array;
@@ -2111,6 +2126,21 @@ cOrganism* cPopulation::GetRandPrey(cAvidaContext& ctx, cOrganism* org)
   return target_org;
 }
 
+void cPopulation::SetCellChangeTracking(bool track)
+{
+  m_track_cell_changes = track;
+  m_changed_cells.Resize(0);
+  m_cell_changed.Resize(track ? cell_array.GetSize() : 0);
+  m_cell_changed.SetAll(false);
+}
+
+void cPopulation::TakeChangedCells(Apto::Array<int, Apto::Smart>& cells)
+{
+  cells = m_changed_cells;
+  for (int i = 0; i < m_changed_cells.GetSize(); i++) m_cell_changed[m_changed_cells[i]] = false;
+  m_changed_cells.Resize(0);
+}
+
 void cPopulation::KillOrganism(cPopulationCell& in_cell, cAvidaContext& ctx)
 {
   // do we actually have something to kill?
@@ -5529,9 +5559,7 @@ void cPopulation::ProcessStep(cAvidaContext& ctx, double step_size, int cell_id)
   resource_count.Update(step_size);
   
   // These must be done even if there is only one deme.
-  for(int i = 0; i < GetNumDemes(); i++) {
-    GetDeme(i).Update(step_size);
-  }
+  m_deme_res_arena.Update(step_size);
   
   cDeme & deme = GetDeme(GetCell(cell_id).GetDemeID());
   deme.IncTimeUsed(merit);
@@ -5575,7 +5603,7 @@ void cPopulation::ProcessStepSpeculative(cAvidaContext& ctx, double step_size, i
   
   // Deme specific
   if (GetNumDemes() > 1) {
-    for(int i = 0; i < GetNumDemes(); i++) GetDeme(i).Update(step_size);
+    m_deme_res_arena.Update(step_size);
     
     cDeme& deme = GetDeme(GetCell(cell_id).GetDemeID());
     deme.IncTimeUsed(cur_org->GetPhenotype().GetMerit().GetDouble());
@@ -5675,174 +5703,144 @@ void cPopulation::UpdateOrganismStats(cAvidaContext& ctx)
   
   for (int osp_idx = 0; osp_idx < m_org_stat_providers.GetSize(); osp_idx++) m_org_stat_providers[osp_idx]->UpdateReset();
 
-  // Counts...
-  int num_breed_true = 0;
-  int num_parasites = 0;
-  int num_no_birth = 0;
-  int num_multi_thread = 0;
-  int num_single_thread = 0;
-  int num_threads = 0;
-  int num_modified = 0;
-  
-  // Maximums...
-  cMerit max_merit(0);
-  double max_fitness = 0;
-  int max_gestation_time = 0;
-  int max_genome_length = 0;
-  
-  // Minimums...
-  cMerit min_merit(FLT_MAX);
-  double min_fitness = FLT_MAX;
-  int min_gestation_time = INT_MAX;
-  int min_genome_length = INT_MAX;
-  
-  for (int i = 0; i < live_org_list.GetSize(); i++) {  
-    cOrganism* organism = live_org_list[i];
-    
-    for (int osp_idx = 0; osp_idx < m_org_stat_providers.GetSize(); osp_idx++) {
-      m_org_stat_providers[osp_idx]->HandleOrganism(organism);
-    }
-    
-    const cPhenotype& phenotype = organism->GetPhenotype();
-    const cMerit cur_merit = phenotype.GetMerit();
-    const double cur_fitness = phenotype.GetFitness();
-    const int cur_gestation_time = phenotype.GetGestationTime();
-    const int cur_genome_length = phenotype.GetGenomeLength();
-    
-    Apto::Array<Apto::Stat::Accumulator<int> >& from_message_exec_counts = stats.InstFromMessageExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
-    for (int j = 0; j < phenotype.GetLastFromMessageInstCount().GetSize(); j++) {
-      from_message_exec_counts[j].Add(organism->GetPhenotype().GetLastFromMessageInstCount()[j]);
-    }
-
-    stats.SumFitness().Add(cur_fitness);
-    stats.SumMerit().Add(cur_merit.GetDouble());
-    stats.SumGestation().Add(phenotype.GetGestationTime());
-    stats.SumCreatureAge().Add(phenotype.GetAge());
-    stats.SumGeneration().Add(phenotype.GetGeneration());
-    stats.SumNeutralMetric().Add(phenotype.GetNeutralMetric());
-    stats.SumLineageLabel().Add(organism->GetLineageLabel());
-    stats.SumCopyMutRate().Push(organism->MutationRates().GetCopyMutProb());
-    stats.SumLogCopyMutRate().Push(log(organism->MutationRates().GetCopyMutProb()));
-    stats.SumDivMutRate().Push(organism->MutationRates().GetDivMutProb() / organism->GetPhenotype().GetDivType());
-    stats.SumLogDivMutRate().Push(log(organism->MutationRates().GetDivMutProb() / organism->GetPhenotype().GetDivType()));
-    stats.SumCopySize().Add(phenotype.GetCopiedSize());
-    stats.SumExeSize().Add(phenotype.GetExecutedSize());
-    
-    if (cur_merit > max_merit) max_merit = cur_merit;
-    if (cur_fitness > max_fitness) max_fitness = cur_fitness;
-    if (cur_gestation_time > max_gestation_time) max_gestation_time = cur_gestation_time;
-    if (cur_genome_length > max_genome_length) max_genome_length = cur_genome_length;
-    
-    if (cur_merit < min_merit) min_merit = cur_merit;
-    if (cur_fitness < min_fitness) min_fitness = cur_fitness;
-    if (cur_gestation_time < min_gestation_time) min_gestation_time = cur_gestation_time;
-    if (cur_genome_length < min_genome_length) min_genome_length = cur_genome_length;
-    
-    // Test what tasks this creatures has completed.
-    for (int j = 0; j < m_world->GetEnvironment().GetNumTasks(); j++) {
-      if (phenotype.GetCurTaskCount()[j] > 0) {
-        stats.AddCurTask(j);
-        stats.AddCurTaskQuality(j, phenotype.GetCurTaskQuality()[j]);
-      }
+  // Only gather the statistic groups that some output consumes (see cStats::RequireOrgStats)
+  const bool collect_tasks = stats.ShouldCollectOrgStats(cStats::ORG_STATS_TASKS);
+  const bool collect_parasite_tasks = stats.ShouldCollectOrgStats(cStats::ORG_STATS_PARASITE_TASKS);
+  const bool collect_internal_tasks = stats.ShouldCollectOrgStats(cStats::ORG_STATS_INTERNAL_TASKS);
+  const bool collect_reactions = stats.ShouldCollectOrgStats(cStats::ORG_STATS_REACTIONS);
+  const bool collect_senses = stats.ShouldCollectOrgStats(cStats::ORG_STATS_SENSES);
+  const bool collect_any_tasks = (collect_tasks || collect_parasite_tasks || collect_internal_tasks);
+  const int num_tasks = m_world->GetEnvironment().GetNumTasks();
+  const int num_reactions = m_world->GetEnvironment().GetNumReactions();
+
+  // Organisms are gathered block by block into per-block shards that are merged once below.  The blocks are fixed by
+  // cStats, never by how (or by how many workers) blocks are processed.
+  const int num_orgs = live_org_list.GetSize();
+  const int num_shards = stats.ResetOrgStatsShards(num_orgs, num_tasks, num_reactions);
+  const int shard_size = stats.GetOrgStatsShardSize();
+  
+  for (int shard_idx = 0; shard_idx < num_shards; shard_idx++) {
+    cStatsShard& shard = stats.GetOrgStatsShard(shard_idx);
+    const int block_start = shard_idx * shard_size;
+    int block_end = block_start + shard_size;
+    if (block_end > num_orgs) block_end = num_orgs;
+    
+    for (int i = block_start; i < block_end; i++) {
+      cOrganism* organism = live_org_list[i];
       
-      if (phenotype.GetLastTaskCount()[j] > 0) {
-        stats.AddLastTask(j);
-        stats.AddLastTaskQuality(j, phenotype.GetLastTaskQuality()[j]);
-        stats.IncTaskExeCount(j, phenotype.GetLastTaskCount()[j]);
+      for (int osp_idx = 0; osp_idx < m_org_stat_providers.GetSize(); osp_idx++) {
+        m_org_stat_providers[osp_idx]->HandleOrganism(organism);
       }
       
-      if (phenotype.GetCurHostTaskCount()[j] > 0) {
-        stats.AddCurHostTask(j);
-      }
+      const cPhenotype& phenotype = organism->GetPhenotype();
+      const cMerit cur_merit = phenotype.GetMerit();
+      const double cur_fitness = phenotype.GetFitness();
       
-      if (phenotype.GetLastHostTaskCount()[j] > 0) {
-        stats.AddLastHostTask(j);
-      }
+      shard.AddSum(cStatsShard::SUM_FITNESS, cur_fitness);
+      shard.AddSum(cStatsShard::SUM_MERIT, cur_merit.GetDouble());
+      shard.AddSum(cStatsShard::SUM_GESTATION, phenotype.GetGestationTime());
+      shard.AddSum(cStatsShard::SUM_CREATURE_AGE, phenotype.GetAge());
+      shard.AddSum(cStatsShard::SUM_GENERATION, phenotype.GetGeneration());
+      shard.AddSum(cStatsShard::SUM_NEUTRAL_METRIC, phenotype.GetNeutralMetric());
+      shard.AddSum(cStatsShard::SUM_LINEAGE_LABEL, organism->GetLineageLabel());
+      shard.AddMutRates(organism->MutationRates().GetCopyMutProb(),
+                        organism->MutationRates().GetDivMutProb() / phenotype.GetDivType());
+      shard.AddSum(cStatsShard::SUM_COPY_SIZE, phenotype.GetCopiedSize());
+      shard.AddSum(cStatsShard::SUM_EXE_SIZE, phenotype.GetExecutedSize());
       
-      if (phenotype.GetCurParasiteTaskCount()[j] > 0) {
-        stats.AddCurParasiteTask(j);
-      }
+      shard.UpdateExtrema(cur_merit, cur_fitness, phenotype.GetGestationTime(), phenotype.GetGenomeLength());
       
-      if (phenotype.GetLastParasiteTaskCount()[j] > 0) {
-        stats.AddLastParasiteTask(j);
+      // Test what tasks this creatures has completed.
+      if (collect_any_tasks) {
+        for (int j = 0; j < num_tasks; j++) {
+          if (collect_tasks) {
+            if (phenotype.GetCurTaskCount()[j] > 0) {
+              shard.IncTask(cStatsShard::TASK_CUR, j);
+              shard.AddTaskQuality(cStatsShard::QUALITY_CUR, j, phenotype.GetCurTaskQuality()[j]);
+            }
+            
+            if (phenotype.GetLastTaskCount()[j] > 0) {
+              shard.IncTask(cStatsShard::TASK_LAST, j);
+              shard.AddTaskQuality(cStatsShard::QUALITY_LAST, j, phenotype.GetLastTaskQuality()[j]);
+              shard.IncTask(cStatsShard::TASK_EXE, j, phenotype.GetLastTaskCount()[j]);
+            }
+          }
+          
+          if (collect_parasite_tasks) {
+            if (phenotype.GetCurHostTaskCount()[j] > 0) shard.IncTask(cStatsShard::TASK_HOST_CUR, j);
+            if (phenotype.GetLastHostTaskCount()[j] > 0) shard.IncTask(cStatsShard::TASK_HOST_LAST, j);
+            if (phenotype.GetCurParasiteTaskCount()[j] > 0) shard.IncTask(cStatsShard::TASK_PARASITE_CUR, j);
+            if (phenotype.GetLastParasiteTaskCount()[j] > 0) shard.IncTask(cStatsShard::TASK_PARASITE_LAST, j);
+          }
+          
+          if (collect_internal_tasks) {
+            if (phenotype.GetCurInternalTaskCount()[j] > 0) {
+              shard.IncTask(cStatsShard::TASK_INTERNAL_CUR, j);
+              shard.AddTaskQuality(cStatsShard::QUALITY_INTERNAL_CUR, j, phenotype.GetCurInternalTaskQuality()[j]);
+            }
+            
+            if (phenotype.GetLastInternalTaskCount()[j] > 0) {
+              shard.IncTask(cStatsShard::TASK_INTERNAL_LAST, j);
+              shard.AddTaskQuality(cStatsShard::QUALITY_INTERNAL_LAST, j, phenotype.GetLastInternalTaskQuality()[j]);
+            }
+          }
+        }
       }
       
-      if (phenotype.GetCurInternalTaskCount()[j] > 0) {
-        stats.AddCurInternalTask(j);
-        stats.AddCurInternalTaskQuality(j, phenotype.GetCurInternalTaskQuality()[j]);
+      if (stats.ShouldCollectEnvTestStats()) {
+        Systematics::GroupPtr genotype = organism->SystematicsGroup("genotype");
+        Systematics::GenomeTestMetricsPtr metrics(Systematics::GenomeTestMetrics::GetMetrics(m_world, ctx, genotype));
+        const Apto::Array<int>& test_task_counts = metrics->GetTaskCounts();
+        
+        for (int j = 0; j < num_tasks; j++) if (test_task_counts[j] > 0) shard.IncTask(cStatsShard::TASK_TEST, j);
       }
       
-      if (phenotype.GetLastInternalTaskCount()[j] > 0) {
-        stats.AddLastInternalTask(j);
-        stats.AddLastInternalTaskQuality(j, phenotype.GetLastInternalTaskQuality()[j]);
-      }
-    }
-
-    if (stats.ShouldCollectEnvTestStats()) {
-      Systematics::GroupPtr genotype = organism->SystematicsGroup("genotype");
-      Systematics::GenomeTestMetricsPtr metrics(Systematics::GenomeTestMetrics::GetMetrics(m_world, ctx, genotype));
-      const Apto::Array<int>& test_task_counts = metrics->GetTaskCounts();
       
-      for (int j = 0; j < m_world->GetEnvironment().GetNumTasks(); j++) if (test_task_counts[j] > 0) stats.AddTestTask(j);
-    }
-    
-    
-    // Record what add bonuses this organism garnered for different reactions
-    for (int j = 0; j < m_world->GetEnvironment().GetNumReactions(); j++) {
-      if (phenotype.GetCurReactionCount()[j] > 0) {
-        stats.AddCurReaction(j);
-        stats.AddCurReactionAddReward(j, phenotype.GetCurReactionAddReward()[j]);
+      // Record what add bonuses this organism garnered for different reactions
+      if (collect_reactions) {
+        for (int j = 0; j < num_reactions; j++) {
+          if (phenotype.GetCurReactionCount()[j] > 0) {
+            shard.IncReaction(cStatsShard::REACTION_CUR, j);
+            shard.AddReactionReward(cStatsShard::REWARD_CUR, j, phenotype.GetCurReactionAddReward()[j]);
+          }
+          
+          if (phenotype.GetLastReactionCount()[j] > 0) {
+            shard.IncReaction(cStatsShard::REACTION_LAST, j);
+            shard.IncReaction(cStatsShard::REACTION_EXE, j, phenotype.GetLastReactionCount()[j]);
+            shard.AddReactionReward(cStatsShard::REWARD_LAST, j, phenotype.GetLastReactionAddReward()[j]);
+          }
+        }
       }
       
-      if (phenotype.GetLastReactionCount()[j] > 0) {
-        stats.AddLastReaction(j);
-        stats.IncReactionExeCount(j, phenotype.GetLastReactionCount()[j]);
-        stats.AddLastReactionAddReward(j, phenotype.GetLastReactionAddReward()[j]);
-      }
-    }
-    
-    // Test what resource combinations this creature has sensed
-    for (int j = 0; j < stats.GetSenseSize(); j++) {
-      if (phenotype.GetLastSenseCount()[j] > 0) {
-        stats.AddLastSense(j);
-        stats.IncLastSenseExeCount(j, phenotype.GetLastSenseCount()[j]);
+      // Test what resource combinations this creature has sensed
+      if (collect_senses) {
+        for (int j = 0; j < stats.GetSenseSize(); j++) {
+          if (phenotype.GetLastSenseCount()[j] > 0) {
+            shard.IncSense(cStatsShard::SENSE_LAST, j);
+            shard.IncSense(cStatsShard::SENSE_LAST_EXE, j, phenotype.GetLastSenseCount()[j]);
+          }
+        }
       }
+      
+      // Increment the counts for all qualities the organism has...
+      shard.IncCount(cStatsShard::COUNT_PARASITES, organism->GetNumParasites());
+      if (phenotype.ParentTrue()) shard.IncCount(cStatsShard::COUNT_BREED_TRUE);
+      if (phenotype.GetNumDivides() == 0) shard.IncCount(cStatsShard::COUNT_NO_BIRTH);
+      if (phenotype.IsMultiThread()) shard.IncCount(cStatsShard::COUNT_MULTI_THREAD);
+      else shard.IncCount(cStatsShard::COUNT_SINGLE_THREAD);
+      
+      if (phenotype.IsModified()) shard.IncCount(cStatsShard::COUNT_MODIFIED);
+      
+      cHardwareBase& hardware = organism->GetHardware();
+      shard.AddSum(cStatsShard::SUM_MEM_SIZE, hardware.GetMemory().GetSize());
+      shard.IncCount(cStatsShard::COUNT_THREADS, hardware.GetNumThreads());
+      
+      // Increment the age of this organism.
+      organism->GetPhenotype().IncAge();
     }
-    
-    // Increment the counts for all qualities the organism has...
-    num_parasites += organism->GetNumParasites();
-    if (phenotype.ParentTrue()) num_breed_true++;
-    if (phenotype.GetNumDivides() == 0) num_no_birth++;
-    if (phenotype.IsMultiThread()) num_multi_thread++;
-    else num_single_thread++;
-    
-    if (phenotype.IsModified()) num_modified++;
-    
-    cHardwareBase& hardware = organism->GetHardware();
-    stats.SumMemSize().Add(hardware.GetMemory().GetSize());
-    num_threads += hardware.GetNumThreads();
-    
-    // Increment the age of this organism.
-    organism->GetPhenotype().IncAge();
   }
   
-  stats.SetBreedTrueCreatures(num_breed_true);
-  stats.SetNumNoBirthCreatures(num_no_birth);
-  stats.SetNumParasites(num_parasites);
-  stats.SetNumSingleThreadCreatures(num_single_thread);
-  stats.SetNumMultiThreadCreatures(num_multi_thread);
-  stats.SetNumThreads(num_threads);
-  stats.SetNumModified(num_modified);
-  
-  stats.SetMaxMerit(max_merit.GetDouble());
-  stats.SetMaxFitness(max_fitness);
-  stats.SetMaxGestationTime(max_gestation_time);
-  stats.SetMaxGenomeLength(max_genome_length);
-  
-  stats.SetMinMerit(min_merit.GetDouble());
-  stats.SetMinFitness(min_fitness);
-  stats.SetMinGestationTime(min_gestation_time);
-  stats.SetMinGenomeLength(min_genome_length);
+  stats.MergeOrgStatsShards();
   
   resource_count.UpdateGlobalResources(ctx);   
 }
@@ -6036,6 +6034,7 @@ void cPopulation::ProcessPreUpdate()
 {
   resource_count.SetSpatialUpdate(m_world->GetStats().GetUpdate());
   for (int i = 0; i < deme_array.GetSize(); i++) deme_array[i].ProcessPreUpdate();   
+  m_deme_res_arena.ProcessUpdate(deme_array, m_world->GetStats().GetUpdate());
 }
 
 void cPopulation::ProcessPostUpdate(cAvidaContext& ctx)
@@ -7123,18 +7122,29 @@ void cPopulation::ResetInputs(cAvidaContext& ctx)
   }
 }
 
+void cPopulation::ConnectionsChanged()
+{
+  for (int i = 0; i < GetSize(); i++) GetCell(i).ClearNeighborhoods();
+}
+
 void cPopulation::BuildTimeSlicer()
 {
   switch (m_world->GetConfig().SLICING_METHOD.Get()) {
     case SLICE_CONSTANT:
       m_scheduler = new Apto::Scheduler::RoundRobin(cell_array.GetSize());
       break;
-//    case SLICE_DEME_PROB_MERIT:
-//      schedule = new cDemeProbSchedule(cell_array.GetSize(), ctx.GetRandom().GetInt(0x7FFFFFFF), deme_array.GetSize());
-//      break;
-//    case SLICE_PROB_DEMESIZE_PROB_MERIT:
-//      schedule = new cProbDemeProbSchedule(cell_array.GetSize(), ctx.GetRandom().GetInt(0x7FFFFFFF), deme_array.GetSize());
-//      break;
+    case SLICE_DEME_PROB_MERIT:
+    {
+      Apto::SmartPtr<Apto::Random> rng(new Apto::RNG::AvidaRNG(m_world->GetRandom().GetInt(0x7FFFFFFF)));
+      m_scheduler = new cDemeProbSchedule(cell_array.GetSize(), deme_array.GetSize(), rng);
+    }
+      break;
+    case SLICE_PROB_DEMESIZE_PROB_MERIT:
+    {
+      Apto::SmartPtr<Apto::Random> rng(new Apto::RNG::AvidaRNG(m_world->GetRandom().GetInt(0x7FFFFFFF)));
+      m_scheduler = new cProbDemeProbSchedule(cell_array.GetSize(), deme_array.GetSize(), rng);
+    }
+      break;
     case SLICE_INTEGRATED_MERIT:
       m_scheduler = new Apto::Scheduler::Integrated(cell_array.GetSize());
       break;
@@ -7155,6 +7165,11 @@ void cPopulation::BuildTimeSlicer()
       m_world->GetDriver().Abort(Avida::INVALID_CONFIG);
       break;
   }
+  
+  // Hand out CPU cycles in multi-instruction quanta, amortizing the scheduler draw over each burst
+  if (m_world->GetConfig().SLICING_BURST_SIZE.Get() > 1) {
+    m_scheduler = new cBurstSchedule(m_scheduler, m_world->GetConfig().SLICING_BURST_SIZE.Get());
+  }
 }
 
 
@@ -8427,6 +8442,7 @@ void cPopulation::UpdateResourceCount(const int Verbosity, cWorld* world) {
     }
   }
   
+  m_deme_res_arena.Build(world, deme_array);
 }
 
 // Adds an organism to live org list  
@@ -27,9 +27,12 @@
 
 #include "cBirthChamber.h"
 #include "cDeme.h"
+#include "cDemeResourceArena.h"
 #include "cOrgInterface.h"
+#include "cOrgMessagePool.h"
 #include "cPopulationInterface.h"
 #include "cResourceCount.h"
+#include "cSensingIndex.h"
 #include "cString.h"
 #include "cWorld.h"
 #include "tList.h"
@@ -70,6 +73,7 @@ private:
   Apto::Array<int> empty_cell_id_array;     // Used for PREFER_EMPTY birth methods
   cResourceCount resource_count;       // Global resources available
   cBirthChamber birth_chamber;         // Global birth chamber.
+  cSensingIndex m_sensing_index;       // Skip tables for organism look queries
   //Keeps track of which organisms are in which group.
   Apto::Map<int, Apto::Array<cOrganism*, Apto::Smart> > m_group_list;
   Apto::Map<int, Apto::Array<pair<int,int> > > m_group_intolerances;
@@ -80,6 +84,8 @@ private:
   // Keep list of live organisms
   Apto::Array<cOrganism*, Apto::Smart> live_org_list;
   
+  cOrgMessagePool m_message_pool;      // Reusable organism message queues
+  
   Apto::Array<cPopulationOrgStatProviderPtr> m_org_stat_providers;
   
   
@@ -112,6 +118,7 @@ private:
   int num_top_pred_organisms;
   
   Apto::Array<cDeme> deme_array;            // Deme structure of the population.
+  cDemeResourceArena m_deme_res_arena;      // Shared storage and stepping for deme resources
  
   // Outside interactions...
   bool sync_events;   // Do we need to sync up the event list with population?
@@ -123,6 +130,11 @@ private:
 
   int m_hgt_resid; //!< HGT resource ID.
 
+  // Cells whose occupant (or its merit) changed since the last TakeChangedCells(), only kept while a consumer asks
+  bool m_track_cell_changes;
+  Apto::Array<int, Apto::Smart> m_changed_cells;
+  Apto::Array<bool> m_cell_changed;
+
   cPopulation(); // @not_implemented
   cPopulation(const cPopulation&); // @not_implemented
   cPopulation& operator=(const cPopulation&); // @not_implemented
@@ -328,6 +340,7 @@ public:
   void SetResource(cAvidaContext& ctx, const cString res_name, double new_level);
   double GetResource(cAvidaContext& ctx, int id) const { return resource_count.Get(ctx, id); }
   cResourceCount& GetResourceCount() { return resource_count; }
+  cSensingIndex& GetSensingIndex() { return m_sensing_index; }
   void SetResourceInflow(const cString res_name, double new_level);
   void SetResourceOutflow(const cString res_name, double new_level);
   
@@ -338,6 +351,9 @@ public:
   void SetDemeResourceOutflow(const cString res_name, double new_level);
   
   void ResetInputs(cAvidaContext& ctx);
+  
+  // Must be called after cell connections are edited, a neighborhood of any depth may run through the edited cells
+  void ConnectionsChanged();
 
   cEnvironment& GetEnvironment() { return environment; }
   int GetNumOrganisms() { return num_organisms; }
@@ -399,6 +415,12 @@ public:
   // Remove an org from live org list
   void RemoveLiveOrg(cOrganism* org); 
   const Apto::Array<cOrganism*, Apto::Smart>& GetLiveOrgList() const { return live_org_list; }
+  cOrgMessagePool& GetMessagePool() { return m_message_pool; }
+
+  // Cell change tracking (births, deaths, moves and merit changes), used to refresh viewer maps incrementally
+  void SetCellChangeTracking(bool track);
+  bool IsTrackingCellChanges() const { return m_track_cell_changes; }
+  void TakeChangedCells(Apto::Array<int, Apto::Smart>& cells);
 	
   // Adds an organism to a group  
   void JoinGroup(cOrganism* org, int group_id);
@@ -89,6 +89,7 @@ void cPopulationCell::operator=(const cPopulationCell& in_cell)
 		tConstListIterator<cPopulationCell> conn_it(in_cell.m_connections);
 		cPopulationCell* test_cell;
 		while ((test_cell = const_cast<cPopulationCell*>(conn_it.Next()))) m_connections.PushRear(test_cell);
+		ClearNeighborhoods();
 		
 		// copy hgt information, if needed.
 		delete m_hgt;
@@ -174,6 +175,41 @@ void cPopulationCell::GetOccupiedNeighboringCells(std::set<cPopulationCell*>& oc
 	}
 }
 
+const Apto::Array<cPopulationCell*>& cPopulationCell::GetNeighborhood(int depth)
+{
+  for (int i = 0; i < m_neighborhood_depths.GetSize(); i++) {
+    if (m_neighborhood_depths[i] == depth) return m_neighborhoods[i];
+  }
+  
+  // Each depth is walked once and kept until the connections change (see cPopulation::ConnectionsChanged()).  The walk
+  // is breadth first, so that (unlike GetNeighboringCells) the result does not depend on which way the cell is facing.
+  std::set<cPopulationCell*> cell_set;
+  cell_set.insert(this);
+  Apto::Array<cPopulationCell*, Apto::Smart> frontier;
+  frontier.Push(this);
+  for (int d = 0; d < depth && frontier.GetSize(); d++) {
+    Apto::Array<cPopulationCell*, Apto::Smart> next;
+    for (int f = 0; f < frontier.GetSize(); f++) {
+      tLWConstListIterator<cPopulationCell> conn_it(frontier[f]->m_connections);
+      while (!conn_it.AtEnd()) {
+        cPopulationCell* cell = conn_it.Next();
+        assert(cell != 0); // cells should never be null.
+        if (cell_set.insert(cell).second) next.Push(cell);
+      }
+    }
+    frontier = next;
+  }
+  cell_set.erase(this);
+  
+  Apto::Array<cPopulationCell*> cells(static_cast<int>(cell_set.size()));
+  int idx = 0;
+  for (std::set<cPopulationCell*>::iterator it = cell_set.begin(); it != cell_set.end(); ++it) cells[idx++] = *it;
+  
+  m_neighborhood_depths.Push(depth);
+  m_neighborhoods.Push(cells);
+  return m_neighborhoods[m_neighborhoods.GetSize() - 1];
+}
+
 void cPopulationCell::GetOccupiedNeighboringCells(Apto::Array<cPopulationCell*>& occupied_cells) const
 {
   occupied_cells.Resize(m_connections.GetSize());
@@ -267,6 +303,7 @@ void cPopulationCell::InsertOrganism(cOrganism* new_org, cAvidaContext& ctx)
   // Adjust this cell's attributes to account for the new organism.
   m_organism = new_org;
   m_hardware = &new_org->GetHardware();
+  m_world->GetPopulation().GetSensingIndex().SetOccupied(cSensingIndex::OCC_ORGANISM, m_cell_id, true);
   m_world->GetStats().AddSpeculativeWaste(m_spec_state);
   m_spec_state = 0;
 	
@@ -303,6 +340,7 @@ cOrganism * cPopulationCell::RemoveOrganism(cAvidaContext& ctx)
   }
   m_organism = NULL;
   m_hardware = NULL;
+  m_world->GetPopulation().GetSensingIndex().SetOccupied(cSensingIndex::OCC_ORGANISM, m_cell_id, false);
   return out_organism;
 }
 
@@ -330,6 +368,7 @@ double cPopulationCell::UptakeCellEnergy(double frac_to_uptake, cAvidaContext& c
 void cPopulationCell::AddPredAV(cAvidaContext& ctx, cOrganism* org)
 {
   m_av_pred.Push(org);
+  if (m_av_pred.GetSize() == 1) m_world->GetPopulation().GetSensingIndex().SetOccupied(cSensingIndex::OCC_PRED_AV, m_cell_id, true);
   // Swaps the added avatar into a random position in the array
   int loc = ctx.GetRandom().GetUInt(0, m_av_pred.GetSize());
   cOrganism* exist_org = m_av_pred[loc];
@@ -342,6 +381,7 @@ void cPopulationCell::AddPredAV(cAvidaContext& ctx, cOrganism* org)
 void cPopulationCell::AddPreyAV(cAvidaContext& ctx, cOrganism* org)
 {
   m_av_prey.Push(org);
+  if (m_av_prey.GetSize() == 1) m_world->GetPopulation().GetSensingIndex().SetOccupied(cSensingIndex::OCC_PREY_AV, m_cell_id, true);
   // Swaps the added avatar into a random position in the array
   int loc = ctx.GetRandom().GetUInt(0, m_av_prey.GetSize());
   cOrganism* exist_org = m_av_prey[loc];
@@ -360,6 +400,7 @@ void cPopulationCell::RemovePredAV(cOrganism* org)
   exist_org->SetAVInIndex(org->GetAVInIndex());
   m_av_pred.Swap(org->GetAVInIndex(), last);
   m_av_pred.Pop();
+  if (m_av_pred.GetSize() == 0) m_world->GetPopulation().GetSensingIndex().SetOccupied(cSensingIndex::OCC_PRED_AV, m_cell_id, false);
 }
 
 // Removes the organism from the cell's output avatars (prey)
@@ -372,6 +413,7 @@ void cPopulationCell::RemovePreyAV(cOrganism* org)
   exist_org->SetAVOutIndex(org->GetAVOutIndex());
   m_av_prey.Swap(org->GetAVOutIndex(), last);
   m_av_prey.Pop();
+  if (m_av_prey.GetSize() == 0) m_world->GetPopulation().GetSensingIndex().SetOccupied(cSensingIndex::OCC_PREY_AV, m_cell_id, false);
 }
 
 // Returns whether a cell has an output AV that the org will be able to receive messages from.
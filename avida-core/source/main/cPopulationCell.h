@@ -79,6 +79,10 @@ private:
   // @WRE: Statistic for movement
   int m_visits; // The number of times Avidians move into the cell
 
+  // Broadcast neighborhoods (cells within a given depth, not including this one), built on first use
+  Apto::Array<int> m_neighborhood_depths;
+  Apto::Array<Apto::Array<cPopulationCell*> > m_neighborhoods;
+
   void InsertOrganism(cOrganism* new_org, cAvidaContext& ctx); 
   cOrganism* RemoveOrganism(cAvidaContext& ctx); 
 
@@ -109,6 +113,10 @@ public:
   //! Recursively build a set of occupied cells that neighbor this one, out to the given depth.
   void GetOccupiedNeighboringCells(std::set<cPopulationCell*>& occupied_cell_set, int depth) const;
   void GetOccupiedNeighboringCells(Apto::Array<cPopulationCell*>& occupied_cells) const;
+  //! Cells within depth connections of this one (excluding this cell), computed once per depth.
+  const Apto::Array<cPopulationCell*>& GetNeighborhood(int depth);
+  //! Drop the cached neighborhoods, needed whenever connections are added or removed at runtime.
+  void ClearNeighborhoods() { m_neighborhood_depths.Resize(0); m_neighborhoods.Resize(0); }
   inline cPopulationCell& GetCellFaced() { return *(m_connections.GetFirst()); }
   int GetFacing();  // Returns the facing of this cell.
   int GetFacedDir(); // Returns the human interpretable facing of this org.
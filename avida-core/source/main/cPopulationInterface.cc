@@ -388,6 +388,11 @@ cResourceCount* cPopulationInterface::GetResourceCount()
   return &m_world->GetPopulation().GetResourceCount();
 }
 
+cSensingIndex* cPopulationInterface::GetSensingIndex()
+{
+  return &m_world->GetPopulation().GetSensingIndex();
+}
+
 const Apto::Array<double>& cPopulationInterface::GetDemeResources(int deme_id, cAvidaContext& ctx)
 {
   return m_world->GetPopulation().GetDemeCellResources(deme_id, m_cell_id, ctx); 
@@ -600,16 +605,10 @@ bool cPopulationInterface::BroadcastMessage(cOrgMessage& msg, int depth) {
   cPopulationCell& cell = m_world->GetPopulation().GetCell(m_cell_id);
   assert(cell.IsOccupied()); // This organism; sanity.
 	
-	// Get the set of cells that are within range.
-	std::set<cPopulationCell*> cell_set;
-	cell.GetNeighboringCells(cell_set, depth);
-	
-	// Remove this cell from the set!
-	cell_set.erase(&cell);
-	
-	// Now, send a message towards each cell:
-	for(std::set<cPopulationCell*>::iterator i=cell_set.begin(); i!=cell_set.end(); ++i) {
-		SendMessage(msg, **i);
+	// Send a message towards each cell that is within range (the neighborhood is cached by the cell).
+	const Apto::Array<cPopulationCell*>& cells = cell.GetNeighborhood(depth);
+	for (int i = 0; i < cells.GetSize(); i++) {
+		SendMessage(msg, *cells[i]);
 	}
 	return true;
 }
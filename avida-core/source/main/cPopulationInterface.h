@@ -126,6 +126,7 @@ public:
   int GetFrozenPeakX(cAvidaContext& ctx, int res_id); 
   int GetFrozenPeakY(cAvidaContext& ctx, int res_id);
   cResourceCount* GetResourceCount();
+  cSensingIndex* GetSensingIndex();
   void TriggerDoUpdates(cAvidaContext& ctx);
   void UpdateResources(cAvidaContext& ctx, const Apto::Array<double>& res_change);
   void UpdateDemeResources(cAvidaContext& ctx, const Apto::Array<double>& res_change);
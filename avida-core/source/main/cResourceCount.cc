@@ -23,6 +23,7 @@
 #include "cResourceCount.h"
 #include "cResource.h"
 #include "cGradientCount.h"
+#include "cPerfTimers.h"
 #include "cWorld.h"
 #include "cStats.h"
 
@@ -37,71 +38,14 @@ const double cResourceCount::EPSILON (1.0e-15);
 const int cResourceCount::PRECALC_DISTANCE(100);
 
 
-void FlowMatter(cSpatialCountElem &elem1, cSpatialCountElem &elem2, 
-                double inxdiffuse, 
-                double inydiffuse, double inxgravity, double inygravity,
-                int xdist, int ydist, double dist) {
-
-  /* Routine to calculate the amount of flow from one Element to another.
-     Amount of flow is a function of:
-
-       1) Amount of material in each cell (will try to equalize)
-       2) Distance between each cell
-       3) x and y "gravity"
-
-     This method only effect the delta amount of each element.  The State
-     method will need to be called at the end of each time step to complete
-     the movement of material.
-  */
-
-  double  diff, flowamt, xgravity, xdiffuse, ygravity,  ydiffuse;
-
-  if (((elem1.amount == 0.0) && (elem2.amount == 0.0)) && (dist < 0.0)) return;
-  diff = (elem1.amount - elem2.amount);
-  if (xdist != 0) {
-
-    /* if there is material to be effected by x gravity */
-
-    if (((xdist>0) && (inxgravity>0.0)) || ((xdist<0) && (inxgravity<0.0))) {
-      xgravity = elem1.amount * fabs(inxgravity)/3.0;
-    } else {
-      xgravity = -elem2.amount * fabs(inxgravity)/3.0;
-    }
-    
-    /* Diffusion uses the diffusion constant x half the difference (as the 
-       elements attempt to equalize) / the number of possible neighbors (8) */
-
-    xdiffuse = inxdiffuse * diff / 16.0;
-  } else {
-    xdiffuse = 0.0;
-    xgravity = 0.0;
-  }  
-  if (ydist != 0) {
-
-    /* if there is material to be effected by y gravity */
-
-    if (((ydist>0) && (inygravity>0.0)) || ((ydist<0) && (inygravity<0.0))) {
-      ygravity = elem1.amount * fabs(inygravity)/3.0;
-    } else {
-      ygravity = -elem2.amount * fabs(inygravity)/3.0;
-    }
-    ydiffuse = inydiffuse * diff / 16.0;
-  } else {
-    ydiffuse = 0.0;
-    ygravity = 0.0;
-  }  
-
-  flowamt = ((xdiffuse + ydiffuse + xgravity + ygravity)/
-             (fabs(xdist*1.0) + fabs(ydist*1.0)))/dist;
-  elem1.delta -= flowamt;
-  elem2.delta += flowamt;
-}
-
 cResourceCount::cResourceCount(int num_resources)
   : update_time(0.0)
   , spatial_update_time(0.0)
   , m_last_updated(0)
   , m_spatial_update(0)
+  , m_shared_steps(NULL)
+  , m_steps_seen(0)
+  , m_modified(0)
 {
   if(num_resources > 0) {
     SetSize(num_resources);
@@ -110,7 +54,7 @@ cResourceCount::cResourceCount(int num_resources)
   return;
 }
 
-cResourceCount::cResourceCount(const cResourceCount &rc) {
+cResourceCount::cResourceCount(const cResourceCount &rc) : m_shared_steps(NULL), m_steps_seen(0), m_modified(0) {
   *this = rc;
 
   return;
@@ -136,6 +80,7 @@ const cResourceCount &cResourceCount::operator=(const cResourceCount &rc) {
   update_time = rc.update_time;
   spatial_update_time = rc.spatial_update_time;
   cell_lists = rc.cell_lists;
+  markModified();
 
   return *this;
 }
@@ -176,6 +121,7 @@ void cResourceCount::SetSize(int num_resources)
   geometry.SetAll(nGeometry::GLOBAL);
   curr_grid_res_cnt.SetAll(0.0);
   //DO spacial resources need to be set to zero?
+  markModified();
 }
 
 cResourceCount::~cResourceCount()
@@ -194,6 +140,7 @@ void cResourceCount::SetCellResources(int cell_id, const Apto::Array<double> & r
         // Set global quantity of resource
     } else {
       spatial_resource_count[i]->SetCellAmount(cell_id, res[i]);
+      m_touched_cells.Push(cell_id);
 
       /* Ideally the state of the cell's resource should not be set till
          the end of the update so that all processes (inflow, outflow, 
@@ -309,7 +256,7 @@ void cResourceCount::Setup(cWorld* world, const int& res_index, const cString& n
     resource_count[res_index] = 0; 
     if (isgradient) {
       delete spatial_resource_count[res_index];
-      spatial_resource_count[res_index] = new cGradientCount(world, in_peakx, in_peaky, in_height, in_spread, in_plateau, in_decay,                                
+      spatial_resource_count[res_index] = new cGradientCount(world, &m_gradient_stencils, in_peakx, in_peaky, in_height, in_spread, in_plateau, in_decay,                                
                                                              in_max_x, in_max_y, in_min_x, in_min_y, in_move_a_scaler, in_updatestep, 
                                                              tempx, tempy, in_geometry, in_halo, in_halo_inner_radius, 
                                                              in_halo_width, in_halo_anchor_x, in_halo_anchor_y, in_move_speed, in_move_resistance,
@@ -354,6 +301,7 @@ void cResourceCount::Setup(cWorld* world, const int& res_index, const cString& n
   spatial_resource_count[res_index]->SetOutflowX2(in_outflowX2);
   spatial_resource_count[res_index]->SetOutflowY1(in_outflowY1);
   spatial_resource_count[res_index]->SetOutflowY2(in_outflowY2);
+  markModified();
 }
 
 void cResourceCount::SetGradientCount(cAvidaContext& ctx, cWorld* world, const int& res_id, const int& peakx, const int& peaky,
@@ -414,6 +362,7 @@ void cResourceCount::SetGradientCount(cAvidaContext& ctx, cWorld* world, const i
   spatial_resource_count[res_id]->SetGradDeathOdds(death_odds);
   
   spatial_resource_count[res_id]->ResetGradRes(ctx, worldx, worldy);
+  markModified();
 }
 
 void cResourceCount::SetGradientPlatInflow(const int& res_id, const double& inflow) 
@@ -471,6 +420,7 @@ void cResourceCount::SetProbabilisticResource(cAvidaContext& ctx, const int& res
   assert(res_id >= 0 && res_id < resource_count.GetSize());
   assert(spatial_resource_count[res_id]->GetSize() > 0);
   spatial_resource_count[res_id]->SetProbabilisticResource(ctx, initial, inflow, outflow, lambda, theta, x, y, count);
+  markModified();
 }
 
 /*
@@ -539,6 +489,13 @@ void cResourceCount::Update(double in_time)
   spatial_update_time += in_time;
  }
 
+void cResourceCount::ShareClock(const Apto::Array<double, Apto::Smart>* steps)
+{
+  syncClock();
+  m_shared_steps = steps;
+  m_steps_seen = (steps) ? steps->GetSize() : 0;
+}
+
  
 const Apto::Array<double> & cResourceCount::GetResources(cAvidaContext& ctx) const
 {
@@ -655,7 +612,7 @@ void cResourceCount::ModifyCell(cAvidaContext& ctx, const Apto::Array<double> &
         resource_count[i] += res_change[i];
       assert(resource_count[i] >= 0.0);
     } else {
-      double temp = spatial_resource_count[i]->Element(cell_id).GetAmount();
+      double temp = spatial_resource_count[i]->GetAmount(cell_id);
       spatial_resource_count[i]->Rate(cell_id, res_change[i]);
       /* Ideally the state of the cell's resource should not be set till
          the end of the update so that all processes (inflow, outflow, 
@@ -664,11 +621,33 @@ void cResourceCount::ModifyCell(cAvidaContext& ctx, const Apto::Array<double> &
          the organism demand to work immediately on the state of the resource */ 
     
       spatial_resource_count[i]->State(cell_id);
-      if(spatial_resource_count[i]->Element(cell_id).GetAmount() != temp){
+      if(spatial_resource_count[i]->GetAmount(cell_id) != temp){
         spatial_resource_count[i]->SetModified(true);
+        m_touched_cells.Push(cell_id);
       }
-      assert(spatial_resource_count[i]->Element(cell_id).GetAmount() >= 0.0);
+      assert(spatial_resource_count[i]->GetAmount(cell_id) >= 0.0);
+    }
+  }
+}
+
+void cResourceCount::ModifyCell(cAvidaContext& ctx, int res_index, double change, int cell_id)
+{
+  assert(res_index < resource_count.GetSize());
+
+  DoUpdates(ctx);
+  if (geometry[res_index] == nGeometry::GLOBAL || geometry[res_index] == nGeometry::PARTIAL) {
+    resource_count[res_index] += change;
+    assert(resource_count[res_index] >= 0.0);
+  } else {
+    cSpatialResCount& sp_res = *spatial_resource_count[res_index];
+    const double temp = sp_res.GetAmount(cell_id);
+    sp_res.Rate(cell_id, change);
+    sp_res.State(cell_id);
+    if (sp_res.GetAmount(cell_id) != temp) {
+      sp_res.SetModified(true);
+      m_touched_cells.Push(cell_id);
     }
+    assert(sp_res.GetAmount(cell_id) >= 0.0);
   }
 }
 
@@ -692,6 +671,7 @@ void cResourceCount::Set(cAvidaContext& ctx, int res_index, double new_level)
     for(int i = 0; i < spatial_resource_count[res_index]->GetSize(); i++) {
       spatial_resource_count[res_index]->SetCellAmount(i, new_level/spatial_resource_count[res_index]->GetSize());
     }
+    markModified();
   }
 }
 
@@ -701,6 +681,7 @@ void cResourceCount::ResizeSpatialGrids(int in_x, int in_y)
     spatial_resource_count[i]->ResizeClear(in_x, in_y, geometry[i]);
     curr_spatial_res_cnt[i].Resize(in_x * in_y);
   }
+  markModified();
 }
 
 int cResourceCount::GetCurrPeakX(cAvidaContext& ctx, int res_id) const
@@ -753,6 +734,7 @@ int cResourceCount::GetMaxUsedY(int res_id)
 ///// Private Methods /////////
 void cResourceCount::DoUpdates(cAvidaContext& ctx, bool global_only) const
 { 
+  syncClock();
   assert(update_time >= -EPSILON);
 
   // Determine how many update steps have progressed
@@ -782,10 +764,14 @@ void cResourceCount::DoUpdates(cAvidaContext& ctx, bool global_only) const
   if (global_only) return;
 
   // If one (or more) complete update has occured update the spatial resources
+  if (m_spatial_update <= m_last_updated) return;
+  cScopedTimer timer(ctx.GetPerfTimers(), cPerfTimers::PERF_RESOURCES);
   while (m_spatial_update > m_last_updated) {
     m_last_updated++;
+    markModified();
     for (int i = 0; i < resource_count.GetSize(); i++) {
-     if (geometry[i] != nGeometry::GLOBAL && geometry[i] != nGeometry::PARTIAL) {
+     // Grids attached to a cDemeResourceArena are stepped by the arena for all demes at once
+     if (geometry[i] != nGeometry::GLOBAL && geometry[i] != nGeometry::PARTIAL && !spatial_resource_count[i]->IsAttached()) {
         spatial_resource_count[i]->UpdateCount(ctx);
         spatial_resource_count[i]->Source(inflow_rate[i]);
         spatial_resource_count[i]->Sink(decay_rate[i]);
@@ -814,6 +800,7 @@ void cResourceCount::ReinitializeResources(cAvidaContext& ctx, double additional
     }
 
   } //End going through the resources
+  markModified();
 }
 
 /* 
@@ -25,6 +25,7 @@
 
 #include "avida/Avida.h"
 
+#include "cGradientStencil.h"
 #include "cSpatialResCount.h"
 #include "cString.h"
 #include "cAvidaContext.h"
@@ -50,14 +51,24 @@ private:
   mutable Apto::Array< Apto::Array<double> > curr_spatial_res_cnt;
   int verbosity;
   Apto::Array< Apto::Array<int> > cell_lists;
+  cGradientStencilCache m_gradient_stencils;  // cone profiles shared by all of the gradient resources
 
   // Setup the update process to use lazy evaluation...
   mutable double update_time;     // Portion of an update compleated...
   mutable double spatial_update_time;
   mutable int m_last_updated;
   mutable int m_spatial_update;
+  const Apto::Array<double, Apto::Smart>* m_shared_steps;  // if set, update time steps come from a log shared with other counts
+  mutable int m_steps_seen;
+
+  // Change tracking for cached views of the spatial grids (see cSensingIndex)
+  mutable int m_modified;                                // bumped whenever spatial counts change in bulk
+  mutable Apto::Array<int, Apto::Smart> m_touched_cells; // cells changed individually since the last bulk change
+
+  inline void markModified() const { m_modified++; m_touched_cells.Resize(0); }
 
   void DoUpdates(cAvidaContext& ctx, bool global_only = false) const;         // Update resource count based on update time
+  inline void syncClock() const;
 
   // A few constants to describe update process...
   static const double UPDATE_STEP;   // Fraction of an update per step
@@ -127,6 +138,9 @@ public:
   void SetDecay(const cString& name, const double _decay);
   
   void Update(double in_time);
+  void ShareClock(const Apto::Array<double, Apto::Smart>* steps);
+  void RebaseClock() { syncClock(); m_steps_seen = 0; }
+  double GetUpdateTime() const { syncClock(); return update_time; }
 
   int GetSize(void) const { return resource_count.GetSize(); }
   const Apto::Array<double>& ReadResources(void) const { return resource_count; }
@@ -142,13 +156,17 @@ public:
   void Modify(cAvidaContext& ctx, const Apto::Array<double>& res_change);
   void Modify(cAvidaContext& ctx, int id, double change);
   void ModifyCell(cAvidaContext& ctx, const Apto::Array<double> & res_change, int cell_id);
+  void ModifyCell(cAvidaContext& ctx, int id, double change, int cell_id);
   void Set(cAvidaContext& ctx, int id, double new_level);
   double Get(cAvidaContext& ctx, int id) const;
   void ResizeSpatialGrids(int in_x, int in_y);
   cSpatialResCount GetSpatialResource(int id) { return *(spatial_resource_count[id]); }
+  cSpatialResCount& GetSpatialGrid(int id) { return *(spatial_resource_count[id]); }
   const cSpatialResCount& GetSpatialResource(int id) const { return *(spatial_resource_count[id]); }
   void ReinitializeResources(cAvidaContext& ctx, double additional_resource);
   double GetInitialResourceValue(int resourceID) const { return resource_initial[resourceID]; }
+  double GetInflowRate(int id) const { return inflow_rate[id]; }
+  double GetDecayRate(int id) const { return decay_rate[id]; }
   const cString& GetResName(int id) const { return resource_name[id]; }
   bool IsSpatial(int id) const { return ((geometry[id] != nGeometry::GLOBAL) && (geometry[id] != nGeometry::PARTIAL)); }
   int GetResourceByName(cString name) const;
@@ -163,9 +181,21 @@ public:
   int GetMaxUsedX(int res_id);
   int GetMaxUsedY(int res_id);
   
+  int GetModificationStamp() const { return m_modified; }
+  const Apto::Array<int, Apto::Smart>& GetTouchedCells() const { return m_touched_cells; }
+
   void SetSpatialUpdate(int update) { m_spatial_update = update; }
   void UpdateGlobalResources(cAvidaContext& ctx) { DoUpdates(ctx, true); }
   void UpdateResources(cAvidaContext& ctx) { DoUpdates(ctx, false); }
 };
 
+
+inline void cResourceCount::syncClock() const
+{
+  if (m_shared_steps == NULL) return;
+  // Replay the steps one at a time, so that update_time is rounded exactly as it is by Update()
+  const Apto::Array<double, Apto::Smart>& steps = *m_shared_steps;
+  for (; m_steps_seen < steps.GetSize(); m_steps_seen++) update_time += steps[m_steps_seen];
+}
+
 #endif
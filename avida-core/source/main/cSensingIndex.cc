@@ -0,0 +1,175 @@
+/*
+ *  cSensingIndex.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cSensingIndex.h"
+
+#include "cResourceCount.h"
+#include "cSpatialResCount.h"
+#include "cWorld.h"
+#include "nGeometry.h"
+
+
+cSensingIndex::cSensingIndex(cWorld* world, const cResourceCount& res_count)
+  : m_res_count(res_count)
+  , m_world_x(world->GetConfig().WORLD_X.Get())
+  , m_world_y(world->GetConfig().WORLD_Y.Get())
+  , m_torus(world->GetConfig().WORLD_GEOMETRY.Get() == nGeometry::TORUS)
+{
+  for (int i = 0; i < NUM_OCC_LAYERS; i++) resetLayer(m_occupancy[i]);
+}
+
+
+void cSensingIndex::SyncResource(int res_id)
+{
+  if (res_id >= m_resources.GetSize()) {
+    const int old_size = m_resources.GetSize();
+    m_resources.Resize(res_id + 1);
+    m_res_stamp.Resize(res_id + 1);
+    m_res_touched.Resize(res_id + 1);
+    for (int i = old_size; i <= res_id; i++) {
+      resetLayer(m_resources[i]);
+      m_res_stamp[i] = -1;
+      m_res_touched[i] = 0;
+    }
+  }
+
+  sLayer& layer = m_resources[res_id];
+  const cSpatialResCount& sp_res = m_res_count.GetSpatialResource(res_id);
+  const Apto::Array<int, Apto::Smart>& touched = m_res_count.GetTouchedCells();
+  const int num_cells = m_world_x * m_world_y;
+
+  // Bulk change (update step, reset, ...), rebuild the layer from scratch
+  if (m_res_stamp[res_id] != m_res_count.GetModificationStamp()) {
+    // Grids that do not cover the world cannot be indexed, so mark every cell and let the walker test them
+    const bool covers_world = (sp_res.GetSize() == num_cells);
+    for (int i = 0; i < num_cells; i++) layer.cells[i] = (!covers_world || sp_res.GetAmount(i) > 0.0) ? 1 : 0;
+
+    for (int y = 0; y < m_world_y; y++) {
+      for (int x = 0; x < m_world_x; x++) {
+        const int mark = layer.cells[y * m_world_x + x];
+        layer.rows[y * m_world_x + x] = mark;
+        layer.cols[x * m_world_y + y] = mark;
+      }
+    }
+    for (int y = 0; y < m_world_y; y++) build(layer.rows, y * m_world_x, m_world_x);
+    for (int x = 0; x < m_world_x; x++) build(layer.cols, x * m_world_y, m_world_y);
+
+    m_res_stamp[res_id] = m_res_count.GetModificationStamp();
+    m_res_touched[res_id] = touched.GetSize();
+    return;
+  }
+
+  // Otherwise just revisit the cells changed individually since the last sync
+  if (sp_res.GetSize() != num_cells) return;
+  for (int i = m_res_touched[res_id]; i < touched.GetSize(); i++) {
+    setCell(layer, touched[i], sp_res.GetAmount(touched[i]) > 0.0);
+  }
+  m_res_touched[res_id] = touched.GetSize();
+}
+
+
+void cSensingIndex::resetLayer(sLayer& layer)
+{
+  const int num_cells = m_world_x * m_world_y;
+  layer.cells.Resize(num_cells);
+  layer.cells.SetAll(0);
+  layer.rows.Resize(num_cells);
+  layer.rows.SetAll(0);
+  layer.cols.Resize(num_cells);
+  layer.cols.SetAll(0);
+}
+
+void cSensingIndex::setCell(sLayer& layer, int cell_id, bool set)
+{
+  const unsigned char mark = set ? 1 : 0;
+  if (layer.cells[cell_id] == mark) return;
+  layer.cells[cell_id] = mark;
+
+  const int x = cell_id % m_world_x;
+  const int y = cell_id / m_world_x;
+  const int delta = set ? 1 : -1;
+  add(layer.rows, y * m_world_x, m_world_x, x, delta);
+  add(layer.cols, x * m_world_y, m_world_y, y, delta);
+}
+
+bool cSensingIndex::anyInArm(const sLayer& layer, int x, int y, int dx, int dy, int len) const
+{
+  if (len <= 0) return false;
+
+  // Arms along a row index into the row trees by x, arms along a column into the column trees by y
+  const bool along_row = (dy == 0);
+  const Apto::Array<int>& tree = along_row ? layer.rows : layer.cols;
+  const int size = along_row ? m_world_x : m_world_y;
+  const int line_size = along_row ? m_world_y : m_world_x;
+  int line = along_row ? y : x;
+  const int start = along_row ? x : y;
+  const int step = along_row ? dx : dy;
+
+  int lo = (step > 0) ? start + 1 : start - len;
+  int hi = (step > 0) ? start + len : start - 1;
+
+  if (!m_torus) {
+    if (line < 0 || line >= line_size) return false;
+    if (lo < 0) lo = 0;
+    if (hi > size - 1) hi = size - 1;
+    if (lo > hi) return false;
+    return anyInLine(tree, line, size, lo, hi);
+  }
+
+  line = ((line % line_size) + line_size) % line_size;
+  if (hi - lo + 1 >= size) return anyInLine(tree, line, size, 0, size - 1);
+
+  const int span = hi - lo;
+  lo = ((lo % size) + size) % size;
+  hi = lo + span;
+  if (hi < size) return anyInLine(tree, line, size, lo, hi);
+  return anyInLine(tree, line, size, lo, size - 1) || anyInLine(tree, line, size, 0, hi - size);
+}
+
+
+// Fenwick tree helpers, each tree occupies tree[base .. base + size - 1] and is indexed from 0
+
+void cSensingIndex::add(Apto::Array<int>& tree, int base, int size, int idx, int delta)
+{
+  for (int i = idx + 1; i <= size; i += (i & -i)) tree[base + i - 1] += delta;
+}
+
+int cSensingIndex::prefix(const Apto::Array<int>& tree, int base, int idx)
+{
+  // Sum of entries [0, idx)
+  int sum = 0;
+  for (int i = idx; i > 0; i -= (i & -i)) sum += tree[base + i - 1];
+  return sum;
+}
+
+void cSensingIndex::build(Apto::Array<int>& tree, int base, int size)
+{
+  // Converts raw entries into a Fenwick tree in place
+  for (int i = 1; i <= size; i++) {
+    const int parent = i + (i & -i);
+    if (parent <= size) tree[base + parent - 1] += tree[base + i - 1];
+  }
+}
+
+bool cSensingIndex::anyInLine(const Apto::Array<int>& tree, int line, int size, int lo, int hi) const
+{
+  const int base = line * size;
+  return (prefix(tree, base, hi + 1) - prefix(tree, base, lo)) > 0;
+}
@@ -0,0 +1,91 @@
+/*
+ *  cSensingIndex.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cSensingIndex_h
+#define cSensingIndex_h
+
+#include "avida/core/Types.h"
+
+class cResourceCount;
+class cWorld;
+
+
+// Skip tables backing cOrgSensor look queries.  Each layer marks the cells that hold something (an organism, an avatar
+// of a given type, or a positive amount of a spatial resource) and keeps a Fenwick tree over every row and column of
+// those marks, so that a sight line can test a whole arm of cells in O(log n) instead of visiting each one.
+//
+// Occupancy layers are maintained by cPopulationCell as organisms and avatars come and go.  Resource layers are synced
+// lazily against cResourceCount, rebuilt whenever the counts change in bulk and patched for single cell changes.
+class cSensingIndex
+{
+public:
+  enum eOccupancyLayer { OCC_ORGANISM = 0, OCC_PRED_AV, OCC_PREY_AV, NUM_OCC_LAYERS };
+
+private:
+  struct sLayer
+  {
+    Apto::Array<unsigned char> cells;   // 1 where the cell holds something
+    Apto::Array<int> rows;              // Fenwick tree over x for each row, stored row by row
+    Apto::Array<int> cols;              // Fenwick tree over y for each column, stored column by column
+  };
+
+  const cResourceCount& m_res_count;
+  int m_world_x;
+  int m_world_y;
+  bool m_torus;
+
+  sLayer m_occupancy[NUM_OCC_LAYERS];
+  Apto::Array<sLayer> m_resources;
+  Apto::Array<int> m_res_stamp;         // cResourceCount modification stamp each resource layer was built against
+  Apto::Array<int> m_res_touched;       // touched cells already applied to each resource layer
+
+
+  cSensingIndex(); // @not_implemented
+  cSensingIndex(const cSensingIndex&); // @not_implemented
+  cSensingIndex& operator=(const cSensingIndex&); // @not_implemented
+
+public:
+  cSensingIndex(cWorld* world, const cResourceCount& res_count);
+
+  void SetOccupied(eOccupancyLayer layer, int cell_id, bool occupied) { setCell(m_occupancy[layer], cell_id, occupied); }
+  void SyncResource(int res_id);
+
+  // Returns true if any of the cells (x, y) + (dx, dy) * j, j = 1..len, holds something.  (dx, dy) must be a unit
+  // step along one axis.  Off-world cells are ignored, or wrapped on a torus.
+  bool AnyOccupiedInArm(eOccupancyLayer layer, int x, int y, int dx, int dy, int len) const
+    { return anyInArm(m_occupancy[layer], x, y, dx, dy, len); }
+  bool AnyResourceInArm(int res_id, int x, int y, int dx, int dy, int len) const
+    { return anyInArm(m_resources[res_id], x, y, dx, dy, len); }
+
+  bool IsOccupied(eOccupancyLayer layer, int cell_id) const { return m_occupancy[layer].cells[cell_id]; }
+  bool HasResource(int res_id, int cell_id) const { return m_resources[res_id].cells[cell_id]; }
+
+private:
+  void resetLayer(sLayer& layer);
+  void setCell(sLayer& layer, int cell_id, bool set);
+  bool anyInArm(const sLayer& layer, int x, int y, int dx, int dy, int len) const;
+
+  static void add(Apto::Array<int>& tree, int base, int size, int idx, int delta);
+  static int prefix(const Apto::Array<int>& tree, int base, int idx);
+  static void build(Apto::Array<int>& tree, int base, int size);
+  bool anyInLine(const Apto::Array<int>& tree, int line, int size, int lo, int hi) const;
+};
+
+#endif
@@ -29,122 +29,230 @@
 using namespace std;
 using namespace AvidaTools;
 
+static inline void FlowMatter(double amount1, double amount2, double& delta1, double& delta2,
+                              double inxdiffuse, double inydiffuse, double inxgravity, double inygravity,
+                              int xdist, int ydist, double dist) {
+
+  /* Routine to calculate the amount of flow from one cell to another.
+     Amount of flow is a function of:
+
+       1) Amount of material in each cell (will try to equalize)
+       2) Distance between each cell
+       3) x and y "gravity"
+
+     This method only effect the delta amount of each cell.  The State
+     method will need to be called at the end of each time step to complete
+     the movement of material.
+  */
+
+  double  diff, flowamt, xgravity, xdiffuse, ygravity,  ydiffuse;
+
+  if (((amount1 == 0.0) && (amount2 == 0.0)) && (dist < 0.0)) return;
+  diff = (amount1 - amount2);
+  if (xdist != 0) {
+
+    /* if there is material to be effected by x gravity */
+
+    if (((xdist>0) && (inxgravity>0.0)) || ((xdist<0) && (inxgravity<0.0))) {
+      xgravity = amount1 * fabs(inxgravity)/3.0;
+    } else {
+      xgravity = -amount2 * fabs(inxgravity)/3.0;
+    }
+    
+    /* Diffusion uses the diffusion constant x half the difference (as the 
+       elements attempt to equalize) / the number of possible neighbors (8) */
+
+    xdiffuse = inxdiffuse * diff / 16.0;
+  } else {
+    xdiffuse = 0.0;
+    xgravity = 0.0;
+  }  
+  if (ydist != 0) {
+
+    /* if there is material to be effected by y gravity */
+
+    if (((ydist>0) && (inygravity>0.0)) || ((ydist<0) && (inygravity<0.0))) {
+      ygravity = amount1 * fabs(inygravity)/3.0;
+    } else {
+      ygravity = -amount2 * fabs(inygravity)/3.0;
+    }
+    ydiffuse = inydiffuse * diff / 16.0;
+  } else {
+    ydiffuse = 0.0;
+    ygravity = 0.0;
+  }  
+
+  flowamt = ((xdiffuse + ydiffuse + xgravity + ygravity)/
+             (fabs(xdist*1.0) + fabs(ydist*1.0)))/dist;
+  delta1 -= flowamt;
+  delta2 += flowamt;
+}
+
+
 /* Setup a single spatial resource with known flows */
 
 cSpatialResCount::cSpatialResCount(int inworld_x, int inworld_y, int ingeometry, double inxdiffuse, double inydiffuse,
                                    double inxgravity, double inygravity)
-: grid(inworld_x * inworld_y), m_initial(0.0), m_modified(false)
+: m_amount(NULL), m_delta(NULL), m_attached(false), m_initial(0.0), cell_list_ptr(NULL), m_modified(false)
 {
-  int i;
- 
   xdiffuse = inxdiffuse;
   ydiffuse = inydiffuse;
   xgravity = inxgravity;
   ygravity = inygravity;
-  world_x = inworld_x;
-  world_y = inworld_y;
-  geometry = ingeometry;
-  num_cells = world_x * world_y;
-  for (i = 0; i < GetSize(); i++) {
-    cSpatialCountElem tmpelem;
-    grid[i] = tmpelem;
-  } 
-  SetPointers();
+  ResizeClear(inworld_x, inworld_y, ingeometry);
 }
 
 /* Setup a single spatial resource using default flow amounts  */
 
 cSpatialResCount::cSpatialResCount(int inworld_x, int inworld_y, int ingeometry)
-: grid(inworld_x * inworld_y), m_initial(0.0), m_modified(false)
+: m_amount(NULL), m_delta(NULL), m_attached(false), m_initial(0.0), cell_list_ptr(NULL), m_modified(false)
 {
-  int i;
- 
   xdiffuse = 1.0;
   ydiffuse = 1.0;
   xgravity = 0.0;
   ygravity = 0.0;
-  world_x = inworld_x;
-  world_y = inworld_y;
-  geometry = ingeometry;
-  num_cells = world_x * world_y;
-  for (i = 0; i < GetSize(); i++) {
-    cSpatialCountElem tmpelem;
-    grid[i] = tmpelem;
-   } 
-   SetPointers();
+  ResizeClear(inworld_x, inworld_y, ingeometry);
 }
 
-cSpatialResCount::cSpatialResCount() : m_initial(0.0), xdiffuse(1.0), ydiffuse(1.0), xgravity(0.0), ygravity(0.0), m_modified(false)
+cSpatialResCount::cSpatialResCount()
+: m_amount(NULL), m_delta(NULL), m_attached(false), m_initial(0.0), xdiffuse(1.0), ydiffuse(1.0), xgravity(0.0)
+, ygravity(0.0), world_x(0), world_y(0), num_cells(0), cell_list_ptr(NULL), m_modified(false)
 {
   geometry = nGeometry::GLOBAL;
 }
 
+cSpatialResCount::cSpatialResCount(const cSpatialResCount& rc)
+: m_amount(NULL), m_delta(NULL), m_attached(false)
+{
+  *this = rc;
+}
+
 cSpatialResCount::~cSpatialResCount() { ; }
 
 
+cSpatialResCount& cSpatialResCount::operator=(const cSpatialResCount& rc)
+{
+  if (this == &rc) return *this;
+
+  // Copies always own their cell state, even when the source is attached to shared storage
+  m_own_amount.ResizeClear(rc.num_cells);
+  m_own_delta.ResizeClear(rc.num_cells);
+  for (int i = 0; i < rc.num_cells; i++) {
+    m_own_amount[i] = rc.m_amount[i];
+    m_own_delta[i] = rc.m_delta[i];
+  }
+  m_attached = false;
+  m_amount = (rc.num_cells > 0) ? &m_own_amount[0] : NULL;
+  m_delta = (rc.num_cells > 0) ? &m_own_delta[0] : NULL;
+  m_cell_initial = rc.m_cell_initial;
+  m_links = rc.m_links;
+
+  m_initial = rc.m_initial;
+  xdiffuse = rc.xdiffuse;
+  ydiffuse = rc.ydiffuse;
+  xgravity = rc.xgravity;
+  ygravity = rc.ygravity;
+  inflowX1 = rc.inflowX1;
+  inflowX2 = rc.inflowX2;
+  inflowY1 = rc.inflowY1;
+  inflowY2 = rc.inflowY2;
+  outflowX1 = rc.outflowX1;
+  outflowX2 = rc.outflowX2;
+  outflowY1 = rc.outflowY1;
+  outflowY2 = rc.outflowY2;
+  geometry = rc.geometry;
+  world_x = rc.world_x;
+  world_y = rc.world_y;
+  num_cells = rc.num_cells;
+  curr_peakx = rc.curr_peakx;
+  curr_peaky = rc.curr_peaky;
+  cell_list_ptr = rc.cell_list_ptr;
+  m_modified = rc.m_modified;
+
+  return *this;
+}
+
+
 void cSpatialResCount::ResizeClear(int inworld_x, int inworld_y, int ingeometry)
 {
-  int i;
- 
-  grid.ResizeClear(inworld_x * inworld_y); 
   world_x = inworld_x;
   world_y = inworld_y;
   geometry = ingeometry;
   num_cells = world_x * world_y;
-  for (i = 0; i < GetSize(); i++) {
-    cSpatialCountElem tmpelem;
-    grid[i] = tmpelem;
-   } 
-   SetPointers();
+
+  m_own_amount.ResizeClear(num_cells);
+  m_own_amount.SetAll(0.0);
+  m_own_delta.ResizeClear(num_cells);
+  m_own_delta.SetAll(0.0);
+  m_cell_initial.ResizeClear(num_cells);
+  m_cell_initial.SetAll(0.0);
+  m_attached = false;
+  m_amount = (num_cells > 0) ? &m_own_amount[0] : NULL;
+  m_delta = (num_cells > 0) ? &m_own_delta[0] : NULL;
+
+  SetPointers();
 }
 
-void cSpatialResCount::SetPointers()
+void cSpatialResCount::AttachStorage(double* amount, double* delta)
 {
-  /* Pointer 0 will point to the cell above and to the left the current cell
-     and will go clockwise around the cell.                               */
+  for (int i = 0; i < num_cells; i++) {
+    amount[i] = m_amount[i];
+    delta[i] = m_delta[i];
+  }
+  m_amount = amount;
+  m_delta = delta;
+  m_attached = true;
+  m_own_amount.ResizeClear(0);
+  m_own_delta.ResizeClear(0);
+}
 
-  int     i,ii;
-  double  SQRT2 = sqrt(2.0);
+void cSpatialResCount::DetachStorage()
+{
+  if (!m_attached) return;
 
-  /* First treat all cells like they are in a torus */
-
-  for (i = 0; i < GetSize(); i++) {
-    grid[i].SetPtr(0 ,GridNeighbor(i, world_x, world_y, -1, -1), -1, -1, SQRT2);
-    grid[i].SetPtr(1 ,GridNeighbor(i, world_x, world_y,  0, -1),  0, -1, 1.0);
-    grid[i].SetPtr(2 ,GridNeighbor(i, world_x, world_y, +1, -1), +1, -1, SQRT2);
-    grid[i].SetPtr(3 ,GridNeighbor(i, world_x, world_y, +1,  0), +1,  0, 1.0);
-    grid[i].SetPtr(4 ,GridNeighbor(i, world_x, world_y, +1, +1), +1, +1, SQRT2);
-    grid[i].SetPtr(5 ,GridNeighbor(i, world_x, world_y,  0, +1),  0, +1, 1.0);
-    grid[i].SetPtr(6 ,GridNeighbor(i, world_x, world_y, -1, +1), -1, +1, SQRT2);
-    grid[i].SetPtr(7 ,GridNeighbor(i, world_x, world_y, -1,  0), -1,  0, 1.0);
+  m_own_amount.ResizeClear(num_cells);
+  m_own_delta.ResizeClear(num_cells);
+  for (int i = 0; i < num_cells; i++) {
+    m_own_amount[i] = m_amount[i];
+    m_own_delta[i] = m_delta[i];
   }
- 
-  /* Fix links for top, bottom and sides for non-torus */
-  
-  if (geometry == nGeometry::GRID) {
-    /* Top and bottom */
-
-    for (i = 0; i < world_x; i++) {
-      grid[i].SetPtr(0, -99, -99, -99, -99.0);
-      grid[i].SetPtr(1, -99, -99, -99, -99.0);
-      grid[i].SetPtr(2, -99, -99, -99, -99.0);
-      ii = num_cells-1-i;
-      grid[ii].SetPtr(4, -99, -99, -99, -99.0);
-      grid[ii].SetPtr(5, -99, -99, -99, -99.0);
-      grid[ii].SetPtr(6, -99, -99, -99, -99.0);
-    }
+  m_amount = (num_cells > 0) ? &m_own_amount[0] : NULL;
+  m_delta = (num_cells > 0) ? &m_own_delta[0] : NULL;
+  m_attached = false;
+}
 
-    /* fix links for right and left sides */
-
-    for (i = 0; i < world_y; i++) {
-      ii = i * world_x;    
-      grid[ii].SetPtr(0, -99, -99, -99, -99.0);
-      grid[ii].SetPtr(7, -99, -99, -99, -99.0);
-      grid[ii].SetPtr(6, -99, -99, -99, -99.0);
-      ii = ((i + 1) * world_x) - 1;
-      grid[ii].SetPtr(2, -99, -99, -99, -99.0);
-      grid[ii].SetPtr(3, -99, -99, -99, -99.0);
-      grid[ii].SetPtr(4, -99, -99, -99, -99.0);
+void cSpatialResCount::SetPointers()
+{
+  /* Link 0 points to the cell to the right of the current cell and the rest
+     go clockwise around the cell down to the one below and to the left.  */
+
+  double  SQRT2 = sqrt(2.0);
+  const int dx[NUM_FLOW_LINKS] = { +1, +1,  0, -1 };
+  const int dy[NUM_FLOW_LINKS] = {  0, +1, +1, +1 };
+
+  m_links.ResizeClear(num_cells * NUM_FLOW_LINKS);
+
+  for (int i = 0; i < num_cells; i++) {
+    const int x = i % world_x;
+    const int y = i / world_x;
+    for (int k = 0; k < NUM_FLOW_LINKS; k++) {
+      sFlowLink& link = m_links[i * NUM_FLOW_LINKS + k];
+
+      /* Treat all cells like they are in a torus, but cut links that cross
+         the top, bottom or sides of a non-torus grid */
+
+      if (geometry == nGeometry::GRID &&
+          (x + dx[k] < 0 || x + dx[k] >= world_x || y + dy[k] >= world_y)) {
+        link.elem = -1;
+        link.xdist = -99;
+        link.ydist = -99;
+        link.dist = -99.0;
+      } else {
+        link.elem = GridNeighbor(i, world_x, world_y, dx[k], dy[k]);
+        link.xdist = dx[k];
+        link.ydist = dy[k];
+        link.dist = (dx[k] != 0 && dy[k] != 0) ? SQRT2 : 1.0;
+      }
     }
   }
 }
@@ -222,10 +330,10 @@ void cSpatialResCount::SetCellList(Apto::Array<cCellResource>* in_cell_list_ptr)
     /* Be sure the user entered a valid cell id or if the the program is loading
        the resource for the testCPU that does not have a grid set up */
        
-    if (cell_id >= 0 && cell_id <= grid.GetSize()) {
+    if (cell_id >= 0 && cell_id <= num_cells) {
       Rate((*cell_list_ptr)[i].GetId(), (*cell_list_ptr)[i].GetInitial());
       State((*cell_list_ptr)[i].GetId());
-      Element(cell_id).SetInitial((*cell_list_ptr)[i].GetInitial());
+      m_cell_initial[cell_id] = (*cell_list_ptr)[i].GetInitial();
     }
   }
 }
@@ -233,8 +341,8 @@ void cSpatialResCount::SetCellList(Apto::Array<cCellResource>* in_cell_list_ptr)
 /* Set the rate variable for one element using the array index */
 
 void cSpatialResCount::Rate(int x, double ratein) const {
-  if (x >= 0 && x < grid.GetSize()) {
-    grid[x].Rate(ratein);
+  if (x >= 0 && x < num_cells) {
+    m_delta[x] += ratein;
   } else {
     assert(false); // x not valid id
   }
@@ -244,7 +352,7 @@ void cSpatialResCount::Rate(int x, double ratein) const {
 
 void cSpatialResCount::Rate(int x, int y, double ratein) const { 
   if (x >= 0 && x < world_x && y>= 0 && y < world_y) {
-    grid[y * world_x + x].Rate(ratein);
+    m_delta[y * world_x + x] += ratein;
   } else {
     assert(false); // x or y not valid id
   }
@@ -254,8 +362,9 @@ void cSpatialResCount::Rate(int x, int y, double ratein) const {
    the array index */
    
 void cSpatialResCount::State(int x) { 
-  if (x >= 0 && x < grid.GetSize()) {
-    grid[x].State();
+  if (x >= 0 && x < num_cells) {
+    m_amount[x] += m_delta[x];
+    m_delta[x] = 0.0;
   } else {
     assert(false); // x not valid id
   }
@@ -266,27 +375,19 @@ void cSpatialResCount::State(int x) {
    
 void cSpatialResCount::State(int x, int y) { 
   if (x >= 0 && x < world_x && y >= 0 && y < world_y) {
-    grid[y*world_x + x].State();
+    const int elem = y * world_x + x;
+    m_amount[elem] += m_delta[elem];
+    m_delta[elem] = 0.0;
   } else {
     assert(false); // x or y not valid id
   }
 }
 
-/* Get the state of one element using the array index */
-
-double cSpatialResCount::GetAmount(int x) const { 
-  if (x >= 0 && x < grid.GetSize()) {
-    return grid[x].GetAmount(); 
-  } else {
-    return -99.9;
-  }
-}
-
 /* Get the state of one element using the the x,y coordinate */
 
 double cSpatialResCount::GetAmount(int x, int y) const { 
   if (x >= 0 && x < world_x && y >= 0 && y < world_y) {
-    return grid[y*world_x + x].GetAmount(); 
+    return m_amount[y * world_x + x];
   } else {
     return -99.9;
   }
@@ -297,7 +398,7 @@ void cSpatialResCount::RateAll(double ratein) {
   int i;
  
   for (i = 0; i < num_cells; i++) {
-    grid[i].Rate(ratein);
+    m_delta[i] += ratein;
   } 
 }
 
@@ -309,31 +410,29 @@ void cSpatialResCount::StateAll() {
   int i;
  
   for (i = 0; i < num_cells; i++) {
-    grid[i].State();
+    m_amount[i] += m_delta[i];
+    m_delta[i] = 0.0;
   } 
 }
 
 void cSpatialResCount::FlowAll() {
+  flowCells(m_amount, m_delta);
+}
+
+void cSpatialResCount::flowCells(const double* amount, double* delta) const {
 
   // @JEB save time if diffusion and gravity off...
   if ((xdiffuse == 0.0) && (ydiffuse == 0.0) && (xgravity == 0.0) && (ygravity == 0.0)) return;
 
-  int     i,k,ii,xdist,ydist;
-  double  dist;
- 
-  for (i = 0; i < num_cells; i++) {
-      
-    /* because flow is two way we must check only half the neighbors to 
-       prevent double flow calculations */
-
-    for (k = 3; k <= 6; k++) {
-      ii = grid[i].GetElemPtr(k);
-      xdist = grid[i].GetPtrXdist(k);
-      ydist = grid[i].GetPtrYdist(k);
-      dist = grid[i].GetPtrDist(k);
-      if (ii >= 0) {
-        FlowMatter(grid[i],grid[ii],xdiffuse,ydiffuse,xgravity,ygravity,
-                   xdist, ydist, dist);
+  /* because flow is two way each cell only links to half of its neighbors,
+     which prevents double flow calculations */
+
+  const sFlowLink* link = (num_cells > 0) ? &m_links[0] : NULL;
+  for (int i = 0; i < num_cells; i++) {
+    for (int k = 0; k < NUM_FLOW_LINKS; k++, link++) {
+      if (link->elem >= 0) {
+        FlowMatter(amount[i], amount[link->elem], delta[i], delta[link->elem], xdiffuse, ydiffuse, xgravity, ygravity,
+                   link->xdist, link->ydist, link->dist);
       }
     }
   }
@@ -379,7 +478,7 @@ void cSpatialResCount::CellInflow() const {
     /* Be sure the user entered a valid cell id or if the the program is loading
        the resource for the testCPU that does not have a grid set up */
        
-    if (cell_id >= 0 && cell_id < grid.GetSize()) {
+    if (cell_id >= 0 && cell_id < num_cells) {
       Rate(cell_id, (*cell_list_ptr)[i].GetInflow());
     }
   }
@@ -415,7 +514,7 @@ void cSpatialResCount::CellOutflow() const {
     /* Be sure the user entered a valid cell id or if the the program is loading
        the resource for the testCPU that does not have a grid set up */
        
-    if (cell_id >= 0 && cell_id < grid.GetSize()) {
+    if (cell_id >= 0 && cell_id < num_cells) {
       deltaamount = Apto::Max((GetAmount(cell_id) * (*cell_list_ptr)[i].GetOutflow()), 0.0);
     }                     
     Rate((*cell_list_ptr)[i].GetId(), -deltaamount); 
@@ -424,14 +523,14 @@ void cSpatialResCount::CellOutflow() const {
 
 void cSpatialResCount::SetCellAmount(int cell_id, double res)
 {
-  if (cell_id >= 0 && cell_id < grid.GetSize())
+  if (cell_id >= 0 && cell_id < num_cells)
   {
-    Element(cell_id).SetAmount(res);
+    m_amount[cell_id] = res;
   }
 }
 
 
 void cSpatialResCount::ResetResourceCounts()
 {
-  for (int i = 0; i < grid.GetSize(); i++) grid[i].ResetResourceCount(m_initial);
+  for (int i = 0; i < num_cells; i++) m_amount[i] = m_initial + m_cell_initial[i];
 }
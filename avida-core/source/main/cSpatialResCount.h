@@ -26,14 +26,37 @@
 #define cSpatialResCount_h
 
 #include "cAvidaContext.h"
-#include "cSpatialCountElem.h"
 #include "cResource.h"
 
+class cDemeResourceArena;
+
 
 class cSpatialResCount
 {
+  friend class cDemeResourceArena;
+
 private:
-  Apto::Array<cSpatialCountElem> grid;
+  // Link from a cell to one of the neighbors it exchanges matter with.  Flow is two way, so each cell only keeps the
+  // links to its east, south-east, south and south-west neighbors.
+  struct sFlowLink
+  {
+    int elem;       // neighbor cell, or -1 if the edge of a grid cuts the link
+    int xdist;
+    int ydist;
+    double dist;
+  };
+  static const int NUM_FLOW_LINKS = 4;
+
+  // Cell state is kept in flat arrays.  The amount and delta arrays normally point at the grid's own storage, but
+  // may be attached to a slice of a larger block shared with other grids (see cDemeResourceArena).
+  Apto::Array<double> m_own_amount;
+  Apto::Array<double> m_own_delta;
+  double* m_amount;
+  double* m_delta;
+  bool m_attached;
+  Apto::Array<double> m_cell_initial;  // per cell amounts set by the CELL command
+  Apto::Array<sFlowLink> m_links;      // NUM_FLOW_LINKS links per cell
+
   double m_initial;
   double xdiffuse, ydiffuse;
   double xgravity, ygravity;
@@ -52,22 +75,24 @@ public:
   cSpatialResCount(int inworld_x, int inworld_y, int ingeometry, 
                    double inxdiffuse, double inydiffuse,
                    double inxgravity, double inygravity);
+  cSpatialResCount(const cSpatialResCount& rc);
   virtual ~cSpatialResCount();
+
+  cSpatialResCount& operator=(const cSpatialResCount& rc);
   
   void ResizeClear(int inworld_x, int inworld_y, int ingeometry);
   void SetPointers();
   void CheckRanges();
   void SetCellList(Apto::Array<cCellResource> *in_cell_list_ptr);
-  int GetSize() const { return grid.GetSize(); }
+  int GetSize() const { return num_cells; }
   int GetX() const { return world_x; }
   int GetY() const { return world_y; }
   int GetCellListSize() const { return cell_list_ptr->GetSize(); }
-  cSpatialCountElem& Element(int x) { return grid[x]; }
   void Rate(int x, double ratein) const;
   void Rate(int x, int y, double ratein) const;
   void State(int x);
   void State(int x, int y);
-  double GetAmount(int x) const;
+  inline double GetAmount(int x) const { return (x >= 0 && x < num_cells) ? m_amount[x] : -99.9; }
   double GetAmount(int x, int y) const;
   void RateAll(double ratein); 
   virtual void StateAll();
@@ -97,6 +122,11 @@ public:
   void ResetResourceCounts();
   void SetModified(bool in_modified) { m_modified = in_modified; }
   bool GetModified() { return m_modified; }
+
+  // Moves the cell amounts and deltas into caller owned storage of GetSize() doubles each, or back into the grid
+  void AttachStorage(double* amount, double* delta);
+  void DetachStorage();
+  bool IsAttached() const { return m_attached; }
   
   virtual void SetGradInitialPlat(double) { ; }
   virtual void SetGradPeakX(int) { ; }
@@ -153,6 +183,9 @@ public:
   virtual int GetMinUsedY() { return -1; }
   virtual int GetMaxUsedX() { return -1; }
   virtual int GetMaxUsedY() { return -1; }
+
+private:
+  void flowCells(const double* amount, double* delta) const;
 };
 
 #endif
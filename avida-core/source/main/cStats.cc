@@ -48,6 +48,7 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <climits>
 #include <numeric>
 #include <cmath>
 #include <sstream>
@@ -95,6 +96,8 @@ cStats::cStats(cWorld* world)
 , num_guard_fail(0)
 , num_resamplings(0)
 , num_failedResamplings(0)
+, m_num_org_shards(0)
+, m_org_shard_size(1)
 , last_update(0)
 , sense_size(0)
 , avg_competition_fitness(0)
@@ -127,6 +130,7 @@ cStats::cStats(cWorld* world)
   task_last_count.Resize(num_tasks);
   task_test_count.Resize(num_tasks);
   m_collect_env_test_stats = false;
+  m_org_stats_demand = (m_world->GetConfig().ORG_STATS_ON_DEMAND.Get()) ? 0 : ORG_STATS_ALL;
   
   tasks_host_current.Resize(num_tasks);
   tasks_host_last.Resize(num_tasks);
@@ -411,10 +415,15 @@ mgr->Register(name, activate); \
   m_data_manager.Add("ave_speculative","Averate Speculative Instructions", &cStats::GetAveSpeculative);
   m_data_manager.Add("speculative_waste", "Speculative Execution Waste",   &cStats::GetSpeculativeWaste);
   
+  m_data_manager.Add("testcpu_cache_hits",   "Test CPU Cache Hits",          &cStats::GetTestCPUCacheHits);
+  m_data_manager.Add("testcpu_cache_misses", "Test CPU Cache Misses",        &cStats::GetTestCPUCacheMisses);
+  
   PROVIDE("core.world.ave_metabolic_rate", "Average Metabolic Rate",               double, GetAveMerit);
   PROVIDE("core.world.ave_age",            "Average Organism Age (in updates)",    double, GetAveCreatureAge);
   PROVIDE("core.world.ave_gestation_time", "Average Gestation Time",               double, GetAveGestation);
   PROVIDE("core.world.ave_fitness",        "Average Fitness",                      double, GetAveFitness);
+  PROVIDE("core.testcpu.cache_hits",       "Test CPU Cache Hits",                  double, GetTestCPUCacheHits);
+  PROVIDE("core.testcpu.cache_misses",     "Test CPU Cache Misses",                double, GetTestCPUCacheMisses);
   
   
   // Maximums
@@ -499,6 +508,125 @@ void cStats::ZeroReactions()
   m_reaction_last_add_reward.SetAll(0);
 }
 
+int cStats::ResetOrgStatsShards(int num_orgs, int num_tasks, int num_reactions)
+{
+  // The shards are still filled one after the other, so the whole population goes into a single shard.  Its sums then
+  // accumulate in organism order, exactly like the running sums used before shards.  Splitting the population into
+  // blocks changes the last bits of the floating point totals, which only pays off once workers fill the blocks.
+  m_org_shard_size = (num_orgs > 0) ? num_orgs : 1;
+  m_num_org_shards = (num_orgs > 0) ? 1 : 0;
+  if (m_org_shards.GetSize() < m_num_org_shards) m_org_shards.Resize(m_num_org_shards);
+  for (int i = 0; i < m_num_org_shards; i++) m_org_shards[i].Reset(m_org_shard_size, num_tasks, num_reactions, sense_size);
+  return m_num_org_shards;
+}
+
+void cStats::MergeOrgStatsShards()
+{
+  // Shards are always folded in order, so the totals never depend on how the shards were filled
+  cMerit all_max_merit(0);
+  double all_max_fitness = 0;
+  int all_max_gestation = 0;
+  int all_max_genome = 0;
+  cMerit all_min_merit(FLT_MAX);
+  double all_min_fitness = FLT_MAX;
+  int all_min_gestation = INT_MAX;
+  int all_min_genome = INT_MAX;
+  int counts[cStatsShard::NUM_COUNTS] = { 0 };
+
+  for (int s = 0; s < m_num_org_shards; s++) {
+    const cStatsShard& shard = m_org_shards[s];
+
+    sum_fitness.Merge(shard.GetSum(cStatsShard::SUM_FITNESS));
+    sum_merit.Merge(shard.GetSum(cStatsShard::SUM_MERIT));
+    sum_gestation.Merge(shard.GetSum(cStatsShard::SUM_GESTATION));
+    sum_creature_age.Merge(shard.GetSum(cStatsShard::SUM_CREATURE_AGE));
+    sum_generation.Merge(shard.GetSum(cStatsShard::SUM_GENERATION));
+    sum_neutral_metric.Merge(shard.GetSum(cStatsShard::SUM_NEUTRAL_METRIC));
+    sum_lineage_label.Merge(shard.GetSum(cStatsShard::SUM_LINEAGE_LABEL));
+    sum_copy_size.Merge(shard.GetSum(cStatsShard::SUM_COPY_SIZE));
+    sum_exe_size.Merge(shard.GetSum(cStatsShard::SUM_EXE_SIZE));
+    sum_mem_size.Merge(shard.GetSum(cStatsShard::SUM_MEM_SIZE));
+
+    for (int i = 0; i < shard.GetNumMutRateSamples(); i++) {
+      const double copy_mut_rate = shard.GetCopyMutRate(i);
+      const double div_mut_rate = shard.GetDivMutRate(i);
+      sum_copy_mut_rate.Push(copy_mut_rate);
+      sum_log_copy_mut_rate.Push(log(copy_mut_rate));
+      sum_div_mut_rate.Push(div_mut_rate);
+      sum_log_div_mut_rate.Push(log(div_mut_rate));
+    }
+
+    for (int i = 0; i < cStatsShard::NUM_COUNTS; i++) counts[i] += shard.GetCount((cStatsShard::eCount)i);
+
+    if (shard.GetMaxMerit() > all_max_merit) all_max_merit = shard.GetMaxMerit();
+    if (shard.GetMaxFitness() > all_max_fitness) all_max_fitness = shard.GetMaxFitness();
+    if (shard.GetMaxGestationTime() > all_max_gestation) all_max_gestation = shard.GetMaxGestationTime();
+    if (shard.GetMaxGenomeLength() > all_max_genome) all_max_genome = shard.GetMaxGenomeLength();
+    if (shard.GetMinMerit() < all_min_merit) all_min_merit = shard.GetMinMerit();
+    if (shard.GetMinFitness() < all_min_fitness) all_min_fitness = shard.GetMinFitness();
+    if (shard.GetMinGestationTime() < all_min_gestation) all_min_gestation = shard.GetMinGestationTime();
+    if (shard.GetMinGenomeLength() < all_min_genome) all_min_genome = shard.GetMinGenomeLength();
+
+    for (int j = 0; j < shard.GetNumTasks(); j++) {
+      task_cur_count[j] += shard.GetTaskCount(cStatsShard::TASK_CUR, j);
+      task_last_count[j] += shard.GetTaskCount(cStatsShard::TASK_LAST, j);
+      task_test_count[j] += shard.GetTaskCount(cStatsShard::TASK_TEST, j);
+      tasks_host_current[j] += shard.GetTaskCount(cStatsShard::TASK_HOST_CUR, j);
+      tasks_host_last[j] += shard.GetTaskCount(cStatsShard::TASK_HOST_LAST, j);
+      tasks_parasite_current[j] += shard.GetTaskCount(cStatsShard::TASK_PARASITE_CUR, j);
+      tasks_parasite_last[j] += shard.GetTaskCount(cStatsShard::TASK_PARASITE_LAST, j);
+      task_internal_cur_count[j] += shard.GetTaskCount(cStatsShard::TASK_INTERNAL_CUR, j);
+      task_internal_last_count[j] += shard.GetTaskCount(cStatsShard::TASK_INTERNAL_LAST, j);
+      task_exe_count[j] += shard.GetTaskCount(cStatsShard::TASK_EXE, j);
+
+      task_cur_quality[j] += shard.GetTaskQuality(cStatsShard::QUALITY_CUR, j);
+      task_last_quality[j] += shard.GetTaskQuality(cStatsShard::QUALITY_LAST, j);
+      task_internal_cur_quality[j] += shard.GetTaskQuality(cStatsShard::QUALITY_INTERNAL_CUR, j);
+      task_internal_last_quality[j] += shard.GetTaskQuality(cStatsShard::QUALITY_INTERNAL_LAST, j);
+
+      const double cur_max = shard.GetTaskMaxQuality(cStatsShard::QUALITY_CUR, j);
+      if (cur_max > task_cur_max_quality[j]) task_cur_max_quality[j] = cur_max;
+      const double last_max = shard.GetTaskMaxQuality(cStatsShard::QUALITY_LAST, j);
+      if (last_max > task_last_max_quality[j]) task_last_max_quality[j] = last_max;
+      const double internal_cur_max = shard.GetTaskMaxQuality(cStatsShard::QUALITY_INTERNAL_CUR, j);
+      if (internal_cur_max > task_internal_cur_max_quality[j]) task_internal_cur_max_quality[j] = internal_cur_max;
+      const double internal_last_max = shard.GetTaskMaxQuality(cStatsShard::QUALITY_INTERNAL_LAST, j);
+      if (internal_last_max > task_internal_last_max_quality[j]) task_internal_last_max_quality[j] = internal_last_max;
+    }
+
+    for (int j = 0; j < shard.GetNumReactions(); j++) {
+      m_reaction_cur_count[j] += shard.GetReactionCount(cStatsShard::REACTION_CUR, j);
+      m_reaction_last_count[j] += shard.GetReactionCount(cStatsShard::REACTION_LAST, j);
+      m_reaction_exe_count[j] += shard.GetReactionCount(cStatsShard::REACTION_EXE, j);
+      m_reaction_cur_add_reward[j] += shard.GetReactionReward(cStatsShard::REWARD_CUR, j);
+      m_reaction_last_add_reward[j] += shard.GetReactionReward(cStatsShard::REWARD_LAST, j);
+    }
+
+    for (int j = 0; j < shard.GetNumSenses(); j++) {
+      AddLastSense(j, shard.GetSenseCount(cStatsShard::SENSE_LAST, j));
+      IncLastSenseExeCount(j, shard.GetSenseCount(cStatsShard::SENSE_LAST_EXE, j));
+    }
+  }
+
+  SetBreedTrueCreatures(counts[cStatsShard::COUNT_BREED_TRUE]);
+  SetNumNoBirthCreatures(counts[cStatsShard::COUNT_NO_BIRTH]);
+  SetNumParasites(counts[cStatsShard::COUNT_PARASITES]);
+  SetNumSingleThreadCreatures(counts[cStatsShard::COUNT_SINGLE_THREAD]);
+  SetNumMultiThreadCreatures(counts[cStatsShard::COUNT_MULTI_THREAD]);
+  SetNumThreads(counts[cStatsShard::COUNT_THREADS]);
+  SetNumModified(counts[cStatsShard::COUNT_MODIFIED]);
+
+  SetMaxMerit(all_max_merit.GetDouble());
+  SetMaxFitness(all_max_fitness);
+  SetMaxGestationTime(all_max_gestation);
+  SetMaxGenomeLength(all_max_genome);
+
+  SetMinMerit(all_min_merit.GetDouble());
+  SetMinFitness(all_min_fitness);
+  SetMinGestationTime(all_min_gestation);
+  SetMinGenomeLength(all_min_genome);
+}
+
 void cStats::ZeroMessageInst()
 {
 
@@ -1199,6 +1327,35 @@ void cStats::PrintThreadsData(const cString& filename)
 }
 
 
+// Cumulative counts outgrow an int on long runs, doubles hold them exactly up to 2^53
+double cStats::GetTestCPUCacheHits() const
+{
+  return (double)m_world->GetHardwareManager().GetTestCPUCache().GetHits();
+}
+
+double cStats::GetTestCPUCacheMisses() const
+{
+  return (double)m_world->GetHardwareManager().GetTestCPUCache().GetMisses();
+}
+
+int cStats::GetTestCPUCacheSize() const
+{
+  return m_world->GetHardwareManager().GetTestCPUCache().GetSize();
+}
+
+void cStats::PrintTestCPUCacheData(const cString& filename)
+{
+  Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
+  df->WriteComment("Avida test CPU cache data");
+  df->WriteTimeStamp();
+  df->Write(m_update, "Update");
+  df->Write(GetTestCPUCacheHits(), "Cumulative Cache Hits");
+  df->Write(GetTestCPUCacheMisses(), "Cumulative Cache Misses");
+  df->Write(GetTestCPUCacheSize(), "Cached Genomes");
+  df->Endl();
+}
+
+
 void cStats::PrintTasksData(const cString& filename)
 {
 	cString file = filename;
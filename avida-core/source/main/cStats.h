@@ -39,6 +39,7 @@
 #include "cOrganism.h"
 #include "cRunningAverage.h"
 #include "cRunningStats.h"
+#include "cStatsShard.h"
 #include "nGeometry.h"
 #include "tDataManager.h"
 #include "tMatrix.h"
@@ -206,7 +207,7 @@ private:
   int num_modified;
 
   int tot_organisms;
-  int tot_executed;
+  long long tot_executed;  // outgrows an int on long runs
 
   // --------  Parasite Task Stats  ---------
   Apto::Array<int> tasks_host_current;
@@ -232,6 +233,7 @@ private:
 
   // --------  Organism Task Stats  ---------
   mutable bool m_collect_env_test_stats;
+  mutable int m_org_stats_demand;
   Apto::Array<int> task_cur_count;
   Apto::Array<int> task_last_count;
   Apto::Array<int> task_test_count;
@@ -258,6 +260,10 @@ private:
   Apto::Array<double> m_reaction_last_add_reward;
   Apto::Array<int> m_reaction_exe_count;
 
+  Apto::Array<cStatsShard> m_org_shards;
+  int m_num_org_shards;
+  int m_org_shard_size;
+
   Apto::Array<double> resource_count;
   Apto::Array<int> resource_geometry;
   Apto::Array< Apto::Array<double> > spatial_res_count;
@@ -663,6 +669,19 @@ public:
   
   bool ShouldCollectEnvTestStats() const { return m_collect_env_test_stats; }
 
+  // Per-organism statistic groups gathered by cPopulation::UpdateOrganismStats().  With ORG_STATS_ON_DEMAND set, a
+  // group is only gathered once some output (print action, viewer screen) has declared that it consumes it.
+  enum {
+    ORG_STATS_TASKS           = 0x01,  // current/last task counts, qualities and execution counts
+    ORG_STATS_PARASITE_TASKS  = 0x02,  // host and parasite task counts
+    ORG_STATS_INTERNAL_TASKS  = 0x04,  // internal resource task counts and qualities
+    ORG_STATS_REACTIONS       = 0x08,  // reaction counts, rewards and execution counts
+    ORG_STATS_SENSES          = 0x10,
+    ORG_STATS_ALL             = 0x1F
+  };
+  void RequireOrgStats(int groups) const { m_org_stats_demand |= groups; }
+  bool ShouldCollectOrgStats(int groups) const { return (m_org_stats_demand & groups); }
+
   void AddLastTaskQuality(int task_num, double quality)
   {
 	  task_last_quality[task_num] += quality;
@@ -677,7 +696,7 @@ public:
   void IncTaskExeCount(int task_num, int task_count) { task_exe_count[task_num] += task_count; }
   void ZeroTasks();
 
-  void AddLastSense(int) { /*sense_last_count[res_comb_index]++;*/ }
+  void AddLastSense(int, int) { /*sense_last_count[res_comb_index] += num_orgs;*/ }
   void IncLastSenseExeCount(int, int) { /*sense_last_exe_count[res_comb_index]+= count;*/ }
 
   // internal resource bins and use of internal resources
@@ -701,6 +720,12 @@ public:
   void IncReactionExeCount(int reaction, int count) { m_reaction_exe_count[reaction] += count; }
   void ZeroReactions();
 
+  // Per-organism statistics are gathered into one shard per GetOrgStatsShardSize() organisms and merged in shard order
+  int ResetOrgStatsShards(int num_orgs, int num_tasks, int num_reactions);
+  int GetOrgStatsShardSize() const { return m_org_shard_size; }
+  cStatsShard& GetOrgStatsShard(int idx) { return m_org_shards[idx]; }
+  void MergeOrgStatsShards();
+
   void SetResources(const Apto::Array<double> &_in) { resource_count = _in; }
   void SetResourcesGeometry(const Apto::Array<int> &_in) { resource_geometry = _in;}
   void SetSpatialRes(const Apto::Array< Apto::Array<double> > &_in) { spatial_res_count = _in; }
@@ -738,6 +763,7 @@ public:
   int GetNumModified() const { return num_modified;}
 
   int GetTotCreatures() const       { return tot_organisms; }
+  long long GetTotExecuted() const  { return tot_executed + num_executed; }
 
   int GetTaskCurCount(int task_num) const { return task_cur_count[task_num]; }
   int GetTaskHostCurCount(int task_num) const { return tasks_host_current[task_num]; }
@@ -803,6 +829,10 @@ public:
   double GetAveSpeculative() const { return (m_spec_num) ? ((double)m_spec_total / (double)m_spec_num) : 0.0; }
   int GetSpeculativeWaste() const { return m_spec_waste; }
 
+  double GetTestCPUCacheHits() const;
+  double GetTestCPUCacheMisses() const;
+  int GetTestCPUCacheSize() const;
+
   double GetAvgNumOrgsKilled() const { return sum_orgs_killed.Mean(); }
   double GetAvgNumCellsScannedAtKill() const { return sum_cells_scanned_at_kill.Mean(); }
   int GetNumMigrations() const { return num_migrations; }
@@ -859,6 +889,7 @@ public:
 
   void PrintCountData(const cString& filename);
   void PrintThreadsData(const cString& filename);
+  void PrintTestCPUCacheData(const cString& filename);
   void PrintMessageData(const cString& filename);
   void PrintInterruptData(const cString& filename);
   void PrintTotalsData(const cString& filename);
@@ -0,0 +1,72 @@
+/*
+ *  cStatsShard.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cStatsShard.h"
+
+#include <cfloat>
+#include <climits>
+
+
+void cStatsShard::Reset(int max_orgs, int num_tasks, int num_reactions, int num_senses)
+{
+  for (int i = 0; i < NUM_SUMS; i++) m_sums[i].Clear();
+  for (int i = 0; i < NUM_COUNTS; i++) m_counts[i] = 0;
+
+  // Same starting points cPopulation::UpdateOrganismStats() has always reported for an empty population
+  m_max_merit = 0;
+  m_max_fitness = 0;
+  m_max_gestation_time = 0;
+  m_max_genome_length = 0;
+  m_min_merit = FLT_MAX;
+  m_min_fitness = FLT_MAX;
+  m_min_gestation_time = INT_MAX;
+  m_min_genome_length = INT_MAX;
+
+  // Only grow the sample buffers, they are overwritten in place each update
+  if (m_copy_mut_rates.GetSize() < max_orgs) {
+    m_copy_mut_rates.Resize(max_orgs);
+    m_div_mut_rates.Resize(max_orgs);
+  }
+  m_num_samples = 0;
+
+  if (m_num_tasks != num_tasks || m_task_counts.GetSize() != NUM_TASK_COUNTS * num_tasks) {
+    m_num_tasks = num_tasks;
+    m_task_counts.Resize(NUM_TASK_COUNTS * num_tasks);
+    m_task_quality.Resize(NUM_TASK_QUALITIES * num_tasks);
+    m_task_max_quality.Resize(NUM_TASK_QUALITIES * num_tasks);
+  }
+  m_task_counts.SetAll(0);
+  m_task_quality.SetAll(0.0);
+  m_task_max_quality.SetAll(0.0);
+
+  if (m_num_reactions != num_reactions || m_reaction_counts.GetSize() != NUM_REACTION_COUNTS * num_reactions) {
+    m_num_reactions = num_reactions;
+    m_reaction_counts.Resize(NUM_REACTION_COUNTS * num_reactions);
+    m_reaction_rewards.Resize(NUM_REACTION_REWARDS * num_reactions);
+  }
+  m_reaction_counts.SetAll(0);
+  m_reaction_rewards.SetAll(0.0);
+
+  if (m_num_senses != num_senses || m_sense_counts.GetSize() != NUM_SENSE_COUNTS * num_senses) {
+    m_num_senses = num_senses;
+    m_sense_counts.Resize(NUM_SENSE_COUNTS * num_senses);
+  }
+  m_sense_counts.SetAll(0);
+}
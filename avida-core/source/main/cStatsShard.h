@@ -0,0 +1,171 @@
+/*
+ *  cStatsShard.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cStatsShard_h
+#define cStatsShard_h
+
+#include "avida/core/Types.h"
+
+#include "cDoubleSum.h"
+#include "cMerit.h"
+
+
+// Partial per-organism statistics for one block of the population.  cPopulation::UpdateOrganismStats() walks the live
+// organisms in fixed size blocks, each block gathering into its own shard, and cStats::MergeOrgStatsShards() folds the
+// shards into the running totals once per update, always in shard order.  Since the blocks depend only on the number of
+// organisms and never on how many workers fill them, the merged totals are the same bit for bit however the blocks are
+// scheduled.
+//
+// Until workers fill the blocks, cStats::ResetOrgStatsShards() makes a single block of the whole population, so the
+// floating point sums come out bit for bit as the single running sum used before shards.  Several blocks would add up
+// per block and then across blocks, changing the last bits.
+//
+// Only the once per update organism pass is sharded.  RecordBirth, RecordDeath, the executed instruction count and the
+// cStats::ProcessUpdate resets still go straight to cStats, since they run on the main thread between organism time
+// slices and the birth interrupt queue reads their totals mid-update.
+//
+// Tallies are kept in flat arrays (one row per field, one column per task or reaction) so that a shard occupies a
+// handful of contiguous allocations that are reused from update to update.
+class cStatsShard
+{
+public:
+  enum eSum {
+    SUM_FITNESS = 0, SUM_MERIT, SUM_GESTATION, SUM_CREATURE_AGE, SUM_GENERATION, SUM_NEUTRAL_METRIC,
+    SUM_LINEAGE_LABEL, SUM_COPY_SIZE, SUM_EXE_SIZE, SUM_MEM_SIZE, NUM_SUMS
+  };
+  enum eCount {
+    COUNT_BREED_TRUE = 0, COUNT_PARASITES, COUNT_NO_BIRTH, COUNT_MULTI_THREAD, COUNT_SINGLE_THREAD, COUNT_THREADS,
+    COUNT_MODIFIED, NUM_COUNTS
+  };
+  enum eTaskCount {
+    TASK_CUR = 0, TASK_LAST, TASK_TEST, TASK_HOST_CUR, TASK_HOST_LAST, TASK_PARASITE_CUR, TASK_PARASITE_LAST,
+    TASK_INTERNAL_CUR, TASK_INTERNAL_LAST, TASK_EXE, NUM_TASK_COUNTS
+  };
+  enum eTaskQuality {
+    QUALITY_CUR = 0, QUALITY_LAST, QUALITY_INTERNAL_CUR, QUALITY_INTERNAL_LAST, NUM_TASK_QUALITIES
+  };
+  enum eReactionCount { REACTION_CUR = 0, REACTION_LAST, REACTION_EXE, NUM_REACTION_COUNTS };
+  enum eReactionReward { REWARD_CUR = 0, REWARD_LAST, NUM_REACTION_REWARDS };
+  enum eSenseCount { SENSE_LAST = 0, SENSE_LAST_EXE, NUM_SENSE_COUNTS };
+
+private:
+  cDoubleSum m_sums[NUM_SUMS];
+  int m_counts[NUM_COUNTS];
+
+  cMerit m_max_merit;
+  double m_max_fitness;
+  int m_max_gestation_time;
+  int m_max_genome_length;
+  cMerit m_min_merit;
+  double m_min_fitness;
+  int m_min_gestation_time;
+  int m_min_genome_length;
+
+  // Mutation rate samples are kept in organism order, cRunningStats results depend on the order they are pushed in
+  Apto::Array<double> m_copy_mut_rates;
+  Apto::Array<double> m_div_mut_rates;
+  int m_num_samples;
+
+  int m_num_tasks;
+  int m_num_reactions;
+  int m_num_senses;
+  Apto::Array<int> m_task_counts;             // [field * m_num_tasks + task]
+  Apto::Array<double> m_task_quality;         // [field * m_num_tasks + task]
+  Apto::Array<double> m_task_max_quality;     // [field * m_num_tasks + task]
+  Apto::Array<int> m_reaction_counts;         // [field * m_num_reactions + reaction]
+  Apto::Array<double> m_reaction_rewards;     // [field * m_num_reactions + reaction]
+  Apto::Array<int> m_sense_counts;            // [field * m_num_senses + sense]
+
+public:
+  cStatsShard() : m_num_samples(0), m_num_tasks(0), m_num_reactions(0), m_num_senses(0) { Reset(0, 0, 0, 0); }
+
+  // Clears every tally, sizing the shard for up to max_orgs organisms
+  void Reset(int max_orgs, int num_tasks, int num_reactions, int num_senses);
+
+  void AddSum(eSum sum, double value) { m_sums[sum].Add(value); }
+  void IncCount(eCount count, int num = 1) { m_counts[count] += num; }
+
+  void AddMutRates(double copy_mut_rate, double div_mut_rate)
+  {
+    m_copy_mut_rates[m_num_samples] = copy_mut_rate;
+    m_div_mut_rates[m_num_samples] = div_mut_rate;
+    m_num_samples++;
+  }
+
+  void UpdateExtrema(const cMerit& merit, double fitness, int gestation_time, int genome_length)
+  {
+    if (merit > m_max_merit) m_max_merit = merit;
+    if (fitness > m_max_fitness) m_max_fitness = fitness;
+    if (gestation_time > m_max_gestation_time) m_max_gestation_time = gestation_time;
+    if (genome_length > m_max_genome_length) m_max_genome_length = genome_length;
+
+    if (merit < m_min_merit) m_min_merit = merit;
+    if (fitness < m_min_fitness) m_min_fitness = fitness;
+    if (gestation_time < m_min_gestation_time) m_min_gestation_time = gestation_time;
+    if (genome_length < m_min_genome_length) m_min_genome_length = genome_length;
+  }
+
+  void IncTask(eTaskCount field, int task, int num = 1) { m_task_counts[field * m_num_tasks + task] += num; }
+  void AddTaskQuality(eTaskQuality field, int task, double quality)
+  {
+    const int idx = field * m_num_tasks + task;
+    m_task_quality[idx] += quality;
+    if (quality > m_task_max_quality[idx]) m_task_max_quality[idx] = quality;
+  }
+
+  void IncReaction(eReactionCount field, int reaction, int num = 1)
+    { m_reaction_counts[field * m_num_reactions + reaction] += num; }
+  void AddReactionReward(eReactionReward field, int reaction, double reward)
+    { m_reaction_rewards[field * m_num_reactions + reaction] += reward; }
+
+  void IncSense(eSenseCount field, int sense, int num = 1) { m_sense_counts[field * m_num_senses + sense] += num; }
+
+
+  const cDoubleSum& GetSum(eSum sum) const { return m_sums[sum]; }
+  int GetCount(eCount count) const { return m_counts[count]; }
+
+  const cMerit& GetMaxMerit() const { return m_max_merit; }
+  double GetMaxFitness() const { return m_max_fitness; }
+  int GetMaxGestationTime() const { return m_max_gestation_time; }
+  int GetMaxGenomeLength() const { return m_max_genome_length; }
+  const cMerit& GetMinMerit() const { return m_min_merit; }
+  double GetMinFitness() const { return m_min_fitness; }
+  int GetMinGestationTime() const { return m_min_gestation_time; }
+  int GetMinGenomeLength() const { return m_min_genome_length; }
+
+  int GetNumMutRateSamples() const { return m_num_samples; }
+  double GetCopyMutRate(int idx) const { return m_copy_mut_rates[idx]; }
+  double GetDivMutRate(int idx) const { return m_div_mut_rates[idx]; }
+
+  int GetNumTasks() const { return m_num_tasks; }
+  int GetNumReactions() const { return m_num_reactions; }
+  int GetTaskCount(eTaskCount field, int task) const { return m_task_counts[field * m_num_tasks + task]; }
+  double GetTaskQuality(eTaskQuality field, int task) const { return m_task_quality[field * m_num_tasks + task]; }
+  double GetTaskMaxQuality(eTaskQuality field, int task) const
+    { return m_task_max_quality[field * m_num_tasks + task]; }
+  int GetReactionCount(eReactionCount field, int reaction) const
+    { return m_reaction_counts[field * m_num_reactions + reaction]; }
+  double GetReactionReward(eReactionReward field, int reaction) const
+    { return m_reaction_rewards[field * m_num_reactions + reaction]; }
+  int GetNumSenses() const { return m_num_senses; }
+  int GetSenseCount(eSenseCount field, int sense) const { return m_sense_counts[field * m_num_senses + sense]; }
+};
+
+#endif
@@ -34,6 +34,7 @@
 
 #include "cAnalyze.h"
 #include "cAnalyzeGenotype.h"
+#include "cDeferredPrintQueue.h"
 #include "cEnvironment.h"
 #include "cEventList.h"
 #include "cHardwareManager.h"
@@ -50,7 +51,7 @@ using namespace AvidaTools;
 
 
 cWorld::cWorld(cAvidaConfig* cfg, const cString& wd)
-  : m_working_dir(wd), m_analyze(NULL), m_conf(cfg), m_ctx(NULL)
+  : m_working_dir(wd), m_analyze(NULL), m_conf(cfg), m_ctx(NULL), m_deferred_prints(NULL)
   , m_env(NULL), m_event_list(NULL), m_hw_mgr(NULL), m_pop(NULL), m_stats(NULL), m_mig_mat(NULL), m_driver(NULL), m_data_mgr(NULL)
   , m_own_driver(false)
 {
@@ -70,7 +71,8 @@ cWorld::~cWorld()
 {
   // m_actlib is not owned by cWorld, DO NOT DELETE
   
-  // These must be deleted first
+  // These must be deleted first, outstanding deferred prints are written out here
+  delete m_deferred_prints; m_deferred_prints = NULL;
   delete m_analyze; m_analyze = NULL;
   
   // Forcefully clean up population before classification manager
@@ -145,7 +147,7 @@ bool cWorld::setup(World* new_world, cUserFeedback* feedback, const Apto::Map<Ap
   // Systematics
   Systematics::ManagerPtr systematics(new Systematics::Manager);
   systematics->AttachTo(new_world);
-  systematics->RegisterArbiter(Systematics::ArbiterPtr(new Systematics::GenotypeArbiter(new_world, "genotype", m_conf->THRESHOLD.Get(), m_conf->DISABLE_GENOTYPE_CLASSIFICATION.Get())));
+  systematics->RegisterArbiter(Systematics::ArbiterPtr(new Systematics::GenotypeArbiter(new_world, "genotype", m_conf->THRESHOLD.Get(), m_conf->DISABLE_GENOTYPE_CLASSIFICATION.Get(), m_conf->RECORD_PRUNED_PHYLOGENY.Get())));
 
   
   // Setup Stats Object
@@ -194,6 +196,7 @@ bool cWorld::setup(World* new_world, cUserFeedback* feedback, const Apto::Map<Ap
   m_test_sterilize = (sterilize_fatal || sterilize_neg || sterilize_neut || sterilize_pos || sterilize_taskloss);
 
   m_pop = Apto::SmartPtr<cPopulation, Apto::InternalRCObject>(new cPopulation(this));
+  m_deferred_prints = new cDeferredPrintQueue(this);
   
   // Setup Event List
   m_event_list = new cEventList(this);
@@ -221,7 +224,11 @@ void cWorld::GetEvents(cAvidaContext& ctx)
     m_event_list->Sync();
     m_pop->SetSyncEvents(false);
   }
+  m_deferred_prints->Flush();
   m_event_list->Process(ctx);
+  
+  // Queued prints read the world as the events left it, finish them before the update goes on to change it
+  m_deferred_prints->Flush();
 }
 
 int cWorld::GetNumResources()
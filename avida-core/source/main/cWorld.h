@@ -34,6 +34,7 @@
 
 class cAnalyze;
 class cAnalyzeGenotype;
+class cDeferredPrintQueue;
 class cEnvironment;
 class cEventList;
 class cHardwareManager;
@@ -59,6 +60,7 @@ protected:
   cAnalyze* m_analyze;
   cAvidaConfig* m_conf;
   cAvidaContext* m_ctx;
+  cDeferredPrintQueue* m_deferred_prints;
   cEnvironment* m_env;
   cEventList* m_event_list;
   cHardwareManager* m_hw_mgr;
@@ -91,6 +93,7 @@ public:
   cAnalyze& GetAnalyze();
   cAvidaConfig& GetConfig() { return *m_conf; }
   cAvidaContext& GetDefaultContext() { return *m_ctx; }
+  cDeferredPrintQueue& GetDeferredPrints() { return *m_deferred_prints; }
   cEnvironment& GetEnvironment() { return *m_env; }
   cHardwareManager& GetHardwareManager() { return *m_hw_mgr; }
   cMigrationMatrix& GetMigrationMatrix(){ return *m_mig_mat; };
@@ -130,6 +133,9 @@ public:
 	//! Process post-update events.
 	virtual void ProcessPostUpdate(cAvidaContext&) { }
 	
+	//! Process the end of the run, called once the driver has stopped updating the world.
+	virtual void ProcessFinish(cAvidaContext&) { }
+	
 	//! Returns true if this world allows early exits, e.g., when the population reaches 0.
 	virtual bool AllowsEarlyExit() const { return true; }
 	
@@ -131,6 +131,16 @@ void Avida::Output::File::Write(long i, const char* descr, const char* format)
   }
 }
 
+void Avida::Output::File::Write(long long i, const char* descr, const char* format)
+{
+  if (!m_descr_written) {
+    m_data << i << " ";
+    WriteColumnDesc(descr, format);
+  } else {
+    m_fp << i << " ";
+  }
+}
+
 void Avida::Output::File::Write(unsigned int i, const char* descr, const char*)
 {
   if (!m_descr_written) {
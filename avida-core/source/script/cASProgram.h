@@ -0,0 +1,135 @@
+/*
+ *  cASProgram.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cASProgram_h
+#define cASProgram_h
+
+#include "avida/Avida.h"
+#include "AvidaScript.h"
+
+#include "cString.h"
+
+class cASFunction;
+
+
+// Opcode list, in dispatch table order.  Register operands are denoted d (destination), a and b (sources).
+//   I* opcodes operate on int registers (bool, char and int values), F* on float registers.
+#define AS_PROGRAM_OPCODES(X) \
+  X(HALT)       /* return 0                                     */ \
+  X(RET)        /* return int a                                 */ \
+  X(JMP)        /* pc = a                                       */ \
+  X(JMPF)       /* if (!a) pc = b                               */ \
+  X(LOADI)      /* d = immediate a                              */ \
+  X(LOADF)      /* d = float constant a                         */ \
+  X(LOADS)      /* d = new copy of string constant a            */ \
+  X(MOV)        /* d = a                                        */ \
+  X(OCOPY)      /* d = a, adding an object reference            */ \
+  X(OSTORE)     /* release object d, d = a (moves the ref)      */ \
+  X(ORELEASE)   /* release object a                             */ \
+  X(SDELETE)    /* delete string a                              */ \
+  X(I2F) X(F2I) X(I2B) X(F2B) X(I2C) \
+  X(ADDI) X(SUBI) X(MULI) X(DIVI) X(MODI) X(NEGI) X(NOTI) X(BNOTI) X(BANDI) X(BORI) X(LANDI) X(LORI) \
+  X(EQI) X(NEI) X(LTI) X(LEI) X(GTI) X(GEI) \
+  X(ADDF) X(SUBF) X(MULF) X(DIVF) X(MODF) X(NEGF) \
+  X(EQF) X(NEF) X(LTF) X(LEF) X(GTF) X(GEF) \
+  X(CALLF)      /* call library function slot a, result in d    */ \
+  X(CALLM)      /* call native object method slot a, result in d */ \
+  X(CALLS)      /* call script function a, frame at b, result in d */ \
+  X(FRET)       /* return a from script function, none if a < 0 */ \
+  X(GLOAD)      /* d = global a                                 */ \
+  X(GSTORE)     /* global d = a                                 */ \
+  X(GOSTORE)    /* release object global d, global d = a        */ \
+  X(FORRANGE)   /* loop d..d+2 over the int range a : b         */ \
+  X(FORREPEAT)  /* loop d..d+2 over b copies of a               */ \
+  X(FORLOOP)    /* advance loop d, pc = a when done             */
+
+
+// Typed register bytecode produced by cCompileASTVisitor and executed by cASVirtualMachine.  Register operands are
+// relative to the current frame.  In the top level frame global variables occupy the first registers (indexed by
+// variable id), followed by the expression temporaries.  Script function frames are laid out the same way over the
+// function's local variables, and reach globals through GLOAD/GSTORE.  Loops are controlled by three consecutive
+// registers, holding the current value, the step and the number of iterations remaining.
+class cASProgram
+{
+public:
+  enum eOpcode {
+#define AS_PROGRAM_OPCODE_ENUM(op) op,
+    AS_PROGRAM_OPCODES(AS_PROGRAM_OPCODE_ENUM)
+#undef AS_PROGRAM_OPCODE_ENUM
+    NUM_OPCODES
+  };
+
+  struct sInstruction
+  {
+    eOpcode op;
+    int d;
+    int a;
+    int b;
+
+    sInstruction() : op(HALT), d(0), a(0), b(0) { ; }
+    sInstruction(eOpcode in_op, int in_d, int in_a, int in_b) : op(in_op), d(in_d), a(in_a), b(in_b) { ; }
+  };
+
+  // Native call site.  Library function signatures are resolved at compile time, native object methods are looked up
+  // on first execution and cached, since only the object instance knows its method table.
+  struct sCallSlot
+  {
+    const cASFunction* func;
+    cString method;
+    int mid;
+    int object;
+    cString object_info;
+
+    Apto::Array<int> args;
+    Apto::Array<ASType_t> arg_types;
+    sASTypeInfo want;
+
+    sCallSlot() : func(NULL), mid(-1), object(-1) { ; }
+  };
+
+
+  // Script defined function.  Callers evaluate arguments directly into the parameter registers of the callee frame,
+  // which starts at register b of the CALLS instruction.
+  struct sFunction
+  {
+    int entry;
+    int num_registers;
+
+    sFunction() : entry(0), num_registers(0) { ; }
+  };
+
+
+  Apto::Array<sInstruction, Apto::Smart> code;
+  Apto::Array<int, Apto::Smart> lines;                // source line of each instruction, for runtime errors
+  cString filename;
+
+  Apto::Array<double, Apto::Smart> float_consts;
+  Apto::Array<cString, Apto::Smart> string_consts;
+  Apto::Array<sCallSlot, Apto::Smart> call_slots;
+  Apto::Array<sFunction, Apto::Smart> functions;
+
+  Apto::Array<ASType_t> var_types;                    // type of each global variable register
+  int num_registers;                                  // size of the top level frame
+
+
+  cASProgram() : num_registers(0) { ; }
+};
+
+#endif
@@ -0,0 +1,509 @@
+/*
+ *  cASVirtualMachine.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cASVirtualMachine.h"
+
+#include "cASFunction.h"
+#include "cASNativeObject.h"
+#include "cStringUtil.h"
+
+#include <cmath>
+#include <cstdarg>
+#include <iostream>
+
+using namespace AvidaScript;
+
+
+#define TYPE(x) AS_TYPE_ ## x
+
+
+cASVirtualMachine::cASVirtualMachine(cASProgram* program)
+  : m_program(program), m_code_size(program->code.GetSize()), m_code(new cASProgram::sInstruction[m_code_size])
+#if AS_VM_THREADED_DISPATCH
+  , m_handlers(NULL)
+#endif
+  , m_regs(new uRegister[(program->num_registers > 0) ? program->num_registers : 1])
+  , m_num_regs((program->num_registers > 0) ? program->num_registers : 1)
+{
+  for (int i = 0; i < m_code_size; i++) m_code[i] = program->code[i];
+
+  for (int i = 0; i < program->num_registers; i++) m_regs[i].as_float = 0.0;
+  for (int i = 0; i < program->var_types.GetSize(); i++) {
+    if (program->var_types[i] == TYPE(OBJECT_REF)) m_regs[i].as_nobj = NULL;
+    else if (program->var_types[i] != TYPE(FLOAT)) m_regs[i].as_int = 0;
+  }
+
+  int max_args = 0;
+  for (int i = 0; i < program->call_slots.GetSize(); i++) {
+    if (program->call_slots[i].args.GetSize() > max_args) max_args = program->call_slots[i].args.GetSize();
+  }
+  m_params.Resize(max_args);
+}
+
+
+cASVirtualMachine::~cASVirtualMachine()
+{
+  for (int i = 0; i < m_program->var_types.GetSize(); i++) {
+    if (m_program->var_types[i] == TYPE(OBJECT_REF) && m_regs[i].as_nobj) m_regs[i].as_nobj->RemoveReference();
+  }
+
+  delete [] m_code;
+#if AS_VM_THREADED_DISPATCH
+  delete [] m_handlers;
+#endif
+  delete [] m_regs;
+}
+
+
+int cASVirtualMachine::Execute()
+{
+  const cASProgram::sInstruction* code = m_code;
+  uRegister* r = m_regs;
+  int fp = 0;
+  int pc = 0;
+
+#define IN code[pc]
+
+#if AS_VM_THREADED_DISPATCH
+  // Resolve each instruction to the address of its handler once, so that dispatch is a single indirect jump
+# define AS_VM_LABEL_ADDRESS(op) &&L_ ## op,
+  static const void* const s_labels[] = { AS_PROGRAM_OPCODES(AS_VM_LABEL_ADDRESS) };
+# undef AS_VM_LABEL_ADDRESS
+
+  if (!m_handlers) {
+    m_handlers = new const void*[m_code_size];
+    for (int i = 0; i < m_code_size; i++) m_handlers[i] = s_labels[m_code[i].op];
+  }
+  const void** handlers = m_handlers;
+
+# define VM_OP(op) L_ ## op:
+# define VM_NEXT() { pc++; goto *handlers[pc]; }
+# define VM_JUMP(target) { pc = (target); goto *handlers[pc]; }
+
+  goto *handlers[pc];
+  {
+#else
+# define VM_OP(op) case cASProgram::op:
+# define VM_NEXT() { pc++; continue; }
+# define VM_JUMP(target) { pc = (target); continue; }
+
+  for (;;) {
+    switch (IN.op) {
+#endif
+
+    VM_OP(HALT)   return 0;
+    VM_OP(RET)    return r[IN.a].as_int;
+    VM_OP(JMP)    VM_JUMP(IN.a);
+    VM_OP(JMPF)   if (!r[IN.a].as_int) VM_JUMP(IN.b); VM_NEXT();
+
+    VM_OP(LOADI)  r[IN.d].as_int = IN.a; VM_NEXT();
+    VM_OP(LOADF)  r[IN.d].as_float = m_program->float_consts[IN.a]; VM_NEXT();
+    VM_OP(LOADS)  r[IN.d].as_string = new cString(m_program->string_consts[IN.a]); VM_NEXT();
+    VM_OP(MOV)    r[IN.d] = r[IN.a]; VM_NEXT();
+
+    VM_OP(OCOPY)
+      r[IN.d].as_nobj = r[IN.a].as_nobj;
+      if (r[IN.d].as_nobj) r[IN.d].as_nobj->GetReference();
+      VM_NEXT();
+    VM_OP(OSTORE)
+      if (r[IN.d].as_nobj) r[IN.d].as_nobj->RemoveReference();
+      r[IN.d].as_nobj = r[IN.a].as_nobj;
+      VM_NEXT();
+    VM_OP(ORELEASE)
+      if (r[IN.a].as_nobj) r[IN.a].as_nobj->RemoveReference();
+      VM_NEXT();
+    VM_OP(SDELETE)
+      delete r[IN.a].as_string;
+      VM_NEXT();
+
+    VM_OP(I2F)    r[IN.d].as_float = (double)r[IN.a].as_int; VM_NEXT();
+    VM_OP(F2I)    r[IN.d].as_int = (int)r[IN.a].as_float; VM_NEXT();
+    VM_OP(I2B)    r[IN.d].as_int = (r[IN.a].as_int != 0); VM_NEXT();
+    VM_OP(F2B)    r[IN.d].as_int = (r[IN.a].as_float != 0.0); VM_NEXT();
+    VM_OP(I2C)    r[IN.d].as_int = (char)r[IN.a].as_int; VM_NEXT();
+
+    VM_OP(ADDI)   r[IN.d].as_int = r[IN.a].as_int + r[IN.b].as_int; VM_NEXT();
+    VM_OP(SUBI)   r[IN.d].as_int = r[IN.a].as_int - r[IN.b].as_int; VM_NEXT();
+    VM_OP(MULI)   r[IN.d].as_int = r[IN.a].as_int * r[IN.b].as_int; VM_NEXT();
+    VM_OP(DIVI)
+      if (r[IN.b].as_int == 0) reportError(AS_DIRECT_INTERPRET_ERR_DIVISION_BY_ZERO, pc);
+      r[IN.d].as_int = r[IN.a].as_int / r[IN.b].as_int;
+      VM_NEXT();
+    VM_OP(MODI)
+      if (r[IN.b].as_int == 0) reportError(AS_DIRECT_INTERPRET_ERR_DIVISION_BY_ZERO, pc);
+      r[IN.d].as_int = r[IN.a].as_int % r[IN.b].as_int;
+      VM_NEXT();
+    VM_OP(NEGI)   r[IN.d].as_int = -r[IN.a].as_int; VM_NEXT();
+    VM_OP(NOTI)   r[IN.d].as_int = !r[IN.a].as_int; VM_NEXT();
+    VM_OP(BNOTI)  r[IN.d].as_int = ~r[IN.a].as_int; VM_NEXT();
+    VM_OP(BANDI)  r[IN.d].as_int = r[IN.a].as_int & r[IN.b].as_int; VM_NEXT();
+    VM_OP(BORI)   r[IN.d].as_int = r[IN.a].as_int | r[IN.b].as_int; VM_NEXT();
+    VM_OP(LANDI)  r[IN.d].as_int = (r[IN.a].as_int && r[IN.b].as_int); VM_NEXT();
+    VM_OP(LORI)   r[IN.d].as_int = (r[IN.a].as_int || r[IN.b].as_int); VM_NEXT();
+
+    VM_OP(EQI)    r[IN.d].as_int = (r[IN.a].as_int == r[IN.b].as_int); VM_NEXT();
+    VM_OP(NEI)    r[IN.d].as_int = (r[IN.a].as_int != r[IN.b].as_int); VM_NEXT();
+    VM_OP(LTI)    r[IN.d].as_int = (r[IN.a].as_int < r[IN.b].as_int); VM_NEXT();
+    VM_OP(LEI)    r[IN.d].as_int = (r[IN.a].as_int <= r[IN.b].as_int); VM_NEXT();
+    VM_OP(GTI)    r[IN.d].as_int = (r[IN.a].as_int > r[IN.b].as_int); VM_NEXT();
+    VM_OP(GEI)    r[IN.d].as_int = (r[IN.a].as_int >= r[IN.b].as_int); VM_NEXT();
+
+    VM_OP(ADDF)   r[IN.d].as_float = r[IN.a].as_float + r[IN.b].as_float; VM_NEXT();
+    VM_OP(SUBF)   r[IN.d].as_float = r[IN.a].as_float - r[IN.b].as_float; VM_NEXT();
+    VM_OP(MULF)   r[IN.d].as_float = r[IN.a].as_float * r[IN.b].as_float; VM_NEXT();
+    VM_OP(DIVF)
+      if (r[IN.b].as_float == 0.0) reportError(AS_DIRECT_INTERPRET_ERR_DIVISION_BY_ZERO, pc);
+      r[IN.d].as_float = r[IN.a].as_float / r[IN.b].as_float;
+      VM_NEXT();
+    VM_OP(MODF)
+      if (r[IN.b].as_float == 0.0) reportError(AS_DIRECT_INTERPRET_ERR_DIVISION_BY_ZERO, pc);
+      r[IN.d].as_float = fmod(r[IN.a].as_float, r[IN.b].as_float);
+      VM_NEXT();
+    VM_OP(NEGF)   r[IN.d].as_float = -r[IN.a].as_float; VM_NEXT();
+
+    VM_OP(EQF)    r[IN.d].as_int = (r[IN.a].as_float == r[IN.b].as_float); VM_NEXT();
+    VM_OP(NEF)    r[IN.d].as_int = (r[IN.a].as_float != r[IN.b].as_float); VM_NEXT();
+    VM_OP(LTF)    r[IN.d].as_int = (r[IN.a].as_float < r[IN.b].as_float); VM_NEXT();
+    VM_OP(LEF)    r[IN.d].as_int = (r[IN.a].as_float <= r[IN.b].as_float); VM_NEXT();
+    VM_OP(GTF)    r[IN.d].as_int = (r[IN.a].as_float > r[IN.b].as_float); VM_NEXT();
+    VM_OP(GEF)    r[IN.d].as_int = (r[IN.a].as_float >= r[IN.b].as_float); VM_NEXT();
+
+    VM_OP(CALLF)  callFunction(pc, r); VM_NEXT();
+    VM_OP(CALLM)  callMethod(pc, r); VM_NEXT();
+
+    VM_OP(CALLS)
+      {
+        const cASProgram::sFunction& func = m_program->functions[IN.a];
+        int callee_fp = fp + IN.b;
+        if (callee_fp + func.num_registers > m_num_regs) growRegisters(callee_fp + func.num_registers);
+        m_frames.Push(sFrame(pc + 1, fp, IN.d));
+        fp = callee_fp;
+        r = m_regs + fp;
+        VM_JUMP(func.entry);
+      }
+    VM_OP(FRET)
+      {
+        uRegister rvalue;
+        rvalue.as_float = 0.0;
+        if (IN.a >= 0) rvalue = r[IN.a];
+
+        const sFrame& frame = m_frames[m_frames.GetSize() - 1];
+        int ret_pc = frame.pc;
+        fp = frame.fp;
+        r = m_regs + fp;
+        if (frame.dest >= 0) r[frame.dest] = rvalue;
+        m_frames.Resize(m_frames.GetSize() - 1);
+        VM_JUMP(ret_pc);
+      }
+
+    VM_OP(GLOAD)  r[IN.d] = m_regs[IN.a]; VM_NEXT();
+    VM_OP(GSTORE) m_regs[IN.d] = r[IN.a]; VM_NEXT();
+    VM_OP(GOSTORE)
+      if (m_regs[IN.d].as_nobj) m_regs[IN.d].as_nobj->RemoveReference();
+      m_regs[IN.d].as_nobj = r[IN.a].as_nobj;
+      VM_NEXT();
+
+    VM_OP(FORRANGE)
+      {
+        // Same element order as the array built by the interpreter for a : b
+        int first = r[IN.a].as_int;
+        int last = r[IN.b].as_int;
+        int step = (last > first) ? 1 : -1;
+        r[IN.d].as_int = first - step;
+        r[IN.d + 1].as_int = step;
+        r[IN.d + 2].as_int = ((last > first) ? (last - first) : (first - last)) + 1;
+      }
+      VM_NEXT();
+    VM_OP(FORREPEAT)
+      // The repeated value stays in place, a zero step leaves its bits untouched whatever its type
+      if (r[IN.b].as_int < 0) reportError(AS_DIRECT_INTERPRET_ERR_INVALID_ARRAY_SIZE, pc);
+      r[IN.d] = r[IN.a];
+      r[IN.d + 1].as_int = 0;
+      r[IN.d + 2].as_int = r[IN.b].as_int;
+      VM_NEXT();
+    VM_OP(FORLOOP)
+      if (--r[IN.d + 2].as_int < 0) VM_JUMP(IN.a);
+      r[IN.d].as_int += r[IN.d + 1].as_int;
+      VM_NEXT();
+
+#if AS_VM_THREADED_DISPATCH
+  }
+#else
+      default:
+        reportError(AS_DIRECT_INTERPRET_ERR_INTERNAL, pc);
+    }
+  }
+#endif
+
+#undef VM_OP
+#undef VM_NEXT
+#undef VM_JUMP
+#undef IN
+
+  return 0;
+}
+
+
+void cASVirtualMachine::callFunction(int pc, uRegister* r)
+{
+  const cASProgram::sInstruction& in = m_code[pc];
+  const cASProgram::sCallSlot& slot = m_program->call_slots[in.a];
+  const cASFunction* func = slot.func;
+
+  // Library function argument types were matched up by the compiler, aside from scalars bound for strings
+  int arity = func->GetArity();
+  for (int i = 0; i < arity; i++) {
+    setParameter(m_params[i], func->GetArgumentType(i).type, slot.arg_types[i], r[slot.args[i]], pc);
+  }
+
+  cASCPPParameter rvalue = func->Call(m_params.GetSize() ? &m_params[0] : NULL);
+  if (in.d >= 0) r[in.d] = getResult(rvalue, func->GetReturnType(), slot.want, pc);
+
+  for (int i = 0; i < arity; i++) {
+    switch (func->GetArgumentType(i).type) {
+      case TYPE(STRING):      delete m_params[i].Get<cString*>(); break;
+      case TYPE(OBJECT_REF):  m_params[i].Get<cASNativeObject*>()->RemoveReference(); break;
+      default: break;
+    }
+  }
+}
+
+
+void cASVirtualMachine::callMethod(int pc, uRegister* r)
+{
+  const cASProgram::sInstruction& in = m_code[pc];
+  cASProgram::sCallSlot& slot = m_program->call_slots[in.a];
+
+  cASNativeObject* nobj = r[slot.object].as_nobj;
+  if (!nobj) reportError(AS_DIRECT_INTERPRET_ERR_INTERNAL, pc);
+
+  // Method ids are cached in the call slot after the first lookup
+  if (slot.mid < 0 && !nobj->LookupMethod(slot.method, slot.mid)) {
+    reportError(AS_DIRECT_INTERPRET_ERR_NOBJ_METHOD_LOOKUP_FAILED, pc, (const char*)slot.method,
+                (const char*)slot.object_info);
+  }
+  int mid = slot.mid;
+
+  int arity = nobj->GetArity(mid);
+  if (arity > slot.args.GetSize()) reportError(AS_DIRECT_INTERPRET_ERR_INTERNAL, pc);
+  for (int i = 0; i < arity; i++) {
+    setParameter(m_params[i], nobj->GetArgumentType(mid, i).type, slot.arg_types[i], r[slot.args[i]], pc);
+  }
+
+  cASCPPParameter rvalue = nobj->CallMethod(mid, m_params.GetSize() ? &m_params[0] : NULL);
+  uRegister result = getResult(rvalue, nobj->GetReturnType(mid), slot.want, pc);
+  if (in.d >= 0) r[in.d] = result;
+
+  // Clean up arguments, including any surplus values that were never passed
+  for (int i = 0; i < arity; i++) {
+    if (nobj->GetArgumentType(mid, i).type == TYPE(STRING)) delete m_params[i].Get<cString*>();
+  }
+  for (int i = arity; i < slot.args.GetSize(); i++) {
+    if (slot.arg_types[i] == TYPE(STRING)) delete r[slot.args[i]].as_string;
+  }
+
+  nobj->RemoveReference();
+}
+
+
+void cASVirtualMachine::growRegisters(int size)
+{
+  // Frames address registers relative to m_regs, so growing the file only requires the callers to rebase
+  int new_size = m_num_regs * 2;
+  if (new_size < size) new_size = size;
+
+  uRegister* regs = new uRegister[new_size];
+  for (int i = 0; i < m_num_regs; i++) regs[i] = m_regs[i];
+  delete [] m_regs;
+
+  m_regs = regs;
+  m_num_regs = new_size;
+}
+
+
+void cASVirtualMachine::setParameter(cASCPPParameter& param, ASType_t target, ASType_t source, uRegister value, int pc)
+{
+  value = convert(value, source, target, pc);
+
+  switch (target) {
+    case TYPE(BOOL):        param.Set((bool)value.as_int); break;
+    case TYPE(CHAR):        param.Set((char)value.as_int); break;
+    case TYPE(INT):         param.Set(value.as_int); break;
+    case TYPE(FLOAT):       param.Set(value.as_float); break;
+    case TYPE(STRING):      param.Set(value.as_string); break;
+    case TYPE(OBJECT_REF):  param.Set(value.as_nobj); break;
+
+    default:
+      reportError(AS_DIRECT_INTERPRET_ERR_INTERNAL, pc);
+  }
+}
+
+
+cASVirtualMachine::uRegister cASVirtualMachine::getResult(const cASCPPParameter& value, const sASTypeInfo& have,
+                                                          const sASTypeInfo& want, int pc)
+{
+  uRegister result;
+  result.as_float = 0.0;
+
+  switch (have.type) {
+    case TYPE(BOOL):        result.as_int = value.Get<bool>(); break;
+    case TYPE(CHAR):        result.as_int = value.Get<char>(); break;
+    case TYPE(INT):         result.as_int = value.Get<int>(); break;
+    case TYPE(FLOAT):       result.as_float = value.Get<double>(); break;
+    case TYPE(STRING):      result.as_string = value.Get<cString*>(); break;
+    case TYPE(OBJECT_REF):
+      result.as_nobj = value.Get<cASNativeObject*>();
+      if (want.type == TYPE(OBJECT_REF) && have.info != want.info) {
+        reportError(AS_DIRECT_INTERPRET_ERR_NOBJ_TYPE_MISMATCH, pc, (const char*)want.info, (const char*)have.info);
+      }
+      break;
+
+    case TYPE(VOID):
+      if (want.type == TYPE(VOID)) return result;
+      reportError(AS_DIRECT_INTERPRET_ERR_TYPE_CAST, pc, mapType(have), mapType(want));
+      break;
+
+    default:
+      reportError(AS_DIRECT_INTERPRET_ERR_INTERNAL, pc);
+  }
+
+  return convert(result, have.type, want.type, pc);
+}
+
+
+cASVirtualMachine::uRegister cASVirtualMachine::convert(uRegister value, ASType_t from, ASType_t to, int pc)
+{
+  if (from == to) return value;
+
+  uRegister result;
+  result.as_float = 0.0;
+
+  // Conversions follow cDirectInterpretASTVisitor::as*(), strings are consumed by the conversion
+  switch (to) {
+    case TYPE(VOID):
+      if (from == TYPE(STRING)) delete value.as_string;
+      else if (from == TYPE(OBJECT_REF) && value.as_nobj) value.as_nobj->RemoveReference();
+      return result;
+
+    case TYPE(BOOL):
+      switch (from) {
+        case TYPE(CHAR):
+        case TYPE(INT):     result.as_int = (value.as_int != 0); return result;
+        case TYPE(FLOAT):   result.as_int = (value.as_float != 0.0); return result;
+        case TYPE(STRING):  result.as_int = (*value.as_string != ""); delete value.as_string; return result;
+        default: break;
+      }
+      break;
+
+    case TYPE(CHAR):
+      switch (from) {
+        case TYPE(BOOL):
+        case TYPE(INT):     result.as_int = (char)value.as_int; return result;
+        default: break;
+      }
+      break;
+
+    case TYPE(INT):
+      switch (from) {
+        case TYPE(BOOL):
+        case TYPE(CHAR):    return value;
+        case TYPE(FLOAT):   result.as_int = (int)value.as_float; return result;
+        case TYPE(STRING):  result.as_int = value.as_string->AsInt(); delete value.as_string; return result;
+        default: break;
+      }
+      break;
+
+    case TYPE(FLOAT):
+      switch (from) {
+        case TYPE(BOOL):
+        case TYPE(CHAR):
+        case TYPE(INT):     result.as_float = (double)value.as_int; return result;
+        case TYPE(STRING):  result.as_float = value.as_string->AsDouble(); delete value.as_string; return result;
+        default: break;
+      }
+      break;
+
+    case TYPE(STRING):
+      switch (from) {
+        case TYPE(BOOL):    result.as_string = new cString(cStringUtil::Convert((bool)value.as_int)); return result;
+        case TYPE(CHAR):    result.as_string = new cString(1); (*result.as_string)[0] = (char)value.as_int; return result;
+        case TYPE(INT):     result.as_string = new cString(cStringUtil::Convert(value.as_int)); return result;
+        case TYPE(FLOAT):   result.as_string = new cString(cStringUtil::Convert(value.as_float)); return result;
+        default: break;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  reportError(AS_DIRECT_INTERPRET_ERR_TYPE_CAST, pc, mapType(from), mapType(to));
+  return result;
+}
+
+
+void cASVirtualMachine::reportError(ASDirectInterpretError_t err, int pc, ...)
+{
+#define VA_ARG_STR va_arg(vargs, const char*)
+
+  std::cerr << m_program->filename << ":" << m_program->lines[pc] << ": error: ";
+
+  va_list vargs;
+  va_start(vargs, pc);
+  switch (err) {
+    case AS_DIRECT_INTERPRET_ERR_DIVISION_BY_ZERO:
+      std::cerr << "division by zero" << std::endl;
+      break;
+    case AS_DIRECT_INTERPRET_ERR_NOBJ_METHOD_LOOKUP_FAILED:
+      {
+        const char* meth = VA_ARG_STR;
+        const char* itype = VA_ARG_STR;
+        std::cerr << "method '" << meth << "' not supported by '" << itype << "'" << std::endl;
+      }
+      break;
+    case AS_DIRECT_INTERPRET_ERR_NOBJ_TYPE_MISMATCH:
+      {
+        const char* otype = VA_ARG_STR;
+        const char* itype = VA_ARG_STR;
+        std::cerr << "expected object of type '" << otype << "', received '" << itype << "'" << std::endl;
+      }
+      break;
+    case AS_DIRECT_INTERPRET_ERR_TYPE_CAST:
+      {
+        const char* type1 = VA_ARG_STR;
+        const char* type2 = VA_ARG_STR;
+        std::cerr << "cannot convert '" << type1 << "' to '" << type2 << "'" << std::endl;
+      }
+      break;
+
+    case AS_DIRECT_INTERPRET_ERR_INTERNAL:
+      std::cerr << "internal virtual machine error at instruction " << pc << std::endl;
+      break;
+    default:
+      std::cerr << "unknown error" << std::endl;
+  }
+  va_end(vargs);
+
+  exit(AS_EXIT_FAIL_INTERPRET);
+
+#undef VA_ARG_STR
+}
+
+#undef TYPE
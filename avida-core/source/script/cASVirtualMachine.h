@@ -0,0 +1,95 @@
+/*
+ *  cASVirtualMachine.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cASVirtualMachine_h
+#define cASVirtualMachine_h
+
+#include "cASCPPParameter.h"
+#include "cASProgram.h"
+
+class cASNativeObject;
+
+// Computed goto dispatch is a GNU extension (also supported by clang), other compilers fall back to a switch loop
+#if defined(__GNUC__)
+# define AS_VM_THREADED_DISPATCH 1
+#else
+# define AS_VM_THREADED_DISPATCH 0
+#endif
+
+
+// Executes a cASProgram over a flat file of unboxed registers.
+class cASVirtualMachine
+{
+private:
+  typedef union {
+    int as_int;         // bool, char and int values
+    double as_float;
+    cString* as_string;
+    cASNativeObject* as_nobj;
+  } uRegister;
+
+
+  cASProgram* m_program;
+
+  int m_code_size;
+  cASProgram::sInstruction* m_code;
+#if AS_VM_THREADED_DISPATCH
+  const void** m_handlers;
+#endif
+
+  struct sFrame
+  {
+    int pc;     // return address
+    int fp;     // caller frame
+    int dest;   // caller register receiving the return value
+
+    sFrame() : pc(0), fp(0), dest(-1) { ; }
+    sFrame(int in_pc, int in_fp, int in_dest) : pc(in_pc), fp(in_fp), dest(in_dest) { ; }
+  };
+
+
+  uRegister* m_regs;
+  int m_num_regs;
+  Apto::Array<sFrame, Apto::Smart> m_frames;
+  Apto::Array<cASCPPParameter> m_params;  // argument scratch space, native calls never nest
+
+
+  cASVirtualMachine(const cASVirtualMachine&); // @not_implemented
+  cASVirtualMachine& operator=(const cASVirtualMachine&); // @not_implemented
+
+public:
+  cASVirtualMachine(cASProgram* program);
+  ~cASVirtualMachine();
+
+  int Execute();
+
+private:
+  void callFunction(int pc, uRegister* r);
+  void callMethod(int pc, uRegister* r);
+  void growRegisters(int size);
+
+  void setParameter(cASCPPParameter& param, ASType_t target, ASType_t source, uRegister value, int pc);
+  uRegister getResult(const cASCPPParameter& value, const sASTypeInfo& have, const sASTypeInfo& want, int pc);
+  uRegister convert(uRegister value, ASType_t from, ASType_t to, int pc);
+
+  void reportError(ASDirectInterpretError_t err, int pc, ...);
+};
+
+#endif
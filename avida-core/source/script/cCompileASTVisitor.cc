@@ -0,0 +1,919 @@
+/*
+ *  cCompileASTVisitor.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cCompileASTVisitor.h"
+
+#include "cASFunction.h"
+#include "cStringUtil.h"
+#include "cSymbolTable.h"
+
+using namespace AvidaScript;
+
+
+#define TOKEN(x) AS_TOKEN_ ## x
+#define TYPE(x) AS_TYPE_ ## x
+#define OP(x) cASProgram::x
+
+
+cCompileASTVisitor::cCompileASTVisitor(cSymbolTable* global_symtbl)
+  : m_global_symtbl(global_symtbl), m_program(NULL), m_success(true), m_cur_symtbl(NULL), m_num_vars(0)
+  , m_next_temp(0), m_num_registers(0), m_loop_values(NULL), m_loop_reg(-1), m_rreg(-1), m_line(0)
+{
+}
+
+
+cASProgram* cCompileASTVisitor::Compile(cASTNode* node)
+{
+  m_program = new cASProgram;
+  m_program->filename = node->GetFilePosition().GetFilename();
+  m_success = true;
+  m_failure = "";
+
+  // Every global variable is given a dedicated, unboxed register
+  m_num_vars = m_global_symtbl->GetNumVariables();
+  m_program->var_types.Resize(m_num_vars);
+  for (int i = 0; i < m_num_vars; i++) {
+    const sASTypeInfo& type = m_global_symtbl->GetVariableType(i);
+    if (!isSupportedType(type)) fail(cString("variable of type '") + mapType(type) + "'");
+    m_program->var_types[i] = type.type;
+  }
+  m_next_temp = m_num_vars;
+  m_num_registers = m_num_vars;
+
+  m_cur_symtbl = NULL;
+  m_func_index.Resize(m_global_symtbl->GetNumFunctions());
+  for (int i = 0; i < m_func_index.GetSize(); i++) m_func_index[i] = -1;
+  m_func_ids.Resize(0);
+
+  compileExpression(node, TYPE(VOID));
+  emit(OP(HALT));
+  m_program->num_registers = m_num_registers;
+
+  // Script function bodies follow the top level code, in order of first call
+  for (int i = 0; m_success && i < m_program->functions.GetSize(); i++) compileFunction(i);
+  m_cur_symtbl = NULL;
+
+  if (!m_success) {
+    delete m_program;
+    m_program = NULL;
+  }
+
+  cASProgram* program = m_program;
+  m_program = NULL;
+  return program;
+}
+
+
+void cCompileASTVisitor::VisitAssignment(cASTAssignment& node)
+{
+  bool global = (!m_cur_symtbl || node.IsVarGlobal());
+  cSymbolTable* symtbl = global ? m_global_symtbl : m_cur_symtbl;
+  compileStore(node.GetVarID(), global, symtbl->GetVariableType(node.GetVarID()), node.GetExpression());
+  setResult(-1, TYPE(VOID));
+}
+
+
+void cCompileASTVisitor::VisitObjectAssignment(cASTObjectAssignment& node)
+{
+  fail("object assignment");
+}
+
+
+void cCompileASTVisitor::VisitArgumentList(cASTArgumentList& node)
+{
+  // Should never recurse into here.  Argument lists are processed by their owners as needed.
+  fail("argument list");
+}
+
+
+void cCompileASTVisitor::VisitReturnStatement(cASTReturnStatement& node)
+{
+  if (m_cur_symtbl) {
+    int reg = compileExpression(node.GetExpression(), m_cur_rtype);
+    emit(OP(FRET), 0, reg);
+  } else {
+    // Top level return values are reported as the exit code, which is always converted to an int
+    int reg = compileExpression(node.GetExpression(), TYPE(INT));
+    emit(OP(RET), 0, reg);
+  }
+  setResult(-1, TYPE(VOID));
+}
+
+
+void cCompileASTVisitor::VisitStatementList(cASTStatementList& node)
+{
+  tListIterator<cASTNode> it = node.Iterator();
+
+  cASTNode* stmt = NULL;
+  while (m_success && (stmt = it.Next())) {
+    // Temporaries never live across statements
+    int mark = m_next_temp;
+    compileExpression(stmt, TYPE(VOID));
+    m_next_temp = mark;
+  }
+  setResult(-1, TYPE(VOID));
+}
+
+
+void cCompileASTVisitor::VisitForeachBlock(cASTForeachBlock& node)
+{
+  cASTVariableDefinition* var = node.GetVariable();
+  const sASTypeInfo& var_type = var->GetType();
+  if (!isScalarType(var_type)) {
+    fail(cString("foreach variable of type '") + mapType(var_type) + "'");
+    return;
+  }
+
+  // Loop control registers stay live below the temporaries of the body
+  int loop = allocTemp();
+  allocTemp();
+  allocTemp();
+  int mark = m_next_temp;
+
+  // Ranges and expansions are iterated in place, rather than being built as arrays first
+  m_loop_values = node.GetValues();
+  m_loop_reg = loop;
+  compileExpression(node.GetValues(), TYPE(ARRAY));
+  m_next_temp = mark;
+  if (m_loop_values) {
+    m_loop_values = NULL;
+    fail("foreach over values other than a range or expansion");
+  }
+  if (!m_success) return;
+
+  int top = emit(OP(FORLOOP), loop);
+  if (m_loop_type.type == var_type.type) {
+    emit(OP(MOV), var->GetVarID(), loop);
+  } else {
+    int t = allocTemp();
+    emit(OP(MOV), t, loop);
+    emit(OP(MOV), var->GetVarID(), convert(t, m_loop_type, var_type));
+    m_next_temp = mark;
+  }
+  compileExpression(node.GetCode(), TYPE(VOID));
+  emit(OP(JMP), 0, top);
+  if (!m_success) return;
+
+  m_program->code[top].a = m_program->code.GetSize();
+  setResult(-1, TYPE(VOID));
+}
+
+
+void cCompileASTVisitor::VisitIfBlock(cASTIfBlock& node)
+{
+  Apto::Array<int> exits;
+
+  int mark = m_next_temp;
+  int cond = compileExpression(node.GetCondition(), TYPE(BOOL));
+  m_next_temp = mark;
+  int skip = emit(OP(JMPF), 0, cond);
+  compileExpression(node.GetCode(), TYPE(VOID));
+  if (node.HasElseIfs() || node.HasElse()) exits.Push(emit(OP(JMP)));
+  if (!m_success) return;
+  m_program->code[skip].b = m_program->code.GetSize();
+
+  tListIterator<cASTIfBlock::cElseIf> it = node.ElseIfIterator();
+  cASTIfBlock::cElseIf* ei = NULL;
+  while (m_success && (ei = it.Next())) {
+    cond = compileExpression(ei->GetCondition(), TYPE(BOOL));
+    m_next_temp = mark;
+    skip = emit(OP(JMPF), 0, cond);
+    compileExpression(ei->GetCode(), TYPE(VOID));
+    exits.Push(emit(OP(JMP)));
+    if (!m_success) return;
+    m_program->code[skip].b = m_program->code.GetSize();
+  }
+
+  if (node.HasElse()) compileExpression(node.GetElseCode(), TYPE(VOID));
+  if (!m_success) return;
+
+  for (int i = 0; i < exits.GetSize(); i++) m_program->code[exits[i]].a = m_program->code.GetSize();
+  setResult(-1, TYPE(VOID));
+}
+
+
+void cCompileASTVisitor::VisitWhileBlock(cASTWhileBlock& node)
+{
+  int top = m_program->code.GetSize();
+
+  int mark = m_next_temp;
+  int cond = compileExpression(node.GetCondition(), TYPE(BOOL));
+  m_next_temp = mark;
+  int done = emit(OP(JMPF), 0, cond);
+  compileExpression(node.GetCode(), TYPE(VOID));
+  emit(OP(JMP), 0, top);
+  if (!m_success) return;
+
+  m_program->code[done].b = m_program->code.GetSize();
+  setResult(-1, TYPE(VOID));
+}
+
+
+void cCompileASTVisitor::VisitFunctionDefinition(cASTFunctionDefinition& node)
+{
+  // Bodies are compiled separately once the function is called, only global functions are supported
+  if (m_cur_symtbl) {
+    fail(cString("nested function definition '") + node.GetName() + "'");
+    return;
+  }
+  setResult(-1, TYPE(VOID));
+}
+
+
+void cCompileASTVisitor::VisitVariableDefinition(cASTVariableDefinition& node)
+{
+  if (node.GetDimensions()) {
+    fail("dimensioned variable definition");
+    return;
+  }
+
+  if (node.GetAssignmentExpression()) {
+    compileStore(node.GetVarID(), !m_cur_symtbl, node.GetType(), node.GetAssignmentExpression());
+  }
+  setResult(-1, TYPE(VOID));
+}
+
+
+void cCompileASTVisitor::VisitVariableDefinitionList(cASTVariableDefinitionList& node)
+{
+  // Should never recurse into here.  Variable definition lists are processed by function definitions.
+  fail("variable definition list");
+}
+
+
+void cCompileASTVisitor::VisitExpressionBinary(cASTExpressionBinary& node)
+{
+  int mark = m_next_temp;
+  ASToken_t op = node.GetOperator();
+
+  switch (op) {
+    case TOKEN(OP_LOGIC_AND):
+    case TOKEN(OP_LOGIC_OR):
+      {
+        // Both sides are always evaluated, matching the direct interpreter
+        int l = compileExpression(node.GetLeft(), TYPE(BOOL));
+        int r = compileExpression(node.GetRight(), TYPE(BOOL));
+        m_next_temp = mark;
+        int d = allocTemp();
+        emit((op == TOKEN(OP_LOGIC_AND)) ? OP(LANDI) : OP(LORI), d, l, r);
+        setResult(d, TYPE(BOOL));
+      }
+      break;
+
+    case TOKEN(OP_BIT_AND):
+    case TOKEN(OP_BIT_OR):
+      {
+        ASType_t rettype = node.GetType().type;
+        if (rettype != TYPE(CHAR) && rettype != TYPE(INT)) {
+          fail(cString("operator '") + mapToken(op) + "' on type '" + mapType(rettype) + "'");
+          return;
+        }
+        int l = compileExpression(node.GetLeft(), rettype);
+        int r = compileExpression(node.GetRight(), rettype);
+        m_next_temp = mark;
+        int d = allocTemp();
+        emit((op == TOKEN(OP_BIT_AND)) ? OP(BANDI) : OP(BORI), d, l, r);
+        setResult(d, rettype);
+      }
+      break;
+
+    case TOKEN(OP_EQ):
+    case TOKEN(OP_NEQ):
+    case TOKEN(OP_LE):
+    case TOKEN(OP_GE):
+    case TOKEN(OP_LT):
+    case TOKEN(OP_GT):
+      {
+        ASType_t comptype = node.GetCompareType().type;
+        bool is_float = false;
+        switch (comptype) {
+          case TYPE(BOOL):
+            if (op != TOKEN(OP_EQ) && op != TOKEN(OP_NEQ)) comptype = TYPE(INVALID);
+            break;
+          case TYPE(CHAR):
+          case TYPE(INT):
+            // Handle both char and int as integers
+            comptype = TYPE(INT);
+            break;
+          case TYPE(FLOAT):
+            is_float = true;
+            break;
+          default:
+            comptype = TYPE(INVALID);
+            break;
+        }
+        if (comptype == TYPE(INVALID)) {
+          fail(cString("comparison '") + mapToken(op) + "' on type '" + mapType(node.GetCompareType()) + "'");
+          return;
+        }
+
+        int l = compileExpression(node.GetLeft(), comptype);
+        int r = compileExpression(node.GetRight(), comptype);
+        m_next_temp = mark;
+        int d = allocTemp();
+        switch (op) {
+          case TOKEN(OP_EQ):  emit(is_float ? OP(EQF) : OP(EQI), d, l, r); break;
+          case TOKEN(OP_NEQ): emit(is_float ? OP(NEF) : OP(NEI), d, l, r); break;
+          case TOKEN(OP_LE):  emit(is_float ? OP(LEF) : OP(LEI), d, l, r); break;
+          case TOKEN(OP_GE):  emit(is_float ? OP(GEF) : OP(GEI), d, l, r); break;
+          case TOKEN(OP_LT):  emit(is_float ? OP(LTF) : OP(LTI), d, l, r); break;
+          case TOKEN(OP_GT):  emit(is_float ? OP(GTF) : OP(GTI), d, l, r); break;
+          default: break;
+        }
+        setResult(d, TYPE(BOOL));
+      }
+      break;
+
+    case TOKEN(OP_ADD):
+    case TOKEN(OP_SUB):
+    case TOKEN(OP_MUL):
+    case TOKEN(OP_DIV):
+    case TOKEN(OP_MOD):
+      {
+        ASType_t rettype = node.GetType().type;
+        if (rettype != TYPE(CHAR) && rettype != TYPE(INT) && rettype != TYPE(FLOAT)) {
+          fail(cString("operator '") + mapToken(op) + "' on type '" + mapType(rettype) + "'");
+          return;
+        }
+        bool is_float = (rettype == TYPE(FLOAT));
+
+        int l = compileExpression(node.GetLeft(), rettype);
+        int r = compileExpression(node.GetRight(), rettype);
+        m_next_temp = mark;
+        int d = allocTemp();
+        switch (op) {
+          case TOKEN(OP_ADD): emit(is_float ? OP(ADDF) : OP(ADDI), d, l, r); break;
+          case TOKEN(OP_SUB): emit(is_float ? OP(SUBF) : OP(SUBI), d, l, r); break;
+          case TOKEN(OP_MUL): emit(is_float ? OP(MULF) : OP(MULI), d, l, r); break;
+          case TOKEN(OP_DIV): emit(is_float ? OP(DIVF) : OP(DIVI), d, l, r); break;
+          case TOKEN(OP_MOD): emit(is_float ? OP(MODF) : OP(MODI), d, l, r); break;
+          default: break;
+        }
+
+        // char arithmetic wraps, since the interpreter stores the result in a char
+        if (rettype == TYPE(CHAR)) emit(OP(I2C), d, d);
+        setResult(d, rettype);
+      }
+      break;
+
+    case TOKEN(ARR_RANGE):
+    case TOKEN(ARR_EXPAN):
+      {
+        // Only supported as the values of a foreach, where they set up the loop registers instead of an array
+        if (&node != m_loop_values) {
+          fail(cString("operator '") + mapToken(op) + "' outside of foreach");
+          return;
+        }
+        m_loop_values = NULL;
+        int loop = m_loop_reg;
+
+        sASTypeInfo elem_type = (op == TOKEN(ARR_RANGE)) ? sASTypeInfo(TYPE(INT)) : node.GetLeft()->GetType();
+        if (!isScalarType(elem_type)) {
+          fail(cString("expansion of type '") + mapType(elem_type) + "'");
+          return;
+        }
+
+        int l = compileExpression(node.GetLeft(), elem_type);
+        int r = compileExpression(node.GetRight(), TYPE(INT));
+        m_next_temp = mark;
+        emit((op == TOKEN(ARR_RANGE)) ? OP(FORRANGE) : OP(FORREPEAT), loop, l, r);
+        m_loop_type = elem_type;
+        setResult(loop, TYPE(ARRAY));
+      }
+      break;
+
+    default:
+      // Indexing consumes aggregate values
+      fail(cString("operator '") + mapToken(op) + "'");
+      break;
+  }
+}
+
+
+void cCompileASTVisitor::VisitExpressionUnary(cASTExpressionUnary& node)
+{
+  int mark = m_next_temp;
+  ASType_t type = node.GetExpression()->GetType().type;
+
+  switch (node.GetOperator()) {
+    case TOKEN(OP_LOGIC_NOT):
+      {
+        int a = compileExpression(node.GetExpression(), TYPE(BOOL));
+        m_next_temp = mark;
+        int d = allocTemp();
+        emit(OP(NOTI), d, a);
+        setResult(d, TYPE(BOOL));
+      }
+      return;
+
+    case TOKEN(OP_BIT_NOT):
+      if (type == TYPE(CHAR) || type == TYPE(INT)) {
+        int a = compileExpression(node.GetExpression(), type);
+        m_next_temp = mark;
+        int d = allocTemp();
+        emit(OP(BNOTI), d, a);
+        setResult(d, type);
+        return;
+      }
+      break;
+
+    case TOKEN(OP_SUB):
+      if (type == TYPE(CHAR) || type == TYPE(INT) || type == TYPE(FLOAT)) {
+        int a = compileExpression(node.GetExpression(), type);
+        m_next_temp = mark;
+        int d = allocTemp();
+        emit((type == TYPE(FLOAT)) ? OP(NEGF) : OP(NEGI), d, a);
+        if (type == TYPE(CHAR)) emit(OP(I2C), d, d);
+        setResult(d, type);
+        return;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  fail(cString("unary operator '") + mapToken(node.GetOperator()) + "' on type '" + mapType(type) + "'");
+}
+
+
+void cCompileASTVisitor::VisitBuiltInCall(cASTBuiltInCall& node)
+{
+  ASType_t type = TYPE(INVALID);
+  switch (node.GetBuiltIn()) {
+    case AS_BUILTIN_CAST_BOOL:  type = TYPE(BOOL); break;
+    case AS_BUILTIN_CAST_CHAR:  type = TYPE(CHAR); break;
+    case AS_BUILTIN_CAST_INT:   type = TYPE(INT); break;
+    case AS_BUILTIN_CAST_FLOAT: type = TYPE(FLOAT); break;
+
+    default:
+      fail("built-in call");
+      return;
+  }
+
+  int reg = compileExpression(node.GetArguments()->Iterator().Next(), type);
+  setResult(reg, type);
+}
+
+
+void cCompileASTVisitor::VisitFunctionCall(cASTFunctionCall& node)
+{
+  if (!node.IsASFunction()) {
+    // Functions found in the scope of the calling function are nested definitions
+    if (m_cur_symtbl && !node.IsFuncGlobal()) {
+      fail(cString("call to nested function '") + node.GetName() + "'");
+      return;
+    }
+
+    int fun_id = node.GetFuncID();
+    cSymbolTable* func_symtbl = m_global_symtbl->GetFunctionSymbolTable(fun_id);
+    cASTVariableDefinitionList* sig = m_global_symtbl->GetFunctionSignature(fun_id);
+
+    const sASTypeInfo& rtype = node.GetType();
+    if (!isScalarType(rtype) && rtype.type != TYPE(VOID)) {
+      fail(cString("function returning '") + mapType(rtype) + "'");
+      return;
+    }
+
+    // Arguments are evaluated straight into the parameter registers of the callee frame, which starts at base
+    Apto::Array<cASTNode*> args;
+    if (node.HasArguments()) {
+      tListIterator<cASTNode> cit = node.GetArguments()->Iterator();
+      cASTNode* an = NULL;
+      while ((an = cit.Next())) args.Push(an);
+    }
+
+    int base = m_next_temp;
+    int span = 1;
+    if (sig) {
+      tListIterator<cASTVariableDefinition> sit = sig->Iterator();
+      cASTVariableDefinition* arg_def = NULL;
+      while ((arg_def = sit.Next())) if (arg_def->GetVarID() >= span) span = arg_def->GetVarID() + 1;
+    }
+    for (int i = 0; i < span; i++) allocTemp();
+
+    if (sig) {
+      tListIterator<cASTVariableDefinition> sit = sig->Iterator();
+      cASTVariableDefinition* arg_def = NULL;
+      for (int i = 0; m_success && (arg_def = sit.Next()); i++) {
+        const sASTypeInfo& arg_type = func_symtbl->GetVariableType(arg_def->GetVarID());
+        if (!isScalarType(arg_type)) {
+          fail(cString("argument of type '") + mapType(arg_type) + "'");
+          return;
+        }
+
+        // Missing arguments take their default value, evaluated in the calling scope like the interpreter does
+        int mark = m_next_temp;
+        int reg = compileExpression((i < args.GetSize()) ? args[i] : arg_def->GetAssignmentExpression(), arg_type);
+        m_next_temp = mark;
+        if (m_success && reg != base + arg_def->GetVarID()) emit(OP(MOV), base + arg_def->GetVarID(), reg);
+      }
+    }
+
+    int d = (rtype.type == TYPE(VOID)) ? -1 : base;
+    emit(OP(CALLS), d, functionIndex(fun_id), base);
+    m_next_temp = (d < 0) ? base : base + 1;
+    setResult(d, rtype);
+    return;
+  }
+
+  const cASFunction* func = node.GetASFunction();
+
+  cASProgram::sCallSlot slot;
+  slot.func = func;
+  if (func->GetArity()) {
+    tListIterator<cASTNode> cit = node.GetArguments()->Iterator();
+    for (int i = 0; i < func->GetArity(); i++) {
+      const sASTypeInfo& arg_type = func->GetArgumentType(i);
+      if (!isSupportedType(arg_type) && arg_type.type != TYPE(STRING)) {
+        fail(cString("argument of type '") + mapType(arg_type) + "'");
+        return;
+      }
+      // Scalars passed to string parameters are converted by the machine when the call is made
+      cASTNode* an = cit.Next();
+      sASTypeInfo src_type = arg_type;
+      if (arg_type.type == TYPE(STRING) && isScalarType(an->GetType())) src_type = an->GetType();
+      slot.args.Push(compileExpression(an, src_type));
+      slot.arg_types.Push(src_type.type);
+    }
+  }
+
+  const sASTypeInfo& rtype = node.GetType();
+  if (!isSupportedType(rtype) && rtype.type != TYPE(STRING) && rtype.type != TYPE(VOID)) {
+    fail(cString("function returning '") + mapType(rtype) + "'");
+    return;
+  }
+  slot.want = rtype;
+
+  int d = (rtype.type == TYPE(VOID)) ? -1 : allocTemp();
+  m_program->call_slots.Push(slot);
+  emit(OP(CALLF), d, m_program->call_slots.GetSize() - 1);
+  setResult(d, rtype);
+}
+
+
+void cCompileASTVisitor::VisitLiteral(cASTLiteral& node)
+{
+  int d = allocTemp();
+  switch (node.GetType().type) {
+    case TYPE(BOOL):
+      emit(OP(LOADI), d, (node.GetValue() == "true") ? 1 : 0);
+      break;
+    case TYPE(CHAR):
+      emit(OP(LOADI), d, node.GetValue()[0]);
+      break;
+    case TYPE(INT):
+      emit(OP(LOADI), d, node.GetValue().AsInt());
+      break;
+    case TYPE(FLOAT):
+      m_program->float_consts.Push(node.GetValue().AsDouble());
+      emit(OP(LOADF), d, m_program->float_consts.GetSize() - 1);
+      break;
+    case TYPE(STRING):
+      m_program->string_consts.Push(node.GetValue());
+      emit(OP(LOADS), d, m_program->string_consts.GetSize() - 1);
+      break;
+
+    default:
+      fail(cString("literal of type '") + mapType(node.GetType()) + "'");
+      return;
+  }
+  setResult(d, node.GetType());
+}
+
+
+void cCompileASTVisitor::VisitLiteralArray(cASTLiteralArray& node)
+{
+  fail("literal array");
+}
+
+
+void cCompileASTVisitor::VisitLiteralDict(cASTLiteralDict& node)
+{
+  fail("literal dict");
+}
+
+
+void cCompileASTVisitor::VisitObjectCall(cASTObjectCall& node)
+{
+  // Native method signatures are only known at runtime, so the result is converted to the type the caller expects
+  ASType_t want = m_want.type;
+  if (!isSupportedType(m_want) && want != TYPE(STRING) && want != TYPE(VOID)) {
+    fail(cString("method call '") + node.GetName() + "' in untyped context");
+    return;
+  }
+
+  const sASTypeInfo& otype = node.GetObject()->GetType();
+  if (otype.type != TYPE(OBJECT_REF)) {
+    fail(cString("method call '") + node.GetName() + "' on type '" + mapType(otype) + "'");
+    return;
+  }
+
+  cASProgram::sCallSlot slot;
+  slot.method = node.GetName();
+  slot.want = m_want;
+  slot.object = compileExpression(node.GetObject(), otype);
+  slot.object_info = otype.info;
+
+  if (node.HasArguments()) {
+    tListIterator<cASTNode> cit = node.GetArguments()->Iterator();
+    cASTNode* an = NULL;
+    while ((an = cit.Next())) {
+      const sASTypeInfo& arg_type = an->GetType();
+      if ((!isSupportedType(arg_type) && arg_type.type != TYPE(STRING)) || arg_type.type == TYPE(OBJECT_REF)) {
+        fail(cString("method argument of type '") + mapType(arg_type) + "'");
+        return;
+      }
+      slot.args.Push(compileExpression(an, arg_type));
+      slot.arg_types.Push(arg_type.type);
+    }
+  }
+
+  int d = (want == TYPE(VOID)) ? -1 : allocTemp();
+  m_program->call_slots.Push(slot);
+  emit(OP(CALLM), d, m_program->call_slots.GetSize() - 1);
+  setResult(d, m_want);
+}
+
+
+void cCompileASTVisitor::VisitObjectReference(cASTObjectReference& node)
+{
+  fail("object reference");
+}
+
+
+void cCompileASTVisitor::VisitVariableReference(cASTVariableReference& node)
+{
+  int var_id = node.GetVarID();
+
+  if (m_cur_symtbl && node.IsVarGlobal()) {
+    // Globals are copied into the function frame, object values taking their own reference as usual
+    const sASTypeInfo& type = m_global_symtbl->GetVariableType(var_id);
+    int d = allocTemp();
+    emit(OP(GLOAD), d, var_id);
+    if (type.type == TYPE(OBJECT_REF)) emit(OP(OCOPY), d, d);
+    setResult(d, type);
+    return;
+  }
+
+  const sASTypeInfo& type = (m_cur_symtbl ? m_cur_symtbl : m_global_symtbl)->GetVariableType(var_id);
+  if (type.type == TYPE(OBJECT_REF)) {
+    // Object values held in temporaries always own a reference
+    int d = allocTemp();
+    emit(OP(OCOPY), d, var_id);
+    setResult(d, type);
+  } else {
+    setResult(var_id, type);
+  }
+}
+
+
+void cCompileASTVisitor::VisitUnpackTarget(cASTUnpackTarget& node)
+{
+  fail("unpack");
+}
+
+
+
+int cCompileASTVisitor::compileExpression(cASTNode* node, const sASTypeInfo& want)
+{
+  if (!m_success) return -1;
+
+  sASTypeInfo prev_want = m_want;
+  int prev_line = m_line;
+  m_want = want;
+  m_line = node->GetFilePosition().GetLineNumber();
+
+  node->Accept(*this);
+
+  m_want = prev_want;
+  m_line = prev_line;
+  if (!m_success) return -1;
+
+  return convert(m_rreg, m_rtype, want);
+}
+
+
+void cCompileASTVisitor::compileFunction(int idx)
+{
+  int fun_id = m_func_ids[idx];
+  cSymbolTable* symtbl = m_global_symtbl->GetFunctionSymbolTable(fun_id);
+  cASTNode* code = m_global_symtbl->GetFunctionDefinition(fun_id);
+
+  m_cur_symtbl = symtbl;
+  m_cur_rtype = m_global_symtbl->GetFunctionRType(fun_id);
+  m_num_vars = symtbl->GetNumVariables();
+  m_next_temp = m_num_vars;
+  m_num_registers = m_num_vars;
+  m_line = code->GetFilePosition().GetLineNumber();
+
+  if (!isScalarType(m_cur_rtype) && m_cur_rtype.type != TYPE(VOID)) {
+    fail(cString("function returning '") + mapType(m_cur_rtype) + "'");
+    return;
+  }
+
+  m_program->functions[idx].entry = m_program->code.GetSize();
+
+  // Arguments arrive in their registers, every other local starts out zeroed like in the interpreter
+  Apto::Array<bool> is_arg;
+  is_arg.Resize(m_num_vars);
+  for (int i = 0; i < m_num_vars; i++) is_arg[i] = false;
+  cASTVariableDefinitionList* sig = m_global_symtbl->GetFunctionSignature(fun_id);
+  if (sig) {
+    tListIterator<cASTVariableDefinition> sit = sig->Iterator();
+    cASTVariableDefinition* arg_def = NULL;
+    while ((arg_def = sit.Next())) is_arg[arg_def->GetVarID()] = true;
+  }
+
+  m_program->float_consts.Push(0.0);
+  int zero = m_program->float_consts.GetSize() - 1;
+  for (int i = 0; i < m_num_vars; i++) {
+    const sASTypeInfo& type = symtbl->GetVariableType(i);
+    if (!isScalarType(type)) {
+      fail(cString("function variable of type '") + mapType(type) + "'");
+      return;
+    }
+    if (!is_arg[i]) {
+      if (type.type == TYPE(FLOAT)) emit(OP(LOADF), i, zero);
+      else emit(OP(LOADI), i, 0);
+    }
+  }
+
+  compileExpression(code, TYPE(VOID));
+
+  // Falling off the end returns a zero value
+  if (m_cur_rtype.type == TYPE(VOID)) {
+    emit(OP(FRET), 0, -1);
+  } else {
+    int d = allocTemp();
+    if (m_cur_rtype.type == TYPE(FLOAT)) emit(OP(LOADF), d, zero);
+    else emit(OP(LOADI), d, 0);
+    emit(OP(FRET), 0, d);
+  }
+
+  m_program->functions[idx].num_registers = m_num_registers;
+}
+
+
+void cCompileASTVisitor::compileStore(int var_id, bool global, const sASTypeInfo& type, cASTNode* expr)
+{
+  int mark = m_next_temp;
+  int reg = compileExpression(expr, type);
+  m_next_temp = mark;
+  if (!m_success) return;
+
+  if (m_cur_symtbl && global) {
+    emit((type.type == TYPE(OBJECT_REF)) ? OP(GOSTORE) : OP(GSTORE), var_id, reg);
+  } else if (type.type == TYPE(OBJECT_REF)) {
+    emit(OP(OSTORE), var_id, reg);
+  } else if (reg != var_id) {
+    // Retarget the instruction that produced the temporary, rather than copying it into place
+    cASProgram::sInstruction& last = m_program->code[m_program->code.GetSize() - 1];
+    if (isTemp(reg) && last.d == reg && last.op >= OP(LOADI) && last.op != OP(OSTORE) && last.op != OP(ORELEASE) &&
+        last.op != OP(SDELETE) && last.op < OP(FRET)) {
+      last.d = var_id;
+    } else {
+      emit(OP(MOV), var_id, reg);
+    }
+  }
+}
+
+
+int cCompileASTVisitor::convert(int reg, const sASTypeInfo& from, const sASTypeInfo& to)
+{
+  if (!m_success) return -1;
+
+  if (to.type == TYPE(VOID)) {
+    // Discarded values still need their storage reclaimed
+    if (from.type == TYPE(STRING)) emit(OP(SDELETE), 0, reg);
+    else if (from.type == TYPE(OBJECT_REF)) emit(OP(ORELEASE), 0, reg);
+    return -1;
+  }
+
+  if (from.type == to.type) {
+    if (from.type == TYPE(OBJECT_REF) && from.info != to.info) {
+      fail(cString("object conversion from '") + from.info + "' to '" + to.info + "'");
+      return -1;
+    }
+    return reg;
+  }
+
+  int d = isTemp(reg) ? reg : allocTemp();
+  switch (to.type) {
+    case TYPE(BOOL):
+      if (from.type == TYPE(CHAR) || from.type == TYPE(INT)) { emit(OP(I2B), d, reg); return d; }
+      if (from.type == TYPE(FLOAT)) { emit(OP(F2B), d, reg); return d; }
+      break;
+
+    case TYPE(CHAR):
+      if (from.type == TYPE(BOOL)) return reg;
+      if (from.type == TYPE(INT)) { emit(OP(I2C), d, reg); return d; }
+      break;
+
+    case TYPE(INT):
+      if (from.type == TYPE(BOOL) || from.type == TYPE(CHAR)) return reg;
+      if (from.type == TYPE(FLOAT)) { emit(OP(F2I), d, reg); return d; }
+      break;
+
+    case TYPE(FLOAT):
+      if (from.type == TYPE(BOOL) || from.type == TYPE(CHAR) || from.type == TYPE(INT)) { emit(OP(I2F), d, reg); return d; }
+      break;
+
+    default:
+      break;
+  }
+
+  fail(cString("conversion from '") + mapType(from) + "' to '" + mapType(to) + "'");
+  return -1;
+}
+
+
+int cCompileASTVisitor::emit(cASProgram::eOpcode op, int d, int a, int b)
+{
+  if (!m_success) return -1;
+
+  m_program->code.Push(cASProgram::sInstruction(op, d, a, b));
+  m_program->lines.Push(m_line);
+  return m_program->code.GetSize() - 1;
+}
+
+
+inline int cCompileASTVisitor::allocTemp()
+{
+  int reg = m_next_temp++;
+  if (m_next_temp > m_num_registers) m_num_registers = m_next_temp;
+  return reg;
+}
+
+
+int cCompileASTVisitor::functionIndex(int fun_id)
+{
+  if (m_func_index[fun_id] < 0) {
+    m_func_index[fun_id] = m_program->functions.GetSize();
+    m_program->functions.Push(cASProgram::sFunction());
+    m_func_ids.Push(fun_id);
+  }
+  return m_func_index[fun_id];
+}
+
+
+bool cCompileASTVisitor::isSupportedType(const sASTypeInfo& type) const
+{
+  switch (type.type) {
+    case TYPE(BOOL):
+    case TYPE(CHAR):
+    case TYPE(INT):
+    case TYPE(FLOAT):
+    case TYPE(OBJECT_REF):
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+
+bool cCompileASTVisitor::isScalarType(const sASTypeInfo& type) const
+{
+  switch (type.type) {
+    case TYPE(BOOL):
+    case TYPE(CHAR):
+    case TYPE(INT):
+    case TYPE(FLOAT):
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+
+void cCompileASTVisitor::fail(const cString& reason)
+{
+  if (!m_success) return;
+
+  m_success = false;
+  m_failure = cStringUtil::Stringf("line %d: unsupported %s", m_line, (const char*)reason);
+}
+
+
+#undef OP
+#undef TOKEN
+#undef TYPE
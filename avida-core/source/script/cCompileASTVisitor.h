@@ -0,0 +1,119 @@
+/*
+ *  cCompileASTVisitor.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cCompileASTVisitor_h
+#define cCompileASTVisitor_h
+
+#include "cASProgram.h"
+#include "cASTVisitor.h"
+
+class cSymbolTable;
+
+
+// Lowers a semantically checked tree to cASProgram register bytecode.  The compiled subset covers code operating on
+// bool, char, int and float values, library function calls, native object method calls, global script functions with
+// scalar arguments, locals and return values, and foreach loops over ranges (a : b) and expansions (a ^ n).  Trees
+// that use anything else (strings beyond call arguments, arrays and dicts as values, matrices, nested functions) are
+// rejected, and should be run with cDirectInterpretASTVisitor instead.
+class cCompileASTVisitor : public cASTVisitor
+{
+private:
+  cSymbolTable* m_global_symtbl;
+  cASProgram* m_program;
+
+  bool m_success;
+  cString m_failure;
+
+  cSymbolTable* m_cur_symtbl;  // symbol table of the function being compiled, NULL at the top level
+  sASTypeInfo m_cur_rtype;
+  Apto::Array<int> m_func_index;  // program function index of each global function id, -1 until first called
+  Apto::Array<int> m_func_ids;
+
+  int m_num_vars;
+  int m_next_temp;
+  int m_num_registers;
+
+  cASTNode* m_loop_values;  // values expression of the foreach being compiled
+  int m_loop_reg;
+  sASTypeInfo m_loop_type;
+
+  sASTypeInfo m_want;   // type the current expression is being compiled for
+  sASTypeInfo m_rtype;  // type of the value produced by the last expression
+  int m_rreg;           // register holding the value produced by the last expression
+  int m_line;
+
+
+  cCompileASTVisitor(const cCompileASTVisitor&); // @not_implemented
+  cCompileASTVisitor& operator=(const cCompileASTVisitor&); // @not_implemented
+
+public:
+  cCompileASTVisitor(cSymbolTable* global_symtbl);
+  ~cCompileASTVisitor() { ; }
+
+  // Returns a newly allocated program, or NULL if the tree uses features outside of the compiled subset
+  cASProgram* Compile(cASTNode* node);
+  const cString& GetFailureReason() const { return m_failure; }
+
+  void VisitAssignment(cASTAssignment&);
+  void VisitObjectAssignment(cASTObjectAssignment&);
+  void VisitArgumentList(cASTArgumentList&);
+
+  void VisitReturnStatement(cASTReturnStatement&);
+  void VisitStatementList(cASTStatementList&);
+
+  void VisitForeachBlock(cASTForeachBlock&);
+  void VisitIfBlock(cASTIfBlock&);
+  void VisitWhileBlock(cASTWhileBlock&);
+
+  void VisitFunctionDefinition(cASTFunctionDefinition&);
+  void VisitVariableDefinition(cASTVariableDefinition&);
+  void VisitVariableDefinitionList(cASTVariableDefinitionList&);
+
+  void VisitExpressionBinary(cASTExpressionBinary&);
+  void VisitExpressionUnary(cASTExpressionUnary&);
+
+  void VisitBuiltInCall(cASTBuiltInCall&);
+  void VisitFunctionCall(cASTFunctionCall&);
+  void VisitLiteral(cASTLiteral&);
+  void VisitLiteralArray(cASTLiteralArray&);
+  void VisitLiteralDict(cASTLiteralDict&);
+  void VisitObjectCall(cASTObjectCall&);
+  void VisitObjectReference(cASTObjectReference&);
+  void VisitVariableReference(cASTVariableReference&);
+  void VisitUnpackTarget(cASTUnpackTarget&);
+
+private:
+  int compileExpression(cASTNode* node, const sASTypeInfo& want);
+  void compileFunction(int idx);
+  void compileStore(int var_id, bool global, const sASTypeInfo& type, cASTNode* expr);
+  int convert(int reg, const sASTypeInfo& from, const sASTypeInfo& to);
+
+  int emit(cASProgram::eOpcode op, int d = 0, int a = 0, int b = 0);
+  inline int allocTemp();
+  inline bool isTemp(int reg) const { return reg >= m_num_vars; }
+  inline void setResult(int reg, const sASTypeInfo& type) { m_rreg = reg; m_rtype = type; }
+
+  int functionIndex(int fun_id);
+  bool isSupportedType(const sASTypeInfo& type) const;
+  bool isScalarType(const sASTypeInfo& type) const;
+  void fail(const cString& reason);
+};
+
+#endif
@@ -1241,12 +1241,19 @@ void cDirectInterpretASTVisitor::VisitFunctionCall(cASTFunctionCall& node)
       }
     }
     
-    // Process the arguments to the function
-    tListIterator<cASTVariableDefinition> sit = func_src_symtbl->GetFunctionSignature(fun_id)->Iterator();
-    tListIterator<cASTNode> cit = node.GetArguments()->Iterator();
+    // Process the arguments to the function.  Functions without parameters have no signature, and calls may leave
+    // out trailing arguments that have default values.
+    cASTVariableDefinitionList no_sig(node.GetFilePosition());
+    cASTArgumentList no_args(node.GetFilePosition());
+    cASTVariableDefinitionList* sig = func_src_symtbl->GetFunctionSignature(fun_id);
+    cASTArgumentList* args = node.GetArguments();
+    tListIterator<cASTVariableDefinition> sit = (sig ? sig : &no_sig)->Iterator();
+    tListIterator<cASTNode> cit = (args ? args : &no_args)->Iterator();
+    int num_args = args ? args->GetSize() : 0;
     cASTVariableDefinition* arg_def = NULL;
-    while ((arg_def = sit.Next())) {
-      cASTNode* arg = cit.Next();
+    for (int i = 0; (arg_def = sit.Next()); i++) {
+      // List iterators wrap around, so stop drawing from the call once the supplied arguments are used up
+      cASTNode* arg = (i < num_args) ? cit.Next() : NULL;
       if (arg) arg->Accept(*this);
       else arg_def->GetAssignmentExpression()->Accept(*this);
       
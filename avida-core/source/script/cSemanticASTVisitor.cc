@@ -836,7 +836,7 @@ void cSemanticASTVisitor::VisitVariableReference(cASTVariableReference& node)
   bool global = false;
   if (lookupVariable(node.GetName(), var_id, global)) {
     node.SetVar(var_id, global);
-    node.SetType(m_cur_symtbl->GetVariableType(var_id));
+    node.SetType((global ? m_global_symtbl : m_cur_symtbl)->GetVariableType(var_id));
   } else {
     SEMANTIC_ERROR(VARIABLE_UNDEFINED, (const char*)node.GetName());
   }
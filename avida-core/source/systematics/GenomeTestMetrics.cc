@@ -27,8 +27,8 @@
 
 #include "cAvidaContext.h"
 #include "cHardwareManager.h"
-#include "cPhenotype.h"
 #include "cTestCPU.h"
+#include "cTestCPUCache.h"
 #include "cWorld.h"
 
 const Apto::String Avida::Systematics::GenomeTestMetrics::ObjectKey("Avida::Systematics::GenomeTestMetrics");
@@ -40,18 +40,18 @@ Avida::Systematics::GenomeTestMetrics::GenomeTestMetrics(cWorld* world, cAvidaCo
   Apto::SmartPtr<cTestCPU> testcpu(world->GetHardwareManager().CreateTestCPU(ctx));
   
   cCPUTestInfo test_info;
-  testcpu->TestGenome(ctx, test_info, Genome(g->Properties().Get("genome").StringValue()));
+  sCPUTestSummary summary;
+  testcpu->TestGenome(ctx, test_info, Genome(g->Properties().Get("genome").StringValue()), summary);
   
-  m_is_viable = test_info.IsViable();
+  m_is_viable = summary.is_viable;
   
-  cPhenotype& phenotype = test_info.GetTestPhenotype();
-  m_fitness = test_info.GetGenotypeFitness();
-  m_colony_fitness = test_info.GetColonyFitness();
-  m_merit = phenotype.GetMerit().GetDouble();
-  m_executed_size = phenotype.GetExecutedSize();
-  m_copied_size = phenotype.GetCopiedSize();
-  m_gestation_time = phenotype.GetGestationTime();
-  m_task_counts = phenotype.GetLastTaskCount();
+  m_fitness = summary.fitness;
+  m_colony_fitness = summary.colony_fitness;
+  m_merit = summary.merit;
+  m_executed_size = summary.executed_size;
+  m_copied_size = summary.copied_size;
+  m_gestation_time = summary.gestation_time;
+  m_task_counts = summary.task_counts;
 }
 
 
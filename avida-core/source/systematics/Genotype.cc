@@ -41,6 +41,7 @@ static const Apto::BasicString<Apto::ThreadSafe> s_unit_prop_name_last_metabolic
 static const Apto::BasicString<Apto::ThreadSafe> s_unit_prop_name_last_fitness("last_fitness");
 
 
+// Set up once by Genotype::Initialize(), read-only while worlds are running
 static Avida::PropertyDescriptionMap s_prop_desc_map;
 
 static const Apto::BasicString<Apto::ThreadSafe> s_prop_name_genome("genome");
@@ -389,6 +390,16 @@ void Avida::Systematics::Genotype::RemoveActiveReference() const
   if (!m_a_refs) m_mgr->AdjustGenotype(nc_this->thisPtr(), m_num_organisms, 0);
 }
 
+void Avida::Systematics::Genotype::RemovePassiveReference() const
+{
+  m_p_refs--;
+  assert(m_p_refs >= 0);
+  
+  // Historic genotypes that lose their last reference are queued for pruning at the end of the update
+  Genotype* nc_this = const_cast<Genotype*>(this);
+  if (!m_active && !m_a_refs && !m_p_refs) m_mgr->QueueForPruning(nc_this->thisPtr());
+}
+
 
 
 bool Avida::Systematics::Genotype::Matches(UnitPtr u)
@@ -36,10 +36,11 @@
 #include <cmath>
 
 
-Avida::Systematics::GenotypeArbiter::GenotypeArbiter(World* world, const RoleID& role, int threshold, bool disable_class)
+Avida::Systematics::GenotypeArbiter::GenotypeArbiter(World* world, const RoleID& role, int threshold, bool disable_class, bool record_pruned)
   : Arbiter(role)
   , m_threshold(threshold)
   , m_disable_class(disable_class)
+  , m_record_pruned(record_pruned)
   , m_active_sz(1)
   , m_coalescent(NULL)
   , m_best(0)
@@ -70,6 +71,7 @@ Avida::Systematics::GenotypeArbiter::~GenotypeArbiter()
     assert((*list_it.Get())->ActiveReferenceCount() == 0);
     removeGenotype(*list_it.Get());
   }
+  prunePending();
   
   assert(m_historic.GetSize() == 0);
   assert(m_best == 0);
@@ -98,8 +100,7 @@ void Avida::Systematics::GenotypeArbiter::PerformUpdate(Context&, Update current
     }    
   }
 
-  Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_historic.Begin());
-  while (list_it.Next() != NULL) if (!(*list_it.Get())->ReferenceCount()) removeGenotype(*list_it.Get());
+  prunePending();
 }
 
 void Avida::Systematics::GenotypeArbiter::PrintListStatus()
@@ -130,10 +131,34 @@ bool Avida::Systematics::GenotypeArbiter::LegacySave(void* dfp) const
   return true;
 }
 
+void Avida::Systematics::GenotypeArbiter::WritePrunedPhylogeny(Output::File& df) const
+{
+  for (int i = 0; i < m_pruned.GetSize(); i++) {
+    const PrunedGenotype& entry = m_pruned[i];
+    
+    Apto::String parents;
+    for (int p = 0; p < entry.num_parents; p++) {
+      if (p) parents += ",";
+      parents += Apto::AsStr(m_pruned_parents[entry.parents_begin + p]);
+    }
+    
+    df.Write(entry.id, "ID", "id");
+    df.Write((parents.GetSize()) ? (const char*)parents : "(none)", "Parent ID(s)", "parents");
+    df.Write(entry.total_units, "Total number of organisms that ever existed", "total_units");
+    df.Write(entry.update_born, "Update Born", "update_born");
+    df.Write(entry.update_deactivated, "Update Deactivated", "update_deactivated");
+    df.Write(entry.depth, "Phylogenetic Depth", "depth");
+    df.Endl();
+  }
+}
+
 Avida::Systematics::GroupPtr Avida::Systematics::GenotypeArbiter::LegacyLoad(void* props)
 {
   GenotypePtr g(new Genotype(thisPtr(), m_next_id++, props));
   m_historic.Push(g, &g->m_handle);
+  
+  // Loaded genotypes that nothing ends up referencing are pruned at the end of the update
+  QueueForPruning(g);
   return g;
 }
 
@@ -518,7 +543,8 @@ void Avida::Systematics::GenotypeArbiter::removeGenotype(GenotypePtr genotype)
     
   const Apto::Array<GenotypePtr>& parents = genotype->Parents();
   for (int i = 0; i < parents.GetSize(); i++) {
-    parents[i]->RemovePassiveReference();
+    // Released directly, rather than through Genotype::RemovePassiveReference, since defunct parents are removed below
+    parents[i]->Group::RemovePassiveReference();
     updateCoalescent();
     
     // Pre-check for active genotypes to avoid recursion costs
@@ -530,6 +556,33 @@ void Avida::Systematics::GenotypeArbiter::removeGenotype(GenotypePtr genotype)
   
   delete genotype->m_handle;
   genotype->m_handle = NULL;
+  
+  if (m_record_pruned) recordPruned(genotype);
+}
+
+void Avida::Systematics::GenotypeArbiter::prunePending()
+{
+  // Entries may have been reactivated, re-referenced or already removed (along with a descendant) since being queued
+  for (int i = 0; i < m_prune_queue.GetSize(); i++) {
+    GenotypePtr genotype = m_prune_queue[i];
+    if (genotype->m_handle && !genotype->IsActive() && !genotype->ReferenceCount()) removeGenotype(genotype);
+  }
+  m_prune_queue.Resize(0);
+}
+
+void Avida::Systematics::GenotypeArbiter::recordPruned(GenotypePtr genotype)
+{
+  PrunedGenotype entry;
+  entry.id = genotype->ID();
+  entry.parents_begin = m_pruned_parents.GetSize();
+  entry.num_parents = genotype->m_parents.GetSize();
+  entry.update_born = genotype->m_update_born;
+  entry.update_deactivated = genotype->m_update_deactivated;
+  entry.depth = genotype->m_depth;
+  entry.total_units = genotype->m_total_organisms;
+  
+  for (int i = 0; i < entry.num_parents; i++) m_pruned_parents.Push(genotype->m_parents[i]->ID());
+  m_pruned.Push(entry);
 }
 
 void Avida::Systematics::GenotypeArbiter::updateCoalescent()
@@ -0,0 +1,304 @@
+/*
+ *  main.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AvidaTools.h"
+
+#include "apto/core/FileSystem.h"
+#include "avida/Avida.h"
+#include "avida/core/World.h"
+#include "avida/util/CmdLine.h"
+
+#include "cAvidaConfig.h"
+#include "cAvidaContext.h"
+#include "cPerfTimers.h"
+#include "cStats.h"
+#include "cUserFeedback.h"
+#include "cWorld.h"
+
+#include "../avida/Avida2Driver.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+
+// Measurements of one workload run, as reported and as kept in a baseline file
+struct sBenchResult
+{
+  cString name;
+  double wall;
+  int updates;
+  double instructions;
+  double births;
+  Apto::Array<cString> timer_names;
+  Apto::Array<double> timer_secs;
+  Apto::Array<double> timer_calls;
+  
+  sBenchResult() : wall(0.0), updates(0), instructions(0.0), births(0.0) { ; }
+  
+  double Rate(double count) const { return (wall > 0.0) ? count / wall : 0.0; }
+  int FindTimer(const cString& timer_name) const
+  {
+    for (int i = 0; i < timer_names.GetSize(); i++) if (timer_names[i] == timer_name) return i;
+    return -1;
+  }
+};
+
+
+static void printUsage(const char* app)
+{
+  cout << "Usage: " << app << " [bench options] [avida options]" << endl
+  << "Runs the configuration in the current directory like avida, and reports its throughput along with the wall time" << endl
+  << "spent in each subsystem." << endl << endl
+  << "Bench options:" << endl
+  << "  -bench-name <name>       Name of the workload, used in reports and baselines" << endl
+  << "  -bench-baseline <file>   Compare the run against a baseline saved earlier" << endl
+  << "  -bench-save <file>       Save the run as a baseline" << endl
+  << "  -bench-margin <fraction> Slow down tolerated before the comparison fails (default 0.05)" << endl
+  << endl << "Any other options are passed on to avida, see -h." << endl;
+}
+
+
+static bool saveBaseline(const sBenchResult& result, const cString& filename)
+{
+  ofstream fp((const char*)filename);
+  if (!fp.good()) return false;
+  
+  fp << "# avida-bench baseline" << endl;
+  fp << setprecision(12);
+  fp << "workload " << result.name << endl;
+  fp << "wall " << result.wall << endl;
+  fp << "updates " << result.updates << endl;
+  fp << "instructions " << result.instructions << endl;
+  fp << "births " << result.births << endl;
+  for (int i = 0; i < result.timer_names.GetSize(); i++) {
+    fp << "timer " << result.timer_names[i] << " " << result.timer_secs[i] << " " << result.timer_calls[i] << endl;
+  }
+  return fp.good();
+}
+
+
+static bool loadBaseline(sBenchResult& result, const cString& filename)
+{
+  ifstream fp((const char*)filename);
+  if (!fp.good()) return false;
+  
+  string raw;
+  while (getline(fp, raw)) {
+    cString line(raw.c_str());
+    line.Trim();
+    if (line.GetSize() == 0 || line[0] == '#') continue;
+    
+    cString key = line.PopWord();
+    if (key == "workload") result.name = line.PopWord();
+    else if (key == "wall") result.wall = line.PopWord().AsDouble();
+    else if (key == "updates") result.updates = line.PopWord().AsInt();
+    else if (key == "instructions") result.instructions = line.PopWord().AsDouble();
+    else if (key == "births") result.births = line.PopWord().AsDouble();
+    else if (key == "timer") {
+      result.timer_names.Push(line.PopWord());
+      result.timer_secs.Push(line.PopWord().AsDouble());
+      result.timer_calls.Push(line.PopWord().AsDouble());
+    }
+  }
+  return true;
+}
+
+
+static void printReport(const sBenchResult& result)
+{
+  cout.setf(ios::fixed);
+  cout << endl << "Benchmark: " << result.name << endl;
+  cout << "  wall time     " << setw(14) << setprecision(3) << result.wall << " s" << endl;
+  cout << "  updates       " << setw(14) << result.updates
+       << setw(14) << setprecision(2) << result.Rate(result.updates) << " /s" << endl;
+  cout << "  instructions  " << setw(14) << setprecision(0) << result.instructions
+       << setw(14) << setprecision(2) << result.Rate(result.instructions) << " /s" << endl;
+  cout << "  births        " << setw(14) << setprecision(0) << result.births
+       << setw(14) << setprecision(2) << result.Rate(result.births) << " /s" << endl;
+  
+  cout << endl << "  " << left << setw(28) << "timer" << right << setw(12) << "seconds" << setw(12) << "calls"
+       << setw(10) << "% wall" << endl;
+  for (int i = 0; i < result.timer_names.GetSize(); i++) {
+    if (result.timer_calls[i] == 0.0) continue;
+    cout << "  " << left << setw(28) << result.timer_names[i] << right
+         << setw(12) << setprecision(3) << result.timer_secs[i]
+         << setw(12) << setprecision(0) << result.timer_calls[i]
+         << setw(10) << setprecision(1) << ((result.wall > 0.0) ? 100.0 * result.timer_secs[i] / result.wall : 0.0)
+         << endl;
+  }
+}
+
+
+// Prints the run against the baseline, returns false if the run is slower than the baseline by more than margin
+static bool compareBaseline(const sBenchResult& result, const sBenchResult& base, double margin)
+{
+  cout << endl << "Baseline comparison (margin " << setprecision(1) << (margin * 100.0) << "%):" << endl;
+  if (result.updates != base.updates) {
+    cout << "  baseline ran " << base.updates << " updates, this run " << result.updates
+         << ", the workload has changed; skipping comparison" << endl;
+    return true;
+  }
+  
+  cout << "  " << left << setw(28) << "" << right << setw(14) << "baseline" << setw(14) << "this run" << setw(8) << "ratio"
+       << endl;
+  
+  bool passed = true;
+  
+  // Throughput, higher is better
+  const char* rate_names[] = { "inst/s", "births/s" };
+  const double rates[] = { result.Rate(result.instructions), result.Rate(result.births) };
+  const double base_rates[] = { base.Rate(base.instructions), base.Rate(base.births) };
+  for (int i = 0; i < 2; i++) {
+    if (base_rates[i] <= 0.0) continue;
+    const double ratio = rates[i] / base_rates[i];
+    const bool ok = (ratio >= 1.0 - margin);
+    if (!ok) passed = false;
+    cout << "  " << left << setw(28) << rate_names[i] << right << setw(14) << setprecision(2) << base_rates[i]
+         << setw(14) << rates[i] << setw(8) << setprecision(3) << ratio << (ok ? "" : "  SLOWER") << endl;
+  }
+  
+  // Wall time, lower is better
+  {
+    const double ratio = (base.wall > 0.0) ? result.wall / base.wall : 1.0;
+    const bool ok = (ratio <= 1.0 + margin);
+    if (!ok) passed = false;
+    cout << "  " << left << setw(28) << "wall" << right << setw(14) << setprecision(3) << base.wall
+         << setw(14) << result.wall << setw(8) << ratio << (ok ? "" : "  SLOWER") << endl;
+  }
+  
+  // Subsystems, for locating a slow down rather than judging the run
+  for (int i = 0; i < result.timer_names.GetSize(); i++) {
+    const int base_idx = base.FindTimer(result.timer_names[i]);
+    if (base_idx < 0 || base.timer_secs[base_idx] <= 0.0) continue;
+    cout << "  " << left << setw(28) << result.timer_names[i] << right
+         << setw(14) << setprecision(3) << base.timer_secs[base_idx] << setw(14) << result.timer_secs[i]
+         << setw(8) << (result.timer_secs[i] / base.timer_secs[base_idx]) << endl;
+  }
+  
+  cout << (passed ? "  passed" : "  FAILED") << endl;
+  return passed;
+}
+
+
+int main(int argc, char * argv[])
+{
+  Avida::Initialize();
+  
+  cout << Avida::Version::Banner() << endl;
+  
+  // Pull out the bench options, everything else is handled by the standard avida command line processing
+  cString bench_name("benchmark");
+  cString baseline_file;
+  cString save_file;
+  double margin = 0.05;
+  
+  Apto::Array<char*> avida_args;
+  avida_args.Push(argv[0]);
+  for (int i = 1; i < argc; i++) {
+    cString cur_arg(argv[i]);
+    const bool has_value = (i + 1 < argc);
+    if (cur_arg == "-bench-help") {
+      printUsage(argv[0]);
+      return 0;
+    } else if (cur_arg == "-bench-name" && has_value) {
+      bench_name = argv[++i];
+    } else if (cur_arg == "-bench-baseline" && has_value) {
+      baseline_file = argv[++i];
+    } else if (cur_arg == "-bench-save" && has_value) {
+      save_file = argv[++i];
+    } else if (cur_arg == "-bench-margin" && has_value) {
+      margin = cString(argv[++i]).AsDouble();
+    } else if (cur_arg.GetSize() >= 7 && cur_arg.Substring(0, 7) == "-bench-") {
+      cerr << "error: unknown or incomplete bench option '" << cur_arg << "', see -bench-help" << endl;
+      return -1;
+    } else {
+      avida_args.Push(argv[i]);
+    }
+  }
+  
+  // Initialize the configuration data...
+  Apto::Map<Apto::String, Apto::String> defs;
+  cAvidaConfig* cfg = new cAvidaConfig();
+  Avida::Util::ProcessCmdLineArgs(avida_args.GetSize(), &avida_args[0], cfg, defs);
+  
+  cUserFeedback feedback;
+  Avida::World* new_world = new Avida::World();
+  cWorld* world = cWorld::Initialize(cfg, cString(Apto::FileSystem::GetCWD()), new_world, &feedback, &defs);
+  
+  for (int i = 0; i < feedback.GetNumMessages(); i++) {
+    switch (feedback.GetMessageType(i)) {
+      case cUserFeedback::UF_ERROR:    cerr << "error: "; break;
+      case cUserFeedback::UF_WARNING:  cerr << "warning: "; break;
+      default: break;
+    };
+    cerr << feedback.GetMessage(i) << endl;
+  }
+  
+  if (!world) return -1;
+  
+  // Timers go on the default context only, analyze worker threads run with contexts of their own and are not timed
+  cPerfTimers timers;
+  world->GetDefaultContext().SetPerfTimers(&timers);
+  
+  Avida2Driver* driver = new Avida2Driver(world, new_world);
+  const long long start = cPerfTimers::Now();
+  driver->Run();
+  
+  sBenchResult result;
+  result.name = bench_name;
+  result.wall = (double)(cPerfTimers::Now() - start) * 1.0e-9;
+  result.updates = world->GetStats().GetUpdate();
+  result.instructions = world->GetStats().GetTotExecuted();
+  result.births = world->GetStats().GetCumulativeBirths();
+  for (int i = 0; i < timers.GetNumTimers(); i++) {
+    result.timer_names.Push(timers.GetName(i));
+    result.timer_secs.Push((double)timers.GetNanoseconds(i) * 1.0e-9);
+    result.timer_calls.Push((double)timers.GetCalls(i));
+  }
+  
+  world->GetDefaultContext().SetPerfTimers(NULL);
+  delete driver;
+  
+  printReport(result);
+  
+  bool passed = true;
+  if (baseline_file.GetSize()) {
+    sBenchResult base;
+    if (!loadBaseline(base, baseline_file)) {
+      cerr << "error: unable to read baseline '" << baseline_file << "'" << endl;
+      return -1;
+    }
+    passed = compareBaseline(result, base, margin);
+  }
+  
+  if (save_file.GetSize()) {
+    if (!saveBaseline(result, save_file)) {
+      cerr << "error: unable to write baseline '" << save_file << "'" << endl;
+      return -1;
+    }
+    cout << endl << "Baseline saved to " << save_file << endl;
+  }
+  
+  return (passed) ? 0 : 1;
+}
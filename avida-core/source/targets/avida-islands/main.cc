@@ -0,0 +1,150 @@
+/*
+ *  main.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AvidaTools.h"
+
+#include "apto/core/FileSystem.h"
+#include "apto/core/Thread.h"
+#include "avida/Avida.h"
+#include "avida/core/World.h"
+#include "avida/util/CmdLine.h"
+
+#include "cAvidaConfig.h"
+#include "cIslandUniverse.h"
+#include "cIslandWorld.h"
+#include "cMigrationMatrix.h"
+#include "cStringUtil.h"
+#include "cUserFeedback.h"
+
+#include "../avida/Avida2Driver.h"
+
+#include <iostream>
+
+using namespace std;
+
+
+class cIslandThread : public Apto::Thread
+{
+private:
+  Avida2Driver* m_driver;
+  
+  void Run() { m_driver->Run(); }
+  
+public:
+  cIslandThread(Avida2Driver* driver) : m_driver(driver) { ; }
+};
+
+
+static void printFeedback(cUserFeedback& feedback, int island_id)
+{
+  for (int i = 0; i < feedback.GetNumMessages(); i++) {
+    if (island_id >= 0) cerr << "[island " << island_id << "] ";
+    switch (feedback.GetMessageType(i)) {
+      case cUserFeedback::UF_ERROR:    cerr << "error: "; break;
+      case cUserFeedback::UF_WARNING:  cerr << "warning: "; break;
+      default: break;
+    };
+    cerr << feedback.GetMessage(i) << endl;
+  }
+}
+
+
+int main(int argc, char * argv[])
+{
+  // Sets up the shared instruction libraries and property tables, which must happen before any island thread starts
+  Avida::Initialize();
+  
+  cout << Avida::Version::Banner() << endl;
+  
+  // Initialize the configuration data...
+  Apto::Map<Apto::String, Apto::String> defs;
+  cAvidaConfig* cfg = new cAvidaConfig();
+  Avida::Util::ProcessCmdLineArgs(argc, argv, cfg, defs);
+  
+  if (cfg->ANALYZE_MODE.Get() > 0) {
+    cerr << "error: analyze mode is not supported by avida-islands, use avida instead" << endl;
+    return -1;
+  }
+  
+  const int num_islands = cfg->MP_ISLAND_COUNT.Get();
+  if (num_islands < 1) {
+    cerr << "error: MP_ISLAND_COUNT must be at least 1" << endl;
+    return -1;
+  }
+  
+  const cString working_dir(Apto::FileSystem::GetCWD());
+  const int base_seed = cfg->RANDOM_SEED.Get();
+  const cString base_data_dir = cfg->DATA_DIR.Get();
+  
+  // Topology between islands, shared by all of them
+  cMigrationMatrix* topology = NULL;
+  if (cfg->MP_ISLAND_MIGRATION_FILE.Get() != "-") {
+    cUserFeedback feedback;
+    topology = new cMigrationMatrix();
+    if (!topology->Load(num_islands, cfg->MP_ISLAND_MIGRATION_FILE.Get(), working_dir, false, true, false, feedback)) {
+      printFeedback(feedback, -1);
+      return -1;
+    }
+  }
+  
+  cIslandUniverse universe(num_islands);
+  Apto::Array<Avida2Driver*> drivers(num_islands);
+  
+  for (int i = 0; i < num_islands; i++) {
+    // Every island owns its configuration, so islands after the first re-read it
+    if (i > 0) {
+      cfg = new cAvidaConfig();
+      Avida::Util::ProcessCmdLineArgs(argc, argv, cfg, defs);
+      cfg->VERBOSITY.Set(VERBOSE_SILENT);
+    }
+    
+    // As with avida-mp, islands get offset seeds and their own data directories
+    cfg->ENABLE_MP.Set(1);
+    if (base_seed > 0) cfg->RANDOM_SEED.Set(base_seed + i);
+    cfg->DATA_DIR.Set(cStringUtil::Stringf("%s_%d", (const char*)base_data_dir, i));
+    
+    cUserFeedback feedback;
+    Avida::World* new_world = new Avida::World();
+    cWorld* world = cIslandWorld::Initialize(cfg, working_dir, new_world, &universe, topology, i, &feedback, &defs);
+    printFeedback(feedback, i);
+    if (!world) return -1;
+    
+    drivers[i] = new Avida2Driver(world, new_world);
+  }
+  
+  cout << "Islands: " << num_islands << endl;
+  cout << "Random Seed: " << base_seed << endl;
+  cout << endl;
+  
+  Apto::Array<cIslandThread*> threads(num_islands);
+  for (int i = 0; i < num_islands; i++) {
+    threads[i] = new cIslandThread(drivers[i]);
+    threads[i]->Start();
+  }
+  for (int i = 0; i < num_islands; i++) {
+    threads[i]->Join();
+    delete threads[i];
+    delete drivers[i];
+  }
+  
+  delete topology;
+  
+  return 0;
+}
@@ -27,6 +27,8 @@
 #include "ASAnalyzeLib.h"
 
 #include "cASLibrary.h"
+#include "cASVirtualMachine.h"
+#include "cCompileASTVisitor.h"
 #include "cDirectInterpretASTVisitor.h"
 #include "cDumpASTVisitor.h"
 #include "cFile.h"
@@ -34,7 +36,9 @@
 #include "cSemanticASTVisitor.h"
 #include "cSymbolTable.h"
 
+#include <cstring>
 #include <iostream>
+#include <sstream>
 
 
 int main (int argc, char * const argv[])
@@ -69,6 +73,54 @@ int main (int argc, char * const argv[])
         exit(AS_EXIT_FAIL_SEMANTIC);
       }
       
+      // Run compiled bytecode when the script is within the compiled subset, otherwise interpret the tree directly
+      cCompileASTVisitor compiler(&global_symtbl);
+      cASProgram* program = compiler.Compile(tree);
+      
+      // --compare runs the script through both paths and requires identical output and exit codes
+      if (argc > 1 && strcmp(argv[1], "--compare") == 0) {
+        if (!program) {
+          std::cerr << "error: script cannot be compiled: " << compiler.GetFailureReason() << std::endl;
+          exit(AS_EXIT_INTERNAL_ERROR);
+        }
+        
+        std::streambuf* cout_buf = std::cout.rdbuf();
+        std::ostringstream vm_out;
+        std::cout.rdbuf(vm_out.rdbuf());
+        int vm_exit = 0;
+        {
+          cASVirtualMachine vm(program);
+          vm_exit = vm.Execute();
+        }
+        delete program;
+        
+        std::ostringstream interp_out;
+        std::cout.rdbuf(interp_out.rdbuf());
+        cDirectInterpretASTVisitor interpeter(&global_symtbl);
+        int interp_exit = interpeter.Interpret(tree);
+        std::cout.rdbuf(cout_buf);
+        
+        std::cout << interp_out.str();
+        if (vm_exit != interp_exit || vm_out.str() != interp_out.str()) {
+          std::cerr << "error: bytecode run differs from interpreter (exit " << vm_exit << " vs " << interp_exit << ")"
+                    << std::endl << vm_out.str();
+          exit(AS_EXIT_INTERNAL_ERROR);
+        }
+        
+        exit(interp_exit);
+      }
+      
+      if (program) {
+        int exit_code = 0;
+        {
+          cASVirtualMachine vm(program);
+          exit_code = vm.Execute();
+        }
+        delete program;
+        
+        exit(exit_code);
+      }
+      
       cDirectInterpretASTVisitor interpeter(&global_symtbl);
       int exit_code = interpeter.Interpret(tree);
       
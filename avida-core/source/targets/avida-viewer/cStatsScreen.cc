@@ -18,6 +18,16 @@
 using namespace std;
 
 
+cStatsScreen::cStatsScreen(cWorld* world, int y_size, int x_size, int y_start, int x_start, cViewInfo& in_info)
+  : cScreen(y_size, x_size, y_start, x_start, in_info), m_world(world), task_offset(0)
+{
+  task_rows = Height() - 16;
+  task_cols = Width() / 20;
+
+  // The task grid is drawn from the per-update task counts
+  m_world->GetStats().RequireOrgStats(cStats::ORG_STATS_TASKS);
+}
+
 void cStatsScreen::Draw(cAvidaContext& ctx)
 {
   SetBoldColor(COLOR_WHITE);
@@ -20,12 +20,7 @@ protected:
   int task_rows;
   int task_cols;
 public:
-  cStatsScreen(cWorld* world, int y_size, int x_size, int y_start, int x_start, cViewInfo& in_info)
-    : cScreen(y_size, x_size, y_start, x_start, in_info), m_world(world), task_offset(0)
-  {
-    task_rows = Height() - 16;
-    task_cols = Width() / 20;
-  }
+  cStatsScreen(cWorld* world, int y_size, int x_size, int y_start, int x_start, cViewInfo& in_info);
   virtual ~cStatsScreen() { ; }
 
   // Virtual in base screen...
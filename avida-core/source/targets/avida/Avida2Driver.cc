@@ -33,6 +33,7 @@
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
 #include "cOrganism.h"
+#include "cPerfTimers.h"
 #include "cPopulation.h"
 #include "cPopulationCell.h"
 #include "cStats.h"
@@ -87,19 +88,27 @@ void Avida2Driver::Run()
   
   cAvidaContext& ctx = m_world->GetDefaultContext();
   Avida::Context new_ctx(this, &m_world->GetRandom());
+  cPerfTimers* perf = ctx.GetPerfTimers();
   
   while (!m_done) {
-    m_world->GetEvents(ctx);
+    {
+      cScopedTimer timer(perf, cPerfTimers::PERF_EVENTS);
+      m_world->GetEvents(ctx);
+    }
     if(m_done == true) break;
     
     // Increment the Update.
     stats.IncCurrentUpdate();
     
-    population.ProcessPreUpdate();
+    {
+      cScopedTimer timer(perf, cPerfTimers::PERF_RESOURCES);
+      population.ProcessPreUpdate();
+    }
 
     // Handle all data collection for previous update.
     if (stats.GetUpdate() > 0) {
       // Tell the stats object to do update calculations and printing.
+      cScopedTimer timer(perf, cPerfTimers::PERF_STATS);
       stats.ProcessUpdate();
     }
     
@@ -108,17 +117,22 @@ void Avida2Driver::Run()
     const int UD_size = m_world->CalculateUpdateSize();
     const double step_size = 1.0 / (double) UD_size;
     
-    for (int i = 0; i < UD_size; i++) {
-      if(population.GetNumOrganisms() == 0) {
-        break;
+    {
+      cScopedTimer timer(perf, cPerfTimers::PERF_EXECUTE);
+      for (int i = 0; i < UD_size; i++) {
+        if(population.GetNumOrganisms() == 0) {
+          break;
+        }
+        (population.*ActiveProcessStep)(ctx, step_size, population.ScheduleOrganism());
       }
-      (population.*ActiveProcessStep)(ctx, step_size, population.ScheduleOrganism());
     }
     
     // end of update stats...
-    population.ProcessPostUpdate(ctx);
-    
-		m_world->ProcessPostUpdate(ctx);
+    {
+      cScopedTimer timer(perf, cPerfTimers::PERF_POST_UPDATE);
+      population.ProcessPostUpdate(ctx);
+      m_world->ProcessPostUpdate(ctx);
+    }
         
     // No viewer; print out status for this update....
     if (m_world->GetVerbosity() > VERBOSE_SILENT) {
@@ -153,13 +167,18 @@ void Avida2Driver::Run()
       }
     }
     
-    m_new_world->PerformUpdate(new_ctx, stats.GetUpdate());
+    {
+      cScopedTimer timer(perf, cPerfTimers::PERF_WORLD_FACETS);
+      m_new_world->PerformUpdate(new_ctx, stats.GetUpdate());
+    }
     
     // Exit conditons...
     if((population.GetNumOrganisms()==0) && m_world->AllowsEarlyExit()) {
 			m_done = true;
 		}
   }
+  
+  m_world->ProcessFinish(ctx);
 }
 
 void Avida2Driver::Abort(Avida::AbortCondition condition)
@@ -22,6 +22,15 @@
 #include <iostream>
 #include <iomanip>
 
+#include "apto/core/FileSystem.h"
+#include "avida/Avida.h"
+#include "avida/core/World.h"
+#include "avida/private/util/GenomeLoader.h"
+
+#include "cAvidaConfig.h"
+#include "cUserFeedback.h"
+#include "cWorld.h"
+
 using namespace std;
 
 
@@ -49,6 +58,37 @@ public:
   inline int GetFailed() { return m_failed; }
 };
 
+// Builds a world from the default configuration in support/config, with the given settings overridden.  Output files
+// go to unit-test-data under the current directory.
+static cWorld* CreateTestWorld(Apto::Map<Apto::String, Apto::String> sets = Apto::Map<Apto::String, Apto::String>())
+{
+  cUserFeedback feedback;
+  cAvidaConfig* cfg = new cAvidaConfig();
+  cfg->Load("avida.cfg", AVD_UNIT_TESTS_CONFIG_DIR, &feedback, NULL, false);
+  if (!sets.Has("RANDOM_SEED")) sets["RANDOM_SEED"] = "101";
+  sets["DATA_DIR"] = Apto::FileSystem::PathAppend(Apto::FileSystem::GetCWD(), "unit-test-data");
+  cfg->Set(sets);
+  
+  cWorld* world = cWorld::Initialize(cfg, AVD_UNIT_TESTS_CONFIG_DIR, new Avida::World(), &feedback, NULL);
+  for (int i = 0; i < feedback.GetNumMessages(); i++) {
+    if (feedback.GetMessageType(i) == cUserFeedback::UF_ERROR) cerr << "error: " << feedback.GetMessage(i) << endl;
+  }
+  return world;
+}
+
+static Avida::GenomePtr LoadTestGenome(cWorld* world, const cString& filename)
+{
+  cUserFeedback feedback;
+  return Avida::Util::LoadGenomeDetailFile(filename, AVD_UNIT_TESTS_CONFIG_DIR, world->GetHardwareManager(), feedback);
+}
+
+template <class T> static bool SameArray(const Apto::Array<T>& a, const Apto::Array<T>& b)
+{
+  if (a.GetSize() != b.GetSize()) return false;
+  for (int i = 0; i < a.GetSize(); i++) if (!(a[i] == b[i])) return false;
+  return true;
+}
+
 
 
 #include "cBitArray.h"
@@ -313,6 +353,1287 @@ protected:
 
 
 
+#include "apto/core/Thread.h"
+#include "cIslandUniverse.h"
+class cIslandUniverseTests : public cUnitTest
+{
+private:
+  enum { NUM_ISLANDS = 3, NUM_UPDATES = 20 };
+  
+  // Each island sends (update + island + 1) migrants per update to every island (itself included), tagged with
+  // their origin, and records the order in which migrants arrive.  An island may instead finish early, as on Exit.
+  class cIsland : public Apto::Thread
+  {
+  private:
+    cIslandUniverse* m_universe;
+    int m_id;
+    int m_finish_at;
+    
+    void Run()
+    {
+      for (int update = 0; update < NUM_UPDATES; update++) {
+        if (update == m_finish_at) {
+          Apto::Array<cIslandUniverse::sMigrant, Apto::Smart> arrivals;
+          finished = true;
+          m_universe->Exchange(m_id, 0, arrivals, finished);
+          return;
+        }
+        for (int dst = 0; dst < NUM_ISLANDS; dst++) {
+          for (int i = 0; i < update + m_id + 1; i++) {
+            cIslandUniverse::sMigrant migrant;
+            migrant.lineage = m_id;
+            migrant.generation = update;
+            migrant.merit = i;
+            m_universe->SendMigrant(m_id, dst, migrant);
+          }
+        }
+        Apto::Array<cIslandUniverse::sMigrant, Apto::Smart> arrivals;
+        const int universe_pop = m_universe->Exchange(m_id, 0, arrivals, finished);
+        census.Push(universe_pop);
+        for (int i = 0; i < arrivals.GetSize(); i++) received.Push(arrivals[i]);
+        if (finished) return;
+      }
+    }
+    
+  public:
+    Apto::Array<cIslandUniverse::sMigrant, Apto::Smart> received;
+    Apto::Array<int, Apto::Smart> census;
+    bool finished;
+    
+    cIsland(cIslandUniverse* universe, int island_id, int finish_at = -1)
+      : m_universe(universe), m_id(island_id), m_finish_at(finish_at), finished(false) { ; }
+  };
+  
+public:
+  const char* GetUnitName() { return "cIslandUniverse"; }
+protected:
+  void RunTests()
+  {
+    cIslandUniverse universe(NUM_ISLANDS);
+    
+    Apto::Array<cIsland*> islands(NUM_ISLANDS);
+    for (int i = 0; i < NUM_ISLANDS; i++) islands[i] = new cIsland(&universe, i);
+    for (int i = 0; i < NUM_ISLANDS; i++) islands[i]->Start();
+    for (int i = 0; i < NUM_ISLANDS; i++) islands[i]->Join();
+    
+    // Arrivals must be grouped by update, then by source island, then in send order
+    bool ordered = true;
+    for (int i = 0; i < NUM_ISLANDS && ordered; i++) {
+      int idx = 0;
+      for (int update = 0; update < NUM_UPDATES && ordered; update++) {
+        for (int src = 0; src < NUM_ISLANDS && ordered; src++) {
+          for (int m = 0; m < update + src + 1; m++, idx++) {
+            if (idx >= islands[i]->received.GetSize()) { ordered = false; break; }
+            const cIslandUniverse::sMigrant& migrant = islands[i]->received[idx];
+            if (migrant.lineage != src || migrant.generation != update || migrant.merit != m) { ordered = false; break; }
+          }
+        }
+      }
+      if (idx != islands[i]->received.GetSize()) ordered = false;
+    }
+    ReportTestResult("Deterministic Delivery Order", ordered);
+    
+    bool census = true;
+    for (int i = 0; i < NUM_ISLANDS; i++) {
+      for (int update = 0; update < NUM_UPDATES; update++) {
+        int expected = 0;
+        for (int src = 0; src < NUM_ISLANDS; src++) expected += NUM_ISLANDS * (update + src + 1);
+        if (islands[i]->census[update] != expected) census = false;
+      }
+    }
+    ReportTestResult("Universe Census", census);
+    
+    for (int i = 0; i < NUM_ISLANDS; i++) delete islands[i];
+    
+    // One island finishing releases the others from the barrier, and they all stop after the same update
+    const int finish_at = 5;
+    cIslandUniverse exiting(NUM_ISLANDS);
+    for (int i = 0; i < NUM_ISLANDS; i++) islands[i] = new cIsland(&exiting, i, (i == 1) ? finish_at : -1);
+    for (int i = 0; i < NUM_ISLANDS; i++) islands[i]->Start();
+    for (int i = 0; i < NUM_ISLANDS; i++) islands[i]->Join();
+    bool stopped = islands[1]->census.GetSize() == finish_at;
+    for (int i = 0; i < NUM_ISLANDS; i++) {
+      if (!islands[i]->finished || (i != 1 && islands[i]->census.GetSize() != finish_at + 1)) stopped = false;
+    }
+    ReportTestResult("Finished Island Stops All", stopped);
+    
+    for (int i = 0; i < NUM_ISLANDS; i++) delete islands[i];
+  }
+};
+
+
+
+
+#include "cGridSnapshot.h"
+#include <sstream>
+class cGridSnapshotTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cGridSnapshot"; }
+protected:
+  void RunTests()
+  {
+    const int world_x = 7;
+    const int world_y = 5;
+    cGridSnapshot grid(world_x, world_y, 42);
+    const int ids = grid.AddLayer("genotype_id", cGridSnapshot::LAYER_INT);
+    const int fit = grid.AddLayer("fitness", cGridSnapshot::LAYER_DOUBLE);
+    for (int i = 0; i < world_x * world_y; i++) {
+      grid.SetInt(ids, i, (i % 3 == 0) ? -1 : i * 100000);
+      grid.SetDouble(fit, i, (i < 20) ? 0.0 : 1.0 / (i + 1));
+    }
+    
+    std::stringstream data;
+    grid.Save(data);
+    cGridSnapshot loaded;
+    bool result = loaded.Load(data);
+    result = result && loaded.GetWorldX() == world_x && loaded.GetWorldY() == world_y && loaded.GetUpdate() == 42;
+    result = result && loaded.GetNumLayers() == 2 && loaded.FindLayer("fitness") == fit;
+    for (int i = 0; result && i < world_x * world_y; i++) {
+      if (loaded.GetInt(ids, i) != grid.GetInt(ids, i) || loaded.GetDouble(fit, i) != grid.GetDouble(fit, i)) result = false;
+    }
+    ReportTestResult("Binary Round Trip", result);
+    
+    std::string truncated = data.str().substr(0, data.str().size() - 1);
+    std::istringstream short_data(truncated);
+    ReportTestResult("Truncated File Rejected", !loaded.Load(short_data));
+    
+    std::istringstream same_world(data.str()), other_world(data.str());
+    ReportTestResult("World Size Checked", loaded.Load(same_world, world_x, world_y) &&
+                     !loaded.Load(other_world, world_x, world_y + 1));
+    
+    // 2^20 x 2^20 cells, which cannot be counted in an int
+    const char huge_header[] = { 'A', 'G', 'R', 'D', 1, '\x80', '\x80', 0x40, '\x80', '\x80', 0x40, 0, 0 };
+    std::istringstream huge_data(std::string(huge_header, sizeof(huge_header)));
+    ReportTestResult("Overflowing World Rejected", !loaded.Load(huge_data));
+    
+    cGridSnapshot small(3, 2);
+    const int cells = small.AddLayer("cells", cGridSnapshot::LAYER_INT);
+    for (int i = 0; i < 6; i++) small.SetInt(cells, i, i);
+    std::ostringstream rows, cols;
+    small.WriteText(cells, rows);
+    small.WriteText(cells, cols, true);
+    ReportTestResult("Text Layout", rows.str() == "0 1 2 \n3 4 5 \n" && cols.str() == "0 3 \n1 4 \n2 5 \n");
+  }
+};
+
+
+
+
+#include "cCPUTestInfo.h"
+#include "cHardwareManager.h"
+#include "cTestCPU.h"
+#include "cTestCPUCache.h"
+class cTestCPUCacheTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cTestCPUCache"; }
+protected:
+  void RunTests()
+  {
+    Apto::Map<Apto::String, Apto::String> sets;
+    sets["TEST_CPU_CACHE_SIZE"] = "16";
+    cWorld* world = CreateTestWorld(sets);
+    if (!world) { ReportTestResult("World Setup", false); return; }
+    
+    cAvidaContext& ctx = world->GetDefaultContext();
+    Avida::GenomePtr genome = LoadTestGenome(world, "default-heads.org");
+    cTestCPU* testcpu = world->GetHardwareManager().CreateTestCPU(ctx);
+    
+    // The second test of the same genome is served from the cache, without any test organisms to read
+    cCPUTestInfo test_info;
+    sCPUTestSummary first, second;
+    testcpu->TestGenome(ctx, test_info, *genome, first);
+    const double colony_fitness = test_info.GetColonyFitness();
+    const double fitness = test_info.GetGenotypeFitness();
+    testcpu->TestGenome(ctx, test_info, *genome, second);
+    
+    const cTestCPUCache& cache = world->GetHardwareManager().GetTestCPUCache();
+    ReportTestResult("Repeat Test Served From Cache", test_info.IsFromCache() && cache.GetHits() == 1);
+    ReportTestResult("Colony Fitness After Cache Hit", colony_fitness > 0.0 && test_info.GetColonyFitness() == colony_fitness);
+    ReportTestResult("Genotype Fitness After Cache Hit", test_info.GetGenotypeFitness() == fitness);
+    ReportTestResult("Cached Summary", second.is_viable && second.colony_fitness == first.colony_fitness &&
+                     second.gestation_time == first.gestation_time && SameArray(second.task_counts, first.task_counts));
+    
+    // A regular test afterwards has its organisms again
+    testcpu->TestGenome(ctx, test_info, *genome);
+    ReportTestResult("Uncached Test After Cache Hit", !test_info.IsFromCache() && test_info.GetColonyFitness() == colony_fitness);
+    
+    delete testcpu;
+    delete world;
+  }
+};
+
+
+
+
+#include "cResourceCount.h"
+#include "cSensingIndex.h"
+class cSensingIndexTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cSensingIndex"; }
+protected:
+  void RunTests()
+  {
+    ReportTestResult("Grid Arms Match Cell Scan", checkArms(1));
+    ReportTestResult("Torus Arms Match Cell Scan", checkArms(2));
+  }
+  
+private:
+  // Marks a fixed scatter of cells, clears some of them again, then compares every arm query against a direct walk
+  bool checkArms(int geometry)
+  {
+    const int world_x = 13;
+    const int world_y = 9;
+    Apto::Map<Apto::String, Apto::String> sets;
+    sets["WORLD_X"] = Apto::AsStr(world_x);
+    sets["WORLD_Y"] = Apto::AsStr(world_y);
+    sets["WORLD_GEOMETRY"] = Apto::AsStr(geometry);
+    cWorld* world = CreateTestWorld(sets);
+    if (!world) return false;
+    
+    const int num_cells = world_x * world_y;
+    const bool torus = (geometry == 2);
+    cResourceCount res_count;
+    cSensingIndex index(world, res_count);
+    Apto::Array<bool> occupied(num_cells);
+    occupied.SetAll(false);
+    for (int i = 0; i < num_cells; i++) {
+      if ((i * 7919) % 11 < 2) { occupied[i] = true; index.SetOccupied(cSensingIndex::OCC_ORGANISM, i, true); }
+    }
+    for (int i = 0; i < num_cells; i += 5) {
+      if (occupied[i]) { occupied[i] = false; index.SetOccupied(cSensingIndex::OCC_ORGANISM, i, false); }
+    }
+    
+    const int dirs[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+    const int max_len = world_x + 2;
+    bool result = true;
+    for (int cell = 0; cell < num_cells; cell++) {
+      if (index.IsOccupied(cSensingIndex::OCC_ORGANISM, cell) != occupied[cell]) result = false;
+      const int x = cell % world_x;
+      const int y = cell / world_x;
+      for (int d = 0; d < 4; d++) {
+        for (int len = 0; len <= max_len; len++) {
+          bool expected = false;
+          for (int j = 1; j <= len && !expected; j++) {
+            int cx = x + dirs[d][0] * j;
+            int cy = y + dirs[d][1] * j;
+            if (torus) {
+              cx = ((cx % world_x) + world_x) % world_x;
+              cy = ((cy % world_y) + world_y) % world_y;
+            } else if (cx < 0 || cx >= world_x || cy < 0 || cy >= world_y) {
+              continue;
+            }
+            expected = occupied[cy * world_x + cx];
+          }
+          if (index.AnyOccupiedInArm(cSensingIndex::OCC_ORGANISM, x, y, dirs[d][0], dirs[d][1], len) != expected) {
+            result = false;
+          }
+        }
+      }
+    }
+    
+    delete world;
+    return result;
+  }
+};
+
+
+
+
+#include "apto/rng.h"
+#include "cDemeNetworkMetrics.h"
+#ifndef BOOST_IS_AVAILABLE
+#define BOOST_IS_AVAILABLE 0
+#endif
+#if BOOST_IS_AVAILABLE
+#include <boost/graph/adjacency_list.hpp>
+#include "cDemeNetworkUtils.h"
+#endif
+class cDemeNetworkMetricsTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cDemeNetworkMetrics"; }
+protected:
+  void RunTests()
+  {
+    const int num_vertices = 24;
+    
+    // Drive the metrics and a plain adjacency matrix through the same random edge changes, recounting the matrix
+    // from scratch after each one
+    Apto::RNG::AvidaRNG rng(101);
+    cDemeNetworkMetrics metrics;
+    Apto::Array<bool> adj(num_vertices * num_vertices);
+    adj.SetAll(false);
+    for (int i = 0; i < num_vertices; i++) metrics.AddVertex();
+#if BOOST_IS_AVAILABLE
+    typedef boost::adjacency_list<boost::setS, boost::vecS, boost::undirectedS> Network;
+    Network network(num_vertices);
+    bool boost_match = true;
+#endif
+    
+    bool edges_match = true;
+    bool degrees_match = true;
+    bool triangles_match = true;
+    bool clustering_match = true;
+    bool components_match = true;
+    for (int step = 0; step < 2000; step++) {
+      const int u = rng.GetUInt(num_vertices);
+      const int v = rng.GetUInt(num_vertices);
+      const int op = rng.GetUInt(20);
+      if (op == 0) {
+        metrics.ClearVertex(u);
+        for (int w = 0; w < num_vertices; w++) adj[u * num_vertices + w] = adj[w * num_vertices + u] = false;
+#if BOOST_IS_AVAILABLE
+        boost::clear_vertex(u, network);
+#endif
+      } else if (op < 8) {
+        if (metrics.RemoveEdge(u, v) != adj[u * num_vertices + v]) edges_match = false;
+        adj[u * num_vertices + v] = adj[v * num_vertices + u] = false;
+#if BOOST_IS_AVAILABLE
+        boost::remove_edge(u, v, network);
+#endif
+      } else if (u != v) {
+        if (metrics.AddEdge(u, v) == adj[u * num_vertices + v]) edges_match = false;
+        adj[u * num_vertices + v] = adj[v * num_vertices + u] = true;
+#if BOOST_IS_AVAILABLE
+        boost::add_edge(u, v, network);
+#endif
+      }
+      
+      // Recount, summing the clustering terms in vertex order like clustering_coefficient() in cDemeNetworkUtils.h
+      int num_edges = 0;
+      double clustering = 0.0;
+      Apto::Array<int> degree_count(num_vertices);
+      degree_count.SetAll(0);
+      for (int i = 0; i < num_vertices; i++) {
+        int degree = 0;
+        int triangles = 0;
+        for (int j = 0; j < num_vertices; j++) {
+          if (!adj[i * num_vertices + j]) continue;
+          degree++;
+          for (int k = j + 1; k < num_vertices; k++) {
+            if (adj[i * num_vertices + k] && adj[j * num_vertices + k]) triangles++;
+          }
+        }
+        num_edges += degree;
+        degree_count[degree]++;
+        if (metrics.GetDegree(i) != degree) degrees_match = false;
+        if (metrics.GetTriangles(i) != triangles) triangles_match = false;
+        clustering += (degree > 1) ? (double)triangles / (degree * (degree - 1) / 2) : 0.0;
+      }
+      clustering /= num_vertices;
+      
+      if (metrics.GetNumEdges() != num_edges / 2) edges_match = false;
+      for (int d = 0; d < num_vertices; d++) if (metrics.GetDegreeCount(d) != degree_count[d]) degrees_match = false;
+      if (metrics.ClusteringCoefficient() != clustering) clustering_match = false;
+      if (metrics.GetNumComponents() != countComponents(adj, num_vertices)) components_match = false;
+#if BOOST_IS_AVAILABLE
+      if (metrics.ClusteringCoefficient() != clustering_coefficient(network)) boost_match = false;
+#endif
+    }
+    
+    ReportTestResult("Edge Count Matches Recount", edges_match);
+    ReportTestResult("Degree Distribution Matches Recount", degrees_match);
+    ReportTestResult("Triangle Counts Match Recount", triangles_match);
+    ReportTestResult("Clustering Coefficient Bit-Identical", clustering_match);
+    ReportTestResult("Components Match Recount", components_match);
+#if BOOST_IS_AVAILABLE
+    ReportTestResult("Clustering Coefficient Matches Boost", boost_match);
+#endif
+  }
+  
+private:
+  static int countComponents(const Apto::Array<bool>& adj, int num_vertices)
+  {
+    Apto::Array<bool> seen(num_vertices);
+    seen.SetAll(false);
+    Apto::Array<int> stack;
+    int components = 0;
+    for (int i = 0; i < num_vertices; i++) {
+      if (seen[i]) continue;
+      components++;
+      seen[i] = true;
+      stack.Push(i);
+      while (stack.GetSize()) {
+        const int u = stack[stack.GetSize() - 1];
+        stack.Resize(stack.GetSize() - 1);
+        for (int w = 0; w < num_vertices; w++) {
+          if (adj[u * num_vertices + w] && !seen[w]) { seen[w] = true; stack.Push(w); }
+        }
+      }
+    }
+    return components;
+  }
+};
+
+
+
+
+#include "cCPUMemory.h"
+#include "cInstSet.h"
+class cCPUMemoryTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cCPUMemory"; }
+protected:
+  void RunTests()
+  {
+    cWorld* world = CreateTestWorld();
+    if (!world) { ReportTestResult("World Setup", false); return; }
+    
+    cAvidaContext& ctx = world->GetDefaultContext();
+    Avida::GenomePtr genome = LoadTestGenome(world, "default-heads.org");
+    Avida::ConstInstructionSequencePtr seq_p;
+    seq_p.DynamicCastFrom(genome->Representation());
+    
+    // Site reads through the memory mark only that site, whole sequence reads through a base reference mark them all
+    Apto::Array<bool> site_read(seq_p->GetSize());
+    site_read.SetAll(false);
+    cCPUMemory memory(*seq_p);
+    memory.TrackReads(&site_read);
+    const int op = memory[2].GetOp();
+    bool result = (op == (*seq_p)[2].GetOp() && site_read[2] && !site_read[1] && !site_read[3]);
+    const Avida::InstructionSequence& base_ref = memory;
+    result = result && (base_ref == *seq_p);
+    for (int i = 0; i < site_read.GetSize(); i++) if (!site_read[i]) result = false;
+    memory.TrackReads(NULL);
+    ReportTestResult("Read Tracking", result);
+    
+    // A genome that loops on its first instruction never reads past the second site (checked as a modifier)
+    cInstSet& inst_set = world->GetHardwareManager().GetInstSet(genome->Properties().Get("instset").StringValue());
+    Avida::Genome looper(*genome);
+    Avida::InstructionSequencePtr looper_seq_p;
+    Avida::GeneticRepresentationPtr looper_rep_p = looper.Representation();
+    looper_seq_p.DynamicCastFrom(looper_rep_p);
+    (*looper_seq_p)[0] = inst_set.GetInst("mov-head");
+    
+    cTestCPU* testcpu = world->GetHardwareManager().CreateTestCPU(ctx);
+    cCPUTestInfo test_info;
+    test_info.TrackSiteCoverage();
+    testcpu->TestGenome(ctx, test_info, looper);
+    const sCPUSiteCoverage base_coverage = test_info.GetSiteCoverage();
+    const double base_fitness = test_info.GetColonyFitness();
+    ReportTestResult("Coverage Valid", base_coverage.valid && base_coverage.IsRead(0) && !base_coverage.IsRead(5));
+    
+    // Its knockout of an unexecuted site is skipped, and testing it anyway gives the same result
+    const int ko_site = 5;
+    Avida::Genome ko_genome(looper);
+    Avida::InstructionSequencePtr ko_seq_p;
+    Avida::GeneticRepresentationPtr ko_rep_p = ko_genome.Representation();
+    ko_seq_p.DynamicCastFrom(ko_rep_p);
+    (*ko_seq_p)[ko_site] = inst_set.ActivateNullInst();
+    const bool skipped = base_coverage.IsInert(ko_site, looper, ko_genome);
+    cCPUTestInfo ko_info;
+    testcpu->TestGenome(ctx, ko_info, ko_genome);
+    ReportTestResult("Unexecuted Site Knockout Skipped", skipped && ko_info.GetColonyFitness() == base_fitness &&
+                     ko_info.IsViable() == test_info.IsViable());
+    
+    // A replicator reads every site it copies, so none of its knockouts may be skipped
+    test_info.TrackSiteCoverage();
+    testcpu->TestGenome(ctx, test_info, *genome);
+    const sCPUSiteCoverage& coverage = test_info.GetSiteCoverage();
+    result = coverage.valid;
+    for (int i = 0; i < seq_p->GetSize(); i++) if (!coverage.IsRead(i)) result = false;
+    ReportTestResult("Replicator Reads Every Site", result);
+    
+    delete testcpu;
+    delete world;
+  }
+};
+
+
+
+
+#include "cAnalyzeGenotype.h"
+#include "cAnalyzeTreeIndex.h"
+#include "cAnalyzeTreeStats_CumulativeStemminess.h"
+#include "cAnalyzeTreeStats_Gamma.h"
+class cAnalyzeTreeIndexTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cAnalyzeTreeIndex"; }
+protected:
+  void RunTests()
+  {
+    cWorld* world = CreateTestWorld();
+    if (!world) { ReportTestResult("World Setup", false); return; }
+    Avida::GenomePtr genome = LoadTestGenome(world, "default-heads.org");
+    
+    // A fixed tree with chains, a trifurcation and nested bifurcations, listed with children ahead of their parents
+    const int num_nodes = 18;
+    const int ids[num_nodes] =     {  7,  1, 12,  3, 17,  9, 14,  2, 16,  5, 10,  6,  4, 13, 18, 11, 15,  8 };
+    const int parents[num_nodes] = {  6, -1, 10,  1, 16,  3, 12,  1,  8,  2,  9,  5,  1, 12, 16,  9,  8,  6 };
+    const int born[num_nodes] =    { 22,  0, 35,  8, 50, 18, 41,  5, 46, 15, 30, 20, 12, 40, 51, 31, 45, 25 };
+    tList<cAnalyzeGenotype> batch;
+    for (int i = 0; i < num_nodes; i++) {
+      cAnalyzeGenotype* genotype = new cAnalyzeGenotype(world, *genome);
+      genotype->SetID(ids[i]);
+      genotype->SetParentID(parents[i]);
+      genotype->SetUpdateBorn(born[i]);
+      batch.PushRear(genotype);
+    }
+    cAnalyzeTreeIndex tree(batch);
+    
+    // The old computations linked each genotype to its parent in batch order and read the child lists back
+    Apto::Array<cAnalyzeGenotype*> genotypes(num_nodes);
+    for (int i = 0; i < num_nodes; i++) genotypes[i] = tree.GetGenotype(i);
+    for (int i = 0; i < num_nodes; i++) {
+      if (parents[i] != -1) genotypes[tree.GetPosition(parents[i])]->LinkChild(*genotypes[i]);
+    }
+    bool result = (tree.GetNumReachable() == num_nodes && tree.GetNumMissingParents() == 0);
+    for (int i = 0; result && i < num_nodes; i++) {
+      tList<cAnalyzeGenotype>& children = genotypes[i]->GetChildList();
+      if (tree.GetNumChildren(i) != children.GetSize()) result = false;
+      for (int c = 0; result && c < children.GetSize(); c++) {
+        if (tree.GetGenotype(tree.GetChild(i, c)) != children.GetPos(c)) result = false;
+      }
+      // Clade ranges against a walk up the parent links
+      for (int j = 0; result && j < num_nodes; j++) {
+        bool in_clade = false;
+        for (cAnalyzeGenotype* anc = genotypes[j]; anc != NULL && !in_clade; anc = anc->GetParent()) {
+          in_clade = (anc == genotypes[i]);
+        }
+        if (tree.IsInClade(i, j) != in_clade) result = false;
+      }
+    }
+    ReportTestResult("Links Match Child Lists", result);
+    
+    // Gamma from the furcations of the old child lists, for each furcation time convention
+    result = true;
+    for (int convention = 1; convention <= 3; convention++) {
+      cAnalyzeTreeStats_Gamma gamma(world);
+      gamma.AnalyzeBatch(batch, 60, convention);
+      
+      Apto::Array<int> times;
+      for (int i = 0; i < num_nodes; i++) {
+        tList<cAnalyzeGenotype>& children = genotypes[i]->GetChildList();
+        for (int c = 1; c < children.GetSize(); c++) {
+          if (convention == 1) times.Push(genotypes[i]->GetUpdateBorn());
+          else if (convention == 2) times.Push(children.GetPos(c - 1)->GetUpdateBorn());
+          else times.Push(children.GetPos(c)->GetUpdateBorn());
+        }
+      }
+      Apto::QSort(times);
+      cAnalyzeTreeStats_Gamma old_gamma(world);
+      Apto::Array<int> inode_dists;
+      old_gamma.FindInternodeDistances(times, 60, inode_dists);
+      const double expected = old_gamma.CalculateGamma(inode_dists);
+      if (!SameArray(gamma.FurcationTimes(), times) || gamma.Gamma() != expected) result = false;
+    }
+    ReportTestResult("Gamma Matches Old Furcations", result);
+    
+    // Branch distances, accumulated distances and stemminess as computed by the old wave scans and DFS
+    const int anc_branch_dist[num_nodes] = { 1, 0, 2, 1, 1, 2, 1, 1, 1, 2, 1, 3, 1, 1, 1, 1, 1, 1 };
+    const int anc_branch_pos[num_nodes] = { 11, -1, 5, 1, 8, 1, 2, 1, 17, 1, 5, 1, 1, 2, 8, 5, 17, 11 };
+    const int num_branches = 6;
+    const int branch_ids[num_branches] = { 1, 12, 9, 16, 6, 8 };
+    const int branch_acc[num_branches] = { 9, 0, 2, 0, 2, 1 };
+    cAnalyzeTreeStats_CumulativeStemminess stemminess(world);
+    stemminess.AnalyzeBatchTree(batch);
+    result = (stemminess.AGL().GetSize() == num_nodes && stemminess.AGL2().GetSize() == num_branches);
+    for (int i = 0; result && i < num_nodes; i++) {
+      cAGLData& agl = stemminess.AGL()[i];
+      if (agl.anc_branch_dist != anc_branch_dist[i] || agl.anc_branch_pos != anc_branch_pos[i]) result = false;
+    }
+    double expected_sum = 0.0;
+    for (int i = 0; result && i < num_branches; i++) {
+      cAGLData& agl = stemminess.AGL2()[i];
+      const double expected = (agl.anc_branch_dist == 0) ? 0.0 :
+        (double)agl.anc_branch_dist / ((double)branch_acc[i] + (double)agl.anc_branch_dist);
+      if (agl.id != branch_ids[i] || agl.off_branch_dist_acc != branch_acc[i] || agl.cumulative_stemminess != expected) {
+        result = false;
+      }
+      if (branch_acc[i] > 0 && agl.anc_branch_id > 0) expected_sum += expected;
+    }
+    result = result && stemminess.InnerNodes() == 3 && stemminess.StemminessSum() == expected_sum;
+    result = result && stemminess.AverageStemminess() == expected_sum / 3;
+    ReportTestResult("Stemminess Matches Old Scans", result);
+    
+    while (batch.GetSize()) delete batch.Pop();
+    delete world;
+  }
+};
+
+
+
+
+#include "apto/rng.h"
+#include "cResourceCount.h"
+class cResourceCountTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cResourceCount"; }
+protected:
+  void RunTests()
+  {
+    cWorld* world = CreateTestWorld(Apto::Map<Apto::String, Apto::String>());
+    if (!world) { ReportTestResult("Create Test World", false); return; }
+    cAvidaContext& ctx = world->GetDefaultContext();
+    
+    // Steps of uneven sizes, as handed out by merit-weighted slicing, applied through Update() to one count and
+    // through a shared step log (cDemeResourceArena) to the other.  Both must round update_time identically.
+    Apto::RNG::AvidaRNG rng(17);
+    Apto::Array<double, Apto::Smart> steps;
+    cResourceCount own_count;
+    cResourceCount shared_count;
+    shared_count.ShareClock(&steps);
+    bool result = true;
+    for (int update = 0; update < 50; update++) {
+      const int num_cycles = 100 + rng.GetUInt(400);
+      for (int i = 0; i < num_cycles; i++) {
+        const double step_size = 1.0 / (double)(1 + rng.GetUInt(1000));
+        own_count.Update(step_size);
+        steps.Push(step_size);
+        if (rng.GetUInt(50) == 0) {
+          own_count.GetResources(ctx);
+          shared_count.GetResources(ctx);
+        }
+        if (rng.GetUInt(20) == 0 && own_count.GetUpdateTime() != shared_count.GetUpdateTime()) result = false;
+      }
+      shared_count.RebaseClock();
+      steps.Resize(0);
+      if (own_count.GetUpdateTime() != shared_count.GetUpdateTime()) result = false;
+    }
+    ReportTestResult("Shared Step Log Matches Update", result);
+    
+    delete world;
+  }
+};
+
+
+
+
+#include "cAction.h"
+#include "cActionLibrary.h"
+#include "cDeferredPrintQueue.h"
+#include "cPopulation.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+class cDeferredPrintQueueTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cDeferredPrintQueue"; }
+protected:
+  void RunTests()
+  {
+    Apto::Array<std::string> sync_out = runPrints(false, 1);
+    Apto::Array<std::string> single_out = runPrints(true, 1);
+    Apto::Array<std::string> threaded_out = runPrints(true, 4);
+    
+    bool written = (sync_out.GetSize() == NUM_PRINTS);
+    for (int i = 0; written && i < sync_out.GetSize(); i++) if (sync_out[i].size() == 0) written = false;
+    ReportTestResult("Prints Written", written);
+    ReportTestResult("Deferred Prints Written", single_out.GetSize() == NUM_PRINTS);
+    ReportTestResult("Threaded Output Matches Single Worker", SameArray(threaded_out, single_out));
+  }
+  
+private:
+  static const int NUM_PRINTS = 4;
+  
+  // Runs every deferrable print twice over a small population, then returns the contents of the files they wrote
+  Apto::Array<std::string> runPrints(bool defer, int workers)
+  {
+    const char* actions[NUM_PRINTS] = { "PrintDominantGenotype", "TestDominant", "PrintTaskSnapshot", "DumpTaskGrid" };
+    const char* filenames[NUM_PRINTS] = { "deferred-dom.org", "deferred-dom-test.dat", "deferred-tasks.dat", "deferred-grid-task.dat" };
+    Apto::Array<std::string> output;
+    
+    const Apto::String data_dir = Apto::FileSystem::PathAppend(Apto::FileSystem::GetCWD(), "unit-test-data");
+    for (int i = 0; i < NUM_PRINTS; i++) remove((const char*)Apto::FileSystem::PathAppend(data_dir, filenames[i]));
+    
+    Apto::Map<Apto::String, Apto::String> sets;
+    sets["DEFER_TEST_PRINTS"] = defer ? "1" : "0";
+    sets["MAX_CONCURRENCY"] = Apto::AsStr(workers);
+    cWorld* world = CreateTestWorld(sets);
+    if (!world) return output;
+    
+    cAvidaContext& ctx = world->GetDefaultContext();
+    Avida::GenomePtr genome = LoadTestGenome(world, "default-heads.org");
+    const int cells[] = { 0, 7, 23, 42 };
+    for (int i = 0; i < 4; i++) {
+      world->GetPopulation().Inject(*genome, Avida::Systematics::Source(Avida::Systematics::DIVISION, "", true), ctx, cells[i]);
+    }
+    
+    for (int round = 0; round < 2; round++) {
+      for (int i = 0; i < NUM_PRINTS; i++) {
+        cUserFeedback feedback;
+        cAction* action = cActionLibrary::GetInstance().Create(actions[i], world, filenames[i], feedback);
+        action->Process(ctx);
+        delete action;
+      }
+    }
+    world->GetDeferredPrints().Flush();
+    delete world;
+    
+    for (int i = 0; i < NUM_PRINTS; i++) {
+      std::ifstream fp((const char*)Apto::FileSystem::PathAppend(data_dir, filenames[i]));
+      std::string line;
+      std::ostringstream contents;
+      // The genome file opens with the time it was written, leave that out
+      if (i == 0) getline(fp, line);
+      while (getline(fp, line)) contents << line << endl;
+      output.Push(contents.str());
+    }
+    return output;
+  }
+};
+
+
+
+
+#include "cAnalyzeGenotype.h"
+#include "cAnalyzeJobQueue.h"
+#include "cGenotypeFileLoader.h"
+#include "cInitFile.h"
+#include "cInstSet.h"
+#include "cStringUtil.h"
+#include "tDataCommandManager.h"
+#include "tDataEntryCommand.h"
+#include <fstream>
+class cGenotypeFileLoaderTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cGenotypeFileLoader"; }
+protected:
+  void RunTests()
+  {
+    Apto::Map<Apto::String, Apto::String> sets;
+    sets["MAX_CONCURRENCY"] = "4";
+    cWorld* world = CreateTestWorld(sets);
+    if (!world) { ReportTestResult("World Setup", false); return; }
+    
+    const Apto::String data_dir = Apto::FileSystem::PathAppend(Apto::FileSystem::GetCWD(), "unit-test-data");
+    Apto::FileSystem::MkDir(data_dir);
+    const cString with_ids((const char*)Apto::FileSystem::PathAppend(data_dir, "loader-ids.spop"));
+    const cString without_ids((const char*)Apto::FileSystem::PathAppend(data_dir, "loader-no-ids.spop"));
+    const cString sequence((const char*)LoadTestGenome(world, "default-heads.org")->Representation()->AsString());
+    writeFile(with_ids, "id parent_id num_cpus total_cpus length update_born depth sequence", sequence, true);
+    writeFile(without_ids, "num_cpus sequence update_born", sequence, false);
+    
+    cAnalyzeJobQueue queue(world, 5);
+    ReportTestResult("Single Chunk Matches Serial", compareLoads(world, queue, with_ids, cGenotypeFileLoader::DEFAULT_CHUNK_SIZE));
+    ReportTestResult("Small Chunks Match Serial", compareLoads(world, queue, with_ids, 37));
+    ReportTestResult("Positional Names Match Serial", compareLoads(world, queue, without_ids, 53));
+    
+    delete world;
+  }
+  
+private:
+  // Data lines with the spacing, comments, blank and short lines the serial reader copes with
+  void writeFile(const cString& path, const char* format, const cString& sequence, bool with_ids)
+  {
+    std::ofstream fp(path);
+    fp << "#filetype genotype_data" << endl << "#format " << format << endl << "# a comment line" << endl << endl;
+    for (int i = 0; i < 200; i++) {
+      const int len = 1 + (i * 7) % sequence.GetSize();
+      const cString seq = sequence.Substring((i * 3) % (sequence.GetSize() - len + 1), len);
+      if (with_ids) {
+        fp << (i + 1) << " " << (i / 2) << "\t" << (i % 5) << "  " << (i * 3) << " " << len << " " << (i / 10) << " " << (i % 4);
+        fp << " " << seq;
+      } else {
+        fp << (i % 5) << "\t\t" << seq;
+        if (i % 9 != 0) fp << " " << (i / 10);
+      }
+      if (i % 13 == 0) fp << "   # trailing comment";
+      if (i % 17 == 0) fp << "\r";
+      fp << endl;
+      if (i % 11 == 0) fp << "   " << endl;
+    }
+  }
+  
+  bool compareLoads(cWorld* world, cAnalyzeJobQueue& queue, const cString& path, size_t chunk_size)
+  {
+    const cInstSet& is = world->GetHardwareManager().GetDefaultInstSet();
+    Avida::HashPropertyMap props;
+    cHardwareManager::SetupPropertyMap(props, (const char*)is.GetInstSetName());
+    Avida::Genome default_genome(is.GetHardwareType(), props, Avida::GeneticRepresentationPtr(new Avida::InstructionSequence(1)));
+    
+    // The serial reader, as cAnalyze::LoadFile runs it
+    tList<cAnalyzeGenotype> serial;
+    cInitFile input_file(path, world->GetWorkingDir());
+    tList<tDataEntryCommand<cAnalyzeGenotype> > columns;
+    cUserFeedback feedback;
+    cAnalyzeGenotype::GetDataCommandManager().LoadCommandList(input_file.GetFormat(), columns, &feedback);
+    const bool id_inc = input_file.GetFormat().HasString("id");
+    tListIterator<tDataEntryCommand<cAnalyzeGenotype> > column_it(columns);
+    for (int line_id = 0; line_id < input_file.GetNumLines(); line_id++) {
+      cString cur_line = input_file.GetLine(line_id);
+      cAnalyzeGenotype* genotype = new cAnalyzeGenotype(world, default_genome);
+      column_it.Reset();
+      while (column_it.Next() != NULL) column_it.Get()->SetValue(genotype, cur_line.PopWord());
+      genotype->SetName(cStringUtil::Stringf("org-%d", (id_inc) ? genotype->GetID() : line_id));
+      serial.PushRear(genotype);
+    }
+    
+    tList<cAnalyzeGenotype> mapped;
+    cGenotypeFileLoader loader(world, path);
+    bool result = loader.Open() && loader.Load(queue, columns, default_genome, mapped, chunk_size);
+    result = result && feedback.GetNumMessages() == 0 && serial.GetSize() > 0 && mapped.GetSize() == serial.GetSize();
+    
+    tListIterator<cAnalyzeGenotype> serial_it(serial);
+    tListIterator<cAnalyzeGenotype> mapped_it(mapped);
+    while (result && serial_it.Next() != NULL && mapped_it.Next() != NULL) {
+      cAnalyzeGenotype* expected = serial_it.Get();
+      cAnalyzeGenotype* genotype = mapped_it.Get();
+      if (genotype->GetName() != expected->GetName()) result = false;
+      if (genotype->GetGenome().Representation()->AsString() != expected->GetGenome().Representation()->AsString()) {
+        result = false;
+      }
+      column_it.Reset();
+      while (column_it.Next() != NULL) {
+        if (column_it.Get()->GetValue(genotype).AsString() != column_it.Get()->GetValue(expected).AsString()) result = false;
+      }
+    }
+    
+    while (serial.GetSize()) delete serial.Pop();
+    while (mapped.GetSize()) delete mapped.Pop();
+    while (columns.GetSize()) delete columns.Pop();
+    return result;
+  }
+};
+
+
+
+
+#include "cGradientStencil.h"
+#include <cmath>
+class cGradientStencilTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cGradientStencil"; }
+protected:
+  void RunTests()
+  {
+    cGradientStencilCache cache;
+    bool cone = true;
+    bool plateau = true;
+    bool hills = true;
+    for (int height = 1; height <= 12; height++) {
+      for (int spread = 0; spread <= 15; spread++) {
+        if (!compareCone(*cache.Get(spread, height), 9, 5)) cone = false;
+        if (!compareHill(*cache.Get(spread, height), 9, 5)) hills = false;
+      }
+      if (!comparePlateau(*cache.Get(height + 1, height), 9, 5)) plateau = false;
+    }
+    ReportTestResult("Cone Profile Bit Exact", cone);
+    ReportTestResult("Plateau Walk Bit Exact", plateau);
+    ReportTestResult("Hill Distances Bit Exact", hills);
+    ReportTestResult("Stencils Shared", cache.Get(4, 7) == cache.Get(4, 7) && cache.Get(4, 7) != cache.Get(7, 4));
+  }
+  
+private:
+  // The comparisons below repeat the per cell arithmetic the stencil lookups replaced in cGradientCount
+  bool compareCone(const cGradientStencil& stencil, int peakx, int peaky)
+  {
+    const int spread = stencil.GetSpread();
+    const int height = stencil.GetHeight();
+    for (int ii = peakx - spread - 2; ii <= peakx + spread + 2; ii++) {
+      for (int jj = peaky - spread - 2; jj <= peaky + spread + 2; jj++) {
+        double thisdist = sqrt((double) (peakx - ii) * (double) (peakx - ii) + (double) (peaky - jj) * (double) (peaky - jj));
+        const bool in_spread = (spread >= thisdist);
+        const int dx = peakx - ii;
+        const int dy = peaky - jj;
+        if (!stencil.Covers(dx, dy)) {
+          if (in_spread) return false;
+          continue;
+        }
+        const int idx = stencil.Index(dx, dy);
+        if (stencil.InSpread(idx) != in_spread || stencil.GetDist(idx) != thisdist) return false;
+        if (stencil.GetSlope(idx) != height / (thisdist + 1)) return false;
+        if (stencil.IsPlateau(idx) != ((height / (thisdist + 1)) >= 1)) return false;
+      }
+    }
+    return true;
+  }
+  
+  bool comparePlateau(const cGradientStencil& stencil, int peakx, int peaky)
+  {
+    const int temp_height = stencil.GetHeight();
+    Apto::Array<int> expected;
+    Apto::Array<int> walked;
+    for (int ii = peakx - temp_height - 1; ii < peakx + temp_height + 2; ii++) {
+      for (int jj = peaky - temp_height - 1; jj < peaky + temp_height + 2; jj++) {
+        double thisdist = sqrt((double) (peakx - ii) * (double) (peakx - ii) + (double) (peaky - jj) * (double) (peaky - jj));
+        double find_plat_dist = temp_height / (thisdist + 1);
+        if (find_plat_dist >= 1) expected.Push(jj * 100 + ii);
+        if (stencil.IsPlateau(stencil.Index(peakx - ii, peaky - jj))) walked.Push(jj * 100 + ii);
+      }
+    }
+    return (expected.GetSize() > 0 && SameArray(expected, walked));
+  }
+  
+  bool compareHill(const cGradientStencil& stencil, int peakx, int peaky)
+  {
+    const int rand_hill_radius = stencil.GetSpread();
+    for (int ii = peakx - rand_hill_radius - 1; ii < peakx + rand_hill_radius + 2; ii++) {
+      for (int jj = peaky - rand_hill_radius - 1; jj < peaky + rand_hill_radius + 2; jj++) {
+        double thisdist = sqrt((double) (peakx - ii) * (peakx - ii) + (peaky - jj) * (peaky - jj));
+        const bool plotted = (thisdist <= rand_hill_radius);
+        const int dx = peakx - ii;
+        const int dy = peaky - jj;
+        const bool covered = stencil.Covers(dx, dy) && stencil.InSpread(stencil.Index(dx, dy));
+        if (covered != plotted) return false;
+        if (covered && stencil.GetDist(stencil.Index(dx, dy)) != thisdist) return false;
+      }
+    }
+    return true;
+  }
+};
+
+
+
+
+#include "cDeme.h"
+#include "cDemeCellEvent.h"
+#include "cEnvironment.h"
+#include "cOrganism.h"
+#include "cPhenotype.h"
+#include "cPopulationCell.h"
+#include "cResource.h"
+#include "cResourceLib.h"
+#include "cStats.h"
+#include <fstream>
+#include <map>
+class cDemeCellEventTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cDemeCellEvent"; }
+protected:
+  void RunTests()
+  {
+    sRun scheduled;
+    sRun full_scan;
+    if (!runEvents(false, scheduled) || !runEvents(true, full_scan)) {
+      ReportTestResult("World Setup", false);
+      return;
+    }
+    
+    ReportTestResult("Events Activated", full_scan.counts[0] > 0 && full_scan.counts[1] > 0);
+    ReportTestResult("Events Killed", full_scan.counts[2] > 0);
+    ReportTestResult("Cell Data Matches Full Scan", SameArray(scheduled.cell_data, full_scan.cell_data));
+    ReportTestResult("Event Counts Match Full Scan", SameArray(scheduled.counts, full_scan.counts));
+    ReportTestResult("Deme Resources Match Full Scan", SameArray(scheduled.resources, full_scan.resources));
+    ReportTestResult("Flow Rate Tuples Match Full Scan", !full_scan.flow_rates.empty() &&
+                     sameFlowRates(scheduled.flow_rates, full_scan.flow_rates));
+  }
+  
+private:
+  static const int NUM_UPDATES = 70;
+  static const int NUM_SLOTS = 6;
+  
+  struct sRun
+  {
+    Apto::Array<int> cell_data;
+    Apto::Array<int> counts;
+    Apto::Array<double> resources;
+    std::map<int, flow_rate_tuple> flow_rates;
+  };
+  
+  // Deme state kept by the full scan, which drives the events from outside of cDeme
+  struct sFullScanState
+  {
+    int age;
+    int events_total;
+    int events_killed;
+    int kill_attempts;
+    int killed_this_slot;
+    int attempts_this_slot;
+    int successful_periods;
+    std::vector<std::pair<int, int> > slot_end_points;
+    
+    sFullScanState() : age(0), events_total(0), events_killed(0), kill_attempts(0), killed_this_slot(0),
+      attempts_this_slot(0), successful_periods(0) { ; }
+  };
+  
+  // Deme 0 carries overlapping static and moving events, an event without duration and a decayed event, deme 1
+  // carries slotted events.  The full scan run steps the same events with the per update scan that ProcessUpdate and
+  // KillCellEvent used before the events were scheduled.
+  bool runEvents(bool full_scan, sRun& run)
+  {
+    const Apto::String data_dir = Apto::FileSystem::PathAppend(Apto::FileSystem::GetCWD(), "unit-test-data");
+    Apto::FileSystem::MkDir(data_dir);
+    const Apto::String env_file = Apto::FileSystem::PathAppend(data_dir, "deme-events-environment.cfg");
+    {
+      std::ofstream fp((const char*)env_file);
+      fp << "RESOURCE CELL_ENERGY:initial=1000:deme=true" << endl;
+    }
+    
+    Apto::Map<Apto::String, Apto::String> sets;
+    sets["ENVIRONMENT_FILE"] = env_file;
+    sets["NUM_DEMES"] = "2";
+    sets["WORLD_X"] = "10";
+    sets["WORLD_Y"] = "10";
+    sets["DEMES_MAX_AGE"] = "60";
+    sets["ATTACK_DECAY_RATE"] = "0.25";
+    cWorld* world = CreateTestWorld(sets);
+    if (!world) return false;
+    
+    cAvidaContext& ctx = world->GetDefaultContext();
+    cPopulation& pop = world->GetPopulation();
+    Avida::GenomePtr genome = LoadTestGenome(world, "default-heads.org");
+    for (int d = 0; d < 2; d++) {
+      pop.Inject(*genome, Avida::Systematics::Source(Avida::Systematics::DIVISION, "", true), ctx, pop.GetDeme(d).GetCellID(0));
+    }
+    
+    cDeme& events = pop.GetDeme(0);
+    events.SetCellEvent(0, 0, 2, 2, 3, 10, true, 2);
+    events.SetCellEvent(1, 1, 3, 3, 5, 8, true, 1);
+    events.SetCellEvent(0, 0, 1, 1, -1, 6, false, 3);
+    events.SetCellEvent(2, 0, 4, 2, 0, 4, true, 1);
+    events.SetCellEvent(3, 3, 4, 4, 4, 0, true, 1);
+    events.GetCellEvent(2)->DecayEventIDFromCenter();
+    
+    cDeme& slotted = pop.GetDeme(1);
+    slotted.SetCellEventSlots(0, 0, 1, 1, -1, 4, false, NUM_SLOTS, 4, 1, 4);
+    
+    sFullScanState state[2];
+    if (full_scan) {
+      // slot ends and flow rates follow from the events each slot was given
+      const int slot_length = world->GetConfig().DEMES_MAX_AGE.Get() / NUM_SLOTS;
+      for (int i = 0; i < NUM_SLOTS; i++) {
+        int flow_level = 0;
+        for (int e = 0; e < slotted.GetNumEvents(); e++) {
+          if (slotted.GetCellEvent(e)->GetDelay() / slot_length == i) flow_level++;
+        }
+        state[1].slot_end_points.push_back(std::make_pair((i + 1) * slot_length, flow_level));
+      }
+    }
+    
+    for (int update = 0; update < NUM_UPDATES; update++) {
+      for (int d = 0; d < 2; d++) {
+        cDeme& deme = pop.GetDeme(d);
+        if (full_scan) fullScanUpdate(world, ctx, deme, state[d]);
+        else deme.ProcessUpdate(ctx);
+        
+        if (update % 3 == 2) {
+          const int event_id = pop.GetCell(deme.GetCellID((update * 7) % deme.GetSize())).GetCellData();
+          if (full_scan) fullScanKill(world, deme, state[d], event_id);
+          else deme.KillCellEvent(event_id);
+        }
+        if (update % 5 == 4) {
+          if (full_scan) fullScanKill(world, deme, state[d], 0);
+          else deme.KillCellEvent(0);
+        }
+        
+        for (int i = 0; i < deme.GetSize(); i++) run.cell_data.Push(pop.GetCell(deme.GetCellID(i)).GetCellData());
+      }
+    }
+    
+    cResource* res = world->GetEnvironment().GetResourceLib().GetResource("CELL_ENERGY");
+    for (int d = 0; d < 2; d++) {
+      cDeme& deme = pop.GetDeme(d);
+      if (full_scan) {
+        run.counts.Push(state[d].events_total);
+        run.counts.Push(state[d].events_killed);
+        run.counts.Push(state[d].kill_attempts);
+        run.counts.Push(state[d].successful_periods);
+      } else {
+        run.counts.Push(deme.GetEventsTotal());
+        run.counts.Push(deme.GetEventsKilled());
+        run.counts.Push(deme.GetEventKillAttempts());
+        run.counts.Push(deme.GetConsecutiveSuccessfulEventPeriods());
+      }
+      run.resources.Push(deme.GetDemeResources().GetCellResVal(ctx, 0, res->GetID()));
+    }
+    run.flow_rates = world->GetStats().FlowRateTuples();
+    
+    delete world;
+    return true;
+  }
+  
+  void fullScanUpdate(cWorld* world, cAvidaContext& ctx, cDeme& deme, sFullScanState& state)
+  {
+    if (deme.IsEmpty()) return;
+    cPopulation& pop = world->GetPopulation();
+    
+    for (int i = 0; i < deme.GetNumEvents(); i++) {
+      cDemeCellEvent& event = *deme.GetCellEvent(i);
+      
+      if (event.IsActive() && event.GetDelay() < state.age && state.age <= event.GetDelay() + event.GetDuration()) {
+        int eventCell = event.GetNextEventCellID();
+        cResource* res = world->GetEnvironment().GetResourceLib().GetResource("CELL_ENERGY");
+        while (eventCell != -1) {
+          cPopulationCell& cell = pop.GetCell(deme.GetCellID(eventCell));
+          if (event.GetEventID() == cell.GetCellData()) {
+            if (cell.IsOccupied()) {
+              cPhenotype& orgPhenotype = cell.GetOrganism()->GetPhenotype();
+              orgPhenotype.ReduceEnergy(orgPhenotype.GetStoredEnergy() * world->GetConfig().ATTACK_DECAY_RATE.Get());
+            }
+            const double energy = deme.GetDemeResources().GetCellResVal(ctx, eventCell, res->GetID());
+            deme.GetDemeResources().ModifyCell(ctx, res->GetID(), energy * (world->GetConfig().ATTACK_DECAY_RATE.Get() - 1.0), eventCell);
+          }
+          eventCell = event.GetNextEventCellID();
+        }
+      }
+      
+      if (!event.IsActive() && event.GetDelay() == state.age) {
+        state.events_total++;
+        event.ActivateEvent();
+        int eventCell = event.GetNextEventCellID();
+        while (eventCell != -1) {
+          if (event.IsDecayed()) {
+            pop.GetCell(deme.GetCellID(eventCell)).SetCellData(event.GetEventIDDecay(deme.GetCellPosition(eventCell)));
+          } else {
+            pop.GetCell(deme.GetCellID(eventCell)).SetCellData(event.GetEventID());
+          }
+          eventCell = event.GetNextEventCellID();
+        }
+      } else if (event.IsActive() && event.GetDelay() + event.GetDuration() == state.age) {
+        int eventCell = event.GetNextEventCellID();
+        while (eventCell != -1) {
+          if (event.GetEventID() == pop.GetCell(deme.GetCellID(eventCell)).GetCellData()) {
+            pop.GetCell(deme.GetCellID(eventCell)).SetCellData(0);
+          }
+          eventCell = event.GetNextEventCellID();
+        }
+        event.DeactivateEvent();
+      }
+    }
+    
+    for (std::vector<std::pair<int, int> >::iterator iter = state.slot_end_points.begin();
+         iter < state.slot_end_points.end(); iter++) {
+      if (state.age == (*iter).first) {
+        if (state.killed_this_slot >= world->GetConfig().DEMES_MIM_EVENTS_KILLED_RATIO.Get() * (*iter).second) {
+          state.successful_periods++;
+        } else {
+          state.successful_periods = 0;
+        }
+        
+        // the energy model is off, leaving the usage average empty, and no organism runs to give birth
+        std::map<int, flow_rate_tuple>& flowRateTuples = world->GetStats().FlowRateTuples();
+        flowRateTuples[(*iter).second].orgCount.Add(deme.GetOrgCount());
+        flowRateTuples[(*iter).second].eventsKilled.Add(state.killed_this_slot);
+        flowRateTuples[(*iter).second].attemptsToKillEvents.Add(state.attempts_this_slot);
+        flowRateTuples[(*iter).second].AvgEnergyUsageRatio.Add(cDoubleSum().Average());
+        flowRateTuples[(*iter).second].totalBirths.Add(0);
+        flowRateTuples[(*iter).second].currentSleeping.Add(deme.GetSleepingCount());
+        state.killed_this_slot = 0;
+        state.attempts_this_slot = 0;
+        break;
+      }
+    }
+    state.age++;
+  }
+  
+  void fullScanKill(cWorld* world, cDeme& deme, sFullScanState& state, int eventID)
+  {
+    state.attempts_this_slot++;
+    if (eventID <= 0) return;
+    cPopulation& pop = world->GetPopulation();
+    for (int i = 0; i < deme.GetNumEvents(); i++) {
+      cDemeCellEvent& event = *deme.GetCellEvent(i);
+      if (event.IsActive() && event.GetEventID() == eventID) {
+        int eventCell = event.GetNextEventCellID();
+        while (eventCell != -1) {
+          if (event.GetEventID() == pop.GetCell(deme.GetCellID(eventCell)).GetCellData()) {
+            pop.GetCell(deme.GetCellID(eventCell)).SetCellData(0);
+          }
+          eventCell = event.GetNextEventCellID();
+        }
+        event.DeactivateEvent();
+        state.events_killed++;
+        state.killed_this_slot++;
+        state.kill_attempts++;
+        return;
+      }
+    }
+  }
+  
+  template <class T> static bool sameAccumulator(const T& a, const T& b)
+  {
+    return (a.Count() == b.Count() && a.Sum() == b.Sum());
+  }
+  
+  bool sameFlowRates(const std::map<int, flow_rate_tuple>& a, const std::map<int, flow_rate_tuple>& b)
+  {
+    if (a.size() != b.size()) return false;
+    std::map<int, flow_rate_tuple>::const_iterator a_it = a.begin();
+    std::map<int, flow_rate_tuple>::const_iterator b_it = b.begin();
+    for (; a_it != a.end(); a_it++, b_it++) {
+      if (a_it->first != b_it->first) return false;
+      const flow_rate_tuple& x = a_it->second;
+      const flow_rate_tuple& y = b_it->second;
+      if (!sameAccumulator(x.orgCount, y.orgCount) || !sameAccumulator(x.eventsKilled, y.eventsKilled) ||
+          !sameAccumulator(x.attemptsToKillEvents, y.attemptsToKillEvents) ||
+          !sameAccumulator(x.AvgEnergyUsageRatio, y.AvgEnergyUsageRatio) ||
+          !sameAccumulator(x.totalBirths, y.totalBirths) || !sameAccumulator(x.currentSleeping, y.currentSleeping)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+
+
+
+#include "cMigrationGeometry.h"
+class cMigrationGeometryTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cMigrationGeometry"; }
+protected:
+  void RunTests()
+  {
+    // A loopback universe sends every migrant back into the same world
+    bool loopback = true;
+    for (int x = 0; x < 7; x++) {
+      if (cMigrationGeometry::DestinationWorld(x, 0, 7, 4, 0, 0, 1) != 0) loopback = false;
+      if (cMigrationGeometry::DestinationWorld(x, 3, 7, 4, 0, 0, 1) != 0) loopback = false;
+    }
+    for (int y = 0; y < 4; y++) {
+      if (cMigrationGeometry::DestinationWorld(0, y, 7, 4, 0, 0, 1) != 0) loopback = false;
+      if (cMigrationGeometry::DestinationWorld(6, y, 7, 4, 0, 0, 1) != 0) loopback = false;
+    }
+    ReportTestResult("Loopback Routes To Itself", loopback);
+    
+    // Worlds of a 3x3 universe, ranked row by row, wrap around the edges of the universe
+    bool wraps = (cMigrationGeometry::DestinationWorld(0, 2, 7, 4, 0, 0, 3) == 2 &&
+                  cMigrationGeometry::DestinationWorld(6, 2, 7, 4, 2, 0, 3) == 0 &&
+                  cMigrationGeometry::DestinationWorld(3, 0, 7, 4, 1, 0, 3) == 7 &&
+                  cMigrationGeometry::DestinationWorld(3, 3, 7, 4, 1, 2, 3) == 1 &&
+                  cMigrationGeometry::DestinationWorld(6, 2, 7, 4, 0, 1, 3) == 4);
+    ReportTestResult("Universe Wraps Around", wraps);
+    
+    // Arrival cells are indexed by the width of the world, which need not be square
+    Apto::Array<bool> seen(7 * 4);
+    seen.SetAll(false);
+    bool bijection = true;
+    for (int y = 0; y < 4; y++) {
+      for (int x = 0; x < 7; x++) {
+        const int cell = cMigrationGeometry::ArrivalCell(x, y, 7, 4);
+        if (cell < 0 || cell >= 7 * 4 || seen[cell]) {
+          bijection = false;
+          continue;
+        }
+        seen[cell] = true;
+      }
+    }
+    ReportTestResult("Arrival Cells Within World", bijection);
+    ReportTestResult("Arrival Cell Inverted", cMigrationGeometry::ArrivalCell(0, 0, 7, 4) == 27 &&
+                     cMigrationGeometry::ArrivalCell(6, 3, 7, 4) == 0 && cMigrationGeometry::ArrivalCell(1, 0, 7, 4) == 26);
+    
+    // Every update that can be in flight at once ships its batches under a tag of its own
+    bool distinct = true;
+    for (int lag = 0; lag <= 3; lag++) {
+      for (int first = 0; first < 10; first++) {
+        for (int ii = first; ii <= first + lag; ii++) {
+          for (int jj = ii + 1; jj <= first + lag; jj++) {
+            if (cMigrationGeometry::BatchTag(1, ii, lag) == cMigrationGeometry::BatchTag(1, jj, lag)) distinct = false;
+          }
+          const int tag = cMigrationGeometry::BatchTag(1, ii, lag);
+          if (tag < 1 || tag > 1 + lag) distinct = false;
+        }
+      }
+    }
+    ReportTestResult("In Flight Batch Tags Distinct", distinct);
+  }
+};
+
+
+
 
 #define TEST(CLASS) \
 tester = new CLASS ## Tests(); \
@@ -328,11 +1649,26 @@ int main(int argc, const char* argv[])
   
   cUnitTest* tester = NULL;
   
+  Avida::Initialize();
+  
   cout << "Avida Tools Unit Tests" << endl;
   cout << endl;
   
   TEST(cRawBitArray);
   TEST(cBitArray);
+  TEST(cIslandUniverse);
+  TEST(cGridSnapshot);
+  TEST(cTestCPUCache);
+  TEST(cSensingIndex);
+  TEST(cDemeNetworkMetrics);
+  TEST(cCPUMemory);
+  TEST(cAnalyzeTreeIndex);
+  TEST(cResourceCount);
+  TEST(cDeferredPrintQueue);
+  TEST(cGenotypeFileLoader);
+  TEST(cGradientStencil);
+  TEST(cDemeCellEvent);
+  TEST(cMigrationGeometry);
   
   if (failed == 0)
     cout << "All unit tests passed." << endl;
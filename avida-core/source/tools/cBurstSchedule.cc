@@ -0,0 +1,47 @@
+/*
+ *  cBurstSchedule.cc
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cBurstSchedule.h"
+
+
+// Hand out the remainder of the current burst before drawing a new organism from the wrapped schedule
+int cBurstSchedule::Next()
+{
+  if (m_remaining > 0) {
+    m_remaining--;
+    return m_current;
+  }
+  
+  m_current = m_schedule->Next();
+  if (m_current >= 0) m_remaining = m_burst_size - 1;
+  return m_current;
+}
+
+
+void cBurstSchedule::AdjustPriority(int entry_id, double priority)
+{
+  // An organism that dies (or is replaced) mid-burst forfeits the rest of it
+  if (entry_id == m_current && priority <= 0.0) {
+    m_current = -1;
+    m_remaining = 0;
+  }
+  
+  m_schedule->AdjustPriority(entry_id, priority);
+}
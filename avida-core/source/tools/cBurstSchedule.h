@@ -0,0 +1,61 @@
+/*
+ *  cBurstSchedule.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cBurstSchedule_h
+#define cBurstSchedule_h
+
+#include "avida/core/Types.h"
+
+#include "apto/scheduler.h"
+
+
+/**
+ * Wraps another schedule, handing each organism it selects a quantum of
+ * burst_size consecutive CPU cycles.  Since every draw of the wrapped
+ * schedule is worth the same number of cycles, the expected share each
+ * organism receives is unchanged, while scheduling cost is amortized over
+ * the burst.  Selection is fully determined by the wrapped schedule, so
+ * runs remain reproducible for a given seed.
+ **/
+
+class cBurstSchedule : public Apto::PriorityScheduler
+{
+private:
+  Apto::PriorityScheduler* m_schedule;
+  int m_burst_size;
+  
+  int m_current;    // entry receiving the current burst
+  int m_remaining;  // cycles left in the current burst
+  
+  
+  cBurstSchedule(const cBurstSchedule&); // @not_implemented
+  cBurstSchedule& operator=(const cBurstSchedule&); // @not_implemented
+  
+  
+public:
+  cBurstSchedule(Apto::PriorityScheduler* schedule, int burst_size)
+    : m_schedule(schedule), m_burst_size(burst_size), m_current(-1), m_remaining(0) { ; }
+  ~cBurstSchedule() { delete m_schedule; }
+  
+  void AdjustPriority(int entry_id, double priority);
+  int Next();
+};
+
+#endif
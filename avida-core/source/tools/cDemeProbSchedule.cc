@@ -22,9 +22,6 @@
 
 #include "cDemeProbSchedule.h"
 
-#include "cDeme.h"
-#include "cMerit.h"
-
 // The larger merits cause problems here; things need to be re-thought out. 
 
 /* 
@@ -36,44 +33,33 @@
 */
 
 //get the next CPU cycle, awarded to the next populated deme and cycled in a round-robin fashion
-int cDemeProbSchedule::GetNextID()
+int cDemeProbSchedule::Next()
 {
-  // iterate the deme
-  curr_deme = ++curr_deme % num_demes;
-
   //loop to check each deme at most once -- this could be a problem in sparse pops, best to start with populated or mostly-poulated demes
   for (int i = 0; i < num_demes; i++) {
+    // iterate the deme
+    curr_deme = (curr_deme + 1) % num_demes;
 
-    // check to see if deme is populated
-    if (chart[curr_deme]->GetTotalWeight() == 0) { 
-      // deme is empty -- iterate the deme
-      curr_deme = ++curr_deme % num_demes;
-    } else {
-      // deme not empty -- return offset id
+    // skip empty demes
+    if (chart[curr_deme]->GetTotalWeight() == 0.0) continue;
 
-      // calculate the offset
-      int offset = curr_deme * deme_size;
-      
-      // get the within postion of the node whos corresponding cell will get the CPU cycle
-      const double position = m_rng->GetDouble(chart[curr_deme]->GetTotalWeight());
+    // get the within postion of the node whos corresponding cell will get the CPU cycle
+    const double position = m_rng->GetDouble(chart[curr_deme]->GetTotalWeight());
 
-      // return the adjusted ID of the cell to get the CPU cycle
-      return chart[curr_deme]->FindPosition(position) + offset;
-    }
+    // return the adjusted ID of the cell to get the CPU cycle
+    return chart[curr_deme]->FindPosition(position) + curr_deme * deme_size;
   }
   
-  assert(false);
+  // nothing is schedulable
   return -1;
 }
 
 
 //adjust the weight of an org within deme
-void cDemeProbSchedule::Adjust(int item_id, const cMerit& item_merit, int deme_id)
+void cDemeProbSchedule::AdjustPriority(int entry_id, double priority)
 {
-  //calculate the corrected id for the org to be adjusted
-  int offset_id = item_id - (deme_id * deme_size);
+  const int deme_id = entry_id / deme_size;
   
-  //adjust the merit of the org in the tree
-  chart[deme_id]->SetWeight(offset_id, item_merit.GetDouble());
+  //adjust the merit of the org in the tree, using its offset within the deme
+  chart[deme_id]->SetWeight(entry_id - deme_id * deme_size, priority);
 }
-
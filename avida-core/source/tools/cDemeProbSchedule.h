@@ -1,5 +1,5 @@
 /*
- *  cProbSchedule.h
+ *  cDemeProbSchedule.h
  *  Avida
  *
  *  Called "prob_schedule.hh" prior to 12/7/05.
@@ -26,27 +26,29 @@
 #include "avida/core/Types.h"
 
 #include "apto/rng.h"
+#include "apto/scheduler.h"
 
-#include "cSchedule.h"
 #include "cWeightedIndex.h"
 
 
 /**
  * The DemeProbiblistic Schedule has the chance for an item to
  * be scheduled within each Deme proportional to the merit of that 
- * item relative to the rest of the deme.
+ * item relative to the rest of the deme.  Populated demes receive
+ * CPU cycles in a round-robin fashion.
+ *
+ * Entries are cell ids; demes are assumed to occupy contiguous blocks
+ * of num_cells / num_demes cells.
  * 
  * @AWC -- further implementation notes in CC file.
  **/
 
-class cMerit;
-
-class cDemeProbSchedule : public cSchedule
+class cDemeProbSchedule : public Apto::PriorityScheduler
 {
 private:
 
   // Keep our own RNG so as to better preserve consistancy.
-  Apto::Random* m_rng;
+  Apto::SmartPtr<Apto::Random> m_rng;
 
   // Array of WeightedIndex tree's to farm out the scheduling.
   Apto::Array<cWeightedIndex*> chart;
@@ -57,7 +59,7 @@ private:
   // size of each deme... num_cells/num_demes
   int deme_size;
 
-  // what deme should GetNextID give the next CPU cycle to?
+  // what deme should Next give the next CPU cycle to?
   int curr_deme;
 
   
@@ -66,17 +68,15 @@ private:
 
 
 public:
-  cDemeProbSchedule(int num_cells, int seed, int ndemes) : cSchedule(num_cells), m_rng(new Apto::RNG::AvidaRNG(seed)), num_demes(ndemes)
+  cDemeProbSchedule(int num_cells, int ndemes, Apto::SmartPtr<Apto::Random> rng)
+    : m_rng(rng), num_demes(ndemes), deme_size(num_cells / ndemes), curr_deme(ndemes - 1)
   {
-    deme_size = num_cells / num_demes;
-
-    for(int i = 0; i < num_demes; i++) chart.Push(new cWeightedIndex(deme_size));
+    for (int i = 0; i < num_demes; i++) chart.Push(new cWeightedIndex(deme_size));
   }
-  ~cDemeProbSchedule() { for (int i = 0; i < chart.GetSize(); i++) delete chart[i]; delete m_rng; }
-
-  virtual void Adjust(int item_id, const cMerit& merit, int deme_id = 0);
+  ~cDemeProbSchedule() { for (int i = 0; i < chart.GetSize(); i++) delete chart[i]; }
 
-  int GetNextID();
+  void AdjustPriority(int entry_id, double priority);
+  int Next();
 };
 
 #endif
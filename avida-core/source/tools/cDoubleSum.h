@@ -62,6 +62,15 @@ public:
     if (value > max) max = value;
   }
 
+  // Folds in the values gathered by another sum, as though they had been added here
+  void Merge(const cDoubleSum& other)
+  {
+    n += other.n;
+    s1 += other.s1;
+    s2 += other.s2;
+    if (other.max > max) max = other.max;
+  }
+
   void Subtract(double value, double weight = 1.0)
   {
     double w_val = value * weight;
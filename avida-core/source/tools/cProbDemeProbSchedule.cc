@@ -22,9 +22,6 @@
 
 #include "cProbDemeProbSchedule.h"
 
-#include "cDeme.h"
-#include "cMerit.h"
-
 // The larger merits cause problems here; things need to be re-thought out. 
 
 /* 
@@ -36,40 +33,36 @@
 */
 
 //get the next CPU cycle, awarded probabistically to a deme based on population with non-zero merits
-int cProbDemeProbSchedule::GetNextID()
+int cProbDemeProbSchedule::Next()
 {
+  // nothing is schedulable
+  if (demeChart.GetTotalWeight() == 0.0) return -1;
+
   //choose a deme to schedule
-  curr_deme = demeChart.FindPosition(m_rng->GetDouble(demeChart.GetTotalWeight()));
+  const int deme_id = demeChart.FindPosition(m_rng->GetDouble(demeChart.GetTotalWeight()));
 
-  //calculate the offset
-  int offset = curr_deme * deme_size;
-  
   // get the within postion of the node whos corresponding cell will get the CPU cycle
-  const double position = m_rng->GetDouble(chart[curr_deme]->GetTotalWeight());
+  const double position = m_rng->GetDouble(chart[deme_id]->GetTotalWeight());
   
   // return the adjusted ID of the cell to get the CPU cycle
-  return chart[curr_deme]->FindPosition(position) + offset;
+  return chart[deme_id]->FindPosition(position) + deme_id * deme_size;
 }
 
 
 //adjust the weight of an org within deme -- adjust the weighting for scheduling that deme
-void cProbDemeProbSchedule::Adjust(int item_id, const cMerit& item_merit, int deme_id)
+void cProbDemeProbSchedule::AdjustPriority(int entry_id, double priority)
 {
-  //calculate the corrected id for the org to be adjusted
-  int offset_id = item_id - (deme_id * deme_size);
+  const int deme_id = entry_id / deme_size;
+  const int offset_id = entry_id - deme_id * deme_size;
+  const bool was_living = (chart[deme_id]->GetWeight(offset_id) > 0.0);
 
-  //is this cell about to be populated by a living organism?
-  if (item_merit.GetDouble() > 0.0) {
-    if (chart[deme_id]->GetWeight(offset_id) == 0.0) {  //...was it previously unpopulated?  -- if so, population size has increased
-      demeChart.SetWeight(deme_id,demeChart.GetWeight(deme_id) + 1.0);//increment the deme's weight to reflect the new population size
-    }
+  //is this cell about to be populated by a living organism?  Only transitions change the deme's population size
+  if (priority > 0.0) {
+    if (!was_living) demeChart.SetWeight(deme_id, demeChart.GetWeight(deme_id) + 1.0);
   } else { //by definition the merit is zero -- no such thing as merits less than 0.0 in Avida
-    if (chart[deme_id]->GetWeight(offset_id) > 0.0) { //...was the cell previously populated -- is so, populatino size has decreased
-      demeChart.SetWeight(deme_id,demeChart.GetWeight(deme_id) - 1.0);//decrement the deme's weight to reflect the new population size
-    }
+    if (was_living) demeChart.SetWeight(deme_id, demeChart.GetWeight(deme_id) - 1.0);
   }
-       
 
   //adjust the merit of the org in the tree
-  chart[deme_id]->SetWeight(offset_id, item_merit.GetDouble());
+  chart[deme_id]->SetWeight(offset_id, priority);
 }
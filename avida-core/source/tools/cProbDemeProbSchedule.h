@@ -26,28 +26,31 @@
 #include "avida/core/Types.h"
 
 #include "apto/rng.h"
+#include "apto/scheduler.h"
 
-#include "cSchedule.h"
 #include "cWeightedIndex.h"
 
 
 /**
- * The DemeProbiblistic Schedule has the chance for an item to
- * be scheduled within each Deme proportional to the merit of that 
- * item relative to the rest of the deme.
+ * Two level probabilistic schedule.  A deme is first selected with
+ * probability proportional to the number of living organisms (non-zero
+ * merits) it contains, then an item within that deme is selected with
+ * probability proportional to its merit relative to the rest of the deme.
+ * Both levels are weighted index trees, so selection is O(log D + log n)
+ * and each priority adjustment updates both levels incrementally.
+ *
+ * Entries are cell ids; demes are assumed to occupy contiguous blocks
+ * of num_cells / num_demes cells.
  * 
  * @AWC -- further implementation notes in CC file.
  **/
 
-class cDeme;
-class cMerit;
-
-class cProbDemeProbSchedule : public cSchedule
+class cProbDemeProbSchedule : public Apto::PriorityScheduler
 {
 private:
 
   // Keep our own RNG so as to better preserve consistancy.
-  Apto::Random* m_rng;
+  Apto::SmartPtr<Apto::Random> m_rng;
 
   // Array of WeightedIndex tree's to farm out the scheduling.
   Apto::Array<cWeightedIndex*> chart;
@@ -60,9 +63,6 @@ private:
 
   // size of each deme... num_cells/num_demes
   int deme_size;
-
-  // what deme should GetNextID give the next CPU cycle to?
-  int curr_deme;
   
   
   cProbDemeProbSchedule(const cProbDemeProbSchedule&); // @not_implemented
@@ -70,19 +70,15 @@ private:
 
 
 public:
-  cProbDemeProbSchedule(int num_cells, int seed, int ndemes)
-    : cSchedule(num_cells), m_rng(new Apto::RNG::AvidaRNG(seed)), demeChart(ndemes), num_demes(ndemes)
+  cProbDemeProbSchedule(int num_cells, int ndemes, Apto::SmartPtr<Apto::Random> rng)
+    : m_rng(rng), demeChart(ndemes), num_demes(ndemes), deme_size(num_cells / ndemes)
   {     
-    deme_size = num_cells / num_demes;
-
     for (int i = 0; i < num_demes; i++) chart.Push(new cWeightedIndex(deme_size));
   }
+  ~cProbDemeProbSchedule() { for (int i = 0; i < chart.GetSize(); i++) delete chart[i]; }
 
-  ~cProbDemeProbSchedule() { for (int i = 0; i < chart.GetSize(); i++) delete chart[i]; delete m_rng; }
-
-  virtual void Adjust(int item_id, const cMerit& merit, int deme_id = 0);
-
-  int GetNextID();
+  void AdjustPriority(int entry_id, double priority);
+  int Next();
 };
 
 #endif
@@ -0,0 +1,84 @@
+/*
+ *  tRingQueue.h
+ *  Avida
+ *
+ *  Copyright 1999-2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef tRingQueue_h
+#define tRingQueue_h
+
+#include "apto/core.h"
+
+#include <cassert>
+
+
+// First-in first-out queue over a circular array.  Storage only changes size through Reserve(), so a queue that is
+// kept within its capacity never allocates.  Element 0 is the oldest entry (unlike tBuffer, which indexes back from
+// the newest).
+template <class T> class tRingQueue
+{
+private:
+  Apto::Array<T> m_data;
+  int m_head;   // Position of the oldest entry
+  int m_size;
+  
+public:
+  tRingQueue() : m_head(0), m_size(0) { ; }
+  explicit tRingQueue(int capacity) : m_data(capacity), m_head(0), m_size(0) { ; }
+  
+  inline int GetSize() const { return m_size; }
+  inline int GetCapacity() const { return m_data.GetSize(); }
+  inline bool IsEmpty() const { return m_size == 0; }
+  inline bool IsFull() const { return m_size == m_data.GetSize(); }
+  
+  inline T& operator[](int i) { assert(i >= 0 && i < m_size); return m_data[(m_head + i) % m_data.GetSize()]; }
+  inline const T& operator[](int i) const { assert(i >= 0 && i < m_size); return m_data[(m_head + i) % m_data.GetSize()]; }
+  
+  inline T& Front() { return operator[](0); }
+  inline const T& Front() const { return operator[](0); }
+  inline T& Back() { return operator[](m_size - 1); }
+  inline const T& Back() const { return operator[](m_size - 1); }
+  
+  inline void PushRear(const T& value)
+  {
+    assert(!IsFull());
+    m_data[(m_head + m_size) % m_data.GetSize()] = value;
+    m_size++;
+  }
+  
+  inline void PopFront()
+  {
+    assert(m_size > 0);
+    m_head = (m_head + 1) % m_data.GetSize();
+    m_size--;
+  }
+  
+  inline void Clear() { m_head = 0; m_size = 0; }
+  
+  // Grows the storage to hold at least capacity entries, keeping the current contents.  Never shrinks.
+  void Reserve(int capacity)
+  {
+    if (capacity <= m_data.GetSize()) return;
+    
+    Apto::Array<T> data(capacity);
+    for (int i = 0; i < m_size; i++) data[i] = operator[](i);
+    m_data = data;
+    m_head = 0;
+  }
+};
+
+#endif
@@ -41,6 +41,76 @@ Avida::Viewer::MapMode::~MapMode() { ; }
 Avida::Viewer::DiscreteScale::~DiscreteScale() { ; }
 
 
+// MapSnapshot/MapBuffers - published state of a map mode
+// --------------------------------------------------------------------------------------------------------------  
+
+// Everything a viewer reads from a map mode.  Grid values index into counts offset by MAP_RESERVED_COLORS.
+struct MapSnapshot
+{
+  Apto::Array<int> grid;
+  Apto::Array<int> counts;
+  Apto::Array<Avida::Viewer::DiscreteScale::Entry> labels;
+  bool rescaling;
+  
+  MapSnapshot() : rescaling(false) { ; }
+  
+  inline void SetCell(int cell_id, int value)
+  {
+    counts[grid[cell_id] + Avida::Viewer::MAP_RESERVED_COLORS]--;
+    grid[cell_id] = value;
+    counts[value + Avida::Viewer::MAP_RESERVED_COLORS]++;
+  }
+};
+
+
+// Front and back snapshots of a map mode.  Viewers only ever see the front, the simulation thread brings the back up
+// to date from the cells that changed and Publish() swaps the two while the map write lock is held.
+class MapBuffers
+{
+private:
+  MapSnapshot m_snapshot[2];
+  int m_front;
+  
+public:
+  MapBuffers() : m_front(0) { ; }
+  
+  void Setup(int grid_size, int num_counts, int num_labels)
+  {
+    for (int i = 0; i < 2; i++) {
+      m_snapshot[i].counts.Resize(num_counts);
+      m_snapshot[i].labels.Resize(num_labels);
+      m_snapshot[i].grid.Resize(0);
+      resize(m_snapshot[i], grid_size);
+    }
+  }
+  
+  inline const MapSnapshot& Front() const { return m_snapshot[m_front]; }
+  inline MapSnapshot& Back() { return m_snapshot[m_front ^ 1]; }
+  
+  // Brings the back snapshot level with the front, so that only changed cells need to be refreshed
+  MapSnapshot& BeginUpdate(int grid_size)
+  {
+    MapSnapshot& back = m_snapshot[m_front ^ 1];
+    back = m_snapshot[m_front];
+    if (back.grid.GetSize() != grid_size) resize(back, grid_size);
+    return back;
+  }
+  
+  inline void Publish() { m_front ^= 1; }
+  
+private:
+  static void resize(MapSnapshot& snapshot, int grid_size)
+  {
+    snapshot.grid.Resize(grid_size);
+    snapshot.grid.SetAll(Avida::Viewer::MAP_RESERVED_COLOR_BLACK);
+    snapshot.counts.SetAll(0);
+    snapshot.counts[Avida::Viewer::MAP_RESERVED_COLOR_BLACK + Avida::Viewer::MAP_RESERVED_COLORS] = grid_size;
+  }
+};
+
+
+
+
 class DoublePropMapMode : public Avida::Viewer::MapMode, public Avida::Viewer::DiscreteScale
 {
 private:
@@ -54,23 +124,28 @@ private:
   Apto::String m_prop_desc;
   Apto::String m_prop_desc_rescale;
   
-  Apto::Array<int> m_color_grid;
-  Apto::Array<int> m_color_count;
-  Apto::Array<DiscreteScale::Entry> m_scale_labels;
+  MapBuffers m_buffers;
+  Apto::Array<double> m_cell_value;   // Property value of each cell's occupant, as of its last change
+  Apto::Array<bool> m_cell_occupied;
   
   double m_cur_min;
   double m_cur_max;
   double m_target_max;
   double m_rescale_rate_min;
   double m_rescale_rate_max;
+  double m_colored_max;               // m_cur_max the published grid was colored against
   
 public:
   DoublePropMapMode(cWorld* world, const Apto::String& prop_id, const Apto::String& prop_desc)
-  : m_prop_id(prop_id), m_prop_desc(prop_desc), m_color_count(SCALE_MAX + Avida::Viewer::MAP_RESERVED_COLORS), m_scale_labels(SCALE_LABELS)
-  , m_cur_min(0.0), m_cur_max(0.0), m_target_max(0.0), m_rescale_rate_min(0.0), m_rescale_rate_max(0.0)
+  : m_prop_id(prop_id), m_prop_desc(prop_desc)
+  , m_cur_min(0.0), m_cur_max(0.0), m_target_max(0.0), m_rescale_rate_min(0.0), m_rescale_rate_max(0.0), m_colored_max(0.0)
   {
-    m_color_grid.Resize(world->GetPopulation().GetSize());
-    m_color_grid.SetAll(-4);
+    const int num_cells = world->GetPopulation().GetSize();
+    m_buffers.Setup(num_cells, SCALE_MAX + Avida::Viewer::MAP_RESERVED_COLORS, SCALE_LABELS);
+    m_cell_value.Resize(num_cells);
+    m_cell_value.SetAll(0.0);
+    m_cell_occupied.Resize(num_cells);
+    m_cell_occupied.SetAll(false);
     
     m_prop_desc_rescale = m_prop_desc + " (rescaling)";
   }
@@ -81,44 +156,63 @@ public:
   
   // MapMode Interface
   const Apto::String& GetName() const { return m_prop_desc; }
-  const Apto::Array<int>& GetGridValues() const { return m_color_grid; }
-  const Apto::Array<int>& GetValueCounts() const { return m_color_count; }
+  const Apto::Array<int>& GetGridValues() const { return m_buffers.Front().grid; }
+  const Apto::Array<int>& GetValueCounts() const { return m_buffers.Front().counts; }
   
   const DiscreteScale& GetScale() const { return *this; }
-  const Apto::String& GetScaleLabel() const;
+  const Apto::String& GetScaleLabel() const { return (m_buffers.Front().rescaling) ? m_prop_desc_rescale : m_prop_desc; }
   
   int GetSupportedTypes() const { return Avida::Viewer::MAP_GRID_VIEW_COLOR; }
   
   bool SetProperty(const Apto::String&, const Apto::String&) { return false; }
   Apto::String GetProperty(const Apto::String&) const { return ""; }
   
-  void Update(cPopulation& pop);
+  void Update(cPopulation& pop, const Apto::Array<int, Apto::Smart>& changed_cells, bool full);
+  void Publish() { m_buffers.Publish(); }
   
   
   // DiscreteScale Interface
-  int GetScaleRange() const { return m_color_count.GetSize() - Avida::Viewer::MAP_RESERVED_COLORS; }
-  int GetNumLabeledEntries() const { return m_scale_labels.GetSize(); }
-  DiscreteScale::Entry GetEntry(int index) const { return m_scale_labels[index]; }
+  int GetScaleRange() const { return m_buffers.Front().counts.GetSize() - Avida::Viewer::MAP_RESERVED_COLORS; }
+  int GetNumLabeledEntries() const { return m_buffers.Front().labels.GetSize(); }
+  DiscreteScale::Entry GetEntry(int index) const { return m_buffers.Front().labels[index]; }
+  
+private:
+  int colorOf(int cell_id) const;
+  void updateScaleLabels(MapSnapshot& snapshot) const;
 };
 
 const double DoublePropMapMode::RESCALE_TOLERANCE = 0.1;
 const double DoublePropMapMode::MAX_RESCALE_FACTOR = 0.03;
 
-void DoublePropMapMode::Update(cPopulation& pop)
+void DoublePropMapMode::Update(cPopulation& pop, const Apto::Array<int, Apto::Smart>& changed_cells, bool full)
 {
-  m_color_grid.Resize(pop.GetSize());
+  if (m_cell_value.GetSize() != pop.GetSize()) {
+    m_cell_value.Resize(pop.GetSize());
+    m_cell_occupied.Resize(pop.GetSize());
+    full = true;
+  }
   
-  // Keep track of how many times each color was assigned.
-  m_color_count.SetAll(0);
+  MapSnapshot& snapshot = m_buffers.BeginUpdate(pop.GetSize());
+  
+  // Only read the property for cells whose occupant has changed.
+  const int num_refresh = (full) ? pop.GetSize() : changed_cells.GetSize();
+  for (int i = 0; i < num_refresh; i++) {
+    const int cell_id = (full) ? i : changed_cells[i];
+    cOrganism* org = pop.GetCell(cell_id).GetOrganism();
+    m_cell_occupied[cell_id] = (org != NULL);
+    m_cell_value[cell_id] = 0.0;
+    if (org != NULL) {
+      double fit = org->Properties().Get(m_prop_id);
+      m_cell_value[cell_id] = fit;
+    }
+  }
   
   // Determine the max and min in the population.
   double max_fit = 0.0;
   double min_fit = 0.0;
   
-  for (int i = 0; i < pop.GetSize(); i++) {
-    cOrganism* org = pop.GetCell(i).GetOrganism();
-    if (org == NULL) continue;
-    double fit = org->Properties().Get(m_prop_id);
+  for (int i = 0; i < m_cell_value.GetSize(); i++) {
+    const double fit = m_cell_value[i];
     if (fit == 0.0) continue;
     if (fit > max_fit) max_fit = fit;
     if (fit < min_fit) min_fit = fit;
@@ -131,12 +225,7 @@ void DoublePropMapMode::Update(cPopulation& pop)
     m_rescale_rate_min = 0.0;
     m_rescale_rate_max = 0.0;
     
-    // Update scale labels
-    for (int i = 0; i < m_scale_labels.GetSize(); i++) {
-      m_scale_labels[i].index = (SCALE_MAX / (m_scale_labels.GetSize() - 1)) * i;
-      m_scale_labels[i].label =
-      static_cast<const char*>(cStringUtil::Stringf("%2.2f", ((m_cur_max - m_cur_min) / (m_scale_labels.GetSize() - 1)) * i));
-    }
+    updateScaleLabels(snapshot);
   } else {
     if (max_fit < (1.0 - RESCALE_TOLERANCE) * m_target_max || m_target_max < max_fit) {
       m_target_max = max_fit * (1.0 + RESCALE_TOLERANCE);
@@ -156,50 +245,42 @@ void DoublePropMapMode::Update(cPopulation& pop)
         m_rescale_rate_max = 0.0;
       }
       
-      // Update scale labels
-      for (int i = 0; i < m_scale_labels.GetSize(); i++) {
-        m_scale_labels[i].index = (SCALE_MAX / (m_scale_labels.GetSize() - 1)) * i;
-        m_scale_labels[i].label =
-        static_cast<const char*>(cStringUtil::Stringf("%2.2f", ((m_cur_max - m_cur_min) / (m_scale_labels.GetSize() - 1)) * i));
-      }
+      updateScaleLabels(snapshot);
     }
   }
+  snapshot.rescaling = (m_rescale_rate_max != 0.0);
   
-  // Now fill out the color grid.
-  for (int i = 0; i < pop.GetSize(); i++) {
-    cOrganism* org = pop.GetCell(i).GetOrganism();
-    if (org == NULL) {
-      m_color_grid[i] = Avida::Viewer::MAP_RESERVED_COLOR_BLACK;
-      m_color_count[Avida::Viewer::MAP_RESERVED_COLORS - Avida::Viewer::MAP_RESERVED_COLOR_BLACK]++;
-      continue;
-    }
-    
-    double fit = org->Properties().Get(m_prop_id);
-    if (fit == 0.0) {
-      m_color_grid[i] = Avida::Viewer::MAP_RESERVED_COLOR_DARK_GRAY;
-      m_color_count[Avida::Viewer::MAP_RESERVED_COLORS - Avida::Viewer::MAP_RESERVED_COLOR_DARK_GRAY]++;
-      continue;
-    }
-    
-    //    fit = log2(fit);
-    
-    fit = (fit - m_cur_min) / (m_cur_max - m_cur_min);
-    if (fit > 1.0) {
-      m_color_grid[i] = Avida::Viewer::MAP_RESERVED_COLOR_WHITE;
-      m_color_count[Avida::Viewer::MAP_RESERVED_COLORS - Avida::Viewer::MAP_RESERVED_COLOR_WHITE]++;
-    } else {
-      int color = fit * static_cast<double>(SCALE_MAX - 1);
-      m_color_grid[i] = color;
-      m_color_count[color + Avida::Viewer::MAP_RESERVED_COLORS]++;
-    }
+  // Now fill out the color grid, every cell needs recoloring when the scale has moved.
+  if (full || m_cur_max != m_colored_max) {
+    for (int i = 0; i < snapshot.grid.GetSize(); i++) snapshot.SetCell(i, colorOf(i));
+    m_colored_max = m_cur_max;
+  } else {
+    for (int i = 0; i < changed_cells.GetSize(); i++) snapshot.SetCell(changed_cells[i], colorOf(changed_cells[i]));
   }
 }
 
-const Apto::String& DoublePropMapMode::GetScaleLabel() const
-{  
-  if (m_rescale_rate_max != 0) return m_prop_desc_rescale;
+int DoublePropMapMode::colorOf(int cell_id) const
+{
+  if (!m_cell_occupied[cell_id]) return Avida::Viewer::MAP_RESERVED_COLOR_BLACK;
+  
+  double fit = m_cell_value[cell_id];
+  if (fit == 0.0) return Avida::Viewer::MAP_RESERVED_COLOR_DARK_GRAY;
   
-  return m_prop_desc;
+  //    fit = log2(fit);
+  
+  fit = (fit - m_cur_min) / (m_cur_max - m_cur_min);
+  if (fit > 1.0) return Avida::Viewer::MAP_RESERVED_COLOR_WHITE;
+  
+  return fit * static_cast<double>(SCALE_MAX - 1);
+}
+
+void DoublePropMapMode::updateScaleLabels(MapSnapshot& snapshot) const
+{
+  for (int i = 0; i < snapshot.labels.GetSize(); i++) {
+    snapshot.labels[i].index = (SCALE_MAX / (snapshot.labels.GetSize() - 1)) * i;
+    snapshot.labels[i].label =
+    static_cast<const char*>(cStringUtil::Stringf("%2.2f", ((m_cur_max - m_cur_min) / (snapshot.labels.GetSize() - 1)) * i));
+  }
 }
 
 
@@ -216,9 +297,9 @@ private:
   const Apto::String m_role_desc;
   
   Avida::Viewer::ClassificationInfo* m_info;
-  Apto::Array<int> m_color_grid;
-  Apto::Array<int> m_color_count;
-  Apto::Array<DiscreteScale::Entry> m_scale_labels;
+  MapBuffers m_buffers;
+  Apto::Array<Systematics::GroupPtr> m_cell_group;  // Classification of each cell's occupant, as of its last change
+  Apto::Array<bool> m_cell_occupied;
   
 public:
   ClassificationMapMode(cWorld* world, const Apto::String& role_id, const Apto::String& role_desc);
@@ -228,8 +309,8 @@ public:
   
   // MapMode Interface
   const Apto::String& GetName() const { return m_role_desc; }
-  const Apto::Array<int>& GetGridValues() const { return m_color_grid; }
-  const Apto::Array<int>& GetValueCounts() const { return m_color_count; }
+  const Apto::Array<int>& GetGridValues() const { return m_buffers.Front().grid; }
+  const Apto::Array<int>& GetValueCounts() const { return m_buffers.Front().counts; }
   
   const DiscreteScale& GetScale() const { return *this; }
   const Apto::String& GetScaleLabel() const { return m_role_desc; }
@@ -239,61 +320,97 @@ public:
   bool SetProperty(const Apto::String&, const Apto::String&) { return false; }
   Apto::String GetProperty(const Apto::String&) const { return ""; }
   
-  void Update(cPopulation& pop);
+  void Update(cPopulation& pop, const Apto::Array<int, Apto::Smart>& changed_cells, bool full);
+  void Publish() { m_buffers.Publish(); }
   
   
   // DiscreteScale Interface
-  int GetScaleRange() const { return m_color_count.GetSize() - Avida::Viewer::MAP_RESERVED_COLORS; }
-  int GetNumLabeledEntries() const { return m_scale_labels.GetSize(); }
-  DiscreteScale::Entry GetEntry(int index) const { return m_scale_labels[index]; }
+  int GetScaleRange() const { return m_buffers.Front().counts.GetSize() - Avida::Viewer::MAP_RESERVED_COLORS; }
+  int GetNumLabeledEntries() const { return m_buffers.Front().labels.GetSize(); }
+  DiscreteScale::Entry GetEntry(int index) const { return m_buffers.Front().labels[index]; }
   bool IsCategorical() const { return true; }
+  
+private:
+  void colorCell(MapSnapshot& snapshot, int cell_id);
 };
 
 ClassificationMapMode::ClassificationMapMode(cWorld* world, const Apto::String& role_id, const Apto::String& role_desc)
 : m_role_id(role_id), m_role_desc(role_desc)
 , m_info(new Avida::Viewer::ClassificationInfo(world->GetNewWorld(), role_id, NUM_COLORS, NUM_COLORS))
-, m_color_count(NUM_COLORS + Avida::Viewer::MAP_RESERVED_COLORS)
-, m_scale_labels(NUM_COLORS + Avida::Viewer::MAP_RESERVED_COLORS)
 {
-  m_scale_labels[0].index = -4;
-  m_scale_labels[0].label = "Unoccupied";
-  m_scale_labels[1].index = -3;
-  m_scale_labels[1].label = "-";
-  m_scale_labels[2].index = -2;
-  m_scale_labels[2].label = "-";
-  m_scale_labels[3].index = -1;
-  m_scale_labels[3].label = "Unassigned";
-  for (int i = 4; i < m_scale_labels.GetSize(); i++) m_scale_labels[i].index = i - 4;
-  m_color_grid.Resize(world->GetPopulation().GetSize());
-  m_color_grid.SetAll(-4);
+  const int num_cells = world->GetPopulation().GetSize();
+  m_buffers.Setup(num_cells, NUM_COLORS + Avida::Viewer::MAP_RESERVED_COLORS, NUM_COLORS + Avida::Viewer::MAP_RESERVED_COLORS);
+  m_cell_group.Resize(num_cells);
+  m_cell_occupied.Resize(num_cells);
+  m_cell_occupied.SetAll(false);
+  
+  for (int b = 0; b < 2; b++) {
+    Apto::Array<DiscreteScale::Entry>& scale_labels = m_buffers.Back().labels;
+    scale_labels[0].index = -4;
+    scale_labels[0].label = "Unoccupied";
+    scale_labels[1].index = -3;
+    scale_labels[1].label = "-";
+    scale_labels[2].index = -2;
+    scale_labels[2].label = "-";
+    scale_labels[3].index = -1;
+    scale_labels[3].label = "Unassigned";
+    for (int i = 4; i < scale_labels.GetSize(); i++) {
+      scale_labels[i].index = i - 4;
+      scale_labels[i].label = "-";
+    }
+    m_buffers.Publish();
+  }
 }
 
-void ClassificationMapMode::Update(cPopulation& pop)
+void ClassificationMapMode::Update(cPopulation& pop, const Apto::Array<int, Apto::Smart>& changed_cells, bool full)
 {
-  m_info->Update();
-  m_color_grid.Resize(pop.GetSize());
-  m_color_count.SetAll(0);            // reset all color counts
-  for (int i = 0; i < pop.GetSize(); i++) {
-    cOrganism* org = pop.GetCell(i).GetOrganism();
-    if (org == NULL) {
-      m_color_grid[i] = -4;
-      m_color_count[0]++;
-    } else {
-      Systematics::GroupPtr bg = org->SystematicsGroup(m_role_id);
-      if (bg) {
-        Avida::Viewer::ClassificationInfo::MapColorPtr mapcolor = bg->GetData<Avida::Viewer::ClassificationInfo::MapColor>();
-        if (mapcolor) {
-          m_color_grid[i] = mapcolor->color;
-          m_color_count[mapcolor->color + 4]++;
-          m_scale_labels[mapcolor->color + 4].label = bg->Properties().Get("name").StringValue();
-          continue;
-        }
-      }
-      m_color_grid[i] = -1;
-      m_color_count[3]++;
+  const bool colors_changed = m_info->Update();
+  
+  if (m_cell_group.GetSize() != pop.GetSize()) {
+    m_cell_group.Resize(pop.GetSize());
+    m_cell_occupied.Resize(pop.GetSize());
+    full = true;
+  }
+  
+  MapSnapshot& snapshot = m_buffers.BeginUpdate(pop.GetSize());
+  
+  const int num_refresh = (full) ? pop.GetSize() : changed_cells.GetSize();
+  for (int i = 0; i < num_refresh; i++) {
+    const int cell_id = (full) ? i : changed_cells[i];
+    cOrganism* org = pop.GetCell(cell_id).GetOrganism();
+    m_cell_occupied[cell_id] = (org != NULL);
+    m_cell_group[cell_id] = (org != NULL) ? org->SystematicsGroup(m_role_id) : Systematics::GroupPtr(NULL);
+  }
+  
+  // Cells keep their color until their occupant changes, unless the color assignments themselves have moved.
+  if (full || colors_changed) {
+    for (int i = 0; i < snapshot.grid.GetSize(); i++) colorCell(snapshot, i);
+  } else {
+    for (int i = 0; i < changed_cells.GetSize(); i++) colorCell(snapshot, changed_cells[i]);
+  }
+  
+  for (int i = Avida::Viewer::MAP_RESERVED_COLORS; i < snapshot.counts.GetSize(); i++) {
+    if (snapshot.counts[i] == 0) snapshot.labels[i].label = "-";
+  }
+}
+
+void ClassificationMapMode::colorCell(MapSnapshot& snapshot, int cell_id)
+{
+  if (!m_cell_occupied[cell_id]) {
+    snapshot.SetCell(cell_id, Avida::Viewer::MAP_RESERVED_COLOR_BLACK);
+    return;
+  }
+  
+  Systematics::GroupPtr bg = m_cell_group[cell_id];
+  if (bg) {
+    Avida::Viewer::ClassificationInfo::MapColorPtr mapcolor = bg->GetData<Avida::Viewer::ClassificationInfo::MapColor>();
+    if (mapcolor && mapcolor->color >= 0) {
+      snapshot.SetCell(cell_id, mapcolor->color);
+      snapshot.labels[mapcolor->color + Avida::Viewer::MAP_RESERVED_COLORS].label = bg->Properties().Get("name").StringValue();
+      return;
     }
   }
-  for (int i = 0; i < m_color_count.GetSize(); i++) if (m_color_count[i] == 0) m_scale_labels[i].label = "-";
+  snapshot.SetCell(cell_id, Avida::Viewer::MAP_RESERVED_COLOR_WHITE);
 }
 
 
@@ -303,9 +420,8 @@ class EnvActionMapMode : public Avida::Viewer::MapMode, public Avida::Viewer::Di
 {
 private:
   cWorld* m_world;
-  Apto::Array<int> m_action_grid;
+  MapBuffers m_buffers;
   Apto::Array<Apto::Array<int> > m_raw_action_counts;
-  Apto::Array<int> m_action_counts;
   Apto::Array<Apto::String> m_action_ids;
   int m_num_enabled;
   Apto::Array<bool> m_enabled_actions;
@@ -320,8 +436,8 @@ public:
   
   // MapMode Interface
   const Apto::String& GetName() const { return m_name; }
-  const Apto::Array<int>& GetGridValues() const { return m_action_grid; }
-  const Apto::Array<int>& GetValueCounts() const { return m_action_counts; }
+  const Apto::Array<int>& GetGridValues() const { return m_buffers.Front().grid; }
+  const Apto::Array<int>& GetValueCounts() const { return m_buffers.Front().counts; }
   
   const DiscreteScale& GetScale() const { return *this; }
   const Apto::String& GetScaleLabel() const { return m_scale_label; }
@@ -331,7 +447,8 @@ public:
   bool SetProperty(const Apto::String& property, const Apto::String& value);
   Apto::String GetProperty(const Apto::String& property) const;
   
-  void Update(cPopulation& pop);
+  void Update(cPopulation& pop, const Apto::Array<int, Apto::Smart>& changed_cells, bool full);
+  void Publish() { m_buffers.Publish(); }
   
   
   // DiscreteScale Interface
@@ -341,12 +458,12 @@ public:
   
   
 private:
-  void updateTagStates();
+  int tagStateOf(int cell_id) const;
 };
 
 
 EnvActionMapMode::EnvActionMapMode(cWorld* world)
- : m_world(world), m_action_counts(Avida::Viewer::MAP_RESERVED_COLORS), m_name("Actions")
+ : m_world(world), m_name("Actions")
 {
   cEnvironment& env = m_world->GetEnvironment();
   const int num_tasks = env.GetNumTasks();
@@ -358,6 +475,13 @@ EnvActionMapMode::EnvActionMapMode(cWorld* world)
   
   for (int i = 0; i < num_tasks; i++) m_action_ids[i] = env.GetTask(i).GetName();
 
+  const int num_cells = m_world->GetPopulation().GetSize();
+  m_buffers.Setup(num_cells, Avida::Viewer::MAP_RESERVED_COLORS, 0);
+  m_raw_action_counts.Resize(num_cells);
+  for (int i = 0; i < num_cells; i++) {
+    m_raw_action_counts[i].Resize(num_tasks);
+    m_raw_action_counts[i].SetAll(0);
+  }
 }
 
 bool EnvActionMapMode::SetProperty(const Apto::String& property, const Apto::String& value)
@@ -382,7 +506,10 @@ bool EnvActionMapMode::SetProperty(const Apto::String& property, const Apto::Str
     m_num_enabled = num_enabled;
     m_enabled_actions = earr;
     m_enabled_action_string = value;
-    updateTagStates();
+    
+    // Every tag depends on the enabled set, retag the whole grid for the map to publish
+    MapSnapshot& snapshot = m_buffers.BeginUpdate(m_raw_action_counts.GetSize());
+    for (int i = 0; i < snapshot.grid.GetSize(); i++) snapshot.SetCell(i, tagStateOf(i));
     return true;
   }
   return false;
@@ -402,68 +529,69 @@ Apto::String EnvActionMapMode::GetProperty(const Apto::String& property) const
   return "";
 }
 
-void EnvActionMapMode::Update(cPopulation& pop)
+void EnvActionMapMode::Update(cPopulation& pop, const Apto::Array<int, Apto::Smart>& changed_cells, bool full)
 {
   cAvidaContext ctx(&m_world->GetDriver(), m_world->GetRandom());
 
-  m_action_grid.Resize(pop.GetSize());
-  m_raw_action_counts.Resize(pop.GetSize());
-  for (int i = 0; i < m_raw_action_counts.GetSize(); i++) m_raw_action_counts[i].Resize(m_action_ids.GetSize());
-  m_action_counts.SetAll(0);            // reset all color counts
+  if (m_raw_action_counts.GetSize() != pop.GetSize()) {
+    m_raw_action_counts.Resize(pop.GetSize());
+    for (int i = 0; i < m_raw_action_counts.GetSize(); i++) m_raw_action_counts[i].Resize(m_action_ids.GetSize());
+    full = true;
+  }
   
-  for (int i = 0; i < pop.GetSize(); i++) {
-    cOrganism* org = pop.GetCell(i).GetOrganism();
+  MapSnapshot& snapshot = m_buffers.BeginUpdate(pop.GetSize());
+  
+  // An organism's test metrics are fixed by its genotype, so only cells with a new occupant need to be looked up.
+  const int num_refresh = (full) ? pop.GetSize() : changed_cells.GetSize();
+  for (int i = 0; i < num_refresh; i++) {
+    const int cell_id = (full) ? i : changed_cells[i];
+    cOrganism* org = pop.GetCell(cell_id).GetOrganism();
     if (org == NULL) {
-      m_raw_action_counts[i].SetAll(0);
+      m_raw_action_counts[cell_id].SetAll(0);
     } else {
+      Systematics::GroupPtr genotype = org->SystematicsGroup("genotype");
+      Systematics::GenomeTestMetricsPtr metrics(Systematics::GenomeTestMetrics::GetMetrics(m_world, ctx, genotype));
+      const Apto::Array<int>& task_counts = metrics->GetTaskCounts();
       for (int task_id = 0; task_id < m_action_ids.GetSize(); task_id++) {
-//        if (org->GetPhenotype().GetLastTaskCount()[task_id] > 0) m_raw_action_counts[i][task_id] = 1;
-//        else if (org->GetPhenotype().GetCurTaskCount()[task_id] > 0) m_raw_action_counts[i][task_id] = 2;
-        Systematics::GroupPtr genotype = org->SystematicsGroup("genotype");
-        Systematics::GenomeTestMetricsPtr metrics(Systematics::GenomeTestMetrics::GetMetrics(m_world, ctx, genotype));
-        const Apto::Array<int>& task_counts = metrics->GetTaskCounts();
-        if (task_counts[task_id] > 0) m_raw_action_counts[i][task_id] = 1;
-        else m_raw_action_counts[i][task_id] = 0;
+//        if (org->GetPhenotype().GetLastTaskCount()[task_id] > 0) m_raw_action_counts[cell_id][task_id] = 1;
+//        else if (org->GetPhenotype().GetCurTaskCount()[task_id] > 0) m_raw_action_counts[cell_id][task_id] = 2;
+        if (task_counts[task_id] > 0) m_raw_action_counts[cell_id][task_id] = 1;
+        else m_raw_action_counts[cell_id][task_id] = 0;
       }
     }
+    snapshot.SetCell(cell_id, tagStateOf(cell_id));
   }
-  
-  updateTagStates();
 }
 
 
-void EnvActionMapMode::updateTagStates()
+int EnvActionMapMode::tagStateOf(int cell_id) const
 {
-  if (m_num_enabled == 0) {
-    m_action_grid.SetAll(-4);
-    return;
-  }
-  for (int i = 0; i < m_action_grid.GetSize(); i++) {
-    int color = -1;
-    for (int task_id = 0; task_id < m_action_ids.GetSize(); task_id++) {
-      if (!m_enabled_actions[task_id]) continue;  // Task disabled, so ignore value
-      
-      if (m_raw_action_counts[i][task_id] == 0) {  // One of the enabled tasks is not being performed, so clear tag and exit
-        color = -4;
-        break;
-      }
-      
-      if (m_raw_action_counts[i][task_id] == 2) color = -3;  // One of the enabled tasks is a current task, so dim the tag
+  if (m_num_enabled == 0) return -4;
+  
+  int color = -1;
+  for (int task_id = 0; task_id < m_action_ids.GetSize(); task_id++) {
+    if (!m_enabled_actions[task_id]) continue;  // Task disabled, so ignore value
+    
+    if (m_raw_action_counts[cell_id][task_id] == 0) {  // One of the enabled tasks is not being performed, so clear tag
+      return -4;
     }
-    m_action_grid[i] = color;
-    m_action_counts[4 + color]++;
+    
+    if (m_raw_action_counts[cell_id][task_id] == 2) color = -3;  // One of the enabled tasks is a current task, so dim the tag
   }
+  return color;
 }
 
 
 
 Avida::Viewer::Map::Map(cWorld* world)
-  : m_width(world->GetPopulation().GetWorldX())
+  : m_world(world)
+  , m_width(world->GetPopulation().GetWorldX())
   , m_height(world->GetPopulation().GetWorldY())
   , m_num_viewer_colors(-1)
   , m_color_mode(0)
   , m_symbol_mode(-1)
   , m_tag_mode(4)
+  , m_tracking(false)
 {
   // Setup the available view modes...
   m_view_modes.Resize(5);
@@ -494,27 +622,50 @@ Avida::Viewer::Map::Map(cWorld* world)
 
 Avida::Viewer::Map::~Map()
 {
+  if (m_tracking) m_world->GetPopulation().SetCellChangeTracking(false);
   for (int i = 0; i < m_view_modes.GetSize(); i++) delete m_view_modes[i];
 }
 
 bool Avida::Viewer::Map::SetModeProperty(int idx, const Apto::String& property, const Apto::String& value)
 {
+  m_update_mutex.Lock();
   m_rw_lock.WriteLock();
   bool rval = m_view_modes[idx]->SetProperty(property, value);
+  if (rval) m_view_modes[idx]->Publish();
   m_rw_lock.WriteUnlock();
+  m_update_mutex.Unlock();
   return rval;
 }
 
 void Avida::Viewer::Map::UpdateMaps(cPopulation& pop)
 {
+  m_update_mutex.Lock();
+  
+  // Change tracking starts with the first update, which has to refresh every cell.  Population size changes are
+  // picked up by the modes themselves.
+  bool full = false;
+  if (!m_tracking) {
+    pop.SetCellChangeTracking(true);
+    m_tracking = true;
+    m_changed_cells.Resize(0);
+    full = true;
+  } else {
+    pop.TakeChangedCells(m_changed_cells);
+  }
+  
+  // Modes refresh their back buffers without the lock, viewers are only held off while the buffers are swapped
+  for (int i = 0; i < m_view_modes.GetSize(); i++) m_view_modes[i]->Update(pop, m_changed_cells, full);
+  
   m_rw_lock.WriteLock();
   
   m_width = pop.GetWorldX();
   m_height = pop.GetWorldY();
   
-  for (int i = 0; i < m_view_modes.GetSize(); i++) m_view_modes[i]->Update(pop);
+  for (int i = 0; i < m_view_modes.GetSize(); i++) m_view_modes[i]->Publish();
   
   m_rw_lock.WriteUnlock();
+  
+  m_update_mutex.Unlock();
 }
 
 